@@ -35,6 +35,7 @@
  */
 /* ----------------------  INCLUDES  ---------------------------------------- */
 #include "motor.h"
+#include "../lib/clock.h"
 #include <stdio.h>
 #include <wiringPi.h>
 #include <softPwm.h>
@@ -114,7 +115,7 @@ void MOTOR_set_command(Command cmd) {
             digitalWrite(AIN2, HIGH);
             digitalWrite(BIN1, HIGH);
             digitalWrite(BIN2, LOW);
-            delay(128); // //change depending on the hardware
+            CLOCK_delay_ms(128); // //change depending on the hardware
             digitalWrite(AIN1, LOW);
             digitalWrite(AIN2, LOW);
             digitalWrite(BIN1, LOW);
@@ -126,7 +127,7 @@ void MOTOR_set_command(Command cmd) {
             digitalWrite(AIN2, LOW);
             digitalWrite(BIN1, LOW);
             digitalWrite(BIN2, HIGH);
-            delay(205); // // //change depending on the hardware
+            CLOCK_delay_ms(205); // // //change depending on the hardware
             digitalWrite(AIN1, LOW);
             digitalWrite(AIN2, LOW);
             digitalWrite(BIN1, LOW);
@@ -138,7 +139,7 @@ void MOTOR_set_command(Command cmd) {
             digitalWrite(AIN2, HIGH);
             digitalWrite(BIN1, LOW);
             digitalWrite(BIN2, HIGH);
-            delay((unsigned int)(temps_necessaire* 1500));  
+            CLOCK_delay_ms((unsigned int)(temps_necessaire* 1500));  
             digitalWrite(AIN1, LOW);
             digitalWrite(AIN2, LOW);
             digitalWrite(BIN1, LOW);
@@ -155,6 +156,10 @@ void MOTOR_set_command(Command cmd) {
         }
     }
 }
+void MOTOR_set_unit_command(int unit, Command cmd) {
+    // An AlphaBot2 has a single pair of motors.
+    MOTOR_set_command(cmd);
+}
 int MOTOR_destroy(void) {
     softPwmStop(PWM_A);
     softPwmStop(PWM_B);
@@ -66,5 +66,11 @@ extern int MOTOR_destroy(void);
  * \author Thomas ROCHER
  */
 extern void MOTOR_set_command(Command cmd);
+/**
+ * \fn extern void MOTOR_set_unit_command(int unit, Command cmd)
+ * \brief Execute a move command on a given motor unit (a pilot drives one unit, unit 0 is MOTOR_set_command()).
+ * \author Thomas ROCHER
+ */
+extern void MOTOR_set_unit_command(int unit, Command cmd);
 
 #endif /* SRC_ALPHABOT2_MOTOR_H_ */
@@ -35,6 +35,7 @@
  */
 /* ----------------------  INCLUDES  ---------------------------------------- */
 #include "ultrasound.h"
+#include "../lib/clock.h"
 
 #include <wiringPi.h>
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
@@ -61,7 +62,7 @@ void ULTRASOUND_create()
     wiringPiSetup();  // Initialize WiringPi
     pinMode(TRIG, OUTPUT);
     pinMode(ECHO, INPUT);
-    delay(30);  // Allow the sensor to settle
+    CLOCK_real_delay_us(30000);  // Allow the sensor to settle (wall clock : the sensor does not follow the virtual time)
 }
 
 bool ULTRASOUND_check_obstacle() {
@@ -69,22 +70,28 @@ bool ULTRASOUND_check_obstacle() {
     return check;
 }
 
+bool ULTRASOUND_check_unit_obstacle(int unit) {
+    // An AlphaBot2 has a single ultrasound sensor.
+    return ULTRASOUND_check_obstacle();
+}
+
 void ULTRASOUND_destroy(){}
 
 /* ----------------------  PRIVATE FUNCTIONS  -------------------- */
 
 double get_obstacle_distance()
 {
+    // The pulses are physical : they are timed on the wall clock, even when Carto runs on the virtual time base.
     digitalWrite(TRIG, LOW);
-    delayMicroseconds(2);
+    CLOCK_real_delay_us(2);
     digitalWrite(TRIG, HIGH);
-    delayMicroseconds(10);
+    CLOCK_real_delay_us(10);
     digitalWrite(TRIG, LOW);
     //printf("Attente d'un signal\n");
     while (digitalRead(ECHO) == LOW);
-    long startTime = micros();
+    uint64_t startTime = CLOCK_real_micros();
     while (digitalRead(ECHO) == HIGH);
-    long travelTime = micros() - startTime;
+    uint64_t travelTime = CLOCK_real_micros() - startTime;
     double distance = travelTime / 58.0;
     return distance;
 }
\ No newline at end of file
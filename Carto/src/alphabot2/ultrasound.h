@@ -62,4 +62,10 @@ extern void ULTRASOUND_destroy();
  * \author Thomas ROCHER
  */
 extern bool ULTRASOUND_check_obstacle();
+/**
+ * \fn extern bool ULTRASOUND_check_unit_obstacle(int unit)
+ * \brief Same as ULTRASOUND_check_obstacle() on a given sensor unit (unit 0 is ULTRASOUND_check_obstacle()).
+ * \author Thomas ROCHER
+ */
+extern bool ULTRASOUND_check_unit_obstacle(int unit);
 #endif /* SRC_ALPHABOT2_ULTRASOUND_H_ */
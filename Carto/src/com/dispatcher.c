@@ -39,14 +39,16 @@
 #include "postman.h"
 #include "../lib/defs.h"
 #include "../controller/pilot.h"
+#include "proxyCartography.h"
 
 #include <stdbool.h>
 #include <pthread.h>
 #include <errno.h>
 #include <stdlib.h>
-#include <arpa/inet.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+#include <unistd.h>
 
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
 #define STATE_GENERATION S(S_IDLE) S(S_READING_MSG) S(S_STOP) S(S_WAITING_RECONNECTION)
@@ -62,6 +64,23 @@ typedef enum {STATE_GENERATION STATE_NB} State_Machine;
  */
 #define MAX_RECEIVED_BYTES (20)
 /* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/**
+ * \struct Dispatcher_t dispatcher.c "com/dispatcher.c"
+ * \brief Context of a dispatcher.
+ */
+struct Dispatcher_t {
+    State_Machine state;                    /**< Dispatcher state Machine. */
+    pthread_t dispatcher_thread;            /**< Dispatcher thread. */
+    uint8_t * data_received;                /**< raw data received from socket. */
+    int data_size;                          /**< Size of the payload in data_received. */
+    pthread_mutex_t dispatcher_mutex;       /**< Mutex used to safely read state from state machine. */
+    pthread_cond_t dispatcher_condition;    /**< Wakes the dispatcher thread up when there is something to read (or when it has to stop). */
+    Command list_commands[50];              /**< Command's list to use as parameter for PILOT_instance_send_moves_trajectory. */
+    int count_command;                      /**< Count of command in the current list_commands. */
+    Postman * postman;                      /**< Postman read by the dispatcher. */
+    Pilot * pilot;                          /**< Pilot receiving the decoded orders. */
+    uint32_t session_token;                 /**< Token of the session, given in SESSION and matched on RESUME. */
+};
 /* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
 /* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
 /**
@@ -71,137 +90,168 @@ typedef enum {STATE_GENERATION STATE_NB} State_Machine;
  * \author Joshua MONTREUIL
  * \see postman.h
  *
- * \param arg : argument pointer.
+ * \param arg : dispatcher context.
  *
  * \return void * : generic pointer (0 on success -1 on error).
  */
 static void *run(void * arg);
 /**
- * \fn static void DISPATCHER_dispatch_received_msg(Communication_Protocol_Head msg)
+ * \fn static void DISPATCHER_dispatch_received_msg(Dispatcher * dispatcher, Communication_Protocol_Head msg)
  * \brief Used to parse the incoming msg and to dispatch and pass data to the right functions.
  * \author Joshua MONTREUIL
  *
- * \see PILOT_send_moves_trajectory(Command list_commands [], int size)
- * \see PILOT_send_move_cartography(Command cmd)
- * \see PILOT_send_robot_position(Position* robot_position_p)
- * \see PILOT_stop_robot()
+ * \see PILOT_instance_send_moves_trajectory(Pilot * pilot, Command list_commands [], int size)
+ * \see PILOT_instance_send_move_cartography(Pilot * pilot, Command cmd)
+ * \see PILOT_instance_send_robot_position(Pilot * pilot, Position* robot_position_p)
+ * \see PILOT_instance_stop_robot(Pilot * pilot)
+ * \see PILOT_instance_send_map_snapshot(Pilot * pilot)
  *
+ * \param dispatcher : dispatcher context.
  * \param msg : message received from postman's socket. Type : Communication_Protocol_Head.
  * \see Communication_Protocol_Head
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int dispatch_received_msg(Communication_Protocol_Head msg);
+static int dispatch_received_msg(Dispatcher * dispatcher, Communication_Protocol_Head msg);
 /**
- * \fn static Communication_Protocol_Head DISPATCHER_decode_message(uint8_t* raw_message)
+ * \fn static Communication_Protocol_Head DISPATCHER_decode_message(Dispatcher * dispatcher, uint8_t* raw_message)
  * \brief Used to decode the raw message from the socket. Separation between the message type, the data size and the rest of the informations.
  * \author Joshua MONTREUIL
  *
+ * \param dispatcher : dispatcher context.
  * \param raw_message : raw message from the socket.
  *
  * \return The header of the message.
  * \see Communication_Protocol_Head
  */
-static Communication_Protocol_Head decode_message(uint8_t* raw_message);
-
-/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
-/**
- * \var static State_Machine state
- * \brief Dispatcher state Machine.
- */
-static State_Machine state;
-/**
- * \var static pthread_t dispatcher_thread
- * \brief Dispatcher thread.
- */
-static pthread_t dispatcher_thread;
+static Communication_Protocol_Head decode_message(Dispatcher * dispatcher, uint8_t* raw_message);
 /**
- * \var static uint8_t * data_received
- * \brief raw data received from socket;
+ * \fn static uint32_t new_session_token(void)
+ * \brief Draws a non null token, different from the one of a previous run of Carto.
+ * \author Thomas ROCHER
  */
-static uint8_t * data_received;
-/**
- * \var static pthread_mutex_t dispatcher_mutex
- * \brief Mutex used to safely read state from state machine
- */
-static pthread_mutex_t dispatcher_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t new_session_token(void);
 
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
 /**
- * \var static Command* list_commands
- * \brief Command's list to use as parameter for PILOT_send_moves_trajectory
- */
-static Command list_commands[50];
-/**
- * \var static int count_command
- * \brief Count of command in the current list_commands
+ * \var static Dispatcher * default_dispatcher
+ * \brief Dispatcher used by the DISPATCHER_* functions without context.
  */
-static int count_command = 0;
+static Dispatcher * default_dispatcher = NULL;
 
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
-int DISPATCHER_create(void) {
-    data_received = (uint8_t *) malloc(MAX_RECEIVED_BYTES);
+Dispatcher * DISPATCHER_instance_create(Postman * postman, Pilot * pilot) {
+    Dispatcher * dispatcher = (Dispatcher *) calloc(1, sizeof(Dispatcher));
+    if(dispatcher == NULL) {
+        return NULL;
+    }
+    dispatcher->data_received = (uint8_t *) malloc(MAX_RECEIVED_BYTES);
+    pthread_mutex_init(&dispatcher->dispatcher_mutex, NULL);
+    pthread_cond_init(&dispatcher->dispatcher_condition, NULL);
+    dispatcher->postman = postman;
+    dispatcher->pilot = pilot;
+    dispatcher->session_token = new_session_token();
+    POSTMAN_instance_set_dispatcher(postman, dispatcher);
+    return dispatcher;
+}
+
+int DISPATCHER_instance_start(Dispatcher * dispatcher) {
+    // The state stays as created (S_IDLE) : the postman may already have accepted Cute and asked for reading.
+    if(pthread_create(&dispatcher->dispatcher_thread, NULL, run, dispatcher) != 0 ) {
+        return -1;
+    }
     return 0;
 }
 
-int DISPATCHER_start(void) {
-    state = S_IDLE;
-    if(pthread_create(&dispatcher_thread, NULL, run, NULL) != 0 ) {
+void DISPATCHER_instance_start_reading(Dispatcher * dispatcher) {
+    pthread_mutex_lock(&dispatcher->dispatcher_mutex);
+    dispatcher->state = S_READING_MSG;
+    pthread_cond_signal(&dispatcher->dispatcher_condition);
+    pthread_mutex_unlock(&dispatcher->dispatcher_mutex);
+}
+
+void DISPATCHER_instance_disconnect(Dispatcher * dispatcher){
+    pthread_mutex_lock(&dispatcher->dispatcher_mutex);
+    if(dispatcher->state != S_STOP) {
+        dispatcher->state = S_WAITING_RECONNECTION;
+    }
+    pthread_mutex_unlock(&dispatcher->dispatcher_mutex);   
+}
+
+int DISPATCHER_instance_stop(Dispatcher * dispatcher) {
+    pthread_mutex_lock(&dispatcher->dispatcher_mutex);
+    dispatcher->state = S_STOP;
+    pthread_cond_signal(&dispatcher->dispatcher_condition);
+    pthread_mutex_unlock(&dispatcher->dispatcher_mutex);
+    if(pthread_join(dispatcher->dispatcher_thread, NULL) != 0) {
         return -1;
     }
-    PILOT_create();
     return 0;
 }
 
+int DISPATCHER_instance_destroy(Dispatcher * dispatcher) {
+    free(dispatcher->data_received);
+    pthread_cond_destroy(&dispatcher->dispatcher_condition);
+    pthread_mutex_destroy(&dispatcher->dispatcher_mutex);
+    free(dispatcher);
+    return 0;
+}
+
+int DISPATCHER_create(void) {
+    if(PILOT_create() == -1) {
+        return -1;
+    }
+    default_dispatcher = DISPATCHER_instance_create(POSTMAN_get_default(), PILOT_get_default());
+    return (default_dispatcher == NULL) ? -1 : 0;
+}
+
+int DISPATCHER_start(void) {
+    return DISPATCHER_instance_start(default_dispatcher);
+}
+
 void DISPATCHER_start_reading() {
-    pthread_mutex_lock(&dispatcher_mutex);
-    state = S_READING_MSG;
-    pthread_mutex_unlock(&dispatcher_mutex);
+    DISPATCHER_instance_start_reading(default_dispatcher);
 }
 
 void DISPATCHER_disconnect(void){
-    pthread_mutex_lock(&dispatcher_mutex);
-    state = S_WAITING_RECONNECTION;
-    pthread_mutex_unlock(&dispatcher_mutex);   
+    DISPATCHER_instance_disconnect(default_dispatcher);
 }
 
 int DISPATCHER_stop(void) {
-    pthread_mutex_lock(&dispatcher_mutex);
-    state = S_STOP;
-    pthread_mutex_unlock(&dispatcher_mutex);
-    if(pthread_join(dispatcher_thread, NULL) != 0) {
-        return -1;
-    }
-    return 0;
+    return DISPATCHER_instance_stop(default_dispatcher);
 }
 
 int DISPATCHER_destroy(void) {
-    free(data_received);
+    DISPATCHER_instance_destroy(default_dispatcher);
+    default_dispatcher = NULL;
     PILOT_destroy();
     return 0;
 }
 
 /* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
 static void * run(void * arg) {
+    Dispatcher * dispatcher = (Dispatcher *) arg;
     State_Machine my_state;
-    pthread_mutex_lock(&dispatcher_mutex);
-    my_state = state;
-    pthread_mutex_unlock(&dispatcher_mutex);
+    pthread_mutex_lock(&dispatcher->dispatcher_mutex);
+    my_state = dispatcher->state;
+    pthread_mutex_unlock(&dispatcher->dispatcher_mutex);
     while(my_state != S_STOP) {
-        pthread_mutex_lock(&dispatcher_mutex);
-        my_state = state;
-        pthread_mutex_unlock(&dispatcher_mutex);
+        pthread_mutex_lock(&dispatcher->dispatcher_mutex);
+        while(dispatcher->state == S_IDLE || dispatcher->state == S_WAITING_RECONNECTION) {
+            pthread_cond_wait(&dispatcher->dispatcher_condition, &dispatcher->dispatcher_mutex);
+        }
+        my_state = dispatcher->state;
+        pthread_mutex_unlock(&dispatcher->dispatcher_mutex);
         if(my_state == S_READING_MSG) {
-            uint8_t* raw_message = POSTMAN_read_request();
+            uint8_t* raw_message = POSTMAN_instance_read_request(dispatcher->postman);
             if(raw_message != NULL) {
                 uint8_t error_value = *raw_message;
                 if(error_value == EBADF) {
-                    pthread_mutex_lock(&dispatcher_mutex);
-                    state = S_WAITING_RECONNECTION;
-                    pthread_mutex_unlock(&dispatcher_mutex);
+                    DISPATCHER_instance_disconnect(dispatcher);
                 }
                 else {
-                    Communication_Protocol_Head msg_decoded = decode_message(raw_message);
-                    dispatch_received_msg(msg_decoded);
+                    Communication_Protocol_Head msg_decoded = decode_message(dispatcher, raw_message);
+                    dispatch_received_msg(dispatcher, msg_decoded);
                 }
                 free(raw_message);
             }
@@ -210,45 +260,94 @@ static void * run(void * arg) {
     return 0;
 }
 
-static int dispatch_received_msg(Communication_Protocol_Head msg) {
+static int dispatch_received_msg(Dispatcher * dispatcher, Communication_Protocol_Head msg) {
+    uint8_t * data_received = dispatcher->data_received;
+    if(msg.sequenced) {
+        // Requests are handled in order : every answer from now on acks this one.
+        POSTMAN_instance_set_ack(dispatcher->postman, msg.seq);
+    }
+    // data_received is not cleared : a payload shorter than its type would read the previous one.
+    const Protocol_Message_Info * info = PROTOCOL_message_info(msg.msg_type);
+    if(info != NULL && info->payload_size > dispatcher->data_size) {
+        return -1;
+    }
     switch(msg.msg_type)
     {
         case SEND_MOVES_TRAJECTORY :
         {
             int size = (int)data_received[0];
-            if (count_command < size-1) {
-                list_commands[count_command] = data_received[1];
-                count_command++;
+            if (dispatcher->count_command < size-1) {
+                dispatcher->list_commands[dispatcher->count_command] = data_received[1];
+                dispatcher->count_command++;
             }
             else {
-                list_commands[count_command] = data_received[1];
-                PILOT_send_moves_trajectory(list_commands, size);
-                count_command = 0;
+                dispatcher->list_commands[dispatcher->count_command] = data_received[1];
+                PILOT_instance_send_moves_trajectory(dispatcher->pilot, dispatcher->list_commands, size);
+                dispatcher->count_command = 0;
             }
             break;
         }
         case SEND_MOVE_CARTOGRAPHY :
         {
             switch((int)data_received[0]){
-                case 0 : PILOT_send_move_cartography(FORWARD); break;
-                case 1 : PILOT_send_move_cartography(RIGHT); break;
-                case 2 : PILOT_send_move_cartography(LEFT); break;
+                case 0 : PILOT_instance_send_move_cartography(dispatcher->pilot, FORWARD); break;
+                case 1 : PILOT_instance_send_move_cartography(dispatcher->pilot, RIGHT); break;
+                case 2 : PILOT_instance_send_move_cartography(dispatcher->pilot, LEFT); break;
                 default : break;
             }
             break;
         }
         case STOP_ROBOT :
         {
-            PILOT_stop_robot();
+            PILOT_instance_stop_robot(dispatcher->pilot);
             break;
         }
         case SEND_ROBOT_POSITION :
+        case SEND_ROBOT_POSITION_V2 :
         {
+            Protocol_Pose pose = PROTOCOL_decode_pose(msg.msg_type, data_received);
             Position robot_position;
-            robot_position.coord_x = (int)data_received[0];
-            robot_position.coord_y = (int)data_received[1];
-            robot_position.dir = (Direction)data_received[2];
-            PILOT_send_robot_position(&robot_position);
+            robot_position.coord_x = pose.coord_x;
+            robot_position.coord_y = pose.coord_y;
+            robot_position.dir = pose.dir;
+            PILOT_instance_send_robot_position(dispatcher->pilot, &robot_position);
+            break;
+        }
+        case HELLO :
+        {
+            Protocol_Hello kept = PROTOCOL_negotiate(PROTOCOL_decode_hello(data_received));
+            // The answer is queued before any frame of the new version.
+            PROXYCARTOGRAPHY_instance_hello_ack(dispatcher->postman, kept.version, kept.capabilities);
+            POSTMAN_instance_set_protocol(dispatcher->postman, kept.version, kept.capabilities);
+            if(kept.capabilities & PROTOCOL_CAP_RESUME) {
+                // The RESUME following the HELLO tells which map changes the client still needs.
+                PILOT_instance_wait_resume(dispatcher->pilot);
+            }
+            break;
+        }
+        case RESUME :
+        {
+            if(!(POSTMAN_instance_get_capabilities(dispatcher->postman) & PROTOCOL_CAP_RESUME)) {
+                break;
+            }
+            // Another token (Cute restarted, or Carto did) : the client starts again from the whole map.
+            Protocol_Msg_Resume resume = PROTOCOL_read_resume(data_received);
+            bool_e resumed = (resume.token == dispatcher->session_token) ? TRUE : FALSE;
+            PROXYCARTOGRAPHY_instance_session(dispatcher->postman, dispatcher->session_token, resumed,
+                                              PILOT_instance_get_moves_done(dispatcher->pilot));
+            if(resumed == TRUE) {
+                PILOT_instance_resume(dispatcher->pilot, resume.map_version, resume.moves_done);
+            }
+            else if(POSTMAN_instance_get_capabilities(dispatcher->postman) & PROTOCOL_CAP_MAP_SNAPSHOT) {
+                PILOT_instance_send_map_snapshot(dispatcher->pilot);
+            }
+            break;
+        }
+        case MAP_SNAPSHOT_REQUEST :
+        {
+            if(POSTMAN_instance_get_capabilities(dispatcher->postman) & PROTOCOL_CAP_MAP_SNAPSHOT) {
+                PILOT_instance_send_map_snapshot(dispatcher->pilot);
+            }
             break;
         }
         default :
@@ -260,12 +359,18 @@ static int dispatch_received_msg(Communication_Protocol_Head msg) {
     return 0;
 }
 
-static Communication_Protocol_Head decode_message(uint8_t* raw_message) {
-    Communication_Protocol_Head msg;
-    msg.msg_size = (raw_message[0] << 8) | raw_message[1];
-    msg.msg_type = ntohs((raw_message[2] << 8) | raw_message[3]);
-    if(msg.msg_size > 2) {
-        memcpy(data_received, raw_message + 4,  msg.msg_size - 2);
-    }
+static Communication_Protocol_Head decode_message(Dispatcher * dispatcher, uint8_t* raw_message) {
+    Communication_Protocol_Head msg = PROTOCOL_decode_head(raw_message);
+    int data_size = PROTOCOL_payload_size(msg);
+    data_size = (data_size < MAX_RECEIVED_BYTES) ? data_size : MAX_RECEIVED_BYTES;
+    memcpy(dispatcher->data_received, raw_message + PROTOCOL_payload_offset(msg), data_size);
+    dispatcher->data_size = data_size;
     return msg;
-}
\ No newline at end of file
+}
+
+static uint32_t new_session_token(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint32_t token = ((uint32_t)now.tv_sec * 2654435761u) ^ (uint32_t)now.tv_nsec ^ ((uint32_t)getpid() << 16);
+    return (token != 0) ? token : 1;
+}
@@ -37,11 +37,67 @@
 #ifndef SRC_COM_DISPATCHER_H_
 #define SRC_COM_DISPATCHER_H_
 /* ----------------------  INCLUDES ------------------------------------------*/
+#include "postman.h"
+#include "../controller/pilot.h"
 /* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \struct Dispatcher dispatcher.h "com/dispatcher.h"
+ * \brief Context of a dispatcher : reads the messages of one postman and gives the orders to one pilot.
+ *
+ * The DISPATCHER_* functions without context use a default dispatcher, bound to the default postman and pilot.
+ */
+typedef struct Dispatcher_t Dispatcher;
 /* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
 /* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
 /* ----------------------  PUBLIC VARIABLES ----------------------------------*/
 /* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern Dispatcher * DISPATCHER_instance_create(Postman * postman, Pilot * pilot)
+ * \brief Creates a dispatcher and attaches it to its postman.
+ * \author Thomas ROCHER
+ *
+ * \param postman : postman to read.
+ * \param pilot : pilot receiving the orders. Its lifetime is handled by the caller.
+ *
+ * \return The dispatcher on success, NULL on error.
+ */
+extern Dispatcher * DISPATCHER_instance_create(Postman * postman, Pilot * pilot);
+/**
+ * \fn extern int DISPATCHER_instance_destroy(Dispatcher * dispatcher)
+ * \brief Destroys a dispatcher.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int DISPATCHER_instance_destroy(Dispatcher * dispatcher);
+/**
+ * \fn extern int DISPATCHER_instance_start(Dispatcher * dispatcher)
+ * \brief Starts a dispatcher.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int DISPATCHER_instance_start(Dispatcher * dispatcher);
+/**
+ * \fn extern int DISPATCHER_instance_stop(Dispatcher * dispatcher)
+ * \brief Stops a dispatcher. Its postman must be disconnected, the thread can't leave a blocking read.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int DISPATCHER_instance_stop(Dispatcher * dispatcher);
+/**
+ * \fn extern void DISPATCHER_instance_start_reading(Dispatcher * dispatcher)
+ * \brief Begins to read. Called by the postman on connection.
+ * \author Thomas ROCHER
+ */
+extern void DISPATCHER_instance_start_reading(Dispatcher * dispatcher);
+/**
+ * \fn extern void DISPATCHER_instance_disconnect(Dispatcher * dispatcher)
+ * \brief Marks the dispatcher's disconnection. Called by the postman.
+ * \author Thomas ROCHER
+ */
+extern void DISPATCHER_instance_disconnect(Dispatcher * dispatcher);
 /**
  * \fn extern int DISPATCHER_create(void)
  * \brief Creates the Dispatcher object in memory.
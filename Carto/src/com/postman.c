@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <string.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/select.h>
 #include <pthread.h>
@@ -58,7 +59,7 @@ typedef enum {STATE_GENERATION STATE_NB} State_Machine;
 #undef STATE_GENERATION
 #undef S
 
-#define ACTION_GENERATION A(A_NOP) A(A_DISCONNECT) A(A_CONNECTED) A(A_CONNECTION_POLLING) A(A_SEND) A(A_STOP)
+#define ACTION_GENERATION A(A_NOP) A(A_DISCONNECT) A(A_CONNECTED) A(A_CONNECTION_POLLING) A(A_SEND) A(A_DROP) A(A_STOP)
 #define A(x) x,
 typedef enum {ACTION_GENERATION ACTION_NB} Action;
 #undef ACTION_GENERATION
@@ -76,9 +77,14 @@ typedef enum {EVENT_GENERATION EVENT_NB} Event;
 #define MAX_PENDING_CONNECTIONS 1
 /**
  * \def MQ_POSTMAN_BOX_NAME
- * Name of the message queue
+ * Name of the message queue, suffixed by the server port.
  */
-#define MQ_POSTMAN_BOX_NAME ("/mb")
+#define MQ_POSTMAN_BOX_NAME "/mb"
+/**
+ * \def MQ_NAME_MAX_LENGTH
+ * Max length of the message queue name.
+ */
+#define MQ_NAME_MAX_LENGTH 32
 /**
  * \def MQ_MSG_COUNT
  * Max amount of message into the message queue.
@@ -121,24 +127,78 @@ typedef struct {
 	Action action; /**< Action to perform from previous the event. */
 } Transition;
 /**
- * \typedef int(*Action_Pt)(uint8_t * raw_data)
+ * \typedef int(*Action_Pt)(Postman * postman, uint8_t * raw_data)
  * \brief Definition of function pointer for the actions to perform.
  */
-typedef int(*Action_Pt)(uint8_t * raw_data);
+typedef int(*Action_Pt)(Postman * postman, uint8_t * raw_data);
 /* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/**
+ * \struct Postman_t postman.c "com/postman.c"
+ * \brief Context of a postman.
+ */
+struct Postman_t {
+    int listen_socket;                  /**< Listening socket identifier. */
+    int data_socket;                    /**< Data socket identifier. */
+    pthread_t postman_thread;           /**< Postman thread. */
+    mqd_t my_mail_box;                  /**< Message queue reference. */
+    uint16_t server_port;               /**< Listening port. */
+    char mq_name[MQ_NAME_MAX_LENGTH];   /**< Name of the message queue. */
+    struct sockaddr_in my_address;      /**< Address parameters of the server. */
+    bool_e is_in_waiting_connection;    /**< Tells if the postman thread is blocked waiting a connection. (used only for stop). */
+    Dispatcher * dispatcher;            /**< Dispatcher reading the data socket. */
+    uint8_t protocol_version;           /**< Protocol version of the current connection (PROTOCOL_VERSION_1 until HELLO). */
+    uint32_t capabilities;              /**< PROTOCOL_CAP_* kept for the current connection. */
+    uint16_t send_sequence;             /**< Sequence number of the last frame sent (PROTOCOL_CAP_SEQUENCE). */
+    uint16_t ack_sequence;              /**< Sequence number of the request being answered, sent as ack. */
+    pthread_mutex_t sequence_mutex;     /**< Keeps the sequence numbers in the order of the mail box. */
+};
 /* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
 /* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
 /* ----- PASSIVES ----- */
 /**
- * \fn static uint8_t* POSTMAN_read_msg(void)
+ * \fn static uint8_t* POSTMAN_read_msg(Postman * postman)
  * \brief Reads messages on the socket.
  * \author Joshua MONTREUIL
  *
- * \param raw_message : raw_message pointer.
+ * \param postman : postman context.
+ *
+ * \return uint8_t* : Raw message in a buffer from socket on success, with at least a whole head. NULL on failure, or for a frame too short to hold a type.
+ */
+static uint8_t* POSTMAN_read_msg(Postman * postman);
+/**
+ * \fn static int POSTMAN_read_all(Postman * postman, uint8_t * buffer, int size)
+ * \brief Reads exactly size bytes on the data socket.
+ * \author Thomas ROCHER
+ *
+ * \param postman : postman context.
+ * \param buffer : destination buffer.
+ * \param size : amount of bytes to read.
+ *
+ * \return size on success, 0 when the socket has been closed by Cute, -1 on error.
+ */
+static int POSTMAN_read_all(Postman * postman, uint8_t * buffer, int size);
+/**
+ * \fn static int POSTMAN_wait_data(Postman * postman)
+ * \brief Waits for data on the data socket, or for a new connection of Cute.
+ * \author Thomas ROCHER
+ *
+ * Cute reconnecting on a fresh socket means the current link is dead, even when TCP has not noticed it yet.
+ *
+ * \param postman : postman context.
+ *
+ * \return 1 when a connection is pending and no data is, 0 otherwise.
+ */
+static int POSTMAN_wait_data(Postman * postman);
+/**
+ * \fn static uint8_t* POSTMAN_connection_lost(Postman * postman)
+ * \brief Puts the dispatcher on hold and asks the postman thread to close the link and wait for the next connection.
+ * \author Thomas ROCHER
  *
- * \return uint8_t* : Raw message in a buffer from socket on success. NULL on failure.
+ * \param postman : postman context.
+ *
+ * \return Always NULL (no message read).
  */
-static uint8_t* POSTMAN_read_msg(void);
+static uint8_t* POSTMAN_connection_lost(Postman * postman);
 /* ----- ACTIVE ----- */
 /**
  * \fn static void * POSTMAN_run(void * arg)
@@ -146,113 +206,111 @@ static uint8_t* POSTMAN_read_msg(void);
  * message queue and sends it through socket.
  * \author Joshua MONTREUIL
  *
- * \param arg : argument pointer.
+ * \param arg : postman context.
  *
  * \return void * : On success, returns 0. On error, returns -1.
  */
 static void * POSTMAN_run(void * arg);
 /**
- * \fn static int POSTMAN_mq_receive(Mq_Msg * a_msg)
+ * \fn static int POSTMAN_mq_receive(Postman * postman, Mq_Msg * a_msg)
  * \brief Receives the messages from the queue.
  * \author Joshua MONTREUIL
  *
+ * \param postman : postman context.
  * \param a_msg : pointer to Mq_Msg struct.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_mq_receive(Mq_Msg * a_msg);
+static int POSTMAN_mq_receive(Postman * postman, Mq_Msg * a_msg);
 /**
- * \fn static int POSTMAN_mq_send(Mq_Msg * a_msg)
+ * \fn static int POSTMAN_mq_send(Postman * postman, Mq_Msg * a_msg)
  * \brief Sends a message into the queue.
  * \author Joshua MONTREUIL
  *
+ * \param postman : postman context.
  * \param a_msg : pointer to Mq_Msg struct.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_mq_send(Mq_Msg * a_msg);
+static int POSTMAN_mq_send(Postman * postman, Mq_Msg * a_msg);
 /* ----- ACTIONS ----- */
 /**
- * \fn static void POSTMAN_action_nop(uint8_t * raw_data)
+ * \fn static void POSTMAN_action_nop(Postman * postman, uint8_t * raw_data)
  * \brief Used to ignore state case that aren't into the state machine.
  * \author Joshua MONTREUIL
  *
+ * \param postman : postman context.
  * \param raw_data : raw data to send.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_action_nop(uint8_t * raw_data);
+static int POSTMAN_action_nop(Postman * postman, uint8_t * raw_data);
 /**
- * \fn static int POSTMAN_action_disconnection(uint8_t * raw_data)
+ * \fn static int POSTMAN_action_disconnection(Postman * postman, uint8_t * raw_data)
  * \brief Handles a disconnection.
  * \author Joshua MONTREUIL
  *
+ * \param postman : postman context.
  * \param raw_data : raw data to send.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_action_disconnection(uint8_t * raw_data);
+static int POSTMAN_action_disconnection(Postman * postman, uint8_t * raw_data);
 /**
- * \fn static void POSTMAN_action_connected(uint8_t * raw_data)
+ * \fn static void POSTMAN_action_connected(Postman * postman, uint8_t * raw_data)
  * \brief Passive function to log when Cute is connected.
  * \author Joshua MONTREUIL
  *
+ * \param postman : postman context.
  * \param raw_data : raw data to send.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_action_connected(uint8_t * raw_data);
+static int POSTMAN_action_connected(Postman * postman, uint8_t * raw_data);
 /**
- * \fn static int POSTMAN_action_polling_connection(uint8_t * raw_data))
+ * \fn static int POSTMAN_action_polling_connection(Postman * postman, uint8_t * raw_data))
  * \brief Waits a connection to the socket.
  * \author Joshua MONTREUIL
  *
- * \param a_msg : pointer to Mq_Msg struct.
+ * \param postman : postman context.
+ * \param raw_data : raw data to send.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_action_polling_connection(uint8_t * raw_data);
+static int POSTMAN_action_polling_connection(Postman * postman, uint8_t * raw_data);
 /**
- * \fn static int POSTMAN_action_send_msg(uint8_t * raw_data)
+ * \fn static int POSTMAN_action_send_msg(Postman * postman, uint8_t * raw_data)
  * \brief Sends a message through socket.
  * \author Joshua MONTREUIL
  *
+ * \param postman : postman context.
  * \param raw_data : raw data to send.
  *
  * \return On success, returns 0. On error, returns -1.
  */
-static int POSTMAN_action_send_msg(uint8_t * raw_data);
-/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
-/**
- * \var static int listen_socket
- * \brief Listening socket identifier.
- */
-static int listen_socket;
+static int POSTMAN_action_send_msg(Postman * postman, uint8_t * raw_data);
 /**
- * \var static int data_socket
- * \brief Listening socket identifier.
- */
-static int data_socket;
-/**
- * \var static pthread_t postman_thread
- * \brief Postman thread.
- */
-static pthread_t postman_thread;
-/**
- * \var static mqd_t my_mail_box
- * \brief Message queue reference.
+ * \fn static int POSTMAN_action_drop_msg(Postman * postman, uint8_t * raw_data)
+ * \brief Frees a message sent while Cute is not connected. The telemetry it carried is replayed on RESUME.
+ * \author Thomas ROCHER
+ *
+ * \param postman : postman context.
+ * \param raw_data : raw data to drop.
+ *
+ * \return Always returns 0.
  */
-static mqd_t my_mail_box;
+static int POSTMAN_action_drop_msg(Postman * postman, uint8_t * raw_data);
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
 /**
- * \var static struct sockaddr_in my_address
- * \brief Address parameters of the server.
+ * \var static Postman * default_postman
+ * \brief Postman used by the POSTMAN_* functions without context.
  */
-static struct sockaddr_in my_address;
+static Postman * default_postman = NULL;
 /**
- * \var tatic bool_e is_in_waiting_connection
- * \brief Tells if the postman thread is blocked waiting a connection. (used only for stop).
+ * \var static uint16_t default_port
+ * \brief Listening port of the default postman.
  */
-static bool_e is_in_waiting_connection = FALSE;
+static uint16_t default_port = SERVER_PORT;
 /**
  * \var static const Action_Pt actions_tab[ACTION_NB]
  * \brief Array of function pointer to call from action to perform.
@@ -263,6 +321,7 @@ static const Action_Pt actions_tab[ACTION_NB] = {
     &POSTMAN_action_connected,
     &POSTMAN_action_polling_connection,
     &POSTMAN_action_send_msg,
+    &POSTMAN_action_drop_msg,
     &POSTMAN_action_nop
 };
 /**
@@ -272,6 +331,7 @@ static const Action_Pt actions_tab[ACTION_NB] = {
 static Transition my_state_machine [STATE_NB -1][EVENT_NB] = {
     [S_WAITING_CONNECTION]  [E_POLL_CONNECTION] = {S_WAITING_CONNECTION,    A_CONNECTION_POLLING},
     [S_WAITING_CONNECTION]  [E_CONNECTION]      = {S_WRITE_MSG_ON_SOCKET,   A_CONNECTED},
+    [S_WAITING_CONNECTION]  [E_WRITE_REQUEST]   = {S_WAITING_CONNECTION,    A_DROP},
     [S_WAITING_CONNECTION]  [E_STOP]            = {S_DEATH,                 A_STOP},
     [S_WRITE_MSG_ON_SOCKET] [E_WRITE_REQUEST]   = {S_WRITE_MSG_ON_SOCKET,   A_SEND},
     [S_WRITE_MSG_ON_SOCKET] [E_DISCONNECTION]   = {S_WAITING_CONNECTION,    A_DISCONNECT},
@@ -279,81 +339,104 @@ static Transition my_state_machine [STATE_NB -1][EVENT_NB] = {
     [S_WRITE_MSG_ON_SOCKET] [E_STOP]            = {S_DEATH,                 A_STOP},
 };
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
-int POSTMAN_create(void) {
+Postman * POSTMAN_instance_create(uint16_t port) {
     struct mq_attr mqa = {
     .mq_maxmsg = MQ_MSG_COUNT,
     .mq_msgsize = sizeof(Mq_Msg)
     };
+    Postman * postman = (Postman *) calloc(1, sizeof(Postman));
+    if(postman == NULL) {
+        perror("calloc() failed");
+        return NULL;
+    }
+    postman->listen_socket = -1;
+    postman->data_socket = -1;
+    postman->server_port = port;
+    postman->protocol_version = PROTOCOL_VERSION_1;
     errno = 0;
+    snprintf(postman->mq_name, sizeof(postman->mq_name), MQ_POSTMAN_BOX_NAME "%u", port);
 
-    if((my_mail_box = mq_open(MQ_POSTMAN_BOX_NAME, O_CREAT | O_RDWR | O_EXCL , 0644 ,&mqa)) == -1) {
+    if((postman->my_mail_box = mq_open(postman->mq_name, O_CREAT | O_RDWR | O_EXCL , 0644 ,&mqa)) == -1) {
         if(errno == EEXIST) {
-            mq_unlink(MQ_POSTMAN_BOX_NAME);
-            if((my_mail_box = mq_open(MQ_POSTMAN_BOX_NAME, O_CREAT | O_RDWR , 0644 ,&mqa)) == -1) {
+            mq_unlink(postman->mq_name);
+            if((postman->my_mail_box = mq_open(postman->mq_name, O_CREAT | O_RDWR , 0644 ,&mqa)) == -1) {
                 perror("mq_open failed ");
-                return -1;
+                goto error_mq;
             }
         }
         else {
             perror("mq_open failed ");
-            return -1;
+            goto error_mq;
         }
     }
-    if((listen_socket =  socket(AF_INET, SOCK_STREAM, 0)) == -1) {
+    if((postman->listen_socket =  socket(AF_INET, SOCK_STREAM, 0)) == -1) {
         //CONTROLLER_LOGGER_log(ERROR, "On socket() : socket failed to be created for the listening socket.");
         goto error_socket;
     }
-    my_address.sin_family = AF_INET;
-    my_address.sin_port = htons(SERVER_PORT);
-    my_address.sin_addr.s_addr = htonl(INADDR_ANY);
-    return 0;
+    int reuse = 1;
+    setsockopt(postman->listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    postman->my_address.sin_family = AF_INET;
+    postman->my_address.sin_port = htons(port);
+    postman->my_address.sin_addr.s_addr = htonl(INADDR_ANY);
+    pthread_mutex_init(&postman->sequence_mutex, NULL);
+    return postman;
 
     error_socket :
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
-    return -1;
+        mq_close(postman->my_mail_box);
+        mq_unlink(postman->mq_name);
+    error_mq :
+        free(postman);
+    return NULL;
 }
 
-int POSTMAN_start(void) {
-    if(bind(listen_socket, (struct sockaddr *)&my_address, sizeof(my_address)) == -1) {
+void POSTMAN_instance_set_dispatcher(Postman * postman, Dispatcher * dispatcher) {
+    postman->dispatcher = dispatcher;
+}
+
+int POSTMAN_instance_start(Postman * postman) {
+    if(bind(postman->listen_socket, (struct sockaddr *)&postman->my_address, sizeof(postman->my_address)) == -1) {
         perror("bind() failed");
         return -1;
     }
-    if(listen(listen_socket, MAX_PENDING_CONNECTIONS) == -1) {
+    if(listen(postman->listen_socket, MAX_PENDING_CONNECTIONS) == -1) {
         perror("listen() failed");
         return -1;
     }
-    if(pthread_create(&postman_thread, NULL, POSTMAN_run, NULL) != 0 ) {
+    if(pthread_create(&postman->postman_thread, NULL, POSTMAN_run, postman) != 0 ) {
         perror("pthread_create failed");
         return -1;
     }
     return 0;
 }
 
-int POSTMAN_send_request(uint8_t * data) {
+int POSTMAN_instance_send_request(Postman * postman, uint8_t * data) {
     Mq_Msg my_msg = {.msg_data.event = E_WRITE_REQUEST, .msg_data.data = data};
-    if(POSTMAN_mq_send(&my_msg) == -1) {
-        return -1;
+    // Numbered and queued at once : the frames leave in the order of their sequence numbers.
+    pthread_mutex_lock(&postman->sequence_mutex);
+    if(postman->capabilities & PROTOCOL_CAP_SEQUENCE) {
+        PROTOCOL_add_sequence(data, ++postman->send_sequence, postman->ack_sequence);
     }
-    return 0;
+    int result = POSTMAN_mq_send(postman, &my_msg);
+    pthread_mutex_unlock(&postman->sequence_mutex);
+    return (result == -1) ? -1 : 0;
 }
 
-uint8_t* POSTMAN_read_request(void) {
-    return POSTMAN_read_msg();
+uint8_t* POSTMAN_instance_read_request(Postman * postman) {
+    return POSTMAN_read_msg(postman);
 }
 
-int POSTMAN_disconnect(void) {
+int POSTMAN_instance_disconnect(Postman * postman) {
     Mq_Msg my_msg = {.msg_data.event = E_DISCONNECTION,0};
-    if(POSTMAN_mq_send(&my_msg) == -1) {
+    if(POSTMAN_mq_send(postman, &my_msg) == -1) {
         return -1;
     }
     return 0;
 }
 
-int POSTMAN_stop(void) {
+int POSTMAN_instance_stop(Postman * postman) {
     Mq_Msg my_msg = {.msg_data.event = E_STOP,0};
-    if(POSTMAN_mq_send(&my_msg) == 0 ) {
-        if(pthread_join(postman_thread, NULL) != 0) {
+    if(POSTMAN_mq_send(postman, &my_msg) == 0 ) {
+        if(pthread_join(postman->postman_thread, NULL) != 0) {
             perror("pthread_join failed");
             return -1;
         }
@@ -361,123 +444,230 @@ int POSTMAN_stop(void) {
     else {
         return -1;
     }
-    if(!listen_socket) {
-        if(close(listen_socket) == -1) {
+    if(postman->listen_socket != -1) {
+        if(close(postman->listen_socket) == -1) {
             perror("close() failed");
             return -1;
         }
+        postman->listen_socket = -1;
     }
-    if(!data_socket) {
-        if(close(data_socket) == -1) {
+    if(postman->data_socket != -1) {
+        if(close(postman->data_socket) == -1) {
             perror("close() failed");
             return -1;
         }
+        postman->data_socket = -1;
     }
-    if(mq_close(my_mail_box) == -1) {
+    if(mq_close(postman->my_mail_box) == -1) {
         perror("mq_close() failed");
         return -1;
     }
     return 0;
 }
 
-int POSTMAN_destroy(void) {
-    if(mq_unlink(MQ_POSTMAN_BOX_NAME) == -1) {
+int POSTMAN_instance_destroy(Postman * postman) {
+    int result = 0;
+    if(mq_unlink(postman->mq_name) == -1) {
         perror("mq_unlink() failed");
-        return -1;
+        result = -1;
     }
-    return 0;
+    pthread_mutex_destroy(&postman->sequence_mutex);
+    free(postman);
+    return result;
+}
+
+void POSTMAN_instance_set_protocol(Postman * postman, uint8_t version, uint32_t capabilities) {
+    pthread_mutex_lock(&postman->sequence_mutex);
+    postman->protocol_version = version;
+    postman->capabilities = capabilities;
+    postman->send_sequence = 0;
+    postman->ack_sequence = 0;
+    pthread_mutex_unlock(&postman->sequence_mutex);
+}
+
+void POSTMAN_instance_set_ack(Postman * postman, uint16_t seq) {
+    pthread_mutex_lock(&postman->sequence_mutex);
+    postman->ack_sequence = seq;
+    pthread_mutex_unlock(&postman->sequence_mutex);
+}
+
+uint8_t POSTMAN_instance_get_protocol_version(Postman * postman) {
+    return postman->protocol_version;
+}
+
+uint32_t POSTMAN_instance_get_capabilities(Postman * postman) {
+    return postman->capabilities;
+}
+
+void POSTMAN_set_port(uint16_t port) {
+    default_port = port;
+}
+
+Postman * POSTMAN_get_default(void) {
+    return default_postman;
+}
+
+int POSTMAN_create(void) {
+    default_postman = POSTMAN_instance_create(default_port);
+    return (default_postman == NULL) ? -1 : 0;
+}
+
+int POSTMAN_start(void) {
+    return POSTMAN_instance_start(default_postman);
+}
+
+int POSTMAN_send_request(uint8_t * data) {
+    return POSTMAN_instance_send_request(default_postman, data);
+}
+
+uint8_t* POSTMAN_read_request(void) {
+    return POSTMAN_instance_read_request(default_postman);
+}
+
+int POSTMAN_disconnect(void) {
+    return POSTMAN_instance_disconnect(default_postman);
+}
+
+int POSTMAN_stop(void) {
+    return POSTMAN_instance_stop(default_postman);
+}
+
+int POSTMAN_destroy(void) {
+    int result = POSTMAN_instance_destroy(default_postman);
+    default_postman = NULL;
+    return result;
 }
 /* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
-static int POSTMAN_action_send_msg(uint8_t * raw_data) {
-    int amount_sent;
-    int message_size = raw_data[0] << 8 | raw_data[1];
-    if((amount_sent = write(data_socket, raw_data, (message_size+2))) == -1 && errno != EPIPE) {
-        perror("write() failed");
-        return -1;
-    }
-    else if(errno == EPIPE) {
-        Mq_Msg my_msg = {.msg_data.event = E_DISCONNECTION,0};
-        if(POSTMAN_mq_send(&my_msg) == -1) {
-            perror("POSTMAN_mq_send failed");
-            return -1;
-        }
-    }
-    else if(amount_sent < message_size + 2) {
-        if(write(data_socket, raw_data, sizeof(raw_data)) == -1) {
-            perror("write() failed");
-            return -1;
+static int POSTMAN_action_send_msg(Postman * postman, uint8_t * raw_data) {
+    int frame_size = PROTOCOL_SIZE_FIELD + PROTOCOL_get_u16(raw_data);
+    int total = 0;
+    while(total < frame_size) {
+        // MSG_NOSIGNAL : a link cut by Cute gives EPIPE instead of killing Carto with SIGPIPE.
+        int amount_sent = send(postman->data_socket, raw_data + total, frame_size - total, MSG_NOSIGNAL);
+        if(amount_sent == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            // Link lost : the reader is woken up and reports the disconnection, the frame is replayed on RESUME.
+            perror("send() failed");
+            shutdown(postman->data_socket, SHUT_RDWR);
+            break;
         }
-    }
-    if(amount_sent == sizeof(raw_data)) {
+        total += amount_sent;
     }
     free(raw_data);
     return 0;
 }
 
-static uint8_t* POSTMAN_read_msg(void) {
+static int POSTMAN_action_drop_msg(Postman * postman, uint8_t * raw_data) {
+    free(raw_data);
+    return 0;
+}
+
+static uint8_t* POSTMAN_read_msg(Postman * postman) {
     uint8_t size_check[2];
+    if(POSTMAN_wait_data(postman) == 1) {
+        printf("Reconnexion\n");
+        return POSTMAN_connection_lost(postman);
+    }
     errno = 0;
-    int read_size = read(data_socket, size_check, 2);
-    if(read_size == -1 ){
-        if(errno == EBADF) {
-            printf("The data socket for reading has been closed, a disconnection has been asked or detected.");
-            uint8_t * error_buffer = NULL;
-            error_buffer = (uint8_t*)malloc(1);
-            *error_buffer = (uint8_t) errno;
-            return error_buffer;
-        }
-        else {
-            perror("read() failed");
-            return NULL;
-        }
+    int read_size = POSTMAN_read_all(postman, size_check, 2);
+    if(read_size == -1 && errno == EBADF) {
+        printf("The data socket for reading has been closed, a disconnection has been asked or detected.");
+        uint8_t * error_buffer = NULL;
+        error_buffer = (uint8_t*)malloc(1);
+        *error_buffer = (uint8_t) errno;
+        return error_buffer;
     }
-    else if(read_size == 0)
+    else if(read_size <= 0)
     {
+        // Closed by Cute, or lost (ECONNRESET, ETIMEDOUT...) : reading again would only fail again.
+        if(read_size == -1) {
+            perror("read() failed");
+        }
         printf("Déconnexion\n");
-        DISPATCHER_disconnect();
-        POSTMAN_disconnect();
-        return NULL;
+        return POSTMAN_connection_lost(postman);
     }
     else {
-        int data_size = size_check[0] << 8 | size_check[1];
-        uint8_t data_buff[data_size];
-        if (read(data_socket, data_buff, data_size) == -1) {
+        int data_size = PROTOCOL_get_u16(size_check);
+        uint8_t * raw_message = (uint8_t *) malloc(data_size + 2);
+        memcpy(raw_message, size_check, 2);
+        if(data_size > 0 && POSTMAN_read_all(postman, raw_message + 2, data_size) <= 0) {
+            // Cut in the middle of a frame : the stream can't be framed any more.
             perror("read() failed");
-            return NULL;
+            free(raw_message);
+            return POSTMAN_connection_lost(postman);
         }
-        uint8_t * raw_message = NULL;
-        if(data_size >= 2) {
-            data_size +=2;
-            raw_message = (uint8_t *) malloc(data_size);
-            memcpy(raw_message, size_check, 2);
-            memcpy(raw_message + 2, data_buff, data_size);
+        if(data_size < PROTOCOL_HEAD_SIZE - PROTOCOL_SIZE_FIELD) {
+            // No type to read : the frame is dropped, the next one starts right after it.
+            free(raw_message);
+            return NULL;
         }
-        else {
-            raw_message = (uint8_t *) malloc(data_size);
-            memcpy(raw_message, size_check, 2);
+        return raw_message;
+    }
+}
+
+static int POSTMAN_wait_data(Postman * postman) {
+    int result;
+    do {
+        fd_set l_read_fds;
+        FD_ZERO(&l_read_fds);
+        FD_SET(postman->data_socket, &l_read_fds);
+        FD_SET(postman->listen_socket, &l_read_fds);
+        int max_socket = (postman->data_socket > postman->listen_socket) ? postman->data_socket : postman->listen_socket;
+        result = select(max_socket + 1, &l_read_fds, NULL, NULL, NULL);
+        if(result > 0) {
+            // The frames already received are read before giving the link up.
+            return (!FD_ISSET(postman->data_socket, &l_read_fds) && FD_ISSET(postman->listen_socket, &l_read_fds)) ? 1 : 0;
         }
+    } while(result == -1 && errno == EINTR);
+    // Data socket closed (EBADF) : the read reports it.
+    return 0;
+}
 
-        return raw_message;
+static uint8_t* POSTMAN_connection_lost(Postman * postman) {
+    // The dispatcher waits before the postman accepts the next connection and wakes it up.
+    DISPATCHER_instance_disconnect(postman->dispatcher);
+    POSTMAN_instance_disconnect(postman);
+    return NULL;
+}
+
+static int POSTMAN_read_all(Postman * postman, uint8_t * buffer, int size) {
+    int total = 0;
+    while(total < size) {
+        int amount_read = read(postman->data_socket, buffer + total, size - total);
+        if(amount_read == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if(amount_read == 0) {
+            return 0;
+        }
+        total += amount_read;
     }
+    return total;
 }
 
 static void * POSTMAN_run(void * arg) {
+    Postman * postman = (Postman *) arg;
     Mq_Msg msg;
     State_Machine my_state = S_WAITING_CONNECTION;
-    if(actions_tab[A_CONNECTION_POLLING](NULL) == -1) {
+    if(actions_tab[A_CONNECTION_POLLING](postman, NULL) == -1) {
         perror("action_tab failed");
         return NULL;
     }
     Transition * my_transition;
     while(my_state != S_DEATH) {
-        if (POSTMAN_mq_receive(&msg) == -1) {
+        if (POSTMAN_mq_receive(postman, &msg) == -1) {
             perror("POSTMAN_mq_receive failed");
             return NULL;
         }
         my_transition = &my_state_machine[my_state][msg.msg_data.event];
         uint8_t * raw_data = msg.msg_data.data;
         if(my_transition->state_destination != S_FORGET) {
-            if(actions_tab[my_transition->action](raw_data) == -1) {
+            if(actions_tab[my_transition->action](postman, raw_data) == -1) {
                 perror("action_tab failed");
                 return NULL;
             }
@@ -487,8 +677,8 @@ static void * POSTMAN_run(void * arg) {
     return 0;
 }
 
-static int POSTMAN_action_polling_connection(uint8_t * raw_data) {
-   socklen_t addr_len = sizeof(my_address);
+static int POSTMAN_action_polling_connection(Postman * postman, uint8_t * raw_data) {
+   socklen_t addr_len = sizeof(postman->my_address);
 
     struct timeval timeout;
     timeout.tv_sec = 1;
@@ -496,73 +686,81 @@ static int POSTMAN_action_polling_connection(uint8_t * raw_data) {
 
     fd_set l_read_fds;
     FD_ZERO(&l_read_fds);
-    FD_SET(listen_socket, &l_read_fds);
+    FD_SET(postman->listen_socket, &l_read_fds);
 
-    int select_state = select(listen_socket + 1, &l_read_fds, NULL, NULL, &timeout);
+    int select_state = select(postman->listen_socket + 1, &l_read_fds, NULL, NULL, &timeout);
     if (select_state == -1) {
         perror("select() failed");
         return -1;
     } 
     else if (select_state) {
         // A connection is pending
-        data_socket = accept(listen_socket, (struct sockaddr *)&my_address, &addr_len);
-        if(data_socket == -1) {
+        postman->data_socket = accept(postman->listen_socket, (struct sockaddr *)&postman->my_address, &addr_len);
+        if(postman->data_socket == -1) {
             perror("accept() failed");
             return -1;
         }
+        // Frames are small and sent in bursts (position, then MOVE_DONE) : no Nagle delay.
+        int no_delay = 1;
+        if(setsockopt(postman->data_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) == -1) {
+            perror("setsockopt() failed");
+        }
 
+        // Every connection starts in v1, until the client sends a HELLO.
+        POSTMAN_instance_set_protocol(postman, PROTOCOL_VERSION_1, 0);
         Mq_Msg msg = {.msg_data.event = E_CONNECTION, NULL};
-        if (POSTMAN_mq_send(&msg) == -1) {
+        if (POSTMAN_mq_send(postman, &msg) == -1) {
             return -1;
         }
-        DISPATCHER_start_reading();
-        is_in_waiting_connection = FALSE;
+        DISPATCHER_instance_start_reading(postman->dispatcher);
+        postman->is_in_waiting_connection = FALSE;
         printf("CONNEXION\n");
     }
     else {
         // No connection could be found
         Mq_Msg msg = {.msg_data.event = E_POLL_CONNECTION, NULL};
-        if (POSTMAN_mq_send(&msg) == -1) {
+        if (POSTMAN_mq_send(postman, &msg) == -1) {
             return -1;
         }
     }
     return 0;
 }
 
-static int POSTMAN_mq_receive(Mq_Msg * a_msg) {
-    if((mq_receive(my_mail_box,a_msg->buffer,sizeof(Mq_Msg), NULL) == -1)) {
+static int POSTMAN_mq_receive(Postman * postman, Mq_Msg * a_msg) {
+    if((mq_receive(postman->my_mail_box,a_msg->buffer,sizeof(Mq_Msg), NULL) == -1)) {
         perror("mq_receive failed");
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
+        mq_close(postman->my_mail_box);
+        mq_unlink(postman->mq_name);
         return -1;
     }
     return 0;
 }
 
-static int POSTMAN_mq_send(Mq_Msg * a_msg) {
-    if(mq_send(my_mail_box,a_msg->buffer, sizeof(Mq_Msg),0) == -1 ) {
+static int POSTMAN_mq_send(Postman * postman, Mq_Msg * a_msg) {
+    if(mq_send(postman->my_mail_box,a_msg->buffer, sizeof(Mq_Msg),0) == -1 ) {
         perror("mq_send failed");
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
+        mq_close(postman->my_mail_box);
+        mq_unlink(postman->mq_name);
         return -1;
     }
     return 0;
 }
 
-static int POSTMAN_action_nop(uint8_t * raw_data) { return 0; }
+static int POSTMAN_action_nop(Postman * postman, uint8_t * raw_data) { return 0; }
 
-static int POSTMAN_action_connected(uint8_t * raw_data) {
+static int POSTMAN_action_connected(Postman * postman, uint8_t * raw_data) {
     return 0;
 }
 
-static int POSTMAN_action_disconnection(uint8_t * raw_data) {
-    if(close(data_socket) == -1) {
+static int POSTMAN_action_disconnection(Postman * postman, uint8_t * raw_data) {
+    if(close(postman->data_socket) == -1) {
         return -1;
     }
+    postman->data_socket = -1;
     Mq_Msg my_msg = {.msg_data.event = E_POLL_CONNECTION, NULL};
-    if(POSTMAN_mq_send(&my_msg) == -1) {
+    if(POSTMAN_mq_send(postman, &my_msg) == -1) {
         return -1;
     }
-    is_in_waiting_connection = TRUE;
+    postman->is_in_waiting_connection = TRUE;
     return 0;
-}
\ No newline at end of file
+}
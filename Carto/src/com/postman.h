@@ -39,10 +39,129 @@
 /* ----------------------  INCLUDES ------------------------------------------*/
 #include <stdint.h>
 /* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \struct Postman postman.h "com/postman.h"
+ * \brief Context of a postman : listening and data sockets, mailbox and thread of one robot.
+ *
+ * Each robot of a process owns its postman. The POSTMAN_* functions without context use a default postman.
+ */
+typedef struct Postman_t Postman;
+/**
+ * \struct Dispatcher_t
+ * \brief Forward declaration of the dispatcher context (see dispatcher.h).
+ */
+struct Dispatcher_t;
 /* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
 /* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
 /* ----------------------  PUBLIC VARIABLES -----------------------------------*/
 /* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern Postman * POSTMAN_instance_create(uint16_t port)
+ * \brief Creates a postman listening on port.
+ * \author Thomas ROCHER
+ *
+ * \param port : listening port, also used to name the mailbox.
+ *
+ * \return The postman on success, NULL on error.
+ */
+extern Postman * POSTMAN_instance_create(uint16_t port);
+/**
+ * \fn extern void POSTMAN_instance_set_dispatcher(Postman * postman, struct Dispatcher_t * dispatcher)
+ * \brief Gives the dispatcher to wake up on connection and disconnection. Called by DISPATCHER_instance_create().
+ * \author Thomas ROCHER
+ */
+extern void POSTMAN_instance_set_dispatcher(Postman * postman, struct Dispatcher_t * dispatcher);
+/**
+ * \fn extern int POSTMAN_instance_start(Postman * postman)
+ * \brief Starts a postman.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int POSTMAN_instance_start(Postman * postman);
+/**
+ * \fn extern int POSTMAN_instance_stop(Postman * postman)
+ * \brief Stops a postman and closes its sockets.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int POSTMAN_instance_stop(Postman * postman);
+/**
+ * \fn extern int POSTMAN_instance_destroy(Postman * postman)
+ * \brief Destroys a postman (mailbox and memory).
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int POSTMAN_instance_destroy(Postman * postman);
+/**
+ * \fn extern int POSTMAN_instance_send_request(Postman * postman, uint8_t * data)
+ * \brief Sends a message through the TCP link of a postman. data is freed once sent.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int POSTMAN_instance_send_request(Postman * postman, uint8_t * data);
+/**
+ * \fn extern uint8_t * POSTMAN_instance_read_request(Postman * postman)
+ * \brief Reads a message on the TCP link of a postman.
+ * \author Thomas ROCHER
+ *
+ * \return uint8_t* : Raw message in a buffer from socket on success. NULL on failure.
+ */
+extern uint8_t * POSTMAN_instance_read_request(Postman * postman);
+/**
+ * \fn extern int POSTMAN_instance_disconnect(Postman * postman)
+ * \brief Disconnects the TCP link of a postman.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int POSTMAN_instance_disconnect(Postman * postman);
+/**
+ * \fn extern void POSTMAN_instance_set_protocol(Postman * postman, uint8_t version, uint32_t capabilities)
+ * \brief Records the protocol negotiated by HELLO for the current connection. Reset to v1 on each new connection.
+ * \author Thomas ROCHER
+ *
+ * \param version : PROTOCOL_VERSION_1 or PROTOCOL_VERSION_2.
+ * \param capabilities : PROTOCOL_CAP_* bitmask.
+ */
+extern void POSTMAN_instance_set_protocol(Postman * postman, uint8_t version, uint32_t capabilities);
+/**
+ * \fn extern uint8_t POSTMAN_instance_get_protocol_version(Postman * postman)
+ * \brief Gives the protocol version of the current connection.
+ * \author Thomas ROCHER
+ */
+extern uint8_t POSTMAN_instance_get_protocol_version(Postman * postman);
+/**
+ * \fn extern uint32_t POSTMAN_instance_get_capabilities(Postman * postman)
+ * \brief Gives the PROTOCOL_CAP_* kept for the current connection.
+ * \author Thomas ROCHER
+ */
+extern uint32_t POSTMAN_instance_get_capabilities(Postman * postman);
+/**
+ * \fn extern void POSTMAN_instance_set_ack(Postman * postman, uint16_t seq)
+ * \brief Records the request being answered : the next frames carry seq as ack (PROTOCOL_CAP_SEQUENCE only).
+ * \author Thomas ROCHER
+ *
+ * \param seq : sequence number of the request, read in its head.
+ */
+extern void POSTMAN_instance_set_ack(Postman * postman, uint16_t seq);
+/**
+ * \fn extern Postman * POSTMAN_get_default(void)
+ * \brief Gives the default postman, created by POSTMAN_create().
+ * \author Thomas ROCHER
+ */
+extern Postman * POSTMAN_get_default(void);
+/**
+ * \fn extern void POSTMAN_set_port(uint16_t port)
+ * \brief Changes the listening port of the default postman (12345 by default). To call before POSTMAN_create().
+ * \author Thomas ROCHER
+ *
+ * \param port : listening port.
+ */
+extern void POSTMAN_set_port(uint16_t port);
 /**
  * \fn extern int POSTMAN_create(void)
  * \brief Creates the Postman object in memory.
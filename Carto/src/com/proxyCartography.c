@@ -38,8 +38,6 @@
 #include "postman.h"
 #include "../lib/defs.h"
 #include <stdlib.h>
-#include <arpa/inet.h>
-#include <string.h>
 
 
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
@@ -50,22 +48,37 @@
 /* ----------------------  PRIVATE VARIABLES  ------------------------------- */
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
 
+extern void PROXYCARTOGRAPHY_instance_robot_position_received(Postman * postman) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_FRAME_SIZE);
+    PROTOCOL_encode_signal(data, ROBOT_POSITION_RECEIVED);
+    POSTMAN_instance_send_request(postman, data);
+}
+
+extern void PROXYCARTOGRAPHY_instance_move_done(Postman * postman) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_FRAME_SIZE);
+    PROTOCOL_encode_signal(data, MOVE_DONE);
+    POSTMAN_instance_send_request(postman, data);
+}
+
+extern void PROXYCARTOGRAPHY_instance_hello_ack(Postman * postman, uint8_t version, uint32_t capabilities) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_FRAME_SIZE);
+    PROTOCOL_encode_hello(data, HELLO_ACK, version, capabilities);
+    POSTMAN_instance_send_request(postman, data);
+}
+
+extern void PROXYCARTOGRAPHY_instance_session(Postman * postman, uint32_t token, bool_e resumed, uint32_t moves_done) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_FRAME_SIZE);
+    Protocol_Msg_Session session = {token, (uint8_t)((resumed == TRUE) ? 1 : 0), moves_done};
+    PROTOCOL_write_session(data, &session);
+    POSTMAN_instance_send_request(postman, data);
+}
+
 extern void PROXYCARTOGRAPHY_robot_position_received() {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = htons(ROBOT_POSITION_RECEIVED);
-    msg_to_send.msg_size = htons((0x0002));
-    uint8_t * data = (uint8_t*) malloc(2 + msg_to_send.msg_size);
-    memcpy(data,&msg_to_send,4);
-    POSTMAN_send_request(data);
+    PROXYCARTOGRAPHY_instance_robot_position_received(POSTMAN_get_default());
 }
 
 extern void PROXYCARTOGRAPHY_move_done() {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = htons(MOVE_DONE);
-    msg_to_send.msg_size = htons((0x0002));
-    uint8_t * data = (uint8_t*) malloc(2 + msg_to_send.msg_size);
-    memcpy(data,&msg_to_send,4);
-    POSTMAN_send_request(data);
+    PROXYCARTOGRAPHY_instance_move_done(POSTMAN_get_default());
 }
 
 /* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
\ No newline at end of file
@@ -37,6 +37,8 @@
 #ifndef SRC_COM_PROXYCARTOGRAPHY_H_
 #define SRC_COM_PROXYCARTOGRAPHY_H_
 /* ----------------------  INCLUDES ------------------------------------------*/
+#include "postman.h"
+#include "../lib/defs.h"
 /* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
 /* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
 /* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
@@ -54,5 +56,29 @@ extern void PROXYCARTOGRAPHY_robot_position_received();
  * \author Thomas Rocher
  */
 extern void PROXYCARTOGRAPHY_move_done();
+/**
+ * \fn extern void PROXYCARTOGRAPHY_instance_robot_position_received(Postman * postman)
+ * \brief Same as PROXYCARTOGRAPHY_robot_position_received(), through a given postman.
+ * \author Thomas Rocher
+ */
+extern void PROXYCARTOGRAPHY_instance_robot_position_received(Postman * postman);
+/**
+ * \fn extern void PROXYCARTOGRAPHY_instance_move_done(Postman * postman)
+ * \brief Same as PROXYCARTOGRAPHY_move_done(), through a given postman.
+ * \author Thomas Rocher
+ */
+extern void PROXYCARTOGRAPHY_instance_move_done(Postman * postman);
+/**
+ * \fn extern void PROXYCARTOGRAPHY_instance_hello_ack(Postman * postman, uint8_t version, uint32_t capabilities)
+ * \brief Answers a HELLO with the version and capabilities kept for the session.
+ * \author Thomas Rocher
+ */
+extern void PROXYCARTOGRAPHY_instance_hello_ack(Postman * postman, uint8_t version, uint32_t capabilities);
+/**
+ * \fn extern void PROXYCARTOGRAPHY_instance_session(Postman * postman, uint32_t token, bool_e resumed, uint32_t moves_done)
+ * \brief Answers a RESUME with the token of the session, before the replayed telemetry.
+ * \author Thomas Rocher
+ */
+extern void PROXYCARTOGRAPHY_instance_session(Postman * postman, uint32_t token, bool_e resumed, uint32_t moves_done);
 
 #endif /* SRC_COM_PROXYCARTOGRAPHY_H_ */
@@ -38,8 +38,6 @@
 #include "postman.h"
 #include "../lib/defs.h"
 #include <stdlib.h>
-#include <arpa/inet.h>
-#include <string.h>
 
 
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
@@ -51,24 +49,34 @@
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
 /* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
 
+void PROXYMAP_instance_set_obstacle_position(Postman * postman, int coord_x, int coord_y) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_FRAME_SIZE);
+    PROTOCOL_encode_obstacle_position(data, POSTMAN_instance_get_protocol_version(postman), coord_x, coord_y);
+    POSTMAN_instance_send_request(postman, data);
+}
+
+void PROXYMAP_instance_set_robot_position(Postman * postman, int coord_x, int coord_y, Direction dir) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_FRAME_SIZE);
+    PROTOCOL_encode_set_robot_position(data, POSTMAN_instance_get_protocol_version(postman), coord_x, coord_y, dir);
+    POSTMAN_instance_send_request(postman, data);
+}
+
+void PROXYMAP_instance_map_delta(Postman * postman, uint32_t map_version, const Protocol_Cell * cells, int count) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_DELTA_FRAME_SIZE);
+    PROTOCOL_encode_map_delta(data, map_version, cells, count);
+    POSTMAN_instance_send_request(postman, data);
+}
+
+void PROXYMAP_instance_map_snapshot_chunk(Postman * postman, Protocol_Snapshot_Head * head, const uint8_t * cells) {
+    uint8_t * data = (uint8_t*) malloc(PROTOCOL_MAX_SNAPSHOT_FRAME_SIZE);
+    PROTOCOL_encode_snapshot_chunk(data, head, cells);
+    POSTMAN_instance_send_request(postman, data);
+}
+
 void PROXYMAP_set_obstacle_position(int coord_x, int coord_y) {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = htons(SET_OBSTACLE_POSITION);
-    msg_to_send.msg_size = htons((0x0004));
-    uint8_t buf[2] = {coord_x & 0xFF, coord_y & 0xFF};
-    uint8_t * data = (uint8_t*) malloc(2 + msg_to_send.msg_size);
-    memcpy(data,&msg_to_send,4);
-    memcpy(data+4,buf, sizeof(buf));
-    POSTMAN_send_request(data);
+    PROXYMAP_instance_set_obstacle_position(POSTMAN_get_default(), coord_x, coord_y);
 }
 
-void PROXYMAP_set_robot_position(int coord_x, int coord_y) {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = htons(SET_ROBOT_POSITION);
-    msg_to_send.msg_size = htons((0x0004));
-    uint8_t buf[2] = {coord_x & 0xFF, coord_y & 0xFF};
-    uint8_t * data = (uint8_t*) malloc(2 + msg_to_send.msg_size);
-    memcpy(data,&msg_to_send,4);
-    memcpy(data+4,buf, sizeof(buf));
-    POSTMAN_send_request(data);
-}
\ No newline at end of file
+void PROXYMAP_set_robot_position(int coord_x, int coord_y, Direction dir) {
+    PROXYMAP_instance_set_robot_position(POSTMAN_get_default(), coord_x, coord_y, dir);
+}
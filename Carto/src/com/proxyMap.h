@@ -37,6 +37,8 @@
 #ifndef SRC_COM_PROXYMAP_H_
 #define SRC_COM_PROXYMAP_H_
 /* ----------------------  INCLUDES ------------------------------------------*/
+#include "postman.h"
+#include "../lib/defs.h"
 /* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
 /* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
 /* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
@@ -52,13 +54,45 @@
  */
 extern void PROXYMAP_set_obstacle_position(int coord_x, int coord_y);
 /**
- * \fn extern void PROXYMAP_set_robot_position(int coord_x, int coord_y)
+ * \fn extern void PROXYMAP_set_robot_position(int coord_x, int coord_y, Direction dir)
  * \brief Send the robot's position.
  * \author Thomas Rocher
  *
  * \param coord_x : x obstacle's coordinate.
  * \param coord_y : y obstacle's coordinate.
+ * \param dir : heading of the robot, only sent in protocol v2.
  */
-extern void PROXYMAP_set_robot_position(int coord_x, int coord_y);
+extern void PROXYMAP_set_robot_position(int coord_x, int coord_y, Direction dir);
+/**
+ * \fn extern void PROXYMAP_instance_set_obstacle_position(Postman * postman, int coord_x, int coord_y)
+ * \brief Same as PROXYMAP_set_obstacle_position(), through a given postman.
+ * \author Thomas Rocher
+ */
+extern void PROXYMAP_instance_set_obstacle_position(Postman * postman, int coord_x, int coord_y);
+/**
+ * \fn extern void PROXYMAP_instance_set_robot_position(Postman * postman, int coord_x, int coord_y, Direction dir)
+ * \brief Same as PROXYMAP_set_robot_position(), through a given postman.
+ * \author Thomas Rocher
+ */
+extern void PROXYMAP_instance_set_robot_position(Postman * postman, int coord_x, int coord_y, Direction dir);
+/**
+ * \fn extern void PROXYMAP_instance_map_delta(Postman * postman, uint32_t map_version, const Protocol_Cell * cells, int count)
+ * \brief Sends a batch of cell changes (MAP_DELTA, protocol v2 with PROTOCOL_CAP_MAP_DELTA only).
+ * \author Thomas Rocher
+ *
+ * \param map_version : version of the map once the cells are applied.
+ * \param cells : changed cells.
+ * \param count : amount of cells, at most PROTOCOL_MAX_DELTA_CELLS.
+ */
+extern void PROXYMAP_instance_map_delta(Postman * postman, uint32_t map_version, const Protocol_Cell * cells, int count);
+/**
+ * \fn extern void PROXYMAP_instance_map_snapshot_chunk(Postman * postman, Protocol_Snapshot_Head * head, const uint8_t * cells)
+ * \brief Sends one chunk of the whole map (MAP_SNAPSHOT, protocol v2 with PROTOCOL_CAP_MAP_SNAPSHOT only).
+ * \author Thomas Rocher
+ *
+ * \param head : head of the chunk, cell_count is set to the amount of cells sent.
+ * \param cells : the head->rows x head->cols cells of the map, row-major.
+ */
+extern void PROXYMAP_instance_map_snapshot_chunk(Postman * postman, Protocol_Snapshot_Head * head, const uint8_t * cells);
 
 #endif /* SRC_COM_PROXYMAP_H_ */
@@ -0,0 +1,337 @@
+/**
+ * \file  mapper.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Source file of the mapper. Cells discovered by a robot, published to Cute in batches.
+ *
+ * \see mapper.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "mapper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../com/proxyMap.h"
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def MAPPER_FLUSH_PERIOD_MS
+ * Max time a changed cell waits before being sent (real time, whatever the clock mode).
+ */
+#define MAPPER_FLUSH_PERIOD_MS 50
+/**
+ * \def MAPPER_GRID_MARGIN
+ * Cells added on each side when the map grows, so that it does not grow at each step of the robot.
+ */
+#define MAPPER_GRID_MARGIN 16
+/**
+ * \def MAPPER_MAX_GRID_SIDE
+ * Max amount of rows or columns of the map (size fields of the MAP_SNAPSHOT head).
+ */
+#define MAPPER_MAX_GRID_SIDE UINT16_MAX
+/**
+ * \def MAPPER_JOURNAL_LENGTH
+ * Amount of MAP_DELTA kept to be replayed on RESUME (at least 3 s of exploration, flushed every MAPPER_FLUSH_PERIOD_MS).
+ */
+#define MAPPER_JOURNAL_LENGTH 64
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/**
+ * \struct Mapper_Delta mapper.c "controller/mapper.c"
+ * \brief One MAP_DELTA of the journal.
+ */
+typedef struct {
+    uint32_t map_version;                               /**< Version of the map after this delta. */
+    int count;                                          /**< Amount of cells. */
+    Protocol_Cell cells[PROTOCOL_MAX_DELTA_CELLS];      /**< Cells changed. */
+} Mapper_Delta;
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/**
+ * \struct Mapper_t mapper.c "controller/mapper.c"
+ * \brief Context of a mapper.
+ */
+struct Mapper_t {
+    Postman * postman;                                  /**< Postman used to send the map changes. */
+    uint32_t map_version;                               /**< Version of the map, incremented at each MAP_DELTA. */
+    Protocol_Cell pending[PROTOCOL_MAX_DELTA_CELLS];    /**< Cells changed since the last MAP_DELTA. */
+    int pending_count;                                  /**< Amount of pending cells. */
+    Mapper_Delta journal[MAPPER_JOURNAL_LENGTH];        /**< Last deltas, indexed by map_version % MAPPER_JOURNAL_LENGTH. */
+    struct timespec oldest_pending;                     /**< Time of the first pending change (CLOCK_MONOTONIC). */
+    uint8_t * grid;                                     /**< Whole map, row-major Protocol_Cell_Value, NULL until the first cell. */
+    int32_t grid_x;                                     /**< Row of the first cell of the grid. */
+    int32_t grid_y;                                     /**< Column of the first cell of the grid. */
+    int grid_rows;                                      /**< Amount of rows of the grid. */
+    int grid_cols;                                      /**< Amount of columns of the grid. */
+    bool held;                                          /**< MAP_DELTA journaled but not sent until the client gives its version. */
+    bool stopping;                                      /**< Asks the flush timer to end. */
+    pthread_t timer_thread;                             /**< Thread flushing the cells older than MAPPER_FLUSH_PERIOD_MS. */
+    pthread_mutex_t mutex;                              /**< Mutex protecting the pending cells and the grid. */
+    pthread_cond_t condition;                           /**< Wakes the flush timer up on the first pending cell and on stop. */
+};
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static void * MAPPER_run_timer(void * arg)
+ * \brief Flush timer : sends the pending cells once the oldest is MAPPER_FLUSH_PERIOD_MS old.
+ *
+ * \param arg : Mapper.
+ */
+static void * MAPPER_run_timer(void * arg);
+/**
+ * \fn static void MAPPER_flush_locked(Mapper * mapper)
+ * \brief Journals the pending cells as a new map version and sends them. The mapper mutex must be held.
+ *
+ * A MAP_DELTA is only sent when the current session has PROTOCOL_CAP_MAP_DELTA (an old client got the obstacles one by
+ * one in MAPPER_instance_set_cell()) and is not held. The version is journaled anyway, so that a client resuming later
+ * gets these cells.
+ */
+static void MAPPER_flush_locked(Mapper * mapper);
+/**
+ * \fn static int MAPPER_store_cell(Mapper * mapper, int coord_x, int coord_y, Protocol_Cell_Value value)
+ * \brief Writes a cell in the grid, growing it if needed. The mapper mutex must be held.
+ *
+ * \return 1 if the cell changed, 0 if it already had this value, -1 if it does not fit in the grid.
+ */
+static int MAPPER_store_cell(Mapper * mapper, int coord_x, int coord_y, Protocol_Cell_Value value);
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+Mapper * MAPPER_instance_create(Postman * postman) {
+    Mapper * mapper = (Mapper *) calloc(1, sizeof(Mapper));
+    if(mapper == NULL) {
+        perror("calloc() failed");
+        return NULL;
+    }
+    mapper->postman = postman;
+    pthread_mutex_init(&mapper->mutex, NULL);
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&mapper->condition, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if(pthread_create(&mapper->timer_thread, NULL, MAPPER_run_timer, mapper) != 0) {
+        perror("pthread_create failed");
+        pthread_cond_destroy(&mapper->condition);
+        pthread_mutex_destroy(&mapper->mutex);
+        free(mapper);
+        return NULL;
+    }
+    return mapper;
+}
+
+int MAPPER_instance_destroy(Mapper * mapper) {
+    pthread_mutex_lock(&mapper->mutex);
+    MAPPER_flush_locked(mapper);
+    mapper->stopping = true;
+    pthread_cond_signal(&mapper->condition);
+    pthread_mutex_unlock(&mapper->mutex);
+    int result = 0;
+    if(pthread_join(mapper->timer_thread, NULL) != 0) {
+        perror("pthread_join failed");
+        result = -1;
+    }
+    pthread_cond_destroy(&mapper->condition);
+    pthread_mutex_destroy(&mapper->mutex);
+    free(mapper->grid);
+    free(mapper);
+    return result;
+}
+
+void MAPPER_instance_set_cell(Mapper * mapper, int coord_x, int coord_y, Protocol_Cell_Value value) {
+    pthread_mutex_lock(&mapper->mutex);
+    int changed = MAPPER_store_cell(mapper, coord_x, coord_y, value);
+    if(!(POSTMAN_instance_get_capabilities(mapper->postman) & PROTOCOL_CAP_MAP_DELTA) && value == PROTOCOL_CELL_OBSTACLE) {
+        // Old client (or no HELLO yet) : one frame per obstacle, no free cells. Sent outside the mutex, as it may wait for the postman.
+        pthread_mutex_unlock(&mapper->mutex);
+        PROXYMAP_instance_set_obstacle_position(mapper->postman, coord_x, coord_y);
+        pthread_mutex_lock(&mapper->mutex);
+    }
+    // A client accumulating the observations (log-odds) gets every one of them, repeated ones included, in order.
+    bool observations = (POSTMAN_instance_get_capabilities(mapper->postman) & PROTOCOL_CAP_OBSERVATIONS) != 0;
+    if(changed == 0 && !observations) {
+        // Already known by the client, through a previous MAP_DELTA or the snapshot.
+        pthread_mutex_unlock(&mapper->mutex);
+        return;
+    }
+    int i = mapper->pending_count;
+    if(!observations) {
+        // The client keeps the last value only : a pending change of the cell is overwritten.
+        i = 0;
+        while(i < mapper->pending_count && (mapper->pending[i].coord_x != coord_x || mapper->pending[i].coord_y != coord_y)) {
+            i++;
+        }
+    }
+    if(i == mapper->pending_count) {
+        if(mapper->pending_count == 0) {
+            clock_gettime(CLOCK_MONOTONIC, &mapper->oldest_pending);
+            pthread_cond_signal(&mapper->condition);
+        }
+        mapper->pending[i].coord_x = coord_x;
+        mapper->pending[i].coord_y = coord_y;
+        mapper->pending_count++;
+    }
+    mapper->pending[i].value = (uint8_t)value;
+    if(mapper->pending_count == PROTOCOL_MAX_DELTA_CELLS) {
+        MAPPER_flush_locked(mapper);
+    }
+    pthread_mutex_unlock(&mapper->mutex);
+}
+
+void MAPPER_instance_flush(Mapper * mapper) {
+    pthread_mutex_lock(&mapper->mutex);
+    MAPPER_flush_locked(mapper);
+    pthread_mutex_unlock(&mapper->mutex);
+}
+
+void MAPPER_instance_send_snapshot(Mapper * mapper) {
+    pthread_mutex_lock(&mapper->mutex);
+    MAPPER_flush_locked(mapper);
+    mapper->held = false;
+    Protocol_Snapshot_Head head = {mapper->map_version, mapper->grid_x, mapper->grid_y,
+                                   (uint16_t)mapper->grid_rows, (uint16_t)mapper->grid_cols, 0, 0};
+    uint32_t total = (uint32_t)mapper->grid_rows * (uint32_t)mapper->grid_cols;
+    do {
+        // An empty map still gets one chunk, carrying the version.
+        PROXYMAP_instance_map_snapshot_chunk(mapper->postman, &head, mapper->grid);
+        head.first_cell += head.cell_count;
+    } while(head.first_cell < total);
+    pthread_mutex_unlock(&mapper->mutex);
+}
+
+void MAPPER_instance_hold(Mapper * mapper) {
+    pthread_mutex_lock(&mapper->mutex);
+    mapper->held = true;
+    pthread_mutex_unlock(&mapper->mutex);
+}
+
+int MAPPER_instance_replay(Mapper * mapper, uint32_t map_version) {
+    pthread_mutex_lock(&mapper->mutex);
+    MAPPER_flush_locked(mapper);
+    mapper->held = false;
+    if(!(POSTMAN_instance_get_capabilities(mapper->postman) & PROTOCOL_CAP_MAP_DELTA)
+       || map_version > mapper->map_version || mapper->map_version - map_version > MAPPER_JOURNAL_LENGTH) {
+        pthread_mutex_unlock(&mapper->mutex);
+        return -1;
+    }
+    for(uint32_t version = map_version + 1; version <= mapper->map_version; version++) {
+        Mapper_Delta * delta = &mapper->journal[version % MAPPER_JOURNAL_LENGTH];
+        PROXYMAP_instance_map_delta(mapper->postman, delta->map_version, delta->cells, delta->count);
+    }
+    pthread_mutex_unlock(&mapper->mutex);
+    return 0;
+}
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+static void * MAPPER_run_timer(void * arg) {
+    Mapper * mapper = (Mapper *) arg;
+    pthread_mutex_lock(&mapper->mutex);
+    while(!mapper->stopping) {
+        if(mapper->pending_count == 0) {
+            pthread_cond_wait(&mapper->condition, &mapper->mutex);
+            continue;
+        }
+        struct timespec deadline = mapper->oldest_pending;
+        deadline.tv_nsec += MAPPER_FLUSH_PERIOD_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
+            MAPPER_flush_locked(mapper);
+        }
+        else {
+            pthread_cond_timedwait(&mapper->condition, &mapper->mutex, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&mapper->mutex);
+    return NULL;
+}
+
+static void MAPPER_flush_locked(Mapper * mapper) {
+    if(mapper->pending_count == 0) {
+        return;
+    }
+    mapper->map_version++;
+    Mapper_Delta * delta = &mapper->journal[mapper->map_version % MAPPER_JOURNAL_LENGTH];
+    delta->map_version = mapper->map_version;
+    delta->count = mapper->pending_count;
+    memcpy(delta->cells, mapper->pending, (size_t)mapper->pending_count * sizeof(Protocol_Cell));
+    if((POSTMAN_instance_get_capabilities(mapper->postman) & PROTOCOL_CAP_MAP_DELTA) && !mapper->held) {
+        PROXYMAP_instance_map_delta(mapper->postman, mapper->map_version, mapper->pending, mapper->pending_count);
+    }
+    mapper->pending_count = 0;
+}
+
+static int MAPPER_store_cell(Mapper * mapper, int coord_x, int coord_y, Protocol_Cell_Value value) {
+    int row = coord_x - mapper->grid_x;
+    int col = coord_y - mapper->grid_y;
+    if(mapper->grid == NULL || row < 0 || col < 0 || row >= mapper->grid_rows || col >= mapper->grid_cols) {
+        int64_t min_x = coord_x - MAPPER_GRID_MARGIN;
+        int64_t min_y = coord_y - MAPPER_GRID_MARGIN;
+        int64_t max_x = (int64_t)coord_x + MAPPER_GRID_MARGIN;
+        int64_t max_y = (int64_t)coord_y + MAPPER_GRID_MARGIN;
+        if(mapper->grid != NULL) {
+            min_x = (mapper->grid_x < min_x) ? mapper->grid_x : min_x;
+            min_y = (mapper->grid_y < min_y) ? mapper->grid_y : min_y;
+            max_x = ((int64_t)mapper->grid_x + mapper->grid_rows - 1 > max_x) ? (int64_t)mapper->grid_x + mapper->grid_rows - 1 : max_x;
+            max_y = ((int64_t)mapper->grid_y + mapper->grid_cols - 1 > max_y) ? (int64_t)mapper->grid_y + mapper->grid_cols - 1 : max_y;
+        }
+        if(max_x - min_x + 1 > MAPPER_MAX_GRID_SIDE || max_y - min_y + 1 > MAPPER_MAX_GRID_SIDE
+           || min_x < INT32_MIN || min_y < INT32_MIN) {
+            return -1;
+        }
+        int rows = (int)(max_x - min_x + 1);
+        int cols = (int)(max_y - min_y + 1);
+        uint8_t * grid = (uint8_t *) calloc((size_t)rows * (size_t)cols, sizeof(uint8_t));  // PROTOCOL_CELL_UNKNOWN
+        if(grid == NULL) {
+            perror("calloc() failed");
+            return -1;
+        }
+        for(int x = 0; x < mapper->grid_rows; x++) {
+            memcpy(grid + (size_t)(mapper->grid_x - min_x + x) * cols + (mapper->grid_y - min_y),
+                   mapper->grid + (size_t)x * mapper->grid_cols, (size_t)mapper->grid_cols);
+        }
+        free(mapper->grid);
+        mapper->grid = grid;
+        mapper->grid_x = (int32_t)min_x;
+        mapper->grid_y = (int32_t)min_y;
+        mapper->grid_rows = rows;
+        mapper->grid_cols = cols;
+        row = coord_x - mapper->grid_x;
+        col = coord_y - mapper->grid_y;
+    }
+    uint8_t * cell = &mapper->grid[(size_t)row * mapper->grid_cols + col];
+    if(*cell == (uint8_t)value) {
+        return 0;
+    }
+    *cell = (uint8_t)value;
+    return 1;
+}
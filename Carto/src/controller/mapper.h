@@ -0,0 +1,119 @@
+/**
+ * \file  mapper.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the mapper. Cells discovered by a robot, published to Cute in batches.
+ *
+ * When the session has PROTOCOL_CAP_MAP_DELTA, the changed cells are gathered and sent in one MAP_DELTA
+ * when PROTOCOL_MAX_DELTA_CELLS cells are pending or when the oldest pending cell is MAPPER_FLUSH_PERIOD_MS old.
+ * Otherwise each obstacle goes out at once as a SET_OBSTACLE_POSITION, like before. A cell is sent when its value
+ * changes, or at each observation when the session has PROTOCOL_CAP_OBSERVATIONS (the client accumulates them).
+ *
+ * The mapper also keeps the whole map (authoritative copy), sent in MAP_SNAPSHOT chunks to a client
+ * which (re)connects, so it does not have to wait for the robots to walk the map again. The last MAP_DELTA are
+ * journaled too : a client resuming its session after a short cut only gets the versions it missed.
+ *
+ * \see mapper.c
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef SRC_CONTROLLER_MAPPER_H_
+#define SRC_CONTROLLER_MAPPER_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include "../lib/defs.h"
+#include "../com/postman.h"
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \struct Mapper mapper.h "controller/mapper.h"
+ * \brief Context of a mapper : map version and cells waiting to be sent through one postman.
+ */
+typedef struct Mapper_t Mapper;
+/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/* ----------------------  PUBLIC VARIABLES -----------------------------------*/
+/* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern Mapper * MAPPER_instance_create(Postman * postman)
+ * \brief Creates a mapper and starts its flush timer.
+ * \author Thomas ROCHER
+ *
+ * \param postman : postman used to send the map changes.
+ *
+ * \return The mapper on success, NULL on error.
+ */
+extern Mapper * MAPPER_instance_create(Postman * postman);
+/**
+ * \fn extern int MAPPER_instance_destroy(Mapper * mapper)
+ * \brief Sends the pending cells, stops the flush timer and destroys the mapper.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int MAPPER_instance_destroy(Mapper * mapper);
+/**
+ * \fn extern void MAPPER_instance_set_cell(Mapper * mapper, int coord_x, int coord_y, Protocol_Cell_Value value)
+ * \brief Records the new value of a cell.
+ * \author Thomas ROCHER
+ *
+ * \param coord_x : row of the cell.
+ * \param coord_y : column of the cell.
+ * \param value : PROTOCOL_CELL_FREE or PROTOCOL_CELL_OBSTACLE.
+ */
+extern void MAPPER_instance_set_cell(Mapper * mapper, int coord_x, int coord_y, Protocol_Cell_Value value);
+/**
+ * \fn extern void MAPPER_instance_flush(Mapper * mapper)
+ * \brief Sends the pending cells now, in one MAP_DELTA.
+ * \author Thomas ROCHER
+ */
+extern void MAPPER_instance_flush(Mapper * mapper);
+/**
+ * \fn extern void MAPPER_instance_send_snapshot(Mapper * mapper)
+ * \brief Sends the pending cells, then the whole map in MAP_SNAPSHOT chunks.
+ * No MAP_DELTA is sent between the chunks, the next one follows the version of the snapshot.
+ * \author Thomas ROCHER
+ */
+extern void MAPPER_instance_send_snapshot(Mapper * mapper);
+/**
+ * \fn extern void MAPPER_instance_hold(Mapper * mapper)
+ * \brief Journals the next MAP_DELTA without sending them, until MAPPER_instance_replay() or MAPPER_instance_send_snapshot().
+ * A resuming client must get the versions in order : the ones it missed first, then the new ones.
+ * \author Thomas ROCHER
+ */
+extern void MAPPER_instance_hold(Mapper * mapper);
+/**
+ * \fn extern int MAPPER_instance_replay(Mapper * mapper, uint32_t map_version)
+ * \brief Sends the pending cells, then the journaled MAP_DELTA following map_version (RESUME).
+ * \author Thomas ROCHER
+ *
+ * \param map_version : last version known by the client.
+ *
+ * \return 0 when the journal holds every missed version, -1 otherwise (nothing replayed, a snapshot is needed).
+ */
+extern int MAPPER_instance_replay(Mapper * mapper, uint32_t map_version);
+
+#endif /* SRC_CONTROLLER_MAPPER_H_ */
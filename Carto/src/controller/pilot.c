@@ -51,114 +51,217 @@
 #include "../com/proxyCartography.h"
 #include "../alphabot2/ultrasound.h"
 #include "pilot.h"
+#include "mapper.h"
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
-static Position* robot_position_base ;
-static bool_e can_set_command = FALSE;
-pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 /* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
 /* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/**
+ * \struct Pilot_t pilot.c "controller/pilot.c"
+ * \brief Context of a pilot.
+ */
+struct Pilot_t {
+    Postman * postman;              /**< Postman used to answer Cute. */
+    int unit;                       /**< Motor and ultrasound unit driven by the pilot. */
+    Position robot_position_base;   /**< Pose of the robot, updated at each move. */
+    bool_e can_set_command;         /**< FALSE once the robot has been stopped. */
+    Mapper * mapper;                /**< Cells discovered by the robot. */
+    uint32_t moves_done;            /**< MOVE_DONE sent since the creation, to replay the ones lost with the link. */
+    pthread_mutex_t mutex;          /**< Mutex protecting can_set_command. */
+};
 /* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
 /*------------------------STATE MACHINE RELATED FUNCTIONS------------------------*/
 /*------------------------ACTIONS RELATED FUNCTIONS------------------------*/
 /* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static Pilot * default_pilot
+ * \brief Pilot used by the PILOT_* functions without context.
+ */
+static Pilot * default_pilot = NULL;
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
-extern int PILOT_create(void) {
+extern Pilot * PILOT_instance_create(Postman * postman, int unit) {
+    Pilot * pilot = (Pilot *) calloc(1, sizeof(Pilot));
+    if(pilot == NULL) {
+        perror("calloc() failed");
+        return NULL;
+    }
+    pilot->postman = postman;
+    pilot->unit = unit;
+    pilot->robot_position_base.dir = SOUTH;
+    pilot->mapper = MAPPER_instance_create(postman);
+    if(pilot->mapper == NULL) {
+        free(pilot);
+        return NULL;
+    }
+    pthread_mutex_init(&pilot->mutex, NULL);
     MOTOR_create();
     ULTRASOUND_create();
-    pthread_mutex_lock(&mutex);
-    can_set_command = TRUE;
-    pthread_mutex_unlock(&mutex);
-    return 0;
+    pthread_mutex_lock(&pilot->mutex);
+    pilot->can_set_command = TRUE;
+    pthread_mutex_unlock(&pilot->mutex);
+    return pilot;
 }
 
-extern int PILOT_destroy(void) {
+extern int PILOT_instance_destroy(Pilot * pilot) {
     MOTOR_destroy();
     ULTRASOUND_destroy();
+    MAPPER_instance_destroy(pilot->mapper);
+    pthread_mutex_destroy(&pilot->mutex);
+    free(pilot);
     return 0;
 }
 
-extern void PILOT_send_robot_position(Position* robot_position_p){
-    robot_position_base->coord_x = robot_position_p->coord_x;
-    robot_position_base->coord_y = robot_position_p->coord_y;
-    robot_position_base->dir = robot_position_p->dir;
-    PROXYCARTOGRAPHY_robot_position_received();
+extern void PILOT_instance_send_robot_position(Pilot * pilot, Position* robot_position_p){
+    pilot->robot_position_base.coord_x = robot_position_p->coord_x;
+    pilot->robot_position_base.coord_y = robot_position_p->coord_y;
+    pilot->robot_position_base.dir = robot_position_p->dir;
+    MAPPER_instance_set_cell(pilot->mapper, robot_position_p->coord_x, robot_position_p->coord_y, PROTOCOL_CELL_FREE);
+    PROXYCARTOGRAPHY_instance_robot_position_received(pilot->postman);
 }
 
-extern void PILOT_send_move_cartography(Command cmd) {
-    PILOT_send_robot_position(robot_position_base);
+extern void PILOT_instance_send_move_cartography(Pilot * pilot, Command cmd) {
+    Position * robot_position = &pilot->robot_position_base;
+    PILOT_instance_send_robot_position(pilot, robot_position);
     if(cmd == FORWARD){
-        if (ULTRASOUND_check_obstacle()){
-            if(robot_position_base->dir == SOUTH){
-                PROXYMAP_set_obstacle_position((robot_position_base->coord_x)+1, (robot_position_base->coord_y));
-            }
-            else if(robot_position_base->dir == NORTH){
-                PROXYMAP_set_obstacle_position((robot_position_base->coord_x)-1, (robot_position_base->coord_y));
-            }
-            else if(robot_position_base->dir == WEST){
-                PROXYMAP_set_obstacle_position((robot_position_base->coord_x), (robot_position_base->coord_y)-1);
-            }
-            else if(robot_position_base->dir == EAST){
-                PROXYMAP_set_obstacle_position((robot_position_base->coord_x), (robot_position_base->coord_y)+1);
+        if (ULTRASOUND_check_unit_obstacle(pilot->unit)){
+            int obstacle_x = robot_position->coord_x;
+            int obstacle_y = robot_position->coord_y;
+            switch(robot_position->dir)
+            {
+                case SOUTH : obstacle_x++; break;
+                case NORTH : obstacle_x--; break;
+                case WEST : obstacle_y--; break;
+                case EAST : obstacle_y++; break;
+                default : break;
             }
+            MAPPER_instance_set_cell(pilot->mapper, obstacle_x, obstacle_y, PROTOCOL_CELL_OBSTACLE);
         }
         else {    
-            MOTOR_set_command(cmd);
-            switch(robot_position_base->dir)
+            MOTOR_set_unit_command(pilot->unit, cmd);
+            switch(robot_position->dir)
             {
-                case SOUTH : PROXYMAP_set_robot_position((robot_position_base->coord_x)+1, (robot_position_base->coord_y)); break;
-                case NORTH : PROXYMAP_set_robot_position((robot_position_base->coord_x)-1, (robot_position_base->coord_y)); break;
-                case WEST : PROXYMAP_set_robot_position((robot_position_base->coord_x), (robot_position_base->coord_y)-1); break;
-                case EAST : PROXYMAP_set_robot_position((robot_position_base->coord_x), (robot_position_base->coord_y)+1); break;
+                case SOUTH : robot_position->coord_x++; break;
+                case NORTH : robot_position->coord_x--; break;
+                case WEST : robot_position->coord_y--; break;
+                case EAST : robot_position->coord_y++; break;
                 default : break;
             }
+            MAPPER_instance_set_cell(pilot->mapper, robot_position->coord_x, robot_position->coord_y, PROTOCOL_CELL_FREE);
+            PROXYMAP_instance_set_robot_position(pilot->postman, robot_position->coord_x, robot_position->coord_y, robot_position->dir);
         }
     }
     else if(cmd == LEFT)
     {
-        MOTOR_set_command(cmd);
-        switch(robot_position_base->dir)
+        MOTOR_set_unit_command(pilot->unit, cmd);
+        switch(robot_position->dir)
         {
-            case SOUTH : robot_position_base->dir = EAST; break;
-            case NORTH : robot_position_base->dir = WEST; break;
-            case WEST : robot_position_base->dir = SOUTH; break;
-            case EAST : robot_position_base->dir = NORTH; break;
+            case SOUTH : robot_position->dir = EAST; break;
+            case NORTH : robot_position->dir = WEST; break;
+            case WEST : robot_position->dir = SOUTH; break;
+            case EAST : robot_position->dir = NORTH; break;
             default : break;
         }
     }
     else if(cmd == RIGHT)
     {
-        MOTOR_set_command(cmd);
-        switch(robot_position_base->dir)
+        MOTOR_set_unit_command(pilot->unit, cmd);
+        switch(robot_position->dir)
         {
-            case SOUTH : robot_position_base->dir = WEST; break;
-            case NORTH : robot_position_base->dir = EAST; break;
-            case WEST : robot_position_base->dir = NORTH; break;
-            case EAST : robot_position_base->dir = SOUTH; break;
+            case SOUTH : robot_position->dir = WEST; break;
+            case NORTH : robot_position->dir = EAST; break;
+            case WEST : robot_position->dir = NORTH; break;
+            case EAST : robot_position->dir = SOUTH; break;
             default : break;
         }
     }
-    PROXYCARTOGRAPHY_move_done();
+    // A turn only changes the heading : sent when the client asked for it.
+    if(cmd != FORWARD && (POSTMAN_instance_get_capabilities(pilot->postman) & PROTOCOL_CAP_HEADING)) {
+        PROXYMAP_instance_set_robot_position(pilot->postman, robot_position->coord_x, robot_position->coord_y, robot_position->dir);
+    }
+    pilot->moves_done++;
+    PROXYCARTOGRAPHY_instance_move_done(pilot->postman);
 }
 
-extern void PILOT_send_moves_trajectory(Command list_commands [], int size) {
+extern void PILOT_instance_send_moves_trajectory(Pilot * pilot, Command list_commands [], int size) {
     int i = 0;
     while(i<size)
     {
-        if (can_set_command){
-            MOTOR_set_command(list_commands[i]);
+        if (pilot->can_set_command){
+            MOTOR_set_unit_command(pilot->unit, list_commands[i]);
         }
         i++;
     }
-    pthread_mutex_lock(&mutex);
-    can_set_command = TRUE;
-    pthread_mutex_unlock(&mutex);
+    pthread_mutex_lock(&pilot->mutex);
+    pilot->can_set_command = TRUE;
+    pthread_mutex_unlock(&pilot->mutex);
+}
+
+extern void PILOT_instance_stop_robot(Pilot * pilot) {
+    pthread_mutex_lock(&pilot->mutex);
+    pilot->can_set_command = FALSE;
+    pthread_mutex_unlock(&pilot->mutex);
+    MOTOR_set_unit_command(pilot->unit, STOP);
+}
+
+extern void PILOT_instance_send_map_snapshot(Pilot * pilot) {
+    MAPPER_instance_send_snapshot(pilot->mapper);
+    Position robot_position = pilot->robot_position_base;
+    PROXYMAP_instance_set_robot_position(pilot->postman, robot_position.coord_x, robot_position.coord_y, robot_position.dir);
+}
+
+extern void PILOT_instance_resume(Pilot * pilot, uint32_t map_version, uint32_t moves_done) {
+    // Distance on the wrapping counter : a client ahead of the pilot gets nothing.
+    int32_t missed = (int32_t)(pilot->moves_done - moves_done);
+    for(int32_t i = 0; i < missed; i++) {
+        PROXYCARTOGRAPHY_instance_move_done(pilot->postman);
+    }
+    if(MAPPER_instance_replay(pilot->mapper, map_version) == -1
+       && (POSTMAN_instance_get_capabilities(pilot->postman) & PROTOCOL_CAP_MAP_SNAPSHOT)) {
+        MAPPER_instance_send_snapshot(pilot->mapper);
+    }
+    Position robot_position = pilot->robot_position_base;
+    PROXYMAP_instance_set_robot_position(pilot->postman, robot_position.coord_x, robot_position.coord_y, robot_position.dir);
+}
+
+extern void PILOT_instance_wait_resume(Pilot * pilot) {
+    MAPPER_instance_hold(pilot->mapper);
+}
+
+extern uint32_t PILOT_instance_get_moves_done(Pilot * pilot) {
+    return pilot->moves_done;
+}
+
+extern Pilot * PILOT_get_default(void) {
+    return default_pilot;
+}
+
+extern int PILOT_create(void) {
+    default_pilot = PILOT_instance_create(POSTMAN_get_default(), 0);
+    return (default_pilot == NULL) ? -1 : 0;
+}
+
+extern int PILOT_destroy(void) {
+    int result = PILOT_instance_destroy(default_pilot);
+    default_pilot = NULL;
+    return result;
+}
+
+extern void PILOT_send_robot_position(Position* robot_position_p){
+    PILOT_instance_send_robot_position(default_pilot, robot_position_p);
+}
+
+extern void PILOT_send_move_cartography(Command cmd) {
+    PILOT_instance_send_move_cartography(default_pilot, cmd);
+}
+
+extern void PILOT_send_moves_trajectory(Command list_commands [], int size) {
+    PILOT_instance_send_moves_trajectory(default_pilot, list_commands, size);
 }
 
 extern void PILOT_stop_robot() {
-    pthread_mutex_lock(&mutex);
-    can_set_command = FALSE;
-    pthread_mutex_unlock(&mutex);
-    MOTOR_set_command(STOP);
+    PILOT_instance_stop_robot(default_pilot);
 }
-/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
 
+extern void PILOT_send_map_snapshot(void) {
+    PILOT_instance_send_map_snapshot(default_pilot);
+}
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
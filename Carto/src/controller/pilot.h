@@ -38,11 +38,96 @@
 #define SRC_CONTROLLER_PILOT_H_
 /* ----------------------  INCLUDES ------------------------------------------*/
 #include "../lib/defs.h"
+#include "../com/postman.h"
 /* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \struct Pilot pilot.h "controller/pilot.h"
+ * \brief Context of a pilot : pose of one robot, its motor and ultrasound unit and the postman answering Cute.
+ *
+ * The PILOT_* functions without context use a default pilot (unit 0, default postman).
+ */
+typedef struct Pilot_t Pilot;
 /* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
 /* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
 /* ----------------------  PUBLIC VARIABLES -----------------------------------*/
 /* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern Pilot * PILOT_instance_create(Postman * postman, int unit)
+ * \brief Creates a pilot.
+ * \author Thomas ROCHER
+ *
+ * \param postman : postman used to answer Cute.
+ * \param unit : motor and ultrasound unit (always 0 on an AlphaBot2).
+ *
+ * \return The pilot on success, NULL on error.
+ */
+extern Pilot * PILOT_instance_create(Postman * postman, int unit);
+/**
+ * \fn extern int PILOT_instance_destroy(Pilot * pilot)
+ * \brief Destroys a pilot.
+ * \author Thomas ROCHER
+ *
+ * \return int : error code 0 on success -1 on error.
+ */
+extern int PILOT_instance_destroy(Pilot * pilot);
+/**
+ * \fn extern void PILOT_instance_send_move_cartography(Pilot * pilot, Command cmd)
+ * \brief Moves a robot for the cartography.
+ * \author Thomas ROCHER
+ */
+extern void PILOT_instance_send_move_cartography(Pilot * pilot, Command cmd);
+/**
+ * \fn extern void PILOT_instance_send_robot_position(Pilot * pilot, Position * robot_position_p)
+ * \brief Sets the pose of a robot.
+ * \author Thomas ROCHER
+ */
+extern void PILOT_instance_send_robot_position(Pilot * pilot, Position * robot_position_p);
+/**
+ * \fn extern void PILOT_instance_send_moves_trajectory(Pilot * pilot, Command list_commands [], int size)
+ * \brief Moves a robot along a trajectory.
+ * \author Thomas ROCHER
+ */
+extern void PILOT_instance_send_moves_trajectory(Pilot * pilot, Command list_commands [], int size);
+/**
+ * \fn extern void PILOT_instance_stop_robot(Pilot * pilot)
+ * \brief Stops a robot and its trajectory.
+ * \author Thomas ROCHER
+ */
+extern void PILOT_instance_stop_robot(Pilot * pilot);
+/**
+ * \fn extern void PILOT_instance_send_map_snapshot(Pilot * pilot)
+ * \brief Sends the whole map known by the robot, then its pose (MAP_SNAPSHOT_REQUEST).
+ * \author Thomas ROCHER
+ */
+extern void PILOT_instance_send_map_snapshot(Pilot * pilot);
+/**
+ * \fn extern void PILOT_instance_resume(Pilot * pilot, uint32_t map_version, uint32_t moves_done)
+ * \brief Replays what Cute missed while the link was down : the lost MOVE_DONE, the map versions after
+ * map_version (whole map when the journal does not hold them any more), then the pose of the robot.
+ * \author Thomas ROCHER
+ *
+ * \param map_version : last map version received by Cute.
+ * \param moves_done : amount of MOVE_DONE received by Cute in the session.
+ */
+extern void PILOT_instance_resume(Pilot * pilot, uint32_t map_version, uint32_t moves_done);
+/**
+ * \fn extern void PILOT_instance_wait_resume(Pilot * pilot)
+ * \brief Holds the map changes until the RESUME of the client gives the version it holds (see MAPPER_instance_hold()).
+ * \author Thomas ROCHER
+ */
+extern void PILOT_instance_wait_resume(Pilot * pilot);
+/**
+ * \fn extern uint32_t PILOT_instance_get_moves_done(Pilot * pilot)
+ * \brief Gives the amount of MOVE_DONE sent since the pilot was created. Called by the thread of the dispatcher.
+ * \author Thomas ROCHER
+ */
+extern uint32_t PILOT_instance_get_moves_done(Pilot * pilot);
+/**
+ * \fn extern Pilot * PILOT_get_default(void)
+ * \brief Gives the default pilot, created by PILOT_create().
+ * \author Thomas ROCHER
+ */
+extern Pilot * PILOT_get_default(void);
 /**
  * \fn extern int PILOT_create()
  * \brief Initialize in memory the object Motor.
@@ -89,6 +174,12 @@ extern void PILOT_send_moves_trajectory(Command list_commands [], int size);
  * \author fatoumata TRAORE
  */
 extern void PILOT_stop_robot();
+/**
+ * \fn extern void PILOT_send_map_snapshot(void)
+ * \brief Sends the whole map known by the robot, then its pose.
+ * \author Thomas ROCHER
+ */
+extern void PILOT_send_map_snapshot(void);
 
 
 
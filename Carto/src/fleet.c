@@ -0,0 +1,886 @@
+/**
+ * \file  fleet.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Entry of the fleet simulator (make TARGET=simulator).
+ *
+ * Starts N Carto robots listening on consecutive ports, each one driving a simulated robot of a shared
+ * grid world. By default each robot is a forked process ; with -i, all the robots are instances of the
+ * postman, dispatcher and pilot modules sharing this process. One client thread per robot then plays Cute's cartography lock-step (SEND_MOVE_CARTOGRAPHY,
+ * wait for MOVE_DONE) as fast as possible. At the end, the aggregate message rate, the CPU time used
+ * by each robot process and the percentiles of the move latency are reported.
+ *
+ * Clients open the session with HELLO (protocol v2) unless -l asks them to speak v1 like the old Cute.
+ * In v2, each client asks for a MAP_SNAPSHOT at the end, as a Cute joining late would, to measure the resync.
+ * With -k, the frames are sequenced and each client keeps up to window moves in flight, matched to their
+ * MOVE_DONE by the ack of the sequenced head.
+ * With -b, each client opens its session with RESUME, then cuts its link every period right after sending its moves,
+ * reconnects on a fresh socket and resumes : the report gives the recovery time (cut to replayed pose) and checks
+ * that no MAP_DELTA version and no MOVE_DONE was lost.
+ *
+ * Usage : swarm_bots_fleet.elf [-i] [-l] [-k window] [-b period_ms] [-n robots] [-p first_port] [-d seconds] [-v scale]
+ *                              [-w world_file | -r rows -c cols -o obstacle_percent -s seed]
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "com/postman.h"
+#include "com/dispatcher.h"
+#include "controller/pilot.h"
+#include "lib/defs.h"
+#include "lib/clock.h"
+#include "simulator/world.h"
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def MAX_ROBOTS
+ * Max amount of simulated robots.
+ */
+#define MAX_ROBOTS 1024
+/**
+ * \def MAX_V1_COORDINATE
+ * The v1 protocol carries the coordinates on one byte.
+ */
+#define MAX_V1_COORDINATE 256
+/**
+ * \def CONNECTION_ATTEMPTS
+ * Amount of connection attempts (every 100 ms) while the robots are starting.
+ */
+#define CONNECTION_ATTEMPTS 50
+/**
+ * \def MAX_FRAME_SIZE
+ * Max size of a frame received from a robot (a full MAP_DELTA, bigger than a MAP_SNAPSHOT chunk).
+ */
+#define MAX_FRAME_SIZE PROTOCOL_MAX_DELTA_FRAME_SIZE
+/**
+ * \def MAX_WINDOW
+ * Max amount of moves in flight per client.
+ */
+#define MAX_WINDOW 64
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/**
+ * \struct Fleet_Client fleet.c "fleet.c"
+ * \brief State and statistics of the client thread of one robot.
+ */
+typedef struct {
+    int robot_id;               /**< Robot identifier in the world. */
+    uint16_t port;              /**< Port of the robot. */
+    Position start_pose;        /**< Pose given to the robot at the beginning. */
+    unsigned int seed;          /**< Seed of the exploration policy. */
+    pthread_t thread;           /**< Client thread. */
+    uint64_t sent;              /**< Frames sent to the robot. */
+    uint64_t received;          /**< Frames received from the robot. */
+    uint64_t * latencies;       /**< Latency of each move, in microseconds. */
+    size_t latency_count;       /**< Amount of latencies. */
+    size_t latency_capacity;    /**< Size of the latencies array. */
+    uint64_t map_frames;        /**< Frames carrying map cells (SET_OBSTACLE_POSITION, MAP_DELTA). */
+    uint64_t map_cells;         /**< Map cells received. */
+    uint64_t snapshot_frames;   /**< MAP_SNAPSHOT chunks received. */
+    uint64_t snapshot_bytes;    /**< Size of the MAP_SNAPSHOT chunks. */
+    uint64_t snapshot_cells;    /**< Known cells (free or obstacle) of the snapshot. */
+    uint64_t snapshot_us;       /**< Time from MAP_SNAPSHOT_REQUEST to the last chunk, in microseconds. */
+    uint32_t token;             /**< Session token given by SESSION (-b). */
+    uint32_t map_version;       /**< Last map version received (MAP_DELTA or MAP_SNAPSHOT). */
+    uint32_t moves_done;        /**< MOVE_DONE received in the session. */
+    uint64_t map_gaps;          /**< MAP_DELTA not following the previous version. */
+    uint64_t resumes;           /**< Sessions resumed after a cut (-b). */
+    uint64_t resume_us;         /**< Total time from the cuts to the replayed poses, in microseconds. */
+    uint64_t resume_max_us;     /**< Longest time from a cut to the replayed pose, in microseconds. */
+    uint64_t moves_lost;        /**< Moves in flight at a cut and neither done nor replayed. */
+    bool failed;                /**< The connection has failed. */
+    bool sequenced;             /**< The session numbers its frames (PROTOCOL_CAP_SEQUENCE). */
+    uint16_t sequence;          /**< Sequence number of the last frame sent. */
+    Postman * postman;          /**< Postman of the robot (in-process mode). */
+    Pilot * pilot;              /**< Pilot of the robot (in-process mode). */
+    Dispatcher * dispatcher;    /**< Dispatcher of the robot (in-process mode). */
+} Fleet_Client;
+/**
+ * \struct Fleet_Move fleet.c "fleet.c"
+ * \brief Move in flight, found back by the sequence number of its request.
+ */
+typedef struct {
+    Command command;            /**< Command sent. */
+    uint64_t sent_at;           /**< Sending time, in microseconds. */
+    bool moved;                 /**< A new position came back for it. */
+} Fleet_Move;
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static void FLEET_run_robot(int robot_id, uint16_t port)
+ * \brief Body of a forked robot : starts Carto on the simulated peripherals and waits for SIGTERM.
+ * \author Thomas ROCHER
+ */
+static void FLEET_run_robot(int robot_id, uint16_t port);
+/**
+ * \fn static int FLEET_start_instance(Fleet_Client * client)
+ * \brief Starts a robot inside this process, on its own postman, dispatcher and pilot.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_start_instance(Fleet_Client * client);
+/**
+ * \fn static void * FLEET_stop_instance(void * arg)
+ * \brief Stops and destroys a robot started by FLEET_start_instance(). Its client must be disconnected.
+ * Called by a thread per robot : a postman may take up to its polling period to stop.
+ * \author Thomas ROCHER
+ *
+ * \param arg : Fleet_Client of the robot.
+ */
+static void * FLEET_stop_instance(void * arg);
+/**
+ * \fn static void * FLEET_run_client(void * arg)
+ * \brief Client thread : plays the cartography lock-step with one robot until the deadline.
+ * \author Thomas ROCHER
+ *
+ * \param arg : Fleet_Client of the robot.
+ */
+static void * FLEET_run_client(void * arg);
+/**
+ * \fn static int FLEET_connect(uint16_t port)
+ * \brief Connects to a robot, retrying while it starts.
+ *
+ * \return The socket on success, -1 on error.
+ */
+static int FLEET_connect(uint16_t port);
+/**
+ * \fn static int FLEET_send_frame(int socket_fd, const uint8_t * frame, int frame_size)
+ * \brief Sends a whole frame built with the protocol.h encoders.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_send_frame(int socket_fd, const uint8_t * frame, int frame_size);
+/**
+ * \fn static int FLEET_send_request(Fleet_Client * client, int socket_fd, uint8_t * frame, int frame_size)
+ * \brief Numbers a frame when the session is sequenced, then sends it.
+ *
+ * \param frame : buffer of PROTOCOL_MAX_FRAME_SIZE bytes.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_send_request(Fleet_Client * client, int socket_fd, uint8_t * frame, int frame_size);
+/**
+ * \fn static int FLEET_read_frame(int socket_fd, uint8_t * frame, uint16_t * type)
+ * \brief Reads a whole frame (at most MAX_FRAME_SIZE bytes) from a robot and gives its type.
+ *
+ * \return On success, returns 0. On error or disconnection, returns -1.
+ */
+static int FLEET_read_frame(int socket_fd, uint8_t * frame, uint16_t * type);
+/**
+ * \fn static void FLEET_count_map_cells(Fleet_Client * client, const uint8_t * frame, uint16_t type)
+ * \brief Counts the map cells carried by a received frame and follows the map version.
+ */
+static void FLEET_count_map_cells(Fleet_Client * client, const uint8_t * frame, uint16_t type);
+/**
+ * \fn static int FLEET_request_snapshot(Fleet_Client * client, int socket_fd)
+ * \brief Asks the robot for its whole map and reads the MAP_SNAPSHOT chunks.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_request_snapshot(Fleet_Client * client, int socket_fd);
+/**
+ * \fn static int FLEET_hello(Fleet_Client * client, int socket_fd)
+ * \brief Opens a v2 session : HELLO, then HELLO_ACK (frame numbers restart).
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_hello(Fleet_Client * client, int socket_fd);
+/**
+ * \fn static int FLEET_resume(Fleet_Client * client, int socket_fd, Fleet_Move * moves, int * in_flight)
+ * \brief Sends RESUME and reads the answer up to the replayed pose. Each replayed MOVE_DONE completes the oldest move in flight.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_resume(Fleet_Client * client, int socket_fd, Fleet_Move * moves, int * in_flight);
+/**
+ * \fn static int FLEET_reconnect(Fleet_Client * client, int * socket_fd, Fleet_Move * moves, int * in_flight)
+ * \brief Cuts the link, frames in flight included, then reconnects on a fresh socket and resumes the session.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int FLEET_reconnect(Fleet_Client * client, int * socket_fd, Fleet_Move * moves, int * in_flight);
+/**
+ * \fn static void FLEET_record_latency(Fleet_Client * client, uint64_t sent_at)
+ * \brief Records the latency of a move done.
+ */
+static void FLEET_record_latency(Fleet_Client * client, uint64_t sent_at);
+/**
+ * \fn static uint64_t FLEET_now_us(void)
+ * \brief Wall clock used for the statistics, whatever the clock of the robots.
+ */
+static uint64_t FLEET_now_us(void);
+/**
+ * \fn static int FLEET_compare(const void * a, const void * b)
+ * \brief qsort comparator of the latencies.
+ */
+static int FLEET_compare(const void * a, const void * b);
+/**
+ * \fn static void FLEET_report(int robot_count, double elapsed, double cpu_total, double cpu_max)
+ * \brief Prints the statistics of the run.
+ *
+ * \param cpu_total : CPU time used by the robots, in seconds.
+ * \param cpu_max : CPU time of the busiest robot, negative when unknown (in-process mode).
+ */
+static void FLEET_report(int robot_count, double elapsed, double cpu_total, double cpu_max);
+/**
+ * \fn static double FLEET_cpu_time(const struct rusage * usage)
+ * \brief Gives the user + system CPU time of a rusage, in seconds.
+ */
+static double FLEET_cpu_time(const struct rusage * usage);
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static Fleet_Client clients[MAX_ROBOTS]
+ * \brief Client of each robot.
+ */
+static Fleet_Client clients[MAX_ROBOTS];
+/**
+ * \var static uint64_t deadline_us
+ * \brief End of the run (FLEET_now_us time base).
+ */
+static uint64_t deadline_us;
+/**
+ * \var static uint8_t client_version
+ * \brief Protocol version offered by the clients (PROTOCOL_VERSION_1 : no HELLO).
+ */
+static uint8_t client_version = PROTOCOL_VERSION;
+/**
+ * \var static int window
+ * \brief Max amount of moves in flight per client (1 : lock-step).
+ */
+static int window = 1;
+/**
+ * \var static int cut_period_ms
+ * \brief Period of the link cuts of each client (-b), 0 : never.
+ */
+static int cut_period_ms = 0;
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+int main(int argc, char * argv[])
+{
+    int robot_count = 4;
+    int first_port = 12345;
+    int duration = 10;
+    double scale = -1.0;
+    const char * world_file = NULL;
+    int rows = 64, cols = 64, obstacle_percent = 10;
+    unsigned int seed = 1;
+    bool in_process = false;
+
+    int option;
+    while((option = getopt(argc, argv, "ilk:b:n:p:d:v:w:r:c:o:s:")) != -1) {
+        switch(option) {
+            case 'i' : in_process = true; break;
+            case 'l' : client_version = PROTOCOL_VERSION_1; break;
+            case 'k' : window = atoi(optarg); break;
+            case 'b' : cut_period_ms = atoi(optarg); break;
+            case 'n' : robot_count = atoi(optarg); break;
+            case 'p' : first_port = atoi(optarg); break;
+            case 'd' : duration = atoi(optarg); break;
+            case 'v' : scale = atof(optarg); break;
+            case 'w' : world_file = optarg; break;
+            case 'r' : rows = atoi(optarg); break;
+            case 'c' : cols = atoi(optarg); break;
+            case 'o' : obstacle_percent = atoi(optarg); break;
+            case 's' : seed = (unsigned int)atoi(optarg); break;
+            default :
+            {
+                printf("Usage : %s [-i] [-l] [-k window] [-b period_ms] [-n robots] [-p first_port] [-d seconds] [-v scale] "
+                       "[-w world_file | -r rows -c cols -o obstacle_percent -s seed]\n", argv[0]);
+                return -1;
+            }
+        }
+    }
+    if(robot_count < 1 || robot_count > MAX_ROBOTS || first_port + robot_count > 65536) {
+        printf("ERROR : 1 to %d robots on valid ports.\n", MAX_ROBOTS);
+        return -1;
+    }
+    if(window < 1 || window > MAX_WINDOW) {
+        printf("ERROR : window from 1 to %d.\n", MAX_WINDOW);
+        return -1;
+    }
+    if(cut_period_ms < 0 || (cut_period_ms > 0 && client_version == PROTOCOL_VERSION_1)) {
+        printf("ERROR : the cuts need a positive period and the v2 protocol (RESUME).\n");
+        return -1;
+    }
+    if(client_version == PROTOCOL_VERSION_1 && (rows > MAX_V1_COORDINATE || cols > MAX_V1_COORDINATE)) {
+        printf("ERROR : the world can't be bigger than %dx%d.\n", MAX_V1_COORDINATE, MAX_V1_COORDINATE);
+        return -1;
+    }
+
+    /* WORLD CREATION */
+    if((world_file != NULL ? SIMWORLD_load(world_file) : SIMWORLD_create(rows, cols, obstacle_percent, seed)) == -1) {
+        printf("ERROR on world creation.\n");
+        return -1;
+    }
+    for(int i = 0; i < robot_count; i++) {
+        Position start_pose = {SOUTH, (i * rows) / robot_count, (i * 7) % cols};
+        clients[i].robot_id = SIMWORLD_add_robot(&start_pose);
+        if(clients[i].robot_id == -1) {
+            printf("ERROR : no free cell for robot %d.\n", i);
+            SIMWORLD_destroy();
+            return -1;
+        }
+        clients[i].start_pose = start_pose;
+        clients[i].port = (uint16_t)(first_port + i);
+        clients[i].seed = seed + (unsigned int)i;
+    }
+
+    /* ROBOTS START */
+    if(scale >= 0.0) {
+        CLOCK_set_mode(CLOCK_VIRTUAL, scale);
+    }
+    // A client leaving while its robot writes must not kill the whole fleet.
+    signal(SIGPIPE, SIG_IGN);
+    struct rusage start_usage;
+    getrusage(RUSAGE_SELF, &start_usage);
+    pid_t robots[MAX_ROBOTS];
+    for(int i = 0; i < robot_count; i++) {
+        if(in_process) {
+            if(FLEET_start_instance(&clients[i]) == -1) {
+                printf("ERROR on robot %d start.\n", i);
+                robot_count = i;
+                break;
+            }
+            continue;
+        }
+        robots[i] = fork();
+        if(robots[i] == -1) {
+            perror("fork() failed");
+            robot_count = i;
+            break;
+        }
+        if(robots[i] == 0) {
+            FLEET_run_robot(clients[i].robot_id, clients[i].port);
+        }
+    }
+    printf("%d robots started on ports %d to %d.\n", robot_count, first_port, first_port + robot_count - 1);
+
+    /* LOAD */
+    uint64_t start_us = FLEET_now_us();
+    deadline_us = start_us + (uint64_t)duration * 1000000ULL;
+    for(int i = 0; i < robot_count; i++) {
+        pthread_create(&clients[i].thread, NULL, FLEET_run_client, &clients[i]);
+    }
+    for(int i = 0; i < robot_count; i++) {
+        pthread_join(clients[i].thread, NULL);
+    }
+    double elapsed = (FLEET_now_us() - start_us) / 1e6;
+
+    /* ROBOTS STOP */
+    double cpu_total = 0.0, cpu_max = -1.0;
+    if(in_process) {
+        // Robots and clients share the process : the CPU time of both is counted.
+        struct rusage end_usage;
+        getrusage(RUSAGE_SELF, &end_usage);
+        cpu_total = FLEET_cpu_time(&end_usage) - FLEET_cpu_time(&start_usage);
+        for(int i = 0; i < robot_count; i++) {
+            pthread_create(&clients[i].thread, NULL, FLEET_stop_instance, &clients[i]);
+        }
+        for(int i = 0; i < robot_count; i++) {
+            pthread_join(clients[i].thread, NULL);
+        }
+    }
+    else {
+        for(int i = 0; i < robot_count; i++) {
+            kill(robots[i], SIGTERM);
+        }
+        cpu_max = 0.0;
+        for(int i = 0; i < robot_count; i++) {
+            int status;
+            struct rusage usage;
+            memset(&usage, 0, sizeof(struct rusage));
+            wait4(robots[i], &status, 0, &usage);
+            double cpu = FLEET_cpu_time(&usage);
+            cpu_total += cpu;
+            cpu_max = (cpu > cpu_max) ? cpu : cpu_max;
+        }
+    }
+    SIMWORLD_destroy();
+
+    FLEET_report(robot_count, elapsed, cpu_total, cpu_max);
+    for(int i = 0; i < robot_count; i++) {
+        free(clients[i].latencies);
+    }
+    return 0;
+}
+
+static void FLEET_run_robot(int robot_id, uint16_t port) {
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+
+    SIMWORLD_select_robot(robot_id);
+    POSTMAN_set_port(port);
+    if(POSTMAN_create() == -1 || DISPATCHER_create() == -1 || POSTMAN_start() == -1 || DISPATCHER_start() == -1) {
+        printf("ERROR on robot %d start.\n", robot_id);
+        POSTMAN_destroy();
+        _exit(EXIT_FAILURE);
+    }
+    int signal_received;
+    sigwait(&stop_signals, &signal_received);
+    POSTMAN_destroy();
+    _exit(EXIT_SUCCESS);
+}
+
+static int FLEET_start_instance(Fleet_Client * client) {
+    // The simulated units are relative to the selected robot, 0 in this process.
+    client->postman = POSTMAN_instance_create(client->port);
+    if(client->postman == NULL) {
+        return -1;
+    }
+    client->pilot = PILOT_instance_create(client->postman, client->robot_id);
+    client->dispatcher = (client->pilot != NULL) ? DISPATCHER_instance_create(client->postman, client->pilot) : NULL;
+    if(client->dispatcher == NULL || POSTMAN_instance_start(client->postman) == -1 || DISPATCHER_instance_start(client->dispatcher) == -1) {
+        return -1;
+    }
+    return 0;
+}
+
+static void * FLEET_stop_instance(void * arg) {
+    Fleet_Client * client = (Fleet_Client *) arg;
+    DISPATCHER_instance_stop(client->dispatcher);
+    POSTMAN_instance_stop(client->postman);
+    DISPATCHER_instance_destroy(client->dispatcher);
+    PILOT_instance_destroy(client->pilot);
+    POSTMAN_instance_destroy(client->postman);
+    return NULL;
+}
+
+static void * FLEET_run_client(void * arg) {
+    Fleet_Client * client = (Fleet_Client *) arg;
+    int socket_fd = FLEET_connect(client->port);
+    if(socket_fd == -1) {
+        client->failed = true;
+        return NULL;
+    }
+    uint16_t type;
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    uint8_t answer[MAX_FRAME_SIZE];
+    Fleet_Move moves[MAX_WINDOW];
+    int in_flight = 0;
+    int version = PROTOCOL_VERSION_1;
+    if(client_version >= PROTOCOL_VERSION_2) {
+        if(FLEET_hello(client, socket_fd) == -1 || (cut_period_ms > 0 && FLEET_resume(client, socket_fd, moves, &in_flight) == -1)) {
+            client->failed = true;
+            close(socket_fd);
+            return NULL;
+        }
+        version = PROTOCOL_VERSION_2;
+    }
+    // Without sequence numbers, the answers can't be matched : lock-step.
+    int max_in_flight = client->sequenced ? window : 1;
+    int frame_size = PROTOCOL_encode_robot_position(frame, version, client->start_pose.coord_x, client->start_pose.coord_y, client->start_pose.dir);
+    if(FLEET_send_request(client, socket_fd, frame, frame_size) == -1) {
+        client->failed = true;
+    }
+    do {
+        if(client->failed || FLEET_read_frame(socket_fd, answer, &type) == -1) {
+            client->failed = true;
+            close(socket_fd);
+            return NULL;
+        }
+        client->received++;
+        FLEET_count_map_cells(client, answer, type);
+    } while(type != ROBOT_POSITION_RECEIVED);
+
+    bool blocked = false;
+    uint64_t next_cut_us = FLEET_now_us() + (uint64_t)cut_period_ms * 1000ULL;
+    while(!client->failed) {
+        /* Goes straight on, turns when blocked and sometimes at random. */
+        while(in_flight < max_in_flight && FLEET_now_us() < deadline_us) {
+            Command command = FORWARD;
+            if(blocked || rand_r(&client->seed) % 5 == 0) {
+                command = (rand_r(&client->seed) % 2 == 0) ? RIGHT : LEFT;
+                blocked = false;
+            }
+            frame_size = PROTOCOL_encode_move_cartography(frame, command);
+            if(FLEET_send_request(client, socket_fd, frame, frame_size) == -1) {
+                client->failed = true;
+                break;
+            }
+            Fleet_Move move = {command, FLEET_now_us(), false};
+            moves[client->sequence % MAX_WINDOW] = move;
+            in_flight++;
+        }
+        if(client->failed || in_flight == 0) {
+            break;
+        }
+        if(cut_period_ms > 0 && FLEET_now_us() >= next_cut_us) {
+            // Cut with the answers of the moves still on their way : only RESUME can bring them back.
+            if(FLEET_reconnect(client, &socket_fd, moves, &in_flight) == -1) {
+                client->failed = true;
+                break;
+            }
+            next_cut_us = FLEET_now_us() + (uint64_t)cut_period_ms * 1000ULL;
+            continue;
+        }
+        if(FLEET_read_frame(socket_fd, answer, &type) == -1) {
+            client->failed = true;
+            break;
+        }
+        client->received++;
+        FLEET_count_map_cells(client, answer, type);
+        /* The answer belongs to the request it acks (the only one in flight in lock-step). */
+        Communication_Protocol_Head head = PROTOCOL_decode_head(answer);
+        Fleet_Move * move = &moves[(head.sequenced ? head.ack : client->sequence) % MAX_WINDOW];
+        if(type == SET_ROBOT_POSITION || type == SET_ROBOT_POSITION_V2) {
+            move->moved = true;
+        }
+        else if(type == MOVE_DONE) {
+            /* The obstacle may come later in a MAP_DELTA : a FORWARD without new position means blocked. */
+            blocked = blocked || (move->command == FORWARD && !move->moved);
+            in_flight--;
+            client->moves_done++;
+            FLEET_record_latency(client, move->sent_at);
+        }
+    }
+    if(!client->failed && version >= PROTOCOL_VERSION_2 && FLEET_request_snapshot(client, socket_fd) == -1) {
+        client->failed = true;
+    }
+    close(socket_fd);
+    return NULL;
+}
+
+static int FLEET_connect(uint16_t port) {
+    struct sockaddr_in address = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+    };
+    for(int attempt = 0; attempt < CONNECTION_ATTEMPTS; attempt++) {
+        int socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if(socket_fd == -1) {
+            perror("socket() failed");
+            return -1;
+        }
+        if(connect(socket_fd, (struct sockaddr *)&address, sizeof(address)) == 0) {
+            int no_delay = 1;
+            setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            return socket_fd;
+        }
+        close(socket_fd);
+        usleep(100000);
+    }
+    printf("ERROR : robot on port %u unreachable.\n", port);
+    return -1;
+}
+
+static int FLEET_send_frame(int socket_fd, const uint8_t * frame, int frame_size) {
+    int total = 0;
+    while(total < frame_size) {
+        int amount_sent = write(socket_fd, frame + total, frame_size - total);
+        if(amount_sent == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        total += amount_sent;
+    }
+    return 0;
+}
+
+static int FLEET_send_request(Fleet_Client * client, int socket_fd, uint8_t * frame, int frame_size) {
+    client->sequence++;
+    if(client->sequenced) {
+        frame_size = PROTOCOL_add_sequence(frame, client->sequence, 0);
+    }
+    if(FLEET_send_frame(socket_fd, frame, frame_size) == -1) {
+        return -1;
+    }
+    client->sent++;
+    return 0;
+}
+
+static int FLEET_read_frame(int socket_fd, uint8_t * frame, uint16_t * type) {
+    int expected = 2;
+    int total = 0;
+    while(total < expected) {
+        int amount_read = read(socket_fd, frame + total, expected - total);
+        if(amount_read <= 0) {
+            if(amount_read == -1 && errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        total += amount_read;
+        if(total == 2 && expected == 2) {
+            expected = PROTOCOL_SIZE_FIELD + PROTOCOL_get_u16(frame);
+            if(expected > MAX_FRAME_SIZE || expected < PROTOCOL_HEAD_SIZE) {
+                return -1;
+            }
+        }
+    }
+    *type = (uint16_t)PROTOCOL_decode_head(frame).msg_type;
+    return 0;
+}
+
+static void FLEET_count_map_cells(Fleet_Client * client, const uint8_t * frame, uint16_t type) {
+    if(type == SET_OBSTACLE_POSITION || type == SET_OBSTACLE_POSITION_V2) {
+        client->map_frames++;
+        client->map_cells++;
+    }
+    else if(type == MAP_DELTA) {
+        const uint8_t * payload = frame + PROTOCOL_payload_offset(PROTOCOL_decode_head(frame));
+        uint32_t map_version = PROTOCOL_get_u32(payload);
+        client->map_frames++;
+        client->map_cells += PROTOCOL_get_u16(payload + 4);
+        client->map_gaps += (map_version != client->map_version + 1) ? 1 : 0;
+        client->map_version = map_version;
+    }
+    else if(type == MAP_SNAPSHOT) {
+        client->map_version = PROTOCOL_decode_snapshot_head(frame + PROTOCOL_payload_offset(PROTOCOL_decode_head(frame))).map_version;
+    }
+}
+
+static int FLEET_request_snapshot(Fleet_Client * client, int socket_fd) {
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    uint8_t answer[MAX_FRAME_SIZE];
+    uint8_t * cells = NULL;
+    uint16_t type;
+    uint64_t sent_at = FLEET_now_us();
+    int frame_size = PROTOCOL_encode_head(frame, MAP_SNAPSHOT_REQUEST, 0);
+    if(FLEET_send_request(client, socket_fd, frame, frame_size) == -1) {
+        return -1;
+    }
+    bool complete = false;
+    while(!complete) {
+        if(FLEET_read_frame(socket_fd, answer, &type) == -1) {
+            free(cells);
+            return -1;
+        }
+        client->received++;
+        if(type != MAP_SNAPSHOT) {
+            FLEET_count_map_cells(client, answer, type);
+            continue;
+        }
+        Communication_Protocol_Head frame_head = PROTOCOL_decode_head(answer);
+        const uint8_t * payload = answer + PROTOCOL_payload_offset(frame_head);
+        int payload_size = PROTOCOL_payload_size(frame_head);
+        Protocol_Snapshot_Head head = PROTOCOL_decode_snapshot_head(payload);
+        uint32_t total = (uint32_t)head.rows * head.cols;
+        if(head.first_cell == 0) {
+            free(cells);
+            cells = malloc(total > 0 ? total : 1);
+        }
+        if(cells == NULL || PROTOCOL_decode_snapshot_cells(payload, payload_size, head, cells) == -1) {
+            free(cells);
+            return -1;
+        }
+        client->snapshot_frames++;
+        client->map_version = head.map_version;
+        client->snapshot_bytes += PROTOCOL_SIZE_FIELD + PROTOCOL_get_u16(answer);
+        complete = (head.first_cell + head.cell_count == total);
+        if(complete) {
+            for(uint32_t i = 0; i < total; i++) {
+                client->snapshot_cells += (cells[i] != PROTOCOL_CELL_UNKNOWN) ? 1 : 0;
+            }
+        }
+    }
+    client->snapshot_us = FLEET_now_us() - sent_at;
+    free(cells);
+    return 0;
+}
+
+static int FLEET_hello(Fleet_Client * client, int socket_fd) {
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    uint8_t answer[MAX_FRAME_SIZE];
+    uint16_t type;
+    // Without cuts the clients don't send RESUME : they must not offer it, Carto would hold the map changes.
+    uint32_t capabilities = (cut_period_ms > 0) ? PROTOCOL_CAPABILITIES : (PROTOCOL_CAPABILITIES & ~PROTOCOL_CAP_RESUME);
+    int frame_size = PROTOCOL_encode_hello(frame, HELLO, client_version, capabilities);
+    if(FLEET_send_frame(socket_fd, frame, frame_size) == -1 || FLEET_read_frame(socket_fd, answer, &type) == -1 || type != HELLO_ACK) {
+        return -1;
+    }
+    client->sent++;
+    client->received++;
+    client->sequence = 0;
+    client->sequenced = (PROTOCOL_decode_hello(answer + PROTOCOL_HEAD_SIZE).capabilities & PROTOCOL_CAP_SEQUENCE) != 0;
+    return 0;
+}
+
+static int FLEET_resume(Fleet_Client * client, int socket_fd, Fleet_Move * moves, int * in_flight) {
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    uint8_t answer[MAX_FRAME_SIZE];
+    uint16_t type;
+    // The moves in flight were numbered in the previous connection : the oldest one is done first.
+    uint16_t oldest = (uint16_t)(client->sequence - *in_flight + 1);
+    Protocol_Msg_Resume resume = {client->token, client->map_version, client->moves_done};
+    int frame_size = PROTOCOL_write_resume(frame, &resume);
+    if(FLEET_send_request(client, socket_fd, frame, frame_size) == -1) {
+        return -1;
+    }
+    bool session = false;
+    bool posed = false;
+    while(!posed) {
+        if(FLEET_read_frame(socket_fd, answer, &type) == -1) {
+            return -1;
+        }
+        client->received++;
+        FLEET_count_map_cells(client, answer, type);
+        if(type == SESSION) {
+            Protocol_Msg_Session answer_session = PROTOCOL_read_session(answer + PROTOCOL_payload_offset(PROTOCOL_decode_head(answer)));
+            if(!answer_session.resumed) {
+                client->moves_done = answer_session.moves_done;
+            }
+            client->token = answer_session.token;
+            session = true;
+        }
+        else if(type == MOVE_DONE && session && *in_flight > 0) {
+            FLEET_record_latency(client, moves[oldest % MAX_WINDOW].sent_at);
+            oldest++;
+            (*in_flight)--;
+            client->moves_done++;
+        }
+        posed = session && (type == SET_ROBOT_POSITION || type == SET_ROBOT_POSITION_V2);
+    }
+    // Carto reads the old link to its end before the RESUME : a move not replayed will never be done.
+    client->moves_lost += (uint64_t)*in_flight;
+    *in_flight = 0;
+    return 0;
+}
+
+static int FLEET_reconnect(Fleet_Client * client, int * socket_fd, Fleet_Move * moves, int * in_flight) {
+    uint64_t cut_at = FLEET_now_us();
+    close(*socket_fd);
+    *socket_fd = FLEET_connect(client->port);
+    if(*socket_fd == -1 || FLEET_hello(client, *socket_fd) == -1 || FLEET_resume(client, *socket_fd, moves, in_flight) == -1) {
+        return -1;
+    }
+    uint64_t recovery = FLEET_now_us() - cut_at;
+    client->resumes++;
+    client->resume_us += recovery;
+    client->resume_max_us = (recovery > client->resume_max_us) ? recovery : client->resume_max_us;
+    return 0;
+}
+
+static void FLEET_record_latency(Fleet_Client * client, uint64_t sent_at) {
+    if(client->latency_count == client->latency_capacity) {
+        client->latency_capacity = (client->latency_capacity == 0) ? 1024 : client->latency_capacity * 2;
+        client->latencies = realloc(client->latencies, client->latency_capacity * sizeof(uint64_t));
+    }
+    client->latencies[client->latency_count++] = FLEET_now_us() - sent_at;
+}
+
+static uint64_t FLEET_now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000ULL;
+}
+
+static int FLEET_compare(const void * a, const void * b) {
+    uint64_t left = *(const uint64_t *)a;
+    uint64_t right = *(const uint64_t *)b;
+    return (left > right) - (left < right);
+}
+
+static double FLEET_cpu_time(const struct rusage * usage) {
+    return usage->ru_utime.tv_sec + usage->ru_utime.tv_usec / 1e6 + usage->ru_stime.tv_sec + usage->ru_stime.tv_usec / 1e6;
+}
+
+static void FLEET_report(int robot_count, double elapsed, double cpu_total, double cpu_max) {
+    uint64_t sent = 0, received = 0, map_frames = 0, map_cells = 0;
+    uint64_t snapshot_frames = 0, snapshot_bytes = 0, snapshot_cells = 0, snapshot_us = 0;
+    uint64_t map_gaps = 0, resumes = 0, resume_us = 0, resume_max_us = 0, moves_lost = 0;
+    size_t moves = 0;
+    int failed = 0;
+    for(int i = 0; i < robot_count; i++) {
+        sent += clients[i].sent;
+        received += clients[i].received;
+        moves += clients[i].latency_count;
+        map_frames += clients[i].map_frames;
+        map_cells += clients[i].map_cells;
+        snapshot_frames += clients[i].snapshot_frames;
+        snapshot_bytes += clients[i].snapshot_bytes;
+        snapshot_cells += clients[i].snapshot_cells;
+        snapshot_us = (clients[i].snapshot_us > snapshot_us) ? clients[i].snapshot_us : snapshot_us;
+        map_gaps += clients[i].map_gaps;
+        resumes += clients[i].resumes;
+        resume_us += clients[i].resume_us;
+        resume_max_us = (clients[i].resume_max_us > resume_max_us) ? clients[i].resume_max_us : resume_max_us;
+        moves_lost += clients[i].moves_lost;
+        failed += clients[i].failed ? 1 : 0;
+    }
+    uint64_t * latencies = malloc((moves > 0 ? moves : 1) * sizeof(uint64_t));
+    size_t count = 0;
+    for(int i = 0; i < robot_count; i++) {
+        memcpy(latencies + count, clients[i].latencies, clients[i].latency_count * sizeof(uint64_t));
+        count += clients[i].latency_count;
+    }
+    qsort(latencies, count, sizeof(uint64_t), FLEET_compare);
+
+    printf("\n-------------- FLEET REPORT -----------------\n");
+    printf("Robots            : %d (%d failed)\n", robot_count, failed);
+    printf("Duration          : %.2f s\n", elapsed);
+    printf("Frames            : %llu sent, %llu received\n", (unsigned long long)sent, (unsigned long long)received);
+    printf("Message rate      : %.0f frames/s (%.0f moves/s)\n", (sent + received) / elapsed, moves / elapsed);
+    printf("Map updates       : %llu cells in %llu frames\n", (unsigned long long)map_cells, (unsigned long long)map_frames);
+    if(snapshot_frames > 0) {
+        printf("Map snapshots     : %llu known cells in %llu frames, %llu bytes, %llu us max\n",
+               (unsigned long long)snapshot_cells, (unsigned long long)snapshot_frames,
+               (unsigned long long)snapshot_bytes, (unsigned long long)snapshot_us);
+    }
+    if(resumes > 0) {
+        printf("Resumed sessions  : %llu, recovery %llu us average, %llu us max\n", (unsigned long long)resumes,
+               (unsigned long long)(resume_us / resumes), (unsigned long long)resume_max_us);
+        printf("Lost on the cuts  : %llu moves, %llu map versions skipped\n", (unsigned long long)moves_lost, (unsigned long long)map_gaps);
+    }
+    if(cpu_max >= 0.0) {
+        printf("CPU per robot     : %.2f %% average, %.2f %% max\n", 100.0 * cpu_total / robot_count / elapsed, 100.0 * cpu_max / elapsed);
+    }
+    else {
+        printf("CPU per robot     : %.2f %% average (clients included)\n", 100.0 * cpu_total / robot_count / elapsed);
+    }
+    if(count > 0) {
+        printf("Move latency (us) : p50 %llu, p90 %llu, p99 %llu, max %llu\n",
+               (unsigned long long)latencies[count / 2],
+               (unsigned long long)latencies[(count * 9) / 10],
+               (unsigned long long)latencies[(count * 99) / 100],
+               (unsigned long long)latencies[count - 1]);
+    }
+    free(latencies);
+}
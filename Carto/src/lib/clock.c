@@ -0,0 +1,182 @@
+/**
+ * \file  clock.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Source file of the clock module. Every delay and timestamp of Carto goes through it.
+ *
+ * \see clock.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "clock.h"
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def BUSY_WAIT_LIMIT_US
+ * Under this delay, CLOCK_REAL spins instead of sleeping (same behaviour as wiringPi's delayMicroseconds).
+ */
+#define BUSY_WAIT_LIMIT_US 100
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static uint64_t real_now_us(void)
+ * \brief Reads the monotonic wall clock.
+ *
+ * \return uint64_t : monotonic time in microseconds.
+ */
+static uint64_t real_now_us(void);
+/**
+ * \fn static void real_sleep_us(uint64_t us)
+ * \brief Sleeps on the wall clock, spinning for the very short delays.
+ *
+ * \param us : delay in microseconds.
+ */
+static void real_sleep_us(uint64_t us);
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static Clock_Mode mode
+ * \brief Current time base.
+ */
+static Clock_Mode mode = CLOCK_REAL;
+/**
+ * \var static double scale
+ * \brief Virtual seconds per real second (0 : instant).
+ */
+static double scale = 0.0;
+/**
+ * \var static uint64_t real_epoch_us
+ * \brief Wall clock time matching the clock time 0.
+ */
+static uint64_t real_epoch_us = 0;
+/**
+ * \var static uint64_t virtual_offset_us
+ * \brief Virtual time accumulated by the delays and CLOCK_advance_us().
+ */
+static uint64_t virtual_offset_us = 0;
+/**
+ * \var static pthread_mutex_t clock_mutex
+ * \brief Mutex protecting the time base shared by all the threads.
+ */
+static pthread_mutex_t clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+void CLOCK_set_mode(Clock_Mode new_mode, double new_scale) {
+    pthread_mutex_lock(&clock_mutex);
+    mode = new_mode;
+    scale = (new_scale > 0.0) ? new_scale : 0.0;
+    real_epoch_us = real_now_us();
+    virtual_offset_us = 0;
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+Clock_Mode CLOCK_get_mode(void) {
+    Clock_Mode current;
+    pthread_mutex_lock(&clock_mutex);
+    current = mode;
+    pthread_mutex_unlock(&clock_mutex);
+    return current;
+}
+
+void CLOCK_delay_ms(unsigned int ms) {
+    CLOCK_delay_us(ms * 1000U);
+}
+
+void CLOCK_delay_us(unsigned int us) {
+    pthread_mutex_lock(&clock_mutex);
+    Clock_Mode current = mode;
+    double current_scale = scale;
+    if(current == CLOCK_VIRTUAL && current_scale == 0.0) {
+        virtual_offset_us += us;
+    }
+    pthread_mutex_unlock(&clock_mutex);
+
+    if(current == CLOCK_REAL) {
+        real_sleep_us(us);
+    }
+    else if(current_scale > 0.0) {
+        real_sleep_us((uint64_t)(us / current_scale));
+    }
+}
+
+uint64_t CLOCK_micros(void) {
+    uint64_t now;
+    pthread_mutex_lock(&clock_mutex);
+    if(real_epoch_us == 0) {
+        real_epoch_us = real_now_us();
+    }
+    if(mode == CLOCK_REAL) {
+        now = real_now_us() - real_epoch_us;
+    }
+    else if(scale == 0.0) {
+        now = virtual_offset_us;
+    }
+    else {
+        now = virtual_offset_us + (uint64_t)((real_now_us() - real_epoch_us) * scale);
+    }
+    pthread_mutex_unlock(&clock_mutex);
+    return now;
+}
+
+void CLOCK_advance_us(uint64_t us) {
+    pthread_mutex_lock(&clock_mutex);
+    if(mode == CLOCK_VIRTUAL) {
+        virtual_offset_us += us;
+    }
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+uint64_t CLOCK_real_micros(void) {
+    return real_now_us();
+}
+
+void CLOCK_real_delay_us(unsigned int us) {
+    real_sleep_us(us);
+}
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+static uint64_t real_now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000ULL;
+}
+
+static void real_sleep_us(uint64_t us) {
+    if(us < BUSY_WAIT_LIMIT_US) {
+        uint64_t end = real_now_us() + us;
+        while(real_now_us() < end);
+        return;
+    }
+    struct timespec request = {
+        .tv_sec = (time_t)(us / 1000000ULL),
+        .tv_nsec = (long)((us % 1000000ULL) * 1000ULL)
+    };
+    while(nanosleep(&request, &request) == -1 && errno == EINTR);
+}
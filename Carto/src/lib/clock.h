@@ -0,0 +1,126 @@
+/**
+ * \file  clock.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the clock module. Every delay and timestamp of Carto goes through it.
+ *
+ * The clock runs either on the wall clock (CLOCK_REAL) or on a virtual time base (CLOCK_VIRTUAL).
+ * The virtual time base is advanced instantly by the delays (scale 0) or runs "scale" times faster
+ * than the wall clock, so that a whole mission can be replayed in a few seconds with deterministic timings.
+ * The hardware drivers time their physical signals (ultrasound pulses) with CLOCK_real_micros() and
+ * CLOCK_real_delay_us(), which always follow the wall clock : only the simulator reads the virtual time for them.
+ *
+ * \see clock.c
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef SRC_LIB_CLOCK_H_
+#define SRC_LIB_CLOCK_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <stdint.h>
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \enum Clock_Mode
+ * \brief Defines the time bases of the clock.
+ */
+typedef enum {
+    CLOCK_REAL = 0,     /**< CLOCK_REAL : delays and timestamps follow the wall clock. */
+    CLOCK_VIRTUAL       /**< CLOCK_VIRTUAL : delays and timestamps follow the virtual time base. */
+} Clock_Mode;
+/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/* ----------------------  PUBLIC VARIABLES -----------------------------------*/
+/* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern void CLOCK_set_mode(Clock_Mode mode, double scale)
+ * \brief Selects the time base of the clock. The virtual time restarts from 0.
+ * \author Thomas ROCHER
+ *
+ * \param mode : time base to use.
+ * \param scale : CLOCK_VIRTUAL only. Virtual seconds elapsed per real second (100.0 runs 100 times faster).
+ * 0 makes every delay return immediately after having advanced the virtual time.
+ */
+extern void CLOCK_set_mode(Clock_Mode mode, double scale);
+/**
+ * \fn extern Clock_Mode CLOCK_get_mode(void)
+ * \brief Gives the time base of the clock.
+ * \author Thomas ROCHER
+ *
+ * \return Clock_Mode : current time base.
+ */
+extern Clock_Mode CLOCK_get_mode(void);
+/**
+ * \fn extern void CLOCK_delay_ms(unsigned int ms)
+ * \brief Waits for ms milliseconds of clock time.
+ * \author Thomas ROCHER
+ *
+ * \param ms : delay in milliseconds.
+ */
+extern void CLOCK_delay_ms(unsigned int ms);
+/**
+ * \fn extern void CLOCK_delay_us(unsigned int us)
+ * \brief Waits for us microseconds of clock time.
+ * \author Thomas ROCHER
+ *
+ * \param us : delay in microseconds.
+ */
+extern void CLOCK_delay_us(unsigned int us);
+/**
+ * \fn extern uint64_t CLOCK_micros(void)
+ * \brief Gives the clock time.
+ * \author Thomas ROCHER
+ *
+ * \return uint64_t : microseconds elapsed since the last CLOCK_set_mode() (or the first call in CLOCK_REAL).
+ */
+extern uint64_t CLOCK_micros(void);
+/**
+ * \fn extern void CLOCK_advance_us(uint64_t us)
+ * \brief Moves the virtual time forward without waiting. No effect in CLOCK_REAL.
+ * \author Thomas ROCHER
+ *
+ * \param us : amount of virtual time to skip, in microseconds.
+ */
+extern void CLOCK_advance_us(uint64_t us);
+/**
+ * \fn extern uint64_t CLOCK_real_micros(void)
+ * \brief Gives the monotonic wall clock, whatever the time base. For the drivers timing physical signals.
+ * \author Thomas ROCHER
+ *
+ * \return uint64_t : monotonic time in microseconds (arbitrary origin : only differences are meaningful).
+ */
+extern uint64_t CLOCK_real_micros(void);
+/**
+ * \fn extern void CLOCK_real_delay_us(unsigned int us)
+ * \brief Waits for us microseconds of wall clock time, whatever the time base. For the drivers driving physical signals.
+ * \author Thomas ROCHER
+ *
+ * \param us : delay in microseconds.
+ */
+extern void CLOCK_real_delay_us(unsigned int us);
+
+#endif /* SRC_LIB_CLOCK_H_ */
@@ -0,0 +1,88 @@
+/**
+ * \file  motor_sim.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Simulated motor peripheral. Same API and timings as alphabot2/motor.c, moves the robot in the simulated world.
+ *
+ * \see motor.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "../alphabot2/motor.h"
+#include "../lib/clock.h"
+#include "world.h"
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def VELOCITY_DEFAULT
+ * Default velocity, in cm per second.
+ */
+#define VELOCITY_DEFAULT 35
+/**
+ * \def CELL_SIZE_CM
+ * Distance covered by a FORWARD command.
+ */
+#define CELL_SIZE_CM 12.0
+/**
+ * \def RIGHT_DURATION_MS
+ * Duration of a RIGHT rotation.
+ */
+#define RIGHT_DURATION_MS 128
+/**
+ * \def LEFT_DURATION_MS
+ * Duration of a LEFT rotation.
+ */
+#define LEFT_DURATION_MS 205
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+int MOTOR_create(void) {
+    return 0;
+}
+
+void MOTOR_set_command(Command cmd) {
+    MOTOR_set_unit_command(0, cmd);
+}
+
+void MOTOR_set_unit_command(int unit, Command cmd) {
+    switch (cmd) {
+        case RIGHT : CLOCK_delay_ms(RIGHT_DURATION_MS); break;
+        case LEFT : CLOCK_delay_ms(LEFT_DURATION_MS); break;
+        case FORWARD : CLOCK_delay_ms((unsigned int)(CELL_SIZE_CM / VELOCITY_DEFAULT * 1500)); break;
+        default : break;
+    }
+    SIMWORLD_apply_command(SIMWORLD_get_unit_robot(unit), cmd);
+}
+
+int MOTOR_destroy(void) {
+    return 0;
+}
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
@@ -0,0 +1,66 @@
+/**
+ * \file  ultrasound_sim.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Simulated ultrasound peripheral. Same API as alphabot2/ultrasound.c, looks at the simulated world.
+ *
+ * \see ultrasound.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "../alphabot2/ultrasound.h"
+#include "../lib/clock.h"
+#include "world.h"
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def ECHO_DURATION_US
+ * Round trip of the sound up to the 12cm detection limit (distance = travel time / 58).
+ */
+#define ECHO_DURATION_US (12 * 58)
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+void ULTRASOUND_create() {
+    CLOCK_delay_ms(30);
+}
+
+bool ULTRASOUND_check_obstacle() {
+    return ULTRASOUND_check_unit_obstacle(0);
+}
+
+bool ULTRASOUND_check_unit_obstacle(int unit) {
+    CLOCK_delay_us(ECHO_DURATION_US);
+    return SIMWORLD_is_obstacle_ahead(SIMWORLD_get_unit_robot(unit));
+}
+
+void ULTRASOUND_destroy() {}
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
@@ -0,0 +1,271 @@
+/**
+ * \file  world.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Source file of the simulated world. Grid shared by every simulated robot of the fleet.
+ *
+ * \see world.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "world.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def SIMWORLD_MAX_ROBOTS
+ * Max amount of robots in the world.
+ */
+#define SIMWORLD_MAX_ROBOTS 1024
+/**
+ * \def SIMWORLD_MAX_LINE
+ * Max length of a line of a world file.
+ */
+#define SIMWORLD_MAX_LINE 4096
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/**
+ * \struct World world.c "simulator/world.c"
+ * \brief Shared memory layout of the world.
+ */
+typedef struct {
+    int rows;                               /**< Number of rows (x axis). */
+    int cols;                               /**< Number of columns (y axis). */
+    int robot_count;                        /**< Number of robots placed in the world. */
+    Position robots[SIMWORLD_MAX_ROBOTS];   /**< Real pose of each robot, written only by the robot itself. */
+    uint8_t cells[];                        /**< Row-major cells, 1 for an obstacle. */
+} World;
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static int SIMWORLD_allocate(int rows, int cols)
+ * \brief Maps the shared memory of a world of rows x cols free cells.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int SIMWORLD_allocate(int rows, int cols);
+/**
+ * \fn static bool SIMWORLD_is_free(int coord_x, int coord_y, int ignored_robot)
+ * \brief Tells if a cell is inside the world, without wall and without robot (ignored_robot excepted).
+ */
+static bool SIMWORLD_is_free(int coord_x, int coord_y, int ignored_robot);
+/**
+ * \fn static void SIMWORLD_cell_ahead(Position pose, int * coord_x, int * coord_y)
+ * \brief Gives the cell in front of a pose.
+ */
+static void SIMWORLD_cell_ahead(Position pose, int * coord_x, int * coord_y);
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static World * world
+ * \brief Shared world, inherited by the forked robots.
+ */
+static World * world = NULL;
+/**
+ * \var static size_t world_size
+ * \brief Size of the shared mapping.
+ */
+static size_t world_size = 0;
+/**
+ * \var static int selected_robot
+ * \brief Robot driven by the unit 0 of the simulated peripherals of this process.
+ */
+static int selected_robot = 0;
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+int SIMWORLD_create(int rows, int cols, int obstacle_percent, unsigned int seed) {
+    if(SIMWORLD_allocate(rows, cols) == -1) {
+        return -1;
+    }
+    for(int x = 0; x < rows; x++) {
+        for(int y = 0; y < cols; y++) {
+            bool border = (x == 0 || y == 0 || x == rows - 1 || y == cols - 1);
+            world->cells[x * cols + y] = (border || (int)(rand_r(&seed) % 100) < obstacle_percent) ? 1 : 0;
+        }
+    }
+    return 0;
+}
+
+int SIMWORLD_load(const char * path) {
+    FILE * file = fopen(path, "r");
+    if(file == NULL) {
+        perror("fopen() failed");
+        return -1;
+    }
+    char line[SIMWORLD_MAX_LINE];
+    int rows = 0;
+    int cols = 0;
+    while(fgets(line, sizeof(line), file) != NULL) {
+        int length = (int)strcspn(line, "\r\n");
+        cols = (length > cols) ? length : cols;
+        rows++;
+    }
+    if(rows == 0 || cols == 0 || SIMWORLD_allocate(rows, cols) == -1) {
+        fclose(file);
+        return -1;
+    }
+    rewind(file);
+    for(int x = 0; x < rows && fgets(line, sizeof(line), file) != NULL; x++) {
+        int length = (int)strcspn(line, "\r\n");
+        for(int y = 0; y < length; y++) {
+            world->cells[x * cols + y] = (line[y] == '#') ? 1 : 0;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+int SIMWORLD_destroy(void) {
+    if(world != NULL && munmap(world, world_size) == -1) {
+        perror("munmap() failed");
+        return -1;
+    }
+    world = NULL;
+    return 0;
+}
+
+int SIMWORLD_add_robot(Position * start_pose) {
+    if(world->robot_count >= SIMWORLD_MAX_ROBOTS) {
+        return -1;
+    }
+    int start = start_pose->coord_x * world->cols + start_pose->coord_y;
+    int area = world->rows * world->cols;
+    for(int i = 0; i < area; i++) {
+        int cell = (start + i) % area;
+        if(SIMWORLD_is_free(cell / world->cols, cell % world->cols, -1)) {
+            start_pose->coord_x = cell / world->cols;
+            start_pose->coord_y = cell % world->cols;
+            world->robots[world->robot_count] = *start_pose;
+            return world->robot_count++;
+        }
+    }
+    return -1;
+}
+
+void SIMWORLD_select_robot(int robot_id) {
+    selected_robot = robot_id;
+}
+
+int SIMWORLD_get_unit_robot(int unit) {
+    return selected_robot + unit;
+}
+
+bool SIMWORLD_is_obstacle_ahead(int robot_id) {
+    int coord_x, coord_y;
+    SIMWORLD_cell_ahead(world->robots[robot_id], &coord_x, &coord_y);
+    return !SIMWORLD_is_free(coord_x, coord_y, robot_id);
+}
+
+void SIMWORLD_apply_command(int robot_id, Command cmd) {
+    Position * pose = &world->robots[robot_id];
+    switch(cmd) {
+        case FORWARD :
+        {
+            int coord_x, coord_y;
+            SIMWORLD_cell_ahead(*pose, &coord_x, &coord_y);
+            if(SIMWORLD_is_free(coord_x, coord_y, robot_id)) {
+                pose->coord_x = coord_x;
+                pose->coord_y = coord_y;
+            }
+            break;
+        }
+        /* Same rotations as the pilot. */
+        case LEFT :
+        {
+            switch(pose->dir) {
+                case SOUTH : pose->dir = EAST; break;
+                case NORTH : pose->dir = WEST; break;
+                case WEST : pose->dir = SOUTH; break;
+                case EAST : pose->dir = NORTH; break;
+                default : break;
+            }
+            break;
+        }
+        case RIGHT :
+        {
+            switch(pose->dir) {
+                case SOUTH : pose->dir = WEST; break;
+                case NORTH : pose->dir = EAST; break;
+                case WEST : pose->dir = NORTH; break;
+                case EAST : pose->dir = SOUTH; break;
+                default : break;
+            }
+            break;
+        }
+        default :
+        {
+            break;
+        }
+    }
+}
+
+Position SIMWORLD_get_robot_pose(int robot_id) {
+    return world->robots[robot_id];
+}
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+static int SIMWORLD_allocate(int rows, int cols) {
+    world_size = sizeof(World) + (size_t)rows * (size_t)cols;
+    world = mmap(NULL, world_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(world == MAP_FAILED) {
+        perror("mmap() failed");
+        world = NULL;
+        return -1;
+    }
+    world->rows = rows;
+    world->cols = cols;
+    world->robot_count = 0;
+    return 0;
+}
+
+static bool SIMWORLD_is_free(int coord_x, int coord_y, int ignored_robot) {
+    if(coord_x < 0 || coord_y < 0 || coord_x >= world->rows || coord_y >= world->cols) {
+        return false;
+    }
+    if(world->cells[coord_x * world->cols + coord_y] != 0) {
+        return false;
+    }
+    for(int i = 0; i < world->robot_count; i++) {
+        if(i != ignored_robot && world->robots[i].coord_x == coord_x && world->robots[i].coord_y == coord_y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void SIMWORLD_cell_ahead(Position pose, int * coord_x, int * coord_y) {
+    *coord_x = pose.coord_x;
+    *coord_y = pose.coord_y;
+    switch(pose.dir) {
+        case SOUTH : (*coord_x)++; break;
+        case NORTH : (*coord_x)--; break;
+        case WEST : (*coord_y)--; break;
+        case EAST : (*coord_y)++; break;
+        default : break;
+    }
+}
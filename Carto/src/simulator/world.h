@@ -0,0 +1,131 @@
+/**
+ * \file  world.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the simulated world. Grid shared by every simulated robot of the fleet.
+ *
+ * The world is allocated in shared memory before the robots are forked, so each robot process
+ * sees the walls and the current pose of the other robots.
+ *
+ * \see world.c
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef SRC_SIMULATOR_WORLD_H_
+#define SRC_SIMULATOR_WORLD_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <stdbool.h>
+#include "../lib/defs.h"
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/* ----------------------  PUBLIC VARIABLES -----------------------------------*/
+/* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern int SIMWORLD_create(int rows, int cols, int obstacle_percent, unsigned int seed)
+ * \brief Creates a walled world with random obstacles.
+ * \author Thomas ROCHER
+ *
+ * \param rows : number of rows (x axis).
+ * \param cols : number of columns (y axis).
+ * \param obstacle_percent : percentage of inner cells turned into obstacles.
+ * \param seed : seed of the obstacle generator (same seed, same world).
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int SIMWORLD_create(int rows, int cols, int obstacle_percent, unsigned int seed);
+/**
+ * \fn extern int SIMWORLD_load(const char * path)
+ * \brief Creates the world from a text file. One line per row, '#' for an obstacle, any other character for a free cell.
+ * \author Thomas ROCHER
+ *
+ * \param path : path of the world file.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int SIMWORLD_load(const char * path);
+/**
+ * \fn extern int SIMWORLD_destroy(void)
+ * \brief Releases the world.
+ * \author Thomas ROCHER
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+extern int SIMWORLD_destroy(void);
+/**
+ * \fn extern int SIMWORLD_add_robot(Position * start_pose)
+ * \brief Places a new robot on the first free cell found from start_pose, scanning row by row.
+ * \author Thomas ROCHER
+ *
+ * \param start_pose : wished start pose, updated with the pose actually given.
+ *
+ * \return The robot identifier on success, -1 when the world is full.
+ */
+extern int SIMWORLD_add_robot(Position * start_pose);
+/**
+ * \fn extern void SIMWORLD_select_robot(int robot_id)
+ * \brief Selects the robot driven by the unit 0 of the simulated motor and ultrasound of this process.
+ * The unit n drives the robot robot_id + n.
+ * \author Thomas ROCHER
+ *
+ * \param robot_id : identifier given by SIMWORLD_add_robot().
+ */
+extern void SIMWORLD_select_robot(int robot_id);
+/**
+ * \fn extern int SIMWORLD_get_unit_robot(int unit)
+ * \brief Gives the robot driven by a motor and ultrasound unit.
+ * \author Thomas ROCHER
+ */
+extern int SIMWORLD_get_unit_robot(int unit);
+/**
+ * \fn extern bool SIMWORLD_is_obstacle_ahead(int robot_id)
+ * \brief Tells if the cell in front of a robot is a wall, another robot or out of the world.
+ * \author Thomas ROCHER
+ */
+extern bool SIMWORLD_is_obstacle_ahead(int robot_id);
+/**
+ * \fn extern void SIMWORLD_apply_command(int robot_id, Command cmd)
+ * \brief Moves a robot. FORWARD is ignored when the cell ahead is not free.
+ * \author Thomas ROCHER
+ *
+ * \param robot_id : identifier given by SIMWORLD_add_robot().
+ * \param cmd : command performed by the motors.
+ */
+extern void SIMWORLD_apply_command(int robot_id, Command cmd);
+/**
+ * \fn extern Position SIMWORLD_get_robot_pose(int robot_id)
+ * \brief Gives the real pose of a robot.
+ * \author Thomas ROCHER
+ *
+ * \param robot_id : identifier given by SIMWORLD_add_robot().
+ *
+ * \return Position : pose of the robot.
+ */
+extern Position SIMWORLD_get_robot_pose(int robot_id);
+
+#endif /* SRC_SIMULATOR_WORLD_H_ */
@@ -44,6 +44,7 @@
 #include "com/postman.h"
 #include "com/dispatcher.h"
 #include "lib/defs.h"
+#include "lib/clock.h"
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
 /* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
 /* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
@@ -56,6 +57,15 @@ typedef enum {
     LOG_STOP = 'q',
 } log_key_e;
 /* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static int STARTER_parse_options(int argc, char * argv[])
+ * \brief Reads the command line options.
+ * -v scale : runs on the virtual clock, scale times faster than real time (0 : instant delays).
+ * \author Thomas ROCHER.
+ *
+ * \return On success, returns 0. On error, returns -1.
+ */
+static int STARTER_parse_options(int argc, char * argv[]);
 /**
  * \fn static void STARTER_capture_choice(void)
  * \brief Capture the user key entry.
@@ -85,6 +95,9 @@ static bool_e quit_case = FALSE;
 int main (int argc, char * argv[])
 {
 	printf("Hello swarmbots\n\n");
+    if(STARTER_parse_options(argc, argv) == -1) {
+        return -1;
+    }
     /* MODULE CREATION */
     if(POSTMAN_create() == -1) {
         printf("ERROR on postman creation.\n");
@@ -118,6 +131,26 @@ int main (int argc, char * argv[])
     return -1;
 }
 
+static int STARTER_parse_options(int argc, char * argv[]) {
+    int option;
+    while((option = getopt(argc, argv, "v:")) != -1) {
+        switch(option) {
+            case 'v':
+            {
+                CLOCK_set_mode(CLOCK_VIRTUAL, atof(optarg));
+                printf("Virtual clock, scale %s\n", optarg);
+                break;
+            }
+            default:
+            {
+                printf("Usage : %s [-v scale]\n", argv[0]);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
 static void STARTER_capture_choice(void) {
     struct termios oldt, newt;
     tcgetattr(STDIN_FILENO, &oldt);
@@ -0,0 +1,208 @@
+/**
+ * \file  clock_check.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Checks of the clock module : the virtual time base must advance deterministically.
+ *
+ * Scale 0 : every delay and CLOCK_advance_us() moves the virtual time by exactly its amount, without
+ * waiting, even from several threads at once. Scale N : the delays wait N times less than their amount
+ * and the virtual time follows. CLOCK_REAL and the CLOCK_real_* functions follow the wall clock whatever
+ * the mode. Runs without any hardware : make -C Carto check.
+ *
+ * \see clock.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "lib/clock.h"
+/* ----------------------  PRIVATE CONFIGURATIONS ----------------------------*/
+/**
+ * \def THREADS
+ * Threads delaying at the same time on the virtual time base.
+ */
+#define THREADS 4
+/**
+ * \def DELAYS_PER_THREAD
+ * Delays of DELAY_MS made by each thread.
+ */
+#define DELAYS_PER_THREAD 25000
+/**
+ * \def DELAY_MS
+ * Delay of each step of the threads.
+ */
+#define DELAY_MS 10
+/**
+ * \def INSTANT_LIMIT_US
+ * Longest wall clock time allowed for the delays at scale 0 (they must not wait).
+ */
+#define INSTANT_LIMIT_US 2000000ULL
+/**
+ * \def SCALE
+ * Speed of the virtual time base in the scaled checks.
+ */
+#define SCALE 50.0
+/* ----------------------  PRIVATE VARIABLES ---------------------------------*/
+/**
+ * \var static int failures
+ * \brief Amount of failed checks.
+ */
+static int failures = 0;
+/* ----------------------  PRIVATE FUNCTIONS  --------------------------------*/
+/**
+ * \fn static void check(int condition, const char * what)
+ * \brief Counts and prints a failed check.
+ * \author Thomas ROCHER
+ */
+static void check(int condition, const char * what) {
+    if(!condition) {
+        failures++;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+/**
+ * \fn static void * delay_steps(void * unused)
+ * \brief Makes DELAYS_PER_THREAD delays of DELAY_MS.
+ * \author Thomas ROCHER
+ */
+static void * delay_steps(void * unused) {
+    (void)unused;
+    for(int i = 0; i < DELAYS_PER_THREAD; i++) {
+        CLOCK_delay_ms(DELAY_MS);
+    }
+    return NULL;
+}
+/**
+ * \fn static void check_instant(void)
+ * \brief Scale 0 : the virtual time is the exact sum of the delays and advances, and nothing waits.
+ * \author Thomas ROCHER
+ */
+static void check_instant(void) {
+    uint64_t real_start = CLOCK_real_micros();
+    CLOCK_set_mode(CLOCK_VIRTUAL, 0.0);
+    check(CLOCK_get_mode() == CLOCK_VIRTUAL, "virtual mode selected");
+    check(CLOCK_micros() == 0, "virtual time restarts from 0");
+
+    CLOCK_delay_ms(1000);
+    check(CLOCK_micros() == 1000000ULL, "delay_ms advances by its amount");
+    CLOCK_delay_us(250);
+    check(CLOCK_micros() == 1000250ULL, "delay_us advances by its amount");
+    CLOCK_advance_us(5000000ULL);
+    check(CLOCK_micros() == 6000250ULL, "advance_us advances by its amount");
+    check(CLOCK_micros() == 6000250ULL, "virtual time stands still between delays");
+
+    // Des délais concurrents s'additionnent sans en perdre : la même mission donne toujours le même temps.
+    pthread_t threads[THREADS];
+    for(int t = 0; t < THREADS; t++) {
+        pthread_create(&threads[t], NULL, delay_steps, NULL);
+    }
+    for(int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    check(CLOCK_micros() == 6000250ULL + (uint64_t)THREADS * DELAYS_PER_THREAD * DELAY_MS * 1000ULL, "concurrent delays add up exactly");
+
+    // Plus de 11 jours virtuels : aucun ne doit avoir été attendu.
+    check(CLOCK_real_micros() - real_start < INSTANT_LIMIT_US, "delays at scale 0 do not wait");
+
+    CLOCK_set_mode(CLOCK_VIRTUAL, 0.0);
+    check(CLOCK_micros() == 0, "set_mode restarts the virtual time");
+}
+/**
+ * \fn static void check_scaled(void)
+ * \brief Scale N : a delay waits N times less than its amount, and the virtual time follows the wall clock N times faster.
+ * \author Thomas ROCHER
+ */
+static void check_scaled(void) {
+    CLOCK_set_mode(CLOCK_VIRTUAL, SCALE);
+    uint64_t real_start = CLOCK_real_micros();
+    uint64_t virtual_start = CLOCK_micros();
+    CLOCK_delay_ms(1000);
+    uint64_t real_elapsed = CLOCK_real_micros() - real_start;
+    uint64_t virtual_elapsed = CLOCK_micros() - virtual_start;
+    check(real_elapsed >= (uint64_t)(1000000.0 / SCALE), "scaled delay waits its amount divided by the scale");
+    check(real_elapsed < 1000000ULL / 2, "scaled delay waits less than its amount");
+    check(virtual_elapsed >= 1000000ULL, "virtual time covers the scaled delay");
+    // Marge pour l'ordonnanceur : le temps virtuel ne dépasse pas le temps réel écoulé fois l'échelle.
+    check(virtual_elapsed <= (uint64_t)((CLOCK_real_micros() - real_start) * SCALE) + 1, "virtual time runs at the scale");
+
+    uint64_t before = CLOCK_micros();
+    CLOCK_advance_us(3000000ULL);
+    check(CLOCK_micros() >= before + 3000000ULL, "advance_us adds to the scaled time");
+}
+/**
+ * \fn static void check_real(void)
+ * \brief CLOCK_REAL : delays wait their amount and CLOCK_advance_us() has no effect.
+ * \author Thomas ROCHER
+ */
+static void check_real(void) {
+    CLOCK_set_mode(CLOCK_REAL, 0.0);
+    check(CLOCK_get_mode() == CLOCK_REAL, "real mode selected");
+    uint64_t start = CLOCK_micros();
+    uint64_t real_start = CLOCK_real_micros();
+    CLOCK_delay_ms(20);
+    check(CLOCK_micros() - start >= 20000ULL, "real delay waits its amount");
+    check(CLOCK_real_micros() - real_start >= 20000ULL, "real delay follows the wall clock");
+
+    uint64_t before = CLOCK_micros();
+    CLOCK_advance_us(10000000ULL);
+    check(CLOCK_micros() - before < 10000000ULL, "advance_us has no effect in real mode");
+}
+/**
+ * \fn static void check_wall_clock(void)
+ * \brief CLOCK_real_* follow the wall clock even on the virtual time base (hardware drivers).
+ * \author Thomas ROCHER
+ */
+static void check_wall_clock(void) {
+    CLOCK_set_mode(CLOCK_VIRTUAL, 0.0);
+    uint64_t real_start = CLOCK_real_micros();
+    CLOCK_real_delay_us(5000);
+    check(CLOCK_real_micros() - real_start >= 5000ULL, "real_delay_us waits on the virtual time base");
+    check(CLOCK_micros() == 0, "real_delay_us does not move the virtual time");
+}
+/* ----------------------  PUBLIC FUNCTIONS  ---------------------------------*/
+/**
+ * \fn int main(void)
+ * \brief Runs every check.
+ * \author Thomas ROCHER
+ *
+ * \return 0 when every check passed, 1 otherwise.
+ */
+int main(void) {
+    check_instant();
+    check_scaled();
+    check_real();
+    check_wall_clock();
+    printf("%s\n", failures ? "FAILED" : "OK");
+    if(failures) {
+        fprintf(stderr, "%d failed checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * \file  mapper_check.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Checks of the mapper : which observations of a cell go out in MAP_DELTA.
+ *
+ * A client with PROTOCOL_CAP_OBSERVATIONS accumulates the observations (log-odds) : it must get every one of them, in
+ * order, repeated ones included, or a cell seen free once then occupied once never converges. A client without it keeps
+ * the last value of a cell : it only gets the changes. The proxy and the postman are replaced by fakes recording the
+ * MAP_DELTA cells. Runs without any hardware : make -C Carto check.
+ *
+ * \see mapper.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include "controller/mapper.h"
+#include "com/proxyMap.h"
+/* ----------------------  PRIVATE CONFIGURATIONS ----------------------------*/
+/**
+ * \def MAX_SENT
+ * Max amount of MAP_DELTA cells recorded by a check.
+ */
+#define MAX_SENT 1024
+/**
+ * \def REPEATS
+ * Observations of the same cell in a row, more than a MAP_DELTA holds.
+ */
+#define REPEATS (PROTOCOL_MAX_DELTA_CELLS + 10)
+/* ----------------------  PRIVATE VARIABLES ---------------------------------*/
+/**
+ * \var static int failures
+ * \brief Amount of failed checks.
+ */
+static int failures = 0;
+/**
+ * \var static uint32_t capabilities
+ * \brief Capabilities of the fake session.
+ */
+static uint32_t capabilities = 0;
+/**
+ * \var static Protocol_Cell sent[MAX_SENT]
+ * \brief Cells of the MAP_DELTA sent since sent_count was reset, in order.
+ */
+static Protocol_Cell sent[MAX_SENT];
+/**
+ * \var static int sent_count
+ * \brief Amount of cells in sent.
+ */
+static int sent_count = 0;
+/* ----------------------  FAKES  --------------------------------------------*/
+// Le proxy et le postman de la session : seules les cellules des MAP_DELTA sont gardées.
+uint32_t POSTMAN_instance_get_capabilities(Postman * postman) {
+    (void)postman;
+    return capabilities;
+}
+
+void PROXYMAP_instance_map_delta(Postman * postman, uint32_t map_version, const Protocol_Cell * cells, int count) {
+    (void)postman;
+    (void)map_version;
+    for(int i = 0; i < count && sent_count < MAX_SENT; i++) {
+        sent[sent_count++] = cells[i];
+    }
+}
+
+void PROXYMAP_instance_set_obstacle_position(Postman * postman, int coord_x, int coord_y) {
+    (void)postman;
+    (void)coord_x;
+    (void)coord_y;
+}
+
+void PROXYMAP_instance_map_snapshot_chunk(Postman * postman, Protocol_Snapshot_Head * head, const uint8_t * cells) {
+    (void)postman;
+    (void)cells;
+    head->cell_count = 0;
+}
+/* ----------------------  PRIVATE FUNCTIONS  --------------------------------*/
+/**
+ * \fn static void check(int condition, const char * what)
+ * \brief Counts and prints a failed check.
+ * \author Thomas ROCHER
+ */
+static void check(int condition, const char * what) {
+    if(!condition) {
+        failures++;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+/**
+ * \fn static int count_sent(int coord_x, int coord_y, Protocol_Cell_Value value)
+ * \brief Amount of cells (coord_x, coord_y) sent with value.
+ * \author Thomas ROCHER
+ */
+static int count_sent(int coord_x, int coord_y, Protocol_Cell_Value value) {
+    int count = 0;
+    for(int i = 0; i < sent_count; i++) {
+        if(sent[i].coord_x == coord_x && sent[i].coord_y == coord_y && sent[i].value == (uint8_t)value) {
+            count++;
+        }
+    }
+    return count;
+}
+/**
+ * \fn static void check_observations(void)
+ * \brief With PROTOCOL_CAP_OBSERVATIONS, every observation is sent, in order, repeated ones included.
+ * \author Thomas ROCHER
+ */
+static void check_observations(void) {
+    capabilities = PROTOCOL_CAP_MAP_DELTA | PROTOCOL_CAP_OBSERVATIONS;
+    sent_count = 0;
+    Mapper * mapper = MAPPER_instance_create(NULL);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_FREE);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_OBSTACLE);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_OBSTACLE);
+    MAPPER_instance_set_cell(mapper, 4, -2, PROTOCOL_CELL_FREE);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_OBSTACLE);
+    MAPPER_instance_flush(mapper);
+    check(sent_count == 5, "every observation is sent");
+    check(sent_count == 5 && sent[0].value == PROTOCOL_CELL_FREE && sent[1].value == PROTOCOL_CELL_OBSTACLE
+          && sent[3].coord_x == 4 && sent[4].value == PROTOCOL_CELL_OBSTACLE, "observations keep their order");
+
+    // Plus d'observations qu'un MAP_DELTA n'en contient : elles partent dans plusieurs, aucune n'est perdue.
+    sent_count = 0;
+    for(int i = 0; i < REPEATS; i++) {
+        MAPPER_instance_set_cell(mapper, 0, 0, PROTOCOL_CELL_FREE);
+    }
+    MAPPER_instance_flush(mapper);
+    check(count_sent(0, 0, PROTOCOL_CELL_FREE) == REPEATS, "repeated observations span several MAP_DELTA");
+    MAPPER_instance_destroy(mapper);
+}
+/**
+ * \fn static void check_changes(void)
+ * \brief Without PROTOCOL_CAP_OBSERVATIONS, only the changes of a cell are sent, the last pending value winning.
+ * \author Thomas ROCHER
+ */
+static void check_changes(void) {
+    capabilities = PROTOCOL_CAP_MAP_DELTA;
+    sent_count = 0;
+    Mapper * mapper = MAPPER_instance_create(NULL);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_FREE);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_OBSTACLE);
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_OBSTACLE);
+    MAPPER_instance_flush(mapper);
+    check(sent_count == 1 && count_sent(3, -2, PROTOCOL_CELL_OBSTACLE) == 1, "pending changes of a cell are merged");
+    MAPPER_instance_set_cell(mapper, 3, -2, PROTOCOL_CELL_OBSTACLE);
+    MAPPER_instance_flush(mapper);
+    check(sent_count == 1, "an unchanged cell is not sent again");
+    MAPPER_instance_destroy(mapper);
+}
+/* ----------------------  PUBLIC FUNCTIONS  ---------------------------------*/
+/**
+ * \fn int main(void)
+ * \brief Runs every check.
+ * \author Thomas ROCHER
+ *
+ * \return 0 when every check passed, 1 otherwise.
+ */
+int main(void) {
+    check_observations();
+    check_changes();
+    printf("%s\n", failures ? "FAILED" : "OK");
+    if(failures) {
+        fprintf(stderr, "%d failed checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
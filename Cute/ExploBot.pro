@@ -3,12 +3,18 @@ TARGET = ExploBot
 
 QT = core gui
 
+# protocole partage avec Carto (header only).
+INCLUDEPATH += ../Protocol
+
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 SOURCES += \
     client_tcp/dispatcher.cpp \
+    client_tcp/ingestion.cpp \
+    client_tcp/mission.cpp \
     client_tcp/postman.cpp \
     client_tcp/proxyPilot.cpp \
+    client_tcp/tcpclient.cpp \
     customgraphicsview.cpp \
     main.cpp \
     map.cpp \
@@ -18,12 +24,25 @@ RESOURCES += \
     resources.qrc
 
 HEADERS += \
+    ../Protocol/protocol.h \
+    ../Protocol/protocol_codecs.h \
+    ../Protocol/protocol_messages.h \
     client_tcp/defs.h \
     client_tcp/dispatcher.h \
+    client_tcp/ingestion.h \
+    client_tcp/mission.h \
     client_tcp/postman.h \
     client_tcp/proxyPilot.h \
+    client_tcp/tcpclient.h \
     customgraphicsview.h \
+    grid/chunked_grid.h \
+    grid/connectivity.h \
+    grid/distance_field.h \
+    grid/grid.h \
+    grid/log_odds.h \
+    grid/swar.h \
     map.h \
+    map_file.h \
     window.h
 
 CONFIG += file_copies
@@ -40,42 +40,10 @@
 #include <iostream>
 #include <iomanip>
 
-/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
-
-enum Command {
-    FORWARD=0,
-    RIGHT,   /**< RIGHT : left motor clockwise, right  motor anti-clockwise. */
-    LEFT,    /**< LEFT : left  motor anti-clockwise, right  motor clockwise. */
-    STOP     /**< STOP :  motors stop. */
-};
+// Command, Direction, Message_Type et Communication_Protocol_Head viennent du protocol.h partage avec Carto.
+#include "protocol.h"
 
-/**
- * \enum Message_Type
- * \brief Defines message types.
- *
- * Messag_Type gives all the message type that can go threw TCP.
- */
-enum class Message_Type {
-    SEND_MOVES_TRAJECTORY = 0x0100,     /**< SEND_MOVES_TRAJECTORY : Cute sends the move commands for the trajectory to Carto. */
-    SEND_MOVE_CARTOGRAPHY = 0x0200,     /**< SEND_MOVE_CARTOGRAPHY : Cute sends a move command for the cartography to Carto. */
-    MOVE_DONE = 0x0300,                 /**< MOVE_DONE : Carto confirms to Cute that move command has been performed. */
-    SET_OBSTACLE_POSITION = 0x0400,     /**< SET_OBSTACLE_POSITION : Carto sends an obstacle position to Cute. */
-    SET_ROBOT_POSITION = 0x0500,        /**< SET_ROBOT_POSITION : Carto sends the new robot position to Cute. */
-    STOP_ROBOT = 0x0600,                /**< STOP_ROBOT : Cute sends a stop command to the robot.  */
-    SEND_ROBOT_POSITION = 0x0700,       /**< SEND_ROBOT_POSITION : Cute sends the robot position to Carto. */
-    ROBOT_POSITION_RECEIVED = 0x0800,   /**< ROBOT_POSITION_RECEIVED : Carto confirms to Cute that the robot position has been received. */
-};
-
-/**
- * \struct Communication_Protocol_Head defs.h "lib/defs.h"
- * \brief Lists the head sections of a message.
- *
- * Communication_Protocol_Head gives a list of header section for the TCP communication protocol.
- */
-struct __attribute__((__packed__, aligned(1))) Communication_Protocol_Head {
-    int16_t msg_size; /**< Gives the Message size (type + data) in bytes. Minimum = 2 bytes Maximum = 0xFFFF. */
-    Message_Type msg_type; /**< Gives the Message type. Size = 2 bytes */
-};
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
 
 /**
  * \enum bool_e
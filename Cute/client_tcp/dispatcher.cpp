@@ -38,43 +38,40 @@
 #include "dispatcher.h"
 #include "postman.h"
 #include "proxyPilot.h"
+#include "ingestion.h"
+#include "mission.h"
 #include "defs.h"
-#include <stdbool.h>
-#include <pthread.h>
-#include <errno.h>
+#include "../map.h"
+#include <QMetaObject>
 #include <stdlib.h>
-#include <arpa/inet.h>
 #include <string.h>
-#include <stdio.h>
 
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
-#define STATE_GENERATION S(S_IDLE) S(S_READING_MSG) S(S_STOP) S(S_WAITING_RECONNECTION)
-#define S(x) x,
-typedef enum {STATE_GENERATION STATE_NB} State_Machine;
-#undef STATE_GENERATION
-#undef S
 /* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
 /* DISPATCHER */
 /**
  * \def MAX_RECEIVED_BYTES
  * Maximum of possible received bytes.
  */
-#define MAX_RECEIVED_BYTES (20)
+#define MAX_RECEIVED_BYTES (PROTOCOL_MAX_DELTA_PAYLOAD)
+/**
+ * \def MAX_SNAPSHOT_SIDE
+ * Most rows, and most columns, of a MAP_SNAPSHOT : its cells are buffered until the last chunk (16 MB at most).
+ */
+#define MAX_SNAPSHOT_SIDE 4096
 /* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
 /* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
 /* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
 /**
- * \fn static void * DISPATCHER_run(void * arg)
- * \brief Called by a thread. This function is the "active" part of dispatcher.
- * It reads any messages on postman's socket then parse and dispatch it.
- * \author Joshua MONTREUIL
+ * \fn static void receive(const uint8_t * frame, int size)
+ * \brief Postman_Receiver of the dispatcher : decodes and dispatches a whole frame. Called in the network thread.
+ * \author Thomas ROCHER
  * \see postman.h
  *
- * \param arg : argument pointer.
- *
- * \return void * : generic pointer (0 on success -1 on error).
+ * \param frame : frame received, head included.
+ * \param size : size of the frame.
  */
-static void *run(void * arg);
+static void receive(const uint8_t * frame, int size);
 /**
  * \fn static void DISPATCHER_dispatch_received_msg(Communication_Protocol_Head msg)
  * \brief Used to parse the incoming msg and to dispatch and pass data to the right functions.
@@ -96,29 +93,61 @@ static int dispatch_received_msg(Communication_Protocol_Head msg);
  * \return The header of the message.
  * \see Communication_Protocol_Head
  */
-static Communication_Protocol_Head decode_message(uint8_t* raw_message);
-
-/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+static Communication_Protocol_Head decode_message(const uint8_t* raw_message);
 /**
- * \var static State_Machine state
- * \brief Dispatcher state Machine.
+ * \fn static bool is_same_snapshot(Protocol_Snapshot_Head head, Protocol_Snapshot_Head first)
+ * \brief Tells if a MAP_SNAPSHOT chunk belongs to the snapshot whose first chunk had the head first.
+ * \author Thomas ROCHER
  */
-static State_Machine state;
+static bool is_same_snapshot(Protocol_Snapshot_Head head, Protocol_Snapshot_Head first);
 /**
- * \var static pthread_t dispatcher_thread
- * \brief Dispatcher thread.
+ * \fn static void drop_snapshot(void)
+ * \brief Forgets the MAP_SNAPSHOT being received and frees its cells.
+ * \author Thomas ROCHER
  */
-static pthread_t dispatcher_thread;
+static void drop_snapshot(void);
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
 /**
  * \var static uint8_t * data_received
  * \brief raw data received from socket;
  */
 static uint8_t * data_received;
 /**
- * \var static pthread_mutex_t dispatcher_mutex
- * \brief Mutex used to safely read state from state machine
+ * \var static uint32_t map_version
+ * \brief Version of the last MAP_DELTA applied, kept across the reconnections of a session.
+ */
+static uint32_t map_version = 0;
+/**
+ * \var static uint32_t session_token
+ * \brief Token of the session given by Carto in SESSION, 0 before the first one.
+ */
+static uint32_t session_token = 0;
+/**
+ * \var static uint32_t moves_done
+ * \brief Count of MOVE_DONE received in the session.
+ */
+static uint32_t moves_done = 0;
+/**
+ * \var static int data_size
+ * \brief Size of the payload held in data_received.
+ */
+static int data_size = 0;
+/**
+ * \var static uint8_t * snapshot_cells
+ * \brief Cells of the MAP_SNAPSHOT being received, row-major.
  */
-static pthread_mutex_t dispatcher_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t * snapshot_cells = NULL;
+/**
+ * \var static Protocol_Snapshot_Head snapshot_head
+ * \brief Head of the first chunk of the MAP_SNAPSHOT being received : snapshot_cells holds its rows x cols cells.
+ */
+static Protocol_Snapshot_Head snapshot_head;
+/**
+ * \var static uint32_t snapshot_received
+ * \brief Cells of the MAP_SNAPSHOT being received already written in snapshot_cells (the next chunk starts there).
+ */
+static uint32_t snapshot_received = 0;
 
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
 int DISPATCHER_create(void) {
@@ -127,126 +156,171 @@ int DISPATCHER_create(void) {
 }
 
 int DISPATCHER_start(void) {
-    state = S_IDLE;
-    if(pthread_create(&dispatcher_thread, NULL, run, NULL) != 0 ) {
-        return -1;
-    }
+    POSTMAN_set_receiver(&receive);
     return 0;
 }
 
-void DISPATCHER_start_reading() {
-    pthread_mutex_lock(&dispatcher_mutex);
-    state = S_READING_MSG;
-    pthread_mutex_unlock(&dispatcher_mutex);
+void DISPATCHER_resume_session(void) {
+    PROXYPILOT_send_resume(session_token, map_version, moves_done);
 }
 
 void DISPATCHER_disconnect(void){
-    pthread_mutex_lock(&dispatcher_mutex);
-    state = S_WAITING_RECONNECTION;
-    pthread_mutex_unlock(&dispatcher_mutex);   
+    // Appelé dans le thread réseau à la coupure : un snapshot à moitié reçu ne sera jamais complété.
+    // map_version et moves_done restent : le RESUME de la reconnexion les donne à Carto.
+    drop_snapshot();
+    MISSION_interrupt();
 }
 
 int DISPATCHER_stop(void) {
-    pthread_mutex_lock(&dispatcher_mutex);
-    state = S_STOP;
-    pthread_mutex_unlock(&dispatcher_mutex);
-    if(pthread_join(dispatcher_thread, NULL) != 0) {
-        return -1;
-    }
+    POSTMAN_set_receiver(NULL);
     return 0;
 }
 
 int DISPATCHER_destroy(void) {
     std::free(data_received);
+    drop_snapshot();
     return 0;
 }
 
 /* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
 
-static void * run(void * arg) {
-    State_Machine my_state;
-    pthread_mutex_lock(&dispatcher_mutex);
-    my_state = state;
-    pthread_mutex_unlock(&dispatcher_mutex);
-    while(my_state != S_STOP) {
-        pthread_mutex_lock(&dispatcher_mutex);
-        my_state = state;
-        pthread_mutex_unlock(&dispatcher_mutex);
-        if(my_state == S_READING_MSG) {
-            uint8_t* raw_message = POSTMAN_read_request();
-            if(raw_message != NULL) {
-                uint8_t error_value = *raw_message;
-                if(error_value == EBADF) {
-                    pthread_mutex_lock(&dispatcher_mutex);
-                    state = S_WAITING_RECONNECTION;
-                    pthread_mutex_unlock(&dispatcher_mutex);
-                }
-                else {
-                    Communication_Protocol_Head msg_decoded = decode_message(raw_message);
-                    dispatch_received_msg(msg_decoded);
-                }
-                std::free(raw_message);
-            }
-            else{
-                return NULL;
-            }
-        }
+static void receive(const uint8_t * frame, int size) {
+    // Le client ne donne que des trames entières : seule une trame sans type est à écarter.
+    if(size < PROTOCOL_HEAD_SIZE) {
+        return;
     }
-    return 0;
+    Communication_Protocol_Head msg_decoded = decode_message(frame);
+    dispatch_received_msg(msg_decoded);
 }
 
-
 static int dispatch_received_msg(Communication_Protocol_Head msg) {
+    if(msg.sequenced) {
+        POSTMAN_acknowledge(msg);
+    }
+    // data_received n'est pas remis à zéro : une trame trop courte lirait la précédente.
+    const Protocol_Message_Info * info = PROTOCOL_message_info(msg.msg_type);
+    if(info != NULL && info->payload_size > data_size) {
+        return -1;
+    }
     switch(msg.msg_type)
     {
         case Message_Type::MOVE_DONE :
         {
+            moves_done++;
+            INGESTION_move_done();
+            MISSION_move_done();
             break;
         }
         case Message_Type::ROBOT_POSITION_RECEIVED :
         {
+            MISSION_robot_position_received();
             break;
         }
         case Message_Type::SET_OBSTACLE_POSITION :
+        case Message_Type::SET_OBSTACLE_POSITION_V2 :
         {
+            Protocol_Pose cell = PROTOCOL_decode_pose(msg.msg_type, data_received);
+            INGESTION_add_obstacle(cell.coord_x, cell.coord_y);
+            Protocol_Cell obstacle = {cell.coord_x, cell.coord_y, PROTOCOL_CELL_OBSTACLE};
+            MISSION_set_cells(&obstacle, 1);
             break;
         }
         case Message_Type::SET_ROBOT_POSITION :
+        case Message_Type::SET_ROBOT_POSITION_V2 :
         {
+            Protocol_Pose pose = PROTOCOL_decode_pose(msg.msg_type, data_received);
+            INGESTION_set_robot_position(pose.coord_x, pose.coord_y);
+            MISSION_set_robot_position(pose.coord_x, pose.coord_y);
             break;
         }
-        default :
-        {
-            //Should not get here
-            break;
-        }
-    }
-    return 0;
-}
-
-static Communication_Protocol_Head decode_message(uint8_t* raw_message) {
-    Communication_Protocol_Head msg;
-    msg.msg_size = (raw_message[0] << 8) | raw_message[1];
-    uint16_t type = ((raw_message[2] << 8) | raw_message[3]);
-    switch(type){
-        case(768) :
+        case Message_Type::HELLO_ACK :
         {
-            msg.msg_type = Message_Type::MOVE_DONE;
+            Protocol_Hello kept = PROTOCOL_decode_hello(data_received);
+            PROXYPILOT_set_protocol(kept.version, kept.capabilities);
+            if(!(kept.capabilities & PROTOCOL_CAP_RESUME)) {
+                // Pas de reprise possible : nouvelle session, la carte est redemandée en entier.
+                session_token = 0;
+                map_version = 0;
+                PROXYPILOT_request_map_snapshot();
+                MISSION_stop();
+            }
             break;
         }
-        case(2048) :
+        case Message_Type::SESSION :
         {
-            msg.msg_type = Message_Type::ROBOT_POSITION_RECEIVED;
+            // Session reprise : les MOVE_DONE manqués suivent et complètent moves_done.
+            Protocol_Msg_Session session = PROTOCOL_read_session(data_received);
+            if(!session.resumed || session.token != session_token) {
+                // Nouvelle session : le MAP_SNAPSHOT qui suit donne la version de la carte, la pose du robot est perdue.
+                session_token = session.token;
+                moves_done = session.moves_done;
+                map_version = 0;
+                MISSION_stop();
+            }
+            else {
+                MISSION_resume(static_cast<int32_t>(session.moves_done - moves_done));
+            }
             break;
         }
-        case(1024) :
+        case Message_Type::MAP_DELTA :
         {
-            msg.msg_type = Message_Type::SET_OBSTACLE_POSITION;
+            // Les cases rejoignent le lot de la frame en cours (un seul rafraîchissement pour plusieurs MAP_DELTA).
+            static Protocol_Cell cells[PROTOCOL_MAX_DELTA_CELLS];
+            uint32_t version = 0;
+            int count = PROTOCOL_decode_map_delta(data_received, data_size, &version, cells, PROTOCOL_MAX_DELTA_CELLS);
+            if(count <= 0 || version <= map_version) {
+                break;
+            }
+            map_version = version;
+            INGESTION_add_cells(cells, count);
+            MISSION_set_cells(cells, count);
             break;
         }
-        case(1280) :
+        case Message_Type::MAP_SNAPSHOT :
         {
-            msg.msg_type = Message_Type::SET_ROBOT_POSITION;
+            // Les morceaux arrivent dans l'ordre, sans MAP_DELTA entre eux : la carte est remplacée au dernier.
+            Protocol_Snapshot_Head head = PROTOCOL_decode_snapshot_head(data_received);
+            uint32_t total = static_cast<uint32_t>(head.rows) * head.cols;
+            if(head.first_cell == 0) {
+                // Un nouveau snapshot remplace celui en cours : sa tête donne la taille du tampon et sert à vérifier les morceaux suivants.
+                // rows et cols viennent du réseau : une carte de plus de MAX_SNAPSHOT_SIDE de côté n'est pas allouée, ses morceaux sont écartés.
+                drop_snapshot();
+                if(head.rows <= MAX_SNAPSHOT_SIDE && head.cols <= MAX_SNAPSHOT_SIDE) {
+                    snapshot_cells = static_cast<uint8_t *>(std::malloc(total > 0 ? total : 1));
+                }
+                snapshot_head = head;
+            }
+            // Morceau sans tampon (pas de premier morceau, carte trop grande, malloc raté), d'un autre snapshot (deux snapshots mêlés après une reconnexion), hors d'ordre ou malformé :
+            // il n'est pas écrit, et le snapshot en cours ne pourra plus être complet.
+            if(snapshot_cells == NULL || !is_same_snapshot(head, snapshot_head) || head.first_cell != snapshot_received
+               || PROTOCOL_decode_snapshot_cells(data_received, data_size, head, snapshot_cells) == -1) {
+                drop_snapshot();
+                break;
+            }
+            // Les morceaux se suivent sans trou : aucune case du tampon n'est lue sans avoir été écrite.
+            snapshot_received += head.cell_count;
+            if(snapshot_received < total) {
+                break;
+            }
+            map_version = head.map_version;
+            QVector<QPoint> obstacles;
+            QVector<QPoint> cartographied_areas;
+            for(uint32_t i = 0; i < total; i++) {
+                QPoint cell(head.origin_y + static_cast<int>(i % head.cols), head.origin_x + static_cast<int>(i / head.cols));
+                if(snapshot_cells[i] == PROTOCOL_CELL_OBSTACLE) {
+                    obstacles.append(cell);
+                }
+                else if(snapshot_cells[i] == PROTOCOL_CELL_FREE) {
+                    cartographied_areas.append(cell);
+                }
+            }
+            drop_snapshot();
+            // Le lot en cours passe avant : la carte chargée le remplace.
+            INGESTION_flush();
+            Map *map = &Map::getInstance();
+            QMetaObject::invokeMethod(map, [map, obstacles, cartographied_areas]() {
+                map->load_cells(obstacles, cartographied_areas);
+            }, Qt::QueuedConnection);
             break;
         }
         default :
@@ -255,8 +329,25 @@ static Communication_Protocol_Head decode_message(uint8_t* raw_message) {
             break;
         }
     }
-    if(msg.msg_size > 2) {
-        memcpy(data_received, raw_message + 4,  msg.msg_size - 2);
-    }
+    return 0;
+}
+
+static Communication_Protocol_Head decode_message(const uint8_t* raw_message) {
+    Communication_Protocol_Head msg = PROTOCOL_decode_head(raw_message);
+    data_size = PROTOCOL_payload_size(msg);
+    data_size = (data_size < MAX_RECEIVED_BYTES) ? data_size : MAX_RECEIVED_BYTES;
+    memcpy(data_received, raw_message + PROTOCOL_payload_offset(msg), data_size);
     return msg;
 }
+
+static bool is_same_snapshot(Protocol_Snapshot_Head head, Protocol_Snapshot_Head first) {
+    // Même boîte et même version : le tampon alloué au premier morceau a la taille de celle du morceau.
+    return head.map_version == first.map_version && head.origin_x == first.origin_x && head.origin_y == first.origin_y
+        && head.rows == first.rows && head.cols == first.cols;
+}
+
+static void drop_snapshot(void) {
+    std::free(snapshot_cells);
+    snapshot_cells = NULL;
+    snapshot_received = 0;
+}
@@ -56,7 +56,7 @@ extern int DISPATCHER_create(void);
 extern int DISPATCHER_destroy(void);
 /**
  * \fn extern int DISPATCHER_start(void)
- * \brief Starts the module.
+ * \brief Starts the module : the frames received by the postman are dispatched from now on.
  * \author Joshua MONTREUIL
  *
  * \return On success, returns 0. On error, returns -1.
@@ -71,14 +71,14 @@ extern int DISPATCHER_start(void);
  */
 extern int DISPATCHER_stop(void);
 /**
- * \fn extern void DISPATCHER_start_reading(void)
- * \brief Begins to read.
- * \author Joshua MONTREUIL.
+ * \fn extern void DISPATCHER_resume_session(void)
+ * \brief Sends the RESUME of the connection : token of the session, map version and count of MOVE_DONE held. Called in the network thread.
+ * \author Thomas ROCHER
  */
-extern void DISPATCHER_start_reading(void);
+extern void DISPATCHER_resume_session(void);
 /**
  * \fn extern void DISPATCHER_disconnect(void);
- * \brief TODO
+ * \brief Forgets the state of the session (map version, snapshot being received) when the link is lost.
  * \author Thomas ROCHER.
  */
 extern void DISPATCHER_disconnect(void);
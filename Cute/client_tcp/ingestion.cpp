@@ -0,0 +1,168 @@
+/**
+ * \file  ingestion.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Source file of the ingestion module.
+ *
+ * \see ingestion.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "ingestion.h"
+#include "../map.h"
+
+#include <atomic>
+#include <QTimer>
+#include <QVector>
+#include <QPoint>
+#include <QMetaObject>
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def INGESTION_FRAME_INTERVAL_MS
+ * Min time between two batches applied to the Map (one display frame).
+ */
+#define INGESTION_FRAME_INTERVAL_MS 16
+
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/**
+ * \struct Batch ingestion.cpp "client_tcp/ingestion.cpp"
+ * \brief Telemetry received since the last batch applied. QPoint : x = column, y = row, as in the Map.
+ */
+typedef struct {
+    QVector<QPoint> obstacles;              /**< Obstacles seen. */
+    QVector<QPoint> cartographied_areas;    /**< Free cells seen. */
+    QPoint robot;                           /**< Last robot position, valid when has_robot. */
+    bool has_robot;                         /**< A robot position has been received. */
+} Batch;
+
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static void schedule_flush(void)
+ * \brief Starts the frame timer if the batch has no flush planned yet.
+ * \author Thomas ROCHER
+ */
+static void schedule_flush(void);
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static Batch batch
+ * \brief Batch being filled, only touched by the network thread.
+ */
+static Batch batch = {QVector<QPoint>(), QVector<QPoint>(), QPoint(-1, -1), false};
+/**
+ * \var static QTimer * flush_timer
+ * \brief Frame timer, created in the network thread at the first telemetry.
+ */
+static QTimer * flush_timer = nullptr;
+/**
+ * \var static std::atomic<int> moves_done
+ * \brief Amount of MOVE_DONE received.
+ */
+static std::atomic<int> moves_done(0);
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+void INGESTION_add_cells(const Protocol_Cell * cells, int count) {
+    for(int i = 0; i < count; i++) {
+        QPoint cell(cells[i].coord_y, cells[i].coord_x);
+        if(cells[i].value == PROTOCOL_CELL_OBSTACLE) {
+            batch.obstacles.append(cell);
+        }
+        else if(cells[i].value == PROTOCOL_CELL_FREE) {
+            batch.cartographied_areas.append(cell);
+        }
+    }
+    schedule_flush();
+}
+
+void INGESTION_add_obstacle(int32_t coord_x, int32_t coord_y) {
+    batch.obstacles.append(QPoint(coord_y, coord_x));
+    schedule_flush();
+}
+
+void INGESTION_set_robot_position(int32_t coord_x, int32_t coord_y) {
+    // Seule la dernière position compte, les cases traversées sont libres.
+    QPoint position(coord_y, coord_x);
+    batch.cartographied_areas.append(position);
+    batch.robot = position;
+    batch.has_robot = true;
+    schedule_flush();
+}
+
+void INGESTION_move_done(void) {
+    moves_done++;
+}
+
+int INGESTION_get_moves_done(void) {
+    return moves_done;
+}
+
+void INGESTION_flush(void) {
+    if(flush_timer != nullptr) {
+        flush_timer->stop();
+    }
+    if(batch.obstacles.isEmpty() && batch.cartographied_areas.isEmpty() && !batch.has_robot) {
+        return;
+    }
+    // Le lot part tel quel dans l'appel en file : un seul map_updated pour toute la frame.
+    QVector<QPoint> obstacles;
+    QVector<QPoint> cartographied_areas;
+    obstacles.swap(batch.obstacles);
+    cartographied_areas.swap(batch.cartographied_areas);
+    QPoint robot = batch.has_robot ? batch.robot : QPoint(Map::no_position, Map::no_position);
+    batch.has_robot = false;
+    Map *map = &Map::getInstance();
+    QMetaObject::invokeMethod(map, [map, obstacles, cartographied_areas, robot]() {
+        map->apply_telemetry(obstacles, cartographied_areas, robot);
+    }, Qt::QueuedConnection);
+}
+
+void INGESTION_destroy(void) {
+    delete flush_timer;
+    flush_timer = nullptr;
+    batch.obstacles.clear();
+    batch.cartographied_areas.clear();
+    batch.has_robot = false;
+}
+
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+static void schedule_flush(void) {
+    if(flush_timer == nullptr) {
+        flush_timer = new QTimer();
+        flush_timer->setSingleShot(true);
+        flush_timer->setInterval(INGESTION_FRAME_INTERVAL_MS);
+        QObject::connect(flush_timer, &QTimer::timeout, flush_timer, &INGESTION_flush);
+    }
+    // Le premier élément d'un lot arme la minuterie, les suivants attendent la même échéance.
+    if(!flush_timer->isActive()) {
+        flush_timer->start();
+    }
+}
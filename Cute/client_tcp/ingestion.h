@@ -0,0 +1,92 @@
+/**
+ * \file  ingestion.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the ingestion module. Gathers the telemetry of Carto into batches applied to the Map.
+ *
+ * The dispatcher adds what it decodes (cells, obstacles, robot position) in the network thread. The batch is
+ * applied to the Map by a single queued call per INGESTION_FRAME_INTERVAL_MS, whatever the amount of frames received.
+ *
+ * \see ingestion.cpp
+ * \see dispatcher.cpp
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef SRC_COM_INGESTION_H_
+#define SRC_COM_INGESTION_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include "defs.h"
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/* ----------------------  PUBLIC VARIABLES ----------------------------------*/
+/* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern void INGESTION_add_cells(const Protocol_Cell * cells, int count)
+ * \brief Adds the cells of a MAP_DELTA to the batch. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void INGESTION_add_cells(const Protocol_Cell * cells, int count);
+/**
+ * \fn extern void INGESTION_add_obstacle(int32_t coord_x, int32_t coord_y)
+ * \brief Adds an obstacle (SET_OBSTACLE_POSITION) to the batch. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void INGESTION_add_obstacle(int32_t coord_x, int32_t coord_y);
+/**
+ * \fn extern void INGESTION_set_robot_position(int32_t coord_x, int32_t coord_y)
+ * \brief Records the last robot position (SET_ROBOT_POSITION) of the batch. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void INGESTION_set_robot_position(int32_t coord_x, int32_t coord_y);
+/**
+ * \fn extern void INGESTION_move_done(void)
+ * \brief Counts a MOVE_DONE. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void INGESTION_move_done(void);
+/**
+ * \fn extern int INGESTION_get_moves_done(void)
+ * \brief Gives the amount of MOVE_DONE received since the start. Thread-safe.
+ * \author Thomas ROCHER
+ */
+extern int INGESTION_get_moves_done(void);
+/**
+ * \fn extern void INGESTION_flush(void)
+ * \brief Applies the batch to the Map now (before a MAP_SNAPSHOT replaces it). Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void INGESTION_flush(void);
+/**
+ * \fn extern void INGESTION_destroy(void)
+ * \brief Releases the module, once the network thread is stopped.
+ * \author Thomas ROCHER
+ */
+extern void INGESTION_destroy(void);
+
+#endif /* SRC_COM_INGESTION_H_ */
@@ -0,0 +1,517 @@
+/**
+ * \file  mission.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Source file of the mission module.
+ *
+ * \see mission.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "mission.h"
+#include "postman.h"
+#include "proxyPilot.h"
+#include "../map.h"
+
+#include <pthread.h>
+#include <QQueue>
+#include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QDebug>
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def MISSION_WINDOW
+ * Max amount of SEND_MOVE_CARTOGRAPHY in flight.
+ */
+#define MISSION_WINDOW 8
+
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
+/**
+ * \struct Pose mission.cpp "client_tcp/mission.cpp"
+ * \brief Pose of the robot, in the coordinates of Carto (coord_x : row, coord_y : column).
+ */
+typedef struct {
+    int32_t coord_x;    /**< Row of the robot. */
+    int32_t coord_y;    /**< Column of the robot. */
+    Direction dir;      /**< Heading of the robot. */
+} Pose;
+/**
+ * \struct Step mission.cpp "client_tcp/mission.cpp"
+ * \brief One move of the plan.
+ */
+typedef struct {
+    Command command;    /**< Command sent to Carto. */
+    bool certain;       /**< Result known in advance (turn, move to a free cell). */
+    Pose after;         /**< Pose expected after the move. */
+} Step;
+
+/* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/**
+ * \enum State
+ * \brief States of the mission.
+ */
+typedef enum {
+    S_IDLE = 0,     /**< No mission. */
+    S_LOCATING,     /**< Start pose sent, waiting for ROBOT_POSITION_RECEIVED. */
+    S_EXPLORING,    /**< Moves planned and sent as the window allows. */
+    S_DRAINING      /**< A move in flight did not end as planned : waiting for the window to empty before planning again. */
+} State;
+
+/* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
+/**
+ * \fn static Direction turn(Direction dir, Command command)
+ * \brief Gives the heading after a LEFT or a RIGHT, as the pilot of Carto does.
+ * \author Thomas ROCHER
+ */
+static Direction turn(Direction dir, Command command);
+/**
+ * \fn static Pose ahead(Pose pose)
+ * \brief Gives the pose one cell ahead.
+ * \author Thomas ROCHER
+ */
+static Pose ahead(Pose pose);
+/**
+ * \fn static quint64 cell_key(int32_t coord_x, int32_t coord_y)
+ * \brief Gives the key of a cell in the search of plan() : coord_x in the high half, coord_y in the low half.
+ * \author Thomas ROCHER
+ */
+static quint64 cell_key(int32_t coord_x, int32_t coord_y);
+/**
+ * \fn static void record_cell(int32_t coord_x, int32_t coord_y, Protocol_Cell_Value value)
+ * \brief Records the value of a cell and counts the cells discovered.
+ * \author Thomas ROCHER
+ */
+static void record_cell(int32_t coord_x, int32_t coord_y, Protocol_Cell_Value value);
+/**
+ * \fn static bool plan(void)
+ * \brief Plans the moves to the nearest unexplored cell from the pose after the last move queued.
+ * \author Thomas ROCHER
+ *
+ * \return false when no unexplored cell can be reached.
+ */
+static bool plan(void);
+/**
+ * \fn static void advance(void)
+ * \brief Plans when the next moves are known and sends the planned moves while the window has room.
+ * \author Thomas ROCHER
+ */
+static void advance(void);
+/**
+ * \fn static void cancel_plan(bool in_flight_invalid)
+ * \brief Drops the moves not sent yet. The mission drains when the moves in flight were planned on a wrong pose.
+ * \author Thomas ROCHER
+ */
+static void cancel_plan(bool in_flight_invalid);
+/**
+ * \fn static void finish(void)
+ * \brief Ends the mission and prints its throughput.
+ * \author Thomas ROCHER
+ */
+static void finish(void);
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static pthread_mutex_t mission_mutex
+ * \brief Protects the mission, started by the IHM and driven by the network thread.
+ */
+static pthread_mutex_t mission_mutex = PTHREAD_MUTEX_INITIALIZER;
+/**
+ * \var static State state
+ * \brief State of the mission.
+ */
+static State state = S_IDLE;
+/**
+ * \var static bool interrupted
+ * \brief The link is down : nothing is sent until the session is resumed.
+ */
+static bool interrupted = false;
+/**
+ * \var static bool resyncing
+ * \brief The next robot position is the one Carto sends after the MOVE_DONE replayed on RESUME.
+ */
+static bool resyncing = false;
+/**
+ * \var static int replaying
+ * \brief Amount of MOVE_DONE Carto still replays : their position was not received, the plan is assumed.
+ */
+static int replaying = 0;
+/**
+ * \var static ChunkedGrid<uint8_t> known_cells
+ * \brief Protocol_Cell_Value of the cells, PROTOCOL_CELL_UNKNOWN where never seen : no border, the mission goes as far as the free cells.
+ */
+static ChunkedGrid<uint8_t> known_cells(PROTOCOL_CELL_UNKNOWN);
+/**
+ * \var static Pose confirmed
+ * \brief Pose of the robot after the last MOVE_DONE.
+ */
+static Pose confirmed;
+/**
+ * \var static Pose reported
+ * \brief Last robot position sent by Carto, valid when has_reported.
+ */
+static Pose reported;
+/**
+ * \var static bool has_reported
+ * \brief A robot position has been received since the last MOVE_DONE.
+ */
+static bool has_reported = false;
+/**
+ * \var static QQueue<Step> in_flight
+ * \brief Moves sent and not done yet, oldest first.
+ */
+static QQueue<Step> in_flight;
+/**
+ * \var static QQueue<Step> planned
+ * \brief Moves planned and not sent yet.
+ */
+static QQueue<Step> planned;
+/**
+ * \var static int discovered
+ * \brief Cells discovered since the start of the mission.
+ */
+static int discovered = 0;
+/**
+ * \var static QElapsedTimer mission_clock
+ * \brief Time since the start of the mission.
+ */
+static QElapsedTimer mission_clock;
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+int MISSION_start(void) {
+    if(!POSTMAN_is_connected()) {
+        return -1;
+    }
+    pthread_mutex_lock(&mission_mutex);
+    if(state != S_IDLE && !interrupted) {
+        pthread_mutex_unlock(&mission_mutex);
+        return -1;
+    }
+    // Appelé dans le thread de l'IHM : la carte connue au départ est lue directement dans la couche d'occupation de la Map.
+    Map &map = Map::getInstance();
+    known_cells.clear();
+    map.get_occupancy().for_each_chunk([](GridView<const int8_t> cells, int first_row, int first_col) {
+        uint8_t categories[CHUNKED_GRID_SIDE];
+        for(int i = 0; i < cells.rows(); i++) {
+            // Vue seuillée des log-odds, directement en valeurs du protocole.
+            LOG_ODDS_classify(cells.row(i), categories, cells.cols(), PROTOCOL_CELL_OBSTACLE, PROTOCOL_CELL_FREE, PROTOCOL_CELL_UNKNOWN);
+            for(int j = 0; j < cells.cols(); j++) {
+                if(categories[j] != PROTOCOL_CELL_UNKNOWN) {
+                    known_cells.set(first_row + i, first_col + j, categories[j]);
+                }
+            }
+        }
+    });
+    GridBounds bounds = map.get_bounds();
+    bool placed = map.has_robot_position();
+    confirmed.coord_x = placed ? map.get_robot_position_y() : bounds.row + bounds.rows / 2;
+    confirmed.coord_y = placed ? map.get_robot_position_x() : bounds.col + bounds.cols / 2;
+    confirmed.dir = SOUTH;
+    known_cells.set(confirmed.coord_x, confirmed.coord_y, PROTOCOL_CELL_FREE);
+    in_flight.clear();
+    planned.clear();
+    has_reported = false;
+    interrupted = false;
+    resyncing = false;
+    replaying = 0;
+    discovered = 0;
+    mission_clock.start();
+    state = S_LOCATING;
+    // Carto part de la même pose que la mission : ROBOT_POSITION_RECEIVED lance l'exploration.
+    PROXYPILOT_send_robot_position(confirmed.coord_x, confirmed.coord_y, confirmed.dir);
+    pthread_mutex_unlock(&mission_mutex);
+    return 0;
+}
+
+void MISSION_stop(void) {
+    pthread_mutex_lock(&mission_mutex);
+    state = S_IDLE;
+    interrupted = false;
+    in_flight.clear();
+    planned.clear();
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+bool MISSION_is_running(void) {
+    pthread_mutex_lock(&mission_mutex);
+    bool running = (state != S_IDLE);
+    pthread_mutex_unlock(&mission_mutex);
+    return running;
+}
+
+void MISSION_move_done(void) {
+    pthread_mutex_lock(&mission_mutex);
+    if(state == S_IDLE || in_flight.isEmpty()) {
+        pthread_mutex_unlock(&mission_mutex);
+        return;
+    }
+    Step step = in_flight.dequeue();
+    if(replaying > 0) {
+        // MOVE_DONE rejoué : seule la position envoyée à la fin de la reprise dira si les avances ont abouti.
+        replaying--;
+        confirmed = step.after;
+    }
+    else if(step.command == FORWARD) {
+        Pose target = ahead(confirmed);
+        if(has_reported && reported.coord_x == target.coord_x && reported.coord_y == target.coord_y) {
+            confirmed = target;
+            record_cell(target.coord_x, target.coord_y, PROTOCOL_CELL_FREE);
+        }
+        else {
+            // Pas de SET_ROBOT_POSITION avant le MOVE_DONE : le capteur a vu un obstacle, le robot n'a pas bougé.
+            record_cell(target.coord_x, target.coord_y, PROTOCOL_CELL_OBSTACLE);
+        }
+    }
+    else {
+        confirmed.dir = turn(confirmed.dir, step.command);
+    }
+    has_reported = false;
+    if(confirmed.coord_x != step.after.coord_x || confirmed.coord_y != step.after.coord_y) {
+        cancel_plan(true);
+    }
+    if(state == S_DRAINING && in_flight.isEmpty()) {
+        state = S_EXPLORING;
+    }
+    advance();
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+void MISSION_robot_position_received(void) {
+    pthread_mutex_lock(&mission_mutex);
+    // Pendant l'exploration, Carto en envoie aussi un au début de chaque déplacement : seul celui du départ compte.
+    if(state == S_LOCATING) {
+        state = S_EXPLORING;
+        advance();
+    }
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+void MISSION_set_robot_position(int32_t coord_x, int32_t coord_y) {
+    pthread_mutex_lock(&mission_mutex);
+    reported.coord_x = coord_x;
+    reported.coord_y = coord_y;
+    has_reported = true;
+    if(resyncing && replaying == 0 && state != S_IDLE) {
+        // Position de fin de reprise : les MOVE_DONE rejoués ont été supposés conformes au plan.
+        resyncing = false;
+        if(coord_x != confirmed.coord_x || coord_y != confirmed.coord_y) {
+            confirmed.coord_x = coord_x;
+            confirmed.coord_y = coord_y;
+            cancel_plan(true);
+            if(in_flight.isEmpty()) {
+                state = S_EXPLORING;
+            }
+            advance();
+        }
+    }
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+void MISSION_set_cells(const Protocol_Cell * cells, int count) {
+    pthread_mutex_lock(&mission_mutex);
+    if(state == S_IDLE) {
+        pthread_mutex_unlock(&mission_mutex);
+        return;
+    }
+    bool plan_invalid = false;
+    bool in_flight_invalid = false;
+    for(int i = 0; i < count; i++) {
+        record_cell(cells[i].coord_x, cells[i].coord_y, static_cast<Protocol_Cell_Value>(cells[i].value));
+        if(cells[i].value != PROTOCOL_CELL_OBSTACLE) {
+            continue;
+        }
+        // Seules les avances prévues sur une case libre sont remises en cause : l'obstacle est le résultat attendu des autres.
+        for(const Step &step : planned) {
+            if(step.certain && step.command == FORWARD && step.after.coord_x == cells[i].coord_x && step.after.coord_y == cells[i].coord_y) {
+                plan_invalid = true;
+            }
+        }
+        for(const Step &step : in_flight) {
+            if(step.certain && step.command == FORWARD && step.after.coord_x == cells[i].coord_x && step.after.coord_y == cells[i].coord_y) {
+                in_flight_invalid = true;
+            }
+        }
+    }
+    if(plan_invalid || in_flight_invalid) {
+        cancel_plan(in_flight_invalid);
+        advance();
+    }
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+void MISSION_interrupt(void) {
+    pthread_mutex_lock(&mission_mutex);
+    if(state != S_IDLE) {
+        interrupted = true;
+    }
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+void MISSION_resume(int missed_moves) {
+    pthread_mutex_lock(&mission_mutex);
+    if(state == S_IDLE || !interrupted) {
+        pthread_mutex_unlock(&mission_mutex);
+        return;
+    }
+    interrupted = false;
+    if(state == S_LOCATING) {
+        PROXYPILOT_send_robot_position(confirmed.coord_x, confirmed.coord_y, confirmed.dir);
+        pthread_mutex_unlock(&mission_mutex);
+        return;
+    }
+    // Carto a fait les missed_moves premiers déplacements en vol, les suivants ne lui sont jamais arrivés.
+    int sent = static_cast<int>(in_flight.size());
+    replaying = (missed_moves < 0) ? 0 : (missed_moves > sent ? sent : missed_moves);
+    resyncing = true;
+    for(int i = replaying; i < sent; i++) {
+        PROXYPILOT_send_move_cartography(in_flight[i].command);
+    }
+    advance();
+    pthread_mutex_unlock(&mission_mutex);
+}
+
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+static Direction turn(Direction dir, Command command) {
+    switch(dir) {
+        case SOUTH : return (command == LEFT) ? EAST : WEST;
+        case NORTH : return (command == LEFT) ? WEST : EAST;
+        case WEST : return (command == LEFT) ? SOUTH : NORTH;
+        default : return (command == LEFT) ? NORTH : SOUTH;
+    }
+}
+
+static Pose ahead(Pose pose) {
+    switch(pose.dir) {
+        case SOUTH : pose.coord_x++; break;
+        case NORTH : pose.coord_x--; break;
+        case WEST : pose.coord_y--; break;
+        case EAST : pose.coord_y++; break;
+        default : break;
+    }
+    return pose;
+}
+
+static quint64 cell_key(int32_t coord_x, int32_t coord_y) {
+    return (static_cast<quint64>(static_cast<uint32_t>(coord_x)) << 32) | static_cast<uint32_t>(coord_y);
+}
+
+static void record_cell(int32_t coord_x, int32_t coord_y, Protocol_Cell_Value value) {
+    if(value == PROTOCOL_CELL_UNKNOWN) {
+        return;
+    }
+    if(known_cells.get(coord_x, coord_y) == PROTOCOL_CELL_UNKNOWN) {
+        discovered++;
+    }
+    known_cells.set(coord_x, coord_y, value);
+}
+
+static bool plan(void) {
+    Pose start = !planned.isEmpty() ? planned.last().after : (!in_flight.isEmpty() ? in_flight.last().after : confirmed);
+    quint64 start_key = cell_key(start.coord_x, start.coord_y);
+    // Parcours en largeur sur les cases libres : la première case voisine d'une case inconnue est la plus proche.
+    // Les directions partent du cap du robot : à distance égale, la case devant évite des rotations.
+    const Direction order[4] = {start.dir, turn(start.dir, LEFT), turn(start.dir, RIGHT), turn(turn(start.dir, RIGHT), RIGHT)};
+    QHash<quint64, Pose> parent;   // Case d'où chaque case atteinte a été découverte
+    QVector<Pose> queue;
+    parent.insert(start_key, start);
+    queue.append(start);
+    for(int head = 0; head < queue.size(); head++) {
+        for(int d = 0; d < 4; d++) {
+            Pose cell = {queue[head].coord_x, queue[head].coord_y, order[d]};
+            Pose next = ahead(cell);
+            quint64 next_key = cell_key(next.coord_x, next.coord_y);
+            uint8_t value = known_cells.get(next.coord_x, next.coord_y);
+            if(value == PROTOCOL_CELL_OBSTACLE || parent.contains(next_key)) {
+                continue;
+            }
+            if(value == PROTOCOL_CELL_FREE) {
+                parent.insert(next_key, cell);
+                queue.append(next);
+                continue;
+            }
+            // Chemin remonté de la case trouvée jusqu'au départ, puis joué dans l'ordre.
+            QVector<Pose> path;
+            for(Pose p = cell; cell_key(p.coord_x, p.coord_y) != start_key; p = parent.value(cell_key(p.coord_x, p.coord_y))) {
+                path.prepend(p);
+            }
+            path.append(next);
+            Pose pose = start;
+            for(int p = 0; p < path.size(); p++) {
+                int32_t coord_x = path[p].coord_x;
+                int32_t coord_y = path[p].coord_y;
+                Direction dir = (coord_x > pose.coord_x) ? SOUTH : (coord_x < pose.coord_x) ? NORTH : (coord_y < pose.coord_y) ? WEST : EAST;
+                while(pose.dir != dir) {
+                    Command command = (turn(pose.dir, LEFT) == dir) ? LEFT : RIGHT;
+                    pose.dir = turn(pose.dir, command);
+                    planned.enqueue(Step{command, true, pose});
+                }
+                pose = ahead(pose);
+                // La dernière avance entre dans la case inconnue : son résultat n'est connu qu'à son MOVE_DONE.
+                planned.enqueue(Step{FORWARD, p + 1 < path.size(), pose});
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+static void advance(void) {
+    if(state != S_EXPLORING || interrupted) {
+        return;
+    }
+    // Le plan suivant part de la fin du précédent tant que celui-ci ne finit pas sur une case inconnue.
+    if(planned.isEmpty() && (in_flight.isEmpty() || in_flight.last().certain)) {
+        if(!plan() && in_flight.isEmpty()) {
+            finish();
+            return;
+        }
+    }
+    while(in_flight.size() < MISSION_WINDOW && !planned.isEmpty()) {
+        Step step = planned.dequeue();
+        in_flight.enqueue(step);
+        PROXYPILOT_send_move_cartography(step.command);
+    }
+}
+
+static void cancel_plan(bool in_flight_invalid) {
+    planned.clear();
+    // Les déplacements déjà envoyés ne se rappellent pas : Carto les fait depuis la vraie pose, le plan suivant attend leur fin.
+    if(in_flight_invalid && !in_flight.isEmpty() && state == S_EXPLORING) {
+        state = S_DRAINING;
+    }
+}
+
+static void finish(void) {
+    state = S_IDLE;
+    double minutes = mission_clock.elapsed() / 60000.0;
+    qDebug() << "Cartographie terminée :" << discovered << "cases découvertes,"
+             << (minutes > 0 ? discovered / minutes : 0.0) << "cases par minute.";
+}
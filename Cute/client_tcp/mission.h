@@ -0,0 +1,111 @@
+/**
+ * \file  mission.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the mission module. Drives the cartography of Carto with SEND_MOVE_CARTOGRAPHY.
+ *
+ * The mission keeps its own view of the map and of the robot pose. It plans a path to the nearest cell next to an
+ * unexplored one, then sends its moves without waiting for each MOVE_DONE : up to MISSION_WINDOW moves are in flight
+ * while their result is known (turns, moves on free cells). The move into an unexplored cell is the last of the plan :
+ * the next plan waits for its result. An obstacle on the planned path drops the moves not sent yet and re-plans.
+ *
+ * MISSION_start() and MISSION_stop() are called by the IHM, the other functions by the dispatcher in the network thread.
+ *
+ * \see mission.cpp
+ * \see dispatcher.cpp
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef SRC_COM_MISSION_H_
+#define SRC_COM_MISSION_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include "defs.h"
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/* ----------------------  PUBLIC VARIABLES ----------------------------------*/
+/* ----------------------  PUBLIC FUNCTIONS PROTOTYPES  ----------------------*/
+/**
+ * \fn extern int MISSION_start(void)
+ * \brief Starts the cartography from the robot position of the Map (center of the Map if none), facing SOUTH. Called in the IHM thread.
+ * \author Thomas ROCHER
+ *
+ * \return 0 on success, -1 if a mission is already running or Carto is not connected.
+ */
+extern int MISSION_start(void);
+/**
+ * \fn extern void MISSION_stop(void)
+ * \brief Stops the mission : no more move is sent, the moves in flight still end on Carto. Thread-safe.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_stop(void);
+/**
+ * \fn extern bool MISSION_is_running(void)
+ * \brief Tells if a mission is running. Thread-safe.
+ * \author Thomas ROCHER
+ */
+extern bool MISSION_is_running(void);
+/**
+ * \fn extern void MISSION_move_done(void)
+ * \brief Applies the result of the oldest move in flight and sends the next ones. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_move_done(void);
+/**
+ * \fn extern void MISSION_robot_position_received(void)
+ * \brief Carto has the start pose : the exploration begins. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_robot_position_received(void);
+/**
+ * \fn extern void MISSION_set_robot_position(int32_t coord_x, int32_t coord_y)
+ * \brief Records the robot position sent by Carto after a move forward. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_set_robot_position(int32_t coord_x, int32_t coord_y);
+/**
+ * \fn extern void MISSION_set_cells(const Protocol_Cell * cells, int count)
+ * \brief Records cells sent by Carto (MAP_DELTA, SET_OBSTACLE_POSITION). Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_set_cells(const Protocol_Cell * cells, int count);
+/**
+ * \fn extern void MISSION_interrupt(void)
+ * \brief The link is down : nothing is sent until MISSION_resume(). Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_interrupt(void);
+/**
+ * \fn extern void MISSION_resume(int missed_moves)
+ * \brief The session is resumed : Carto replays missed_moves MOVE_DONE, the moves in flight after them never reached
+ * Carto and are sent again. Called in the network thread.
+ * \author Thomas ROCHER
+ */
+extern void MISSION_resume(int missed_moves);
+
+#endif /* SRC_COM_MISSION_H_ */
@@ -5,6 +5,8 @@
  * \date Dec 18, 2023
  * \brief Source file of the postman module. Handles socket connectivity.
  *
+ * The socket belongs to a TcpClient living in the network thread : nothing here blocks the IHM.
+ *
  * \see postman.h
  *
  * \section License
@@ -38,553 +40,250 @@
 /* ----------------------  INCLUDES  ---------------------------------------- */
 
 #include <cstdlib>
-#include <cstring>
-#include <iostream>
 #include <cstdint>
+#include <cstring>
+#include <atomic>
 #include <pthread.h>
-#include <mqueue.h>
-#include <arpa/inet.h>
-#include <cerrno>
-#include <unistd.h>
+#include <QThread>
+#include <QMetaObject>
 
 #include "defs.h"
+#include "postman.h"
+#include "tcpclient.h"
 #include "dispatcher.h"
-#include "qlogging.h"
+#include "proxyPilot.h"
 
 /* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
 
-/**
- * \enum State_Machine
- * \brief Defines state machine.
- */
-enum State_Machine {
-    S_FORGET=0,
-    S_WAITING_CONNECTION,
-    S_WRITE_MSG_ON_SOCKET,
-    S_DEATH,
-    STATE_NB
-};
-
-/**
- * \enum Action
- * \brief Defines actions of the postman's state machine.
- */
-enum Action {
-    A_NOP=0,
-    A_DISCONNECT,
-    A_CONNECTED,
-    A_CONNECTION_POLLING,
-    A_SEND,
-    A_STOP,
-    ACTION_NB
-};
-
-/**
- * \enum Event
- * \brief Defines events of the postman's state machine.
- */
-enum Event {
-    E_CONNECTION=0,
-    E_WRITE_REQUEST,
-    E_DISCONNECTION,
-    E_POLL_CONNECTION,
-    E_STOP,
-    EVENT_NB
-};
-
-/**
- * \def MQ_POSTMAN_BOX_NAME
- * Name of the message queue
- */
-#define MQ_POSTMAN_BOX_NAME "/mb"
-/**
- * \def MQ_MSG_COUNT
- * Max amount of message into the message queue.
- */
-#define MQ_MSG_COUNT 10
 /**
  * \def SERVER_PORT
  * Server port.
  */
 #define SERVER_PORT 12345
 /**
- * \def SERVER_PORT
+ * \def IP_ADDRESS
  * IP address.
  */
 #define IP_ADDRESS "10.3.141.1"
-
-/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
-/**
- * \struct Mq_Msg_Data postman.c "com/postman.c"
- * \brief Definition of the Mq_Msg_Data type.
- *
- * Mq_Msg_Data contains an event for the state machine. And the message to send through socket.
- */
-typedef struct {
-    Event event; /**< Event to change the state of the state machine. */
-    uint8_t * data; /**< Data to send through socket. */
-} Mq_Msg_Data;
-/**
- * \union Mq_Msg postman.c "com/postman.c"
- * \brief Message queue type as an union.
- *
- * This union allows to transform a buffer into the Mq_Msg_Data structure.
- */
-typedef union {
-	Mq_Msg_Data msg_data; /**< Data structure. */
-	char buffer[sizeof(Mq_Msg_Data)]; /**< Raw message. */
-} Mq_Msg;
-/**
- * \struct Transition postman.c "com/postman.c"
- * \brief Gives an action and state destination for a transition.
- *
- * Transition gives the action to perform when an event has been fired. Also gives the destination state.
- */
-typedef struct {
-	State_Machine state_destination; /**< Next state. */
-	Action action; /**< Action to perform from previous the event. */
-} Transition;
 /**
- * \typedef int(*Action_Pt)(uint8_t * raw_data)
- * \brief Definition of function pointer for the actions to perform.
+ * \def MAX_QUEUED_FRAMES
+ * Frames waiting for the socket above which POSTMAN_send_request() refuses new frames.
  */
-typedef int(*Action_Pt)(uint8_t * raw_data);
+#define MAX_QUEUED_FRAMES 1024
 
+/* ----------------------  PRIVATE TYPE DEFINITIONS  ------------------------ */
 /* ----------------------  PRIVATE STRUCTURES  ------------------------------ */
 /* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
 /* ----------------------  PRIVATE FUNCTIONS PROTOTYPES  -------------------- */
-/* ----- PASSIVES ----- */
 /**
- * \fn static uint8_t* POSTMAN_read_msg(void)
- * \brief Reads messages on the socket.
- * \author Joshua MONTREUIL
- *
- * \param raw_message : raw_message pointer.
- *
- * \return uint8_t* : Raw message in a buffer from socket on success. NULL on failure.
+ * \fn static void set_position_request(uint16_t sequence, bool answered_by_position)
+ * \brief Records whether the request numbered sequence ends with ROBOT_POSITION_RECEIVED. Called under sequence_mutex.
+ * \author Thomas ROCHER
  */
-static uint8_t* POSTMAN_read_msg(void);
-/* ----- ACTIVE ----- */
+static void set_position_request(uint16_t sequence, bool answered_by_position);
 /**
- * \fn static void * POSTMAN_run(void * arg)
- * \brief Called by a thread. This function is the "active" part of the postman. It connects Carto? It reads messages received in the
- * message queue and sends it through socket.
- * \author Joshua MONTREUIL
- *
- * \param arg : argument pointer.
- *
- * \return void * : On success, returns 0. On error, returns -1.
+ * \fn static bool is_position_request(uint16_t sequence)
+ * \brief Tells if ROBOT_POSITION_RECEIVED is the final answer of the request numbered sequence. Called under sequence_mutex.
+ * \author Thomas ROCHER
  */
-static void * POSTMAN_run(void * arg);
-/**
- * \fn static int POSTMAN_mq_receive(Mq_Msg * a_msg)
- * \brief Receives the messages from the queue.
- * \author Joshua MONTREUIL
- *
- * \param a_msg : pointer to Mq_Msg struct.
- *
- * \return On success, returns 0. On error, returns -1.
- */
-static int POSTMAN_mq_receive(Mq_Msg * a_msg);
+static bool is_position_request(uint16_t sequence);
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
 /**
- * \fn static int POSTMAN_mq_send(Mq_Msg * a_msg)
- * \brief Sends a message into the queue.
- * \author Joshua MONTREUIL
- *
- * \param a_msg : pointer to Mq_Msg struct.
- *
- * \return On success, returns 0. On error, returns -1.
+ * \var static QThread * network_thread
+ * \brief Thread running the event loop of the client.
  */
-static int POSTMAN_mq_send(Mq_Msg * a_msg);
+static QThread * network_thread = nullptr;
 /**
- * \fn void initialize_state_machine(Transition my_state_machine[][EVENT_NB])
- * \brief Initialize the state machine.
- *
- * \param my_state_machine : 2D array representing the state machine.
+ * \var static TcpClient * client
+ * \brief Connection to Carto, lives in network_thread.
  */
-static void initialize_state_machine(Transition my_state_machine[][EVENT_NB]);
-/* ----- ACTIONS ----- */
+static TcpClient * client = nullptr;
 /**
- * \fn static void POSTMAN_action_nop(uint8_t * raw_data)
- * \brief Used to ignore state case that aren't into the state machine.
- * \author Joshua MONTREUIL
- *
- * \param raw_data : raw data to send.
- *
- * \return On success, returns 0. On error, returns -1.
+ * \var static std::atomic<Postman_Receiver> receiver
+ * \brief Function given each frame received, see POSTMAN_set_receiver().
  */
-static int POSTMAN_action_nop(uint8_t * raw_data);
+static std::atomic<Postman_Receiver> receiver(nullptr);
 /**
- * \fn static int POSTMAN_action_disconnection(uint8_t * raw_data)
- * \brief Handles a disconnection.
- * \author Joshua MONTREUIL
- *
- * \param raw_data : raw data to send.
- *
- * \return On success, returns 0. On error, returns -1.
+ * \var static bool_e is_sequenced
+ * \brief The sent frames carry seq and ack (PROTOCOL_CAP_SEQUENCE kept by Carto).
  */
-static int POSTMAN_action_disconnection(uint8_t * raw_data);
+static bool_e is_sequenced = bool_e::FALSE;
 /**
- * \fn static void POSTMAN_action_connected(uint8_t * raw_data)
- * \brief Passive function to log when Carto is connected.
- * \author Joshua MONTREUIL
- *
- * \param raw_data : raw data to send.
- *
- * \return On success, returns 0. On error, returns -1.
+ * \var static uint16_t send_sequence
+ * \brief Sequence number of the last frame sent.
  */
-static int POSTMAN_action_connected(uint8_t * raw_data);
+static uint16_t send_sequence = 0;
 /**
- * \fn static int POSTMAN_action_polling_connection(uint8_t * raw_data))
- * \brief Waits a connection to the socket.
- * \author Joshua MONTREUIL
- *
- * \param a_msg : pointer to Mq_Msg struct.
- *
- * \return On success, returns 0. On error, returns -1.
+ * \var static uint16_t received_sequence
+ * \brief Sequence number of the last frame received, sent back as ack.
  */
-static int POSTMAN_action_polling_connection(uint8_t * raw_data);
+static uint16_t received_sequence = 0;
 /**
- * \fn static int POSTMAN_action_send_msg(uint8_t * raw_data)
- * \brief Sends a message through socket.
- * \author Joshua MONTREUIL
- *
- * \param raw_data : raw data to send.
- *
- * \return On success, returns 0. On error, returns -1.
+ * \var static uint16_t completed_sequence
+ * \brief Last of our requests known to be answered (cumulative).
  */
-static int POSTMAN_action_send_msg(uint8_t * raw_data);
-/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+static uint16_t completed_sequence = 0;
 /**
- * \var static int client_socket
- * \brief Client socket identifier.
+ * \var static uint8_t position_requests[]
+ * \brief One bit per sequence number, set for the requests answered by ROBOT_POSITION_RECEIVED only (SEND_ROBOT_POSITION).
  */
-static int client_socket;
+static uint8_t position_requests[(UINT16_MAX + 1) / 8];
 /**
- * \var static pthread_t postman_thread
- * \brief Postman thread.
+ * \var static pthread_mutex_t sequence_mutex
+ * \brief Keeps the sequence numbers in the order of the outbound queue (IHM and network threads send).
  */
-static pthread_t postman_thread;
-/**
- * \var static mqd_t my_mail_box
- * \brief Message queue reference.
- */
-static mqd_t my_mail_box;
-/**
- * \var static struct sockaddr_in my_address
- * \brief Address parameters of the server.
- */
-static struct sockaddr_in my_address;
-/**
- * \var tatic bool_e is_in_waiting_connection
- * \brief Tells if the postman thread is blocked waiting a connection. (used only for stop).
- */
-static bool_e is_in_waiting_connection = bool_e::FALSE;
-/**
- * \var static const Action_Pt actions_tab[ACTION_NB]
- * \brief Array of function pointer to call from action to perform.
- */
-static const Action_Pt actions_tab[ACTION_NB] = {
-    &POSTMAN_action_nop,
-    &POSTMAN_action_disconnection,
-    &POSTMAN_action_connected,
-    &POSTMAN_action_polling_connection,
-    &POSTMAN_action_send_msg,
-    &POSTMAN_action_nop
-};
-
-static Transition my_state_machine[STATE_NB - 1][EVENT_NB];
+static pthread_mutex_t sequence_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
 
-
 int POSTMAN_create(void) {
-    struct mq_attr mqa = {
-    .mq_maxmsg = MQ_MSG_COUNT,
-    .mq_msgsize = sizeof(Mq_Msg)
-    };
-    errno = 0;
-
-    if((my_mail_box = mq_open(MQ_POSTMAN_BOX_NAME, O_CREAT | O_RDWR | O_EXCL , 0644 ,&mqa)) == -1) {
-        if(errno == EEXIST) {
-            mq_unlink(MQ_POSTMAN_BOX_NAME);
-            if((my_mail_box = mq_open(MQ_POSTMAN_BOX_NAME, O_CREAT | O_RDWR , 0644 ,&mqa)) == -1) {
-                perror("mq_open failed ");
-                return -1;
-            }
-        }
-        else {
-            perror("mq_open failed ");
-            return -1;
+    network_thread = new QThread();
+    network_thread->setObjectName("network");
+    client = new TcpClient(IP_ADDRESS, SERVER_PORT);
+    client->moveToThread(network_thread);
+    // Signaux en file : chaque trame est traitée par un événement à part du thread réseau, jamais dans l'IHM.
+    QObject::connect(client, &TcpClient::frame_received, client, [](const QByteArray &frame) {
+        Postman_Receiver current = receiver;
+        if(current != nullptr) {
+            current(reinterpret_cast<const uint8_t *>(frame.constData()), frame.size());
         }
-    }
-    // Création du socket
-    if ((client_socket = socket(AF_INET, SOCK_STREAM, 0)) == -1) {
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
-        perror("socket failed ");
-        return -1;
-    }
-    my_address.sin_family = AF_INET;
-    my_address.sin_port = htons(SERVER_PORT);
+    }, Qt::QueuedConnection);
+    QObject::connect(client, &TcpClient::connected, client, []() {
+        // Le RESUME suit le HELLO sans attendre : Carto renvoie ce qui manque, ou la carte entière pour une nouvelle session.
+        PROXYPILOT_send_hello();
+        DISPATCHER_resume_session();
+    }, Qt::QueuedConnection);
+    QObject::connect(client, &TcpClient::disconnected, client, []() {
+        DISPATCHER_disconnect();
+    }, Qt::QueuedConnection);
     return 0;
-
-
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
-    return -1;
 }
 
 int POSTMAN_start(void) {
-    if (inet_pton(AF_INET, IP_ADDRESS, &my_address.sin_addr) <= 0) {
-        perror("Erreur lors de la conversion de l'adresse IP");
-        close(client_socket);
-        exit(EXIT_FAILURE);
-    }
-
-    if(pthread_create(&postman_thread, NULL, POSTMAN_run, NULL) != 0 ) {
+    if(client == nullptr) {
         return -1;
     }
-    return 0;
-}
-
-int POSTMAN_send_request(uint8_t * data) {
-    Mq_Msg my_msg;
-    my_msg.msg_data.event = E_WRITE_REQUEST;
-    my_msg.msg_data.data = data;
-    if(POSTMAN_mq_send(&my_msg) == -1) {
+    network_thread->start();
+    if(!QMetaObject::invokeMethod(client, &TcpClient::open, Qt::QueuedConnection)) {
         return -1;
-    };
-    POSTMAN_action_send_msg(data);
+    }
     return 0;
 }
 
-uint8_t* POSTMAN_read_request(void) {
-    return POSTMAN_read_msg();
-}
-
-int POSTMAN_disconnect(void) {
-    Mq_Msg my_msg;
-    my_msg.msg_data.event = E_DISCONNECTION;
-    my_msg.msg_data.data = nullptr;
-    if(POSTMAN_mq_send(&my_msg) == -1) {
-        return -1;
-    }
-    return 0;
+void POSTMAN_set_receiver(Postman_Receiver new_receiver) {
+    receiver = new_receiver;
 }
 
-int POSTMAN_stop(void) {
-    Mq_Msg my_msg;
-    my_msg.msg_data.event = E_STOP;
-    my_msg.msg_data.data = nullptr;
-    if(POSTMAN_mq_send(&my_msg) == 0 ) {
-        if(pthread_join(postman_thread, NULL) != 0) {
-            return -1;
-        }
+int POSTMAN_send_request(uint8_t * data) {
+    int result = 0;
+    // Numérotée et postée d'un bloc : les trames entrent dans la file dans l'ordre de leurs numéros.
+    pthread_mutex_lock(&sequence_mutex);
+    if(client == nullptr || !client->is_connected() || client->get_queued_frames() >= MAX_QUEUED_FRAMES) {
+        result = -1;
     }
     else {
-        return -1;
-    }
-    if(!client_socket) {
-        if(close(client_socket) == -1) {
-            return -1;
+        if(is_sequenced == bool_e::TRUE) {
+            Message_Type type = PROTOCOL_decode_head(data).msg_type;
+            PROTOCOL_add_sequence(data, ++send_sequence, received_sequence);
+            set_position_request(send_sequence, type == Message_Type::SEND_ROBOT_POSITION
+                                                || type == Message_Type::SEND_ROBOT_POSITION_V2);
         }
+        QByteArray frame(reinterpret_cast<const char *>(data), PROTOCOL_SIZE_FIELD + PROTOCOL_get_u16(data));
+        client->count_queued_frame();
+        TcpClient *target = client;
+        QMetaObject::invokeMethod(client, [target, frame]() {
+            target->enqueue(frame);
+        }, Qt::QueuedConnection);
     }
-    if(mq_close(my_mail_box) == -1) {
-        return -1;
-    }
-    return 0;
+    pthread_mutex_unlock(&sequence_mutex);
+    // La trame a ete allouee par le proxy, comme cote Carto : sa copie est dans la file.
+    std::free(data);
+    return result;
 }
 
-int POSTMAN_destroy(void) {
-    if(mq_unlink(MQ_POSTMAN_BOX_NAME) == -1) {
-        return -1;
-    }
-    return 0;
-}
-/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
-static int POSTMAN_action_send_msg(uint8_t * raw_data) {
-    int amount_sent;
-    int message_size = raw_data[0] << 8 | raw_data[1];
-    if((amount_sent = write(client_socket, raw_data, (message_size+2))) == -1 && errno != EPIPE) {
-        return -1;
-    }
-    else if(errno == EPIPE) {
-        Mq_Msg my_msg;
-        my_msg.msg_data.event = E_DISCONNECTION;
-        my_msg.msg_data.data = nullptr;
-        if(POSTMAN_mq_send(&my_msg) == -1) {
-            return -1;
-        }
-    }
-    else if(amount_sent < message_size + 2) {
-        if(write(client_socket, raw_data, sizeof(raw_data)) == -1) {
-            return -1;
-        }
-    }
-    return 0;
+bool POSTMAN_is_connected(void) {
+    return client != nullptr && client->is_connected();
 }
 
-static uint8_t* POSTMAN_read_msg(void) {
-    uint8_t size_check[2];
-    errno = 0;
-    int read_size = read(client_socket, size_check, 2);
-    if(read_size == -1 ){
-        if(errno == EBADF) {
-            uint8_t * error_buffer = NULL;
-            error_buffer = (uint8_t*)malloc(1);
-            *error_buffer = (uint8_t) errno;
-            return error_buffer;
-        }
-        else {
-            return NULL;
-        }
-    }
-    else if(read_size == 0)
-    {
-        DISPATCHER_disconnect();
-        POSTMAN_disconnect();
-        return NULL;
-    }
-    else {
-        int data_size = size_check[0] << 8 | size_check[1];
-        uint8_t data_buff[data_size];
-        if (read(client_socket, data_buff, data_size) == -1) {
-            return NULL;
-        }
-        uint8_t * raw_message = NULL;
-        if(data_size >= 2) {
-            data_size +=2;
-            raw_message = (uint8_t *) malloc(data_size);
-            memcpy(raw_message, size_check, 2);
-            memcpy(raw_message + 2, data_buff, data_size);
-        }
-        else {
-            raw_message = (uint8_t *) malloc(data_size);
-            memcpy(raw_message, size_check, 2);
-        }
-
-        return raw_message;
-    }
+void POSTMAN_set_sequencing(bool_e sequenced) {
+    pthread_mutex_lock(&sequence_mutex);
+    is_sequenced = sequenced;
+    send_sequence = 0;
+    received_sequence = 0;
+    completed_sequence = 0;
+    std::memset(position_requests, 0, sizeof(position_requests));
+    pthread_mutex_unlock(&sequence_mutex);
 }
 
-static void * POSTMAN_run(void * arg) {
-    Mq_Msg msg;
-    State_Machine my_state = S_WAITING_CONNECTION;
-    if(actions_tab[A_CONNECTION_POLLING](NULL) == -1) {
-        return NULL;
+void POSTMAN_acknowledge(Communication_Protocol_Head head) {
+    pthread_mutex_lock(&sequence_mutex);
+    received_sequence = head.seq;
+    // Carto traite les requêtes dans l'ordre : un ack n termine les requêtes d'avant, la réponse finale termine n.
+    // Un SEND_MOVE_CARTOGRAPHY reçoit ROBOT_POSITION_RECEIVED puis MOVE_DONE : seul MOVE_DONE le termine.
+    bool final_answer = (head.msg_type == Message_Type::MOVE_DONE)
+                     || (head.msg_type == Message_Type::ROBOT_POSITION_RECEIVED && is_position_request(head.ack));
+    uint16_t completed = final_answer ? head.ack : static_cast<uint16_t>(head.ack - 1);
+    if(PROTOCOL_sequence_distance(completed_sequence, completed) > 0) {
+        completed_sequence = completed;
     }
-    while(my_state != S_DEATH) {
-        if (POSTMAN_mq_receive(&msg) == -1) {
-            return NULL;
-        }
-
-        uint8_t * raw_data = msg.msg_data.data;
+    pthread_mutex_unlock(&sequence_mutex);
+}
 
-        if (my_state == S_WAITING_CONNECTION)
-        {
-            if(msg.msg_data.event == E_POLL_CONNECTION) {
-                POSTMAN_action_polling_connection(raw_data);
-                my_state = S_WAITING_CONNECTION;
-            }
-            else if(msg.msg_data.event == E_CONNECTION) {
-                POSTMAN_action_connected(raw_data);
-                my_state = S_WRITE_MSG_ON_SOCKET;
-            }
-            else if(msg.msg_data.event == E_STOP) {
-                my_state = S_DEATH;
-            }
-            else{
-                POSTMAN_action_nop(raw_data);
-            }
-        }
-        else if (my_state == S_WRITE_MSG_ON_SOCKET)
-        {
-            if(msg.msg_data.event == E_WRITE_REQUEST) {
-                //POSTMAN_action_send_msg(raw_data);
-                my_state = S_WRITE_MSG_ON_SOCKET;
-            }
-            else if(msg.msg_data.event == E_DISCONNECTION) {
-                POSTMAN_action_disconnection(raw_data);
-                my_state = S_WAITING_CONNECTION;
-            }
-            else if(msg.msg_data.event == E_CONNECTION) {
-                POSTMAN_action_connected(raw_data);
-                my_state = S_WRITE_MSG_ON_SOCKET;
-            }
-            else if(msg.msg_data.event == E_STOP) {
-                my_state = S_DEATH;
-            }
-            else {
-                POSTMAN_action_nop(raw_data);
-            }
-        }
-    }
-    return 0;
+uint16_t POSTMAN_get_last_sequence() {
+    pthread_mutex_lock(&sequence_mutex);
+    uint16_t sequence = send_sequence;
+    pthread_mutex_unlock(&sequence_mutex);
+    return sequence;
 }
 
-static int POSTMAN_action_polling_connection(uint8_t * raw_data) {
-    socklen_t addr_len = sizeof(my_address);
-    // Tentative de connexion non bloquante
-    int connect_result = connect(client_socket, reinterpret_cast<struct sockaddr*>(&my_address), addr_len);
-    if (connect_result == 0) {
-        // Connexion réussie immédiatement
-        std::cout << "Connexion réussie." << std::endl;
-        Mq_Msg my_msg;
-        my_msg.msg_data.event = E_CONNECTION;
-        my_msg.msg_data.data = nullptr;
-        if (POSTMAN_mq_send(&my_msg) == -1) {
-            return -1;
-        }
-        DISPATCHER_start_reading();
-        is_in_waiting_connection = bool_e::FALSE;
-    }
-    else {
-        sleep(1);
-        Mq_Msg my_msg;
-        my_msg.msg_data.event = E_POLL_CONNECTION;
-        my_msg.msg_data.data = nullptr;
-        if (POSTMAN_mq_send(&my_msg) == -1) {
-            return -1;
-        }
-    }
-    return 0;
+int POSTMAN_get_in_flight() {
+    pthread_mutex_lock(&sequence_mutex);
+    int in_flight = PROTOCOL_sequence_distance(completed_sequence, send_sequence);
+    pthread_mutex_unlock(&sequence_mutex);
+    return in_flight;
 }
 
-static int POSTMAN_mq_receive(Mq_Msg * a_msg) {
-    if((mq_receive(my_mail_box,a_msg->buffer,sizeof(Mq_Msg), NULL) == -1)) {
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
+int POSTMAN_disconnect(void) {
+    if(client == nullptr || !QMetaObject::invokeMethod(client, &TcpClient::close_link, Qt::QueuedConnection)) {
         return -1;
     }
     return 0;
 }
 
-static int POSTMAN_mq_send(Mq_Msg * a_msg) {
-    if(mq_send(my_mail_box, a_msg->buffer, sizeof(Mq_Msg), 0) == -1) {
-        mq_close(my_mail_box);
-        mq_unlink(MQ_POSTMAN_BOX_NAME);
+int POSTMAN_stop(void) {
+    if(client == nullptr) {
         return -1;
     }
+    if(network_thread->isRunning()) {
+        QMetaObject::invokeMethod(client, &TcpClient::close_link, Qt::BlockingQueuedConnection);
+        network_thread->quit();
+        network_thread->wait();
+    }
     return 0;
 }
 
-static int POSTMAN_action_nop(uint8_t * raw_data) { return 0; }
-
-static int POSTMAN_action_connected(uint8_t * raw_data) {
+int POSTMAN_destroy(void) {
+    // Le thread est arrêté : le client et son socket peuvent être détruits d'ici.
+    delete client;
+    client = nullptr;
+    delete network_thread;
+    network_thread = nullptr;
     return 0;
 }
 
-static int POSTMAN_action_disconnection(uint8_t * raw_data) {
-    if(close(client_socket) == -1) {
-        return -1;
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+
+static void set_position_request(uint16_t sequence, bool answered_by_position) {
+    uint8_t bit = static_cast<uint8_t>(1u << (sequence % 8));
+    if(answered_by_position) {
+        position_requests[sequence / 8] |= bit;
     }
-    Mq_Msg my_msg;
-    my_msg.msg_data.event = E_POLL_CONNECTION;
-    my_msg.msg_data.data = nullptr;
-    if(POSTMAN_mq_send(&my_msg) == -1) {
-        return -1;
+    else {
+        position_requests[sequence / 8] &= static_cast<uint8_t>(~bit);
     }
-    is_in_waiting_connection = bool_e::TRUE;
-    return 0;
+}
+
+static bool is_position_request(uint16_t sequence) {
+    return (position_requests[sequence / 8] & (1u << (sequence % 8))) != 0;
 }
@@ -5,6 +5,9 @@
  * \date May 3, 2023
  * \brief Header file of the postman module. Handles socket connectivity.
  *
+ * C interface of the TcpClient running in the network thread. Frames received are given to the receiver
+ * set by POSTMAN_set_receiver(), in the network thread.
+ *
  * \see postman.c
  *
  * \section License
@@ -38,7 +41,13 @@
 #define SRC_COM_POSTMAN_H_
 /* ----------------------  INCLUDES ------------------------------------------*/
 #include <stdint.h>
+#include "defs.h"
 /* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \typedef void (*Postman_Receiver)(const uint8_t * frame, int size)
+ * \brief Function given each whole frame received (head included), called in the network thread.
+ */
+typedef void (*Postman_Receiver)(const uint8_t * frame, int size);
 /* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
 /* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
 /* ----------------------  PUBLIC VARIABLES -----------------------------------*/
@@ -77,27 +86,54 @@ extern int POSTMAN_start(void);
 extern int POSTMAN_stop(void);
 /**
  * \fn extern int POSTMAN_send_request(uint8_t * data)
- * \brief Sends a message through TCP.
+ * \brief Queues a message to be sent through TCP. Never blocks : the network thread writes it.
  * \author Joshua MONTREUIL
  *
- * \param data : message data to be sent.
+ * \param data : message data to be sent, allocated with malloc() and freed by the postman.
  *
- * \return On success, returns 0. On error, returns -1.
+ * \return On success, returns 0. On error (not connected, queue full), returns -1.
  */
 extern int POSTMAN_send_request(uint8_t * data);
 /**
- * \fn extern uint8_t * POSTMAN_read_request(void)
- * \brief Request a socket read action.
- * \author Joshua MONTREUIL
- *
- * \return uint8_t* : Raw message in a buffer from socket on success. NULL on failure.
+ * \fn extern void POSTMAN_set_receiver(Postman_Receiver receiver)
+ * \brief Sets the function given the frames received (NULL to drop them).
+ * \author Thomas ROCHER
  */
-extern uint8_t* POSTMAN_read_request(void);
+extern void POSTMAN_set_receiver(Postman_Receiver receiver);
 /**
  * \fn extern int POSTMAN_disconnect(void)
  * \brief Disconnect the socket link.
  * \author Joshua MONTREUIL
  */
 extern int POSTMAN_disconnect(void);
+/**
+ * \fn extern bool POSTMAN_is_connected(void)
+ * \brief Tells if the link to Carto is up. Thread-safe.
+ */
+extern bool POSTMAN_is_connected(void);
+/**
+ * \fn extern void POSTMAN_set_sequencing(bool_e sequenced)
+ * \brief Turns the numbering of the sent frames on or off (PROTOCOL_CAP_SEQUENCE) and resets the sequence numbers.
+ * \author Thomas Rocher
+ */
+extern void POSTMAN_set_sequencing(bool_e sequenced);
+/**
+ * \fn extern void POSTMAN_acknowledge(Communication_Protocol_Head head)
+ * \brief Records a sequenced frame received from Carto : its seq is sent back as ack, its ack completes our requests.
+ * \author Thomas Rocher
+ */
+extern void POSTMAN_acknowledge(Communication_Protocol_Head head);
+/**
+ * \fn extern uint16_t POSTMAN_get_last_sequence()
+ * \brief Gives the sequence number of the last request sent.
+ * \author Thomas Rocher
+ */
+extern uint16_t POSTMAN_get_last_sequence();
+/**
+ * \fn extern int POSTMAN_get_in_flight()
+ * \brief Gives the amount of requests sent and not answered yet (0 when the frames are not sequenced).
+ * \author Thomas Rocher
+ */
+extern int POSTMAN_get_in_flight();
 
 #endif /* SRC_COM_POSTMAN_H_ */
@@ -42,54 +42,77 @@
 #include <cstdlib>
 #include <cstring>
 #include <unistd.h>
+#include <atomic>
 #include "postman.h"
-#include "../../../../../usr/include/netinet/in.h" //you have to put your own path to in.h
+
+// Version du protocole de la connexion courante : v1 tant que Carto n'a pas repondu au HELLO.
+static std::atomic<uint8_t> protocol_version(PROTOCOL_VERSION_1);
+// Capacites gardees par Carto dans son HELLO_ACK.
+static std::atomic<uint32_t> protocol_capabilities(0);
+
+// Les trames sont construites par les encodeurs de protocol.h (gros-boutiste, comme Carto).
+// Le postman copie la trame dans la file du client TCP puis la libere : elle doit etre allouee.
+static uint8_t * new_frame() {
+    return static_cast<uint8_t*>(std::malloc(PROTOCOL_MAX_FRAME_SIZE));
+}
+
+void PROXYPILOT_send_hello() {
+    // Un ancien Carto ignore le HELLO : on reste alors en v1.
+    protocol_version = PROTOCOL_VERSION_1;
+    protocol_capabilities = 0;
+    POSTMAN_set_sequencing(bool_e::FALSE);
+    uint8_t *data = new_frame();
+    PROTOCOL_encode_hello(data, HELLO, PROTOCOL_VERSION, PROTOCOL_CAPABILITIES);
+    POSTMAN_send_request(data);
+}
+
+void PROXYPILOT_request_map_snapshot() {
+    // Un Carto qui reprend les sessions envoie la carte de lui-même en réponse au RESUME.
+    uint8_t *data = new_frame();
+    PROTOCOL_encode_head(data, MAP_SNAPSHOT_REQUEST, 0);
+    POSTMAN_send_request(data);
+}
+
+void PROXYPILOT_send_resume(uint32_t token, uint32_t map_version, uint32_t moves_done) {
+    uint8_t *data = new_frame();
+    Protocol_Msg_Resume resume = {token, map_version, moves_done};
+    PROTOCOL_write_resume(data, &resume);
+    POSTMAN_send_request(data);
+}
+
+void PROXYPILOT_set_protocol(uint8_t version, uint32_t capabilities) {
+    protocol_version = version;
+    protocol_capabilities = capabilities;
+    POSTMAN_set_sequencing((capabilities & PROTOCOL_CAP_SEQUENCE) ? bool_e::TRUE : bool_e::FALSE);
+}
+
+uint8_t PROXYPILOT_get_protocol_version() {
+    return protocol_version;
+}
 
 void PROXYPILOT_stop_robot() {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = Message_Type::STOP_ROBOT;
-    msg_to_send.msg_size = htons(0x0002);
-    uint8_t *data = static_cast<uint8_t*>(std::malloc(2 + ntohs(msg_to_send.msg_size)));
-    std::memcpy(data, &msg_to_send, 4);
+    uint8_t *data = new_frame();
+    PROTOCOL_encode_signal(data, STOP_ROBOT);
     POSTMAN_send_request(data);
-    std::free(data);
 }
 
 void PROXYPILOT_send_robot_position(int coord_x, int coord_y, int direction) {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = Message_Type::SEND_ROBOT_POSITION;
-    msg_to_send.msg_size = htons(0x0005);
-    uint8_t buf[3] = {static_cast<uint8_t>(coord_x), static_cast<uint8_t>(coord_y), static_cast<uint8_t>(direction)};
-    uint8_t *data = static_cast<uint8_t*>(std::malloc(2 + ntohs(msg_to_send.msg_size))); //ou sans le ntohs
-    std::memcpy(data, &msg_to_send, 4);
-    std::memcpy(data+4, buf, sizeof(buf));
+    uint8_t *data = new_frame();
+    PROTOCOL_encode_robot_position(data, protocol_version, coord_x, coord_y, static_cast<Direction>(direction));
     POSTMAN_send_request(data);
-    std::free(data);
 }
 
 void PROXYPILOT_send_move_cartography(Command command) {
-    Communication_Protocol_Head msg_to_send;
-    msg_to_send.msg_type = Message_Type::SEND_MOVE_CARTOGRAPHY;
-    msg_to_send.msg_size = htons(0x0002);
-    uint8_t buf = static_cast<uint8_t>(command);
-    uint8_t *data = static_cast<uint8_t*>(std::malloc(2 + ntohs(msg_to_send.msg_size)));
-    std::memcpy(data, &msg_to_send, 4);
-    std::memcpy(data+4, &buf, sizeof(buf));
+    uint8_t *data = new_frame();
+    PROTOCOL_encode_move_cartography(data, command);
     POSTMAN_send_request(data);
-    std::free(data);
 }
 
 void PROXYPILOT_send_moves_trajectory(Command command[], int size) {
     for(int i = 0; i < size; i++) {
-        Communication_Protocol_Head msg_to_send;
-        msg_to_send.msg_type = Message_Type::SEND_MOVES_TRAJECTORY;
-        msg_to_send.msg_size = htons(0x0004);
-        uint8_t buf[2] = {static_cast<uint8_t>(size), static_cast<uint8_t>(command[i])};
-        uint8_t *data = static_cast<uint8_t*>(std::malloc(2 + ntohs(msg_to_send.msg_size)));
-        std::memcpy(data, &msg_to_send, 4);
-        std::memcpy(data+4, buf, sizeof(buf));
+        uint8_t *data = new_frame();
+        PROTOCOL_encode_move_trajectory(data, size, command[i]);
         POSTMAN_send_request(data);
-        std::free(data);
     }
 }
 
@@ -36,6 +36,41 @@
 
 #include "defs.h"
 
+/**
+ * \fn extern void PROXYPILOT_send_hello()
+ * \brief Opens the session : offers the protocol v2 to Carto. The link stays in v1 until the HELLO_ACK.
+ * \author Thomas Rocher
+ */
+extern void PROXYPILOT_send_hello();
+
+/**
+ * \fn extern void PROXYPILOT_request_map_snapshot()
+ * \brief Asks Carto for its whole map (MAP_SNAPSHOT_REQUEST). Sent at the HELLO_ACK of a Carto that cannot resume sessions.
+ * \author Thomas Rocher
+ */
+extern void PROXYPILOT_request_map_snapshot();
+
+/**
+ * \fn extern void PROXYPILOT_send_resume(uint32_t token, uint32_t map_version, uint32_t moves_done)
+ * \brief Resumes the session after a reconnection (token 0 : new session). Sent right after the HELLO, ignored by a Carto without CAP_RESUME.
+ * \author Thomas Rocher
+ */
+extern void PROXYPILOT_send_resume(uint32_t token, uint32_t map_version, uint32_t moves_done);
+
+/**
+ * \fn extern void PROXYPILOT_set_protocol(uint8_t version, uint32_t capabilities)
+ * \brief Records the version and capabilities answered by Carto in HELLO_ACK.
+ * \author Thomas Rocher
+ */
+extern void PROXYPILOT_set_protocol(uint8_t version, uint32_t capabilities);
+
+/**
+ * \fn extern uint8_t PROXYPILOT_get_protocol_version()
+ * \brief Gives the protocol version of the current connection.
+ * \author Thomas Rocher
+ */
+extern uint8_t PROXYPILOT_get_protocol_version();
+
 /**
  * \fn extern void PROXYPILOT_stop_robot()
  * \brief Sends a stop's command to the robot.
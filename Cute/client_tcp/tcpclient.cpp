@@ -0,0 +1,231 @@
+/**
+ * \file  tcpclient.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Source file of the TCP client of Cute.
+ *
+ * \see tcpclient.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+/* ----------------------  INCLUDES  ---------------------------------------- */
+#include "tcpclient.h"
+#include "defs.h"
+
+#include <QTcpSocket>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <QDebug>
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def RETRY_MIN_DELAY_MS
+ * Delay before the first connection attempt after a failure, doubled at each new failure.
+ */
+#define RETRY_MIN_DELAY_MS 50
+/**
+ * \def RETRY_MAX_DELAY_MS
+ * Longest delay between two connection attempts.
+ */
+#define RETRY_MAX_DELAY_MS 2000
+/**
+ * \def CONNECT_TIMEOUT_MS
+ * Time given to a connection attempt before it is dropped (link down, SYN lost).
+ */
+#define CONNECT_TIMEOUT_MS 1500
+/**
+ * \def OUTBOUND_HIGH_WATER
+ * Bytes handed to the socket and not written yet above which the outbound queue waits for bytesWritten().
+ */
+#define OUTBOUND_HIGH_WATER 16384
+/**
+ * \def CLOSE_TIMEOUT_MS
+ * Time given to the last frames to leave when the link is closed.
+ */
+#define CLOSE_TIMEOUT_MS 500
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+TcpClient::TcpClient(const QString &host, quint16 port) : host(host), port(port) {
+}
+
+bool TcpClient::is_connected() const {
+    return link_up;
+}
+
+int TcpClient::get_queued_frames() const {
+    return queued_frames;
+}
+
+void TcpClient::count_queued_frame() {
+    queued_frames++;
+}
+
+void TcpClient::open() {
+    if(retry_timer == nullptr) {
+        // Créés ici et pas dans le constructeur : ils doivent appartenir au thread du client.
+        retry_timer = new QTimer(this);
+        retry_timer->setSingleShot(true);
+        connect(retry_timer, &QTimer::timeout, this, &TcpClient::open);
+        connect_timer = new QTimer(this);
+        connect_timer->setSingleShot(true);
+        connect_timer->setInterval(CONNECT_TIMEOUT_MS);
+        connect(connect_timer, &QTimer::timeout, this, &TcpClient::on_connect_timeout);
+    }
+    is_open = true;
+    if(socket != nullptr && socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+    // Un socket neuf à chaque tentative : rien de la connexion perdue (erreur, octets en attente) ne passe à la suivante.
+    drop_socket();
+    socket = new QTcpSocket(this);
+    connect(socket, &QTcpSocket::connected, this, &TcpClient::on_connected);
+    connect(socket, &QTcpSocket::disconnected, this, &TcpClient::on_disconnected);
+    connect(socket, &QTcpSocket::errorOccurred, this, &TcpClient::on_error);
+    connect(socket, &QTcpSocket::readyRead, this, &TcpClient::on_ready_read);
+    connect(socket, &QTcpSocket::bytesWritten, this, &TcpClient::flush);
+    inbound.clear();
+    socket->connectToHost(host, port);
+    connect_timer->start();
+}
+
+void TcpClient::close_link() {
+    is_open = false;
+    if(retry_timer != nullptr) {
+        retry_timer->stop();
+        connect_timer->stop();
+    }
+    if(socket != nullptr && socket->state() == QAbstractSocket::ConnectedState) {
+        // Les dernières trames (STOP_ROBOT) partent avant la fermeture.
+        while(!outbound.isEmpty()) {
+            socket->write(outbound.dequeue());
+            queued_frames--;
+        }
+        socket->disconnectFromHost();
+        if(socket->state() != QAbstractSocket::UnconnectedState) {
+            socket->waitForDisconnected(CLOSE_TIMEOUT_MS);
+        }
+    }
+    if(socket != nullptr) {
+        socket->abort();
+    }
+    link_up = false;
+    drop_queue();
+}
+
+void TcpClient::enqueue(const QByteArray &frame) {
+    if(!link_up) {
+        // Trame postée juste avant une coupure : sa session n'existe plus.
+        queued_frames--;
+        return;
+    }
+    outbound.enqueue(frame);
+    flush();
+}
+
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+void TcpClient::on_connected() {
+    // Petites trames de commande : pas d'attente de Nagle.
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    qDebug() << "Connexion réussie.";
+    connect_timer->stop();
+    retry_delay_ms = 0;
+    link_up = true;
+    emit connected();
+}
+
+void TcpClient::on_disconnected() {
+    link_up = false;
+    drop_queue();
+    inbound.clear();
+    emit disconnected();
+    schedule_retry();
+}
+
+void TcpClient::on_error(QAbstractSocket::SocketError error) {
+    // Une connexion refusée n'émet pas disconnected() : la relance part d'ici.
+    if(!link_up && socket->state() == QAbstractSocket::UnconnectedState) {
+        qDebug() << "Connexion impossible :" << error;
+        connect_timer->stop();
+        schedule_retry();
+    }
+}
+
+void TcpClient::on_ready_read() {
+    inbound.append(socket->readAll());
+    int offset = 0;
+    while(inbound.size() - offset >= PROTOCOL_SIZE_FIELD) {
+        int frame_size = PROTOCOL_SIZE_FIELD + PROTOCOL_get_u16(reinterpret_cast<const uint8_t *>(inbound.constData()) + offset);
+        if(inbound.size() - offset < frame_size) {
+            break;
+        }
+        emit frame_received(inbound.mid(offset, frame_size));
+        offset += frame_size;
+    }
+    // Un seul décalage par lecture, même quand elle contient beaucoup de trames.
+    inbound.remove(0, offset);
+}
+
+void TcpClient::on_connect_timeout() {
+    qDebug() << "Connexion sans réponse.";
+    drop_socket();
+    schedule_retry();
+}
+
+void TcpClient::flush() {
+    while(!outbound.isEmpty() && socket->bytesToWrite() < OUTBOUND_HIGH_WATER) {
+        socket->write(outbound.dequeue());
+        queued_frames--;
+    }
+}
+
+void TcpClient::schedule_retry() {
+    if(!is_open || retry_timer->isActive()) {
+        return;
+    }
+    // Attente doublée à chaque échec : une coupure brève se reprend en quelques dizaines de ms, un Carto absent n'est pas harcelé.
+    retry_delay_ms = (retry_delay_ms == 0) ? RETRY_MIN_DELAY_MS : qMin(retry_delay_ms * 2, RETRY_MAX_DELAY_MS);
+    // Gigue égale : une moitié fixe, l'autre tirée, pour que plusieurs Cute coupés ensemble ne reviennent pas ensemble.
+    int half = retry_delay_ms / 2;
+    retry_timer->start(half + QRandomGenerator::global()->bounded(half + 1));
+}
+
+void TcpClient::drop_socket() {
+    if(socket == nullptr) {
+        return;
+    }
+    // Plus aucun signal de l'ancien socket : sa fermeture ne doit ni relancer ni annoncer de coupure.
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+    socket = nullptr;
+}
+
+void TcpClient::drop_queue() {
+    queued_frames -= outbound.size();
+    outbound.clear();
+}
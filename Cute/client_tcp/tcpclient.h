@@ -0,0 +1,142 @@
+/**
+ * \file  tcpclient.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the TCP client of Cute. Non-blocking QTcpSocket driven by the event loop of the network thread.
+ *
+ * The client frames the byte stream (msg_size then msg_size bytes), emits one frame_received() per frame,
+ * and writes its own outbound queue without ever blocking : a slow link only makes the queue grow.
+ *
+ * \see tcpclient.cpp
+ * \see postman.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef SRC_COM_TCPCLIENT_H_
+#define SRC_COM_TCPCLIENT_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <QObject>
+#include <QByteArray>
+#include <QQueue>
+#include <QString>
+#include <QAbstractSocket>
+#include <atomic>
+
+class QTcpSocket;
+class QTimer;
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \class TcpClient tcpclient.h "client_tcp/tcpclient.h"
+ * \brief Connection to Carto. Every slot runs in the thread of the client (see POSTMAN_create()).
+ */
+class TcpClient : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * \fn TcpClient(const QString &host, quint16 port)
+     * \brief Keeps the address of Carto. Nothing is opened before open().
+     */
+    TcpClient(const QString &host, quint16 port);
+    /**
+     * \fn bool is_connected() const
+     * \brief Tells if the link is up. Thread-safe.
+     */
+    bool is_connected() const;
+    /**
+     * \fn int get_queued_frames() const
+     * \brief Gives the amount of frames queued and not handed to the socket yet. Thread-safe.
+     */
+    int get_queued_frames() const;
+    /**
+     * \fn void count_queued_frame()
+     * \brief Counts a frame about to be posted to enqueue(), so that get_queued_frames() sees it at once. Thread-safe.
+     */
+    void count_queued_frame();
+
+public slots:
+    /**
+     * \fn void open()
+     * \brief Connects to Carto on a fresh socket. Retried with an exponential backoff and jitter until connected.
+     */
+    void open();
+    /**
+     * \fn void close_link()
+     * \brief Writes the frames still queued, closes the link and stops the retries.
+     */
+    void close_link();
+    /**
+     * \fn void enqueue(const QByteArray &frame)
+     * \brief Adds a frame to the outbound queue and writes what the socket accepts.
+     */
+    void enqueue(const QByteArray &frame);
+
+signals:
+    /**
+     * \fn void frame_received(const QByteArray &frame)
+     * \brief A whole frame (head included) has been read.
+     */
+    void frame_received(const QByteArray &frame);
+    /**
+     * \fn void connected()
+     * \brief The link is up, the outbound queue is empty.
+     */
+    void connected();
+    /**
+     * \fn void disconnected()
+     * \brief The link is down, the frames still queued have been dropped.
+     */
+    void disconnected();
+
+private slots:
+    void on_connected();
+    void on_disconnected();
+    void on_error(QAbstractSocket::SocketError error);
+    void on_ready_read();
+    void on_connect_timeout();
+    void flush();
+
+private:
+    void schedule_retry();
+    void drop_socket();
+    void drop_queue();
+
+    QString host;                       // Adresse de Carto
+    quint16 port;                       // Port de Carto
+    QTcpSocket *socket = nullptr;       // Socket non bloquant, créé dans le thread du client
+    QTimer *retry_timer = nullptr;      // Relance la connexion
+    QTimer *connect_timer = nullptr;    // Abandonne une tentative sans réponse
+    int retry_delay_ms = 0;             // Attente de la dernière relance, 0 après une connexion réussie
+    bool is_open = false;               // open() appelé et pas de close_link() depuis
+    QByteArray inbound;                 // Octets reçus pas encore découpés en trames
+    QQueue<QByteArray> outbound;        // Trames pas encore données au socket
+    std::atomic<bool> link_up{false};   // Lu par les autres threads
+    std::atomic<int> queued_frames{0};  // Trames postées et pas encore données au socket
+};
+
+#endif /* SRC_COM_TCPCLIENT_H_ */
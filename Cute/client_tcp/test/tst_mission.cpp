@@ -0,0 +1,365 @@
+/**
+ * \file  tst_mission.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Headless test of the mission module : plan() and advance() driven against a scripted map.
+ *
+ * The proxy and the postman are replaced by fakes recording the frames the mission sends. A scripted Carto plays the
+ * moves as the pilot does (ROBOT_POSITION_RECEIVED, MAP_DELTA, SET_ROBOT_POSITION on a move forward, MOVE_DONE) on a
+ * map of obstacles, and the test checks the planned commands, the window of moves in flight and the session resume.
+ *
+ * Without a display : ./tst_mission -platform offscreen
+ *
+ * \see mission.cpp
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+
+/* ----------------------  INCLUDES  ---------------------------------------- */
+
+#include <QtTest>
+#include <QSet>
+#include <QVector>
+
+#include "../mission.h"
+#include "../postman.h"
+#include "../proxyPilot.h"
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def WINDOW
+ * MISSION_WINDOW of mission.cpp : max amount of SEND_MOVE_CARTOGRAPHY in flight.
+ */
+#define WINDOW 8
+/**
+ * \def START_X
+ * Row of the start pose : center of the box of the empty Map, the robot faces SOUTH.
+ */
+#define START_X 10
+/**
+ * \def START_Y
+ * Column of the start pose.
+ */
+#define START_Y 10
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static QVector<Command> sent
+ * \brief Commands sent by the mission with PROXYPILOT_send_move_cartography(), in order.
+ */
+static QVector<Command> sent;
+/**
+ * \var static Protocol_Pose start_pose
+ * \brief Pose sent by the mission with PROXYPILOT_send_robot_position().
+ */
+static Protocol_Pose start_pose;
+
+/* ----------------------  FAKES  ------------------------------------------- */
+
+void PROXYPILOT_send_robot_position(int coord_x, int coord_y, int direction) {
+    start_pose.coord_x = coord_x;
+    start_pose.coord_y = coord_y;
+    start_pose.dir = static_cast<Direction>(direction);
+}
+
+void PROXYPILOT_send_move_cartography(Command command) {
+    sent.append(command);
+}
+
+bool POSTMAN_is_connected(void) {
+    return true;
+}
+
+/* ----------------------  SCRIPTED CARTO  ---------------------------------- */
+/**
+ * \class Carto
+ * \brief Plays the commands sent by the mission on a map of obstacles, as the pilot of Carto does.
+ */
+class Carto {
+public:
+    QSet<quint64> obstacles;    // Cases occupées du monde
+    QSet<quint64> visited;      // Cases où le robot est passé
+    Protocol_Pose pose;         // Pose réelle du robot
+    int played = 0;             // Commandes de sent déjà jouées
+
+    static quint64 key(int32_t coord_x, int32_t coord_y) {
+        return (static_cast<quint64>(static_cast<uint32_t>(coord_x)) << 32) | static_cast<uint32_t>(coord_y);
+    }
+
+    void add_obstacle(int32_t coord_x, int32_t coord_y) {
+        obstacles.insert(key(coord_x, coord_y));
+    }
+
+    // Joue la commande suivante sans rien répondre : son résultat est perdu avec le lien.
+    void move(QVector<Protocol_Cell> *cells, bool *moved) {
+        Command command = sent[played++];
+        *moved = false;
+        if(command == FORWARD) {
+            Protocol_Pose target = pose;
+            switch(pose.dir) {
+                case SOUTH : target.coord_x++; break;
+                case NORTH : target.coord_x--; break;
+                case WEST : target.coord_y--; break;
+                default : target.coord_y++; break;
+            }
+            bool blocked = obstacles.contains(key(target.coord_x, target.coord_y));
+            cells->append(Protocol_Cell{target.coord_x, target.coord_y, static_cast<uint8_t>(blocked ? PROTOCOL_CELL_OBSTACLE : PROTOCOL_CELL_FREE)});
+            if(!blocked) {
+                pose = target;
+                visited.insert(key(pose.coord_x, pose.coord_y));
+                *moved = true;
+            }
+        }
+        else {
+            // Mêmes rotations que le pilote de Carto.
+            static const Direction left[4] = {EAST, WEST, SOUTH, NORTH};
+            static const Direction right[4] = {WEST, EAST, NORTH, SOUTH};
+            pose.dir = (command == LEFT) ? left[pose.dir] : right[pose.dir];
+        }
+    }
+
+    // Joue la commande suivante et envoie ses trames dans l'ordre du pilote.
+    void step() {
+        QVector<Protocol_Cell> cells;
+        bool moved;
+        MISSION_robot_position_received();
+        move(&cells, &moved);
+        MISSION_set_cells(cells.constData(), cells.size());
+        if(moved) {
+            MISSION_set_robot_position(pose.coord_x, pose.coord_y);
+        }
+        MISSION_move_done();
+    }
+
+    // Joue tout ce que la mission envoie jusqu'à la fin de l'exploration.
+    int run(int max_steps) {
+        int steps = 0;
+        while(played < sent.size() && steps < max_steps) {
+            step();
+            steps++;
+        }
+        return steps;
+    }
+};
+
+/* ----------------------  TESTS  ------------------------------------------- */
+
+class TestMission : public QObject {
+    Q_OBJECT
+
+private:
+    Carto carto;
+
+    // Lance la mission, donne les cases connues au départ puis ROBOT_POSITION_RECEIVED.
+    void start(const QVector<Protocol_Cell> &known) {
+        QCOMPARE(MISSION_start(), 0);
+        QCOMPARE(start_pose.coord_x, START_X);
+        QCOMPARE(start_pose.coord_y, START_Y);
+        carto.pose = start_pose;
+        carto.visited.insert(Carto::key(start_pose.coord_x, start_pose.coord_y));
+        MISSION_set_cells(known.constData(), known.size());
+        MISSION_robot_position_received();
+    }
+
+    // Couloirs de west cases libres vers l'ouest et de north vers le nord, murés, partant de la pose de départ.
+    // Les murs sont connus de la mission, la case du bout de chaque couloir et le mur qui la ferme seulement de Carto.
+    static QVector<Protocol_Cell> corridors(int west, int north) {
+        QVector<Protocol_Cell> cells;
+        for(int32_t coord_y = START_Y - west; coord_y < START_Y; coord_y++) {
+            cells.append(Protocol_Cell{START_X, coord_y, PROTOCOL_CELL_FREE});
+            cells.append(Protocol_Cell{START_X - 1, coord_y, PROTOCOL_CELL_OBSTACLE});
+            cells.append(Protocol_Cell{START_X + 1, coord_y, PROTOCOL_CELL_OBSTACLE});
+        }
+        for(int32_t coord_x = START_X - north; coord_x < START_X; coord_x++) {
+            cells.append(Protocol_Cell{coord_x, START_Y, PROTOCOL_CELL_FREE});
+            cells.append(Protocol_Cell{coord_x, START_Y - 1, PROTOCOL_CELL_OBSTACLE});
+            cells.append(Protocol_Cell{coord_x, START_Y + 1, PROTOCOL_CELL_OBSTACLE});
+        }
+        cells.append(Protocol_Cell{START_X + 1, START_Y, PROTOCOL_CELL_OBSTACLE});
+        cells.append(Protocol_Cell{START_X, START_Y + 1, PROTOCOL_CELL_OBSTACLE});
+        return cells;
+    }
+
+    // Monde de Carto autour des couloirs : leurs murs, puis une case libre et un mur au bout de chacun.
+    void build_corridors(int west, int north) {
+        carto = Carto();
+        for(const Protocol_Cell &cell : corridors(west, north)) {
+            if(cell.value == PROTOCOL_CELL_OBSTACLE) {
+                carto.add_obstacle(cell.coord_x, cell.coord_y);
+            }
+        }
+        carto.add_obstacle(START_X - 1, START_Y - west - 1);
+        carto.add_obstacle(START_X + 1, START_Y - west - 1);
+        carto.add_obstacle(START_X, START_Y - west - 2);
+        carto.add_obstacle(START_X - north - 1, START_Y - 1);
+        carto.add_obstacle(START_X - north - 1, START_Y + 1);
+        carto.add_obstacle(START_X - north - 2, START_Y);
+    }
+
+    // Couloirs de la plupart des tests : la case inconnue la plus proche est au bout de celui de l'ouest, en (10, 3).
+    void start_in_corridors() {
+        build_corridors(6, 7);
+        start(corridors(6, 7));
+    }
+
+    // Commandes du plan vers (10, 3) : quart de tour par la droite (SOUTH -> WEST), puis 7 avances.
+    static QVector<Command> corridor_plan() {
+        QVector<Command> commands = {RIGHT};
+        for(int i = 0; i < 7; i++) {
+            commands.append(FORWARD);
+        }
+        return commands;
+    }
+
+private slots:
+    void init() {
+        sent.clear();
+        carto = Carto();
+    }
+
+    void cleanup() {
+        MISSION_stop();
+    }
+
+    void plans_to_the_nearest_frontier() {
+        start_in_corridors();
+        // Le parcours en largeur passe par le couloir de l'ouest (7 cases) plutôt que par celui du nord (8 cases).
+        QCOMPARE(sent, corridor_plan());
+        QCOMPARE(sent.size(), WINDOW);
+    }
+
+    void waits_for_the_unexplored_cell() {
+        start_in_corridors();
+        // La dernière avance entre dans une case inconnue : rien n'est planifié après elle avant son MOVE_DONE.
+        for(int i = 0; i < WINDOW - 1; i++) {
+            carto.step();
+            QCOMPARE(sent.size(), WINDOW);
+        }
+        carto.step();
+        QVERIFY(sent.size() > WINDOW);
+    }
+
+    void explores_a_closed_room() {
+        // Pièce de 5 x 6 cases libres entourée de murs, avec un pilier : la mission s'arrête quand tout est vu.
+        for(int32_t coord_x = 7; coord_x <= 13; coord_x++) {
+            carto.add_obstacle(coord_x, 6);
+            carto.add_obstacle(coord_x, 13);
+        }
+        for(int32_t coord_y = 6; coord_y <= 13; coord_y++) {
+            carto.add_obstacle(7, coord_y);
+            carto.add_obstacle(13, coord_y);
+        }
+        carto.add_obstacle(11, 9);
+        start(QVector<Protocol_Cell>());
+        QCOMPARE(sent.first(), FORWARD);
+        carto.run(1000);
+        QVERIFY(!MISSION_is_running());
+        QCOMPARE(carto.played, sent.size());
+        // Une case libre n'est connue qu'une fois le robot entré : toutes ont été visitées.
+        QCOMPARE(carto.visited.size(), 5 * 6 - 1);
+    }
+
+    void drains_the_window_on_an_obstacle() {
+        // Le couloir du nord est le plus court : demi-tour, puis 8 avances dont les 7 premières sur des cases libres.
+        build_corridors(12, 7);
+        start(corridors(12, 7));
+        QCOMPARE(sent.size(), WINDOW);
+        QCOMPARE(sent.mid(0, 2), QVector<Command>(2, RIGHT));
+        // Un obstacle apparaît sur la 3e avance, sûre et déjà envoyée : les suivantes partent d'une pose fausse.
+        carto.add_obstacle(7, START_Y);
+        Protocol_Cell obstacle = {7, START_Y, PROTOCOL_CELL_OBSTACLE};
+        MISSION_set_cells(&obstacle, 1);
+        // Les 2 avances encore prévues sont oubliées, et rien n'est planifié tant que la fenêtre ne s'est pas vidée.
+        for(int i = 0; i < WINDOW - 1; i++) {
+            carto.step();
+            QCOMPARE(sent.size(), WINDOW);
+        }
+        carto.step();
+        QCOMPARE(carto.pose.coord_x, 8);
+        // Le nouveau plan part de la vraie pose, vers le couloir de l'ouest.
+        QVERIFY(sent.size() > WINDOW);
+        QVERIFY(MISSION_is_running());
+        carto.run(1000);
+        QVERIFY(!MISSION_is_running());
+    }
+
+    void resumes_the_moves_lost_with_the_link() {
+        start_in_corridors();
+        carto.step();
+        carto.step();
+        // Carto fait deux avances de plus, puis le lien tombe avant leurs réponses.
+        QVector<Protocol_Cell> cells;
+        bool moved;
+        carto.move(&cells, &moved);
+        carto.move(&cells, &moved);
+        MISSION_interrupt();
+        carto.played = sent.size();
+        // RESUME : 2 MOVE_DONE manqués, les 4 avances suivantes ne sont jamais arrivées et sont renvoyées.
+        MISSION_resume(2);
+        QCOMPARE(sent.size(), WINDOW + 4);
+        QCOMPARE(sent.mid(WINDOW), QVector<Command>(4, FORWARD));
+        MISSION_move_done();
+        MISSION_move_done();
+        MISSION_set_robot_position(carto.pose.coord_x, carto.pose.coord_y);
+        // La position de fin de reprise est celle du plan : les avances renvoyées continuent sans re-planifier.
+        carto.step();
+        QCOMPARE(sent.size(), WINDOW + 4);
+        carto.run(1000);
+        QVERIFY(!MISSION_is_running());
+    }
+
+    void resyncs_on_the_reported_position() {
+        start_in_corridors();
+        carto.step();
+        carto.step();
+        // Carto fait l'avance suivante mais pas la 2e : un obstacle apparu depuis l'arrête.
+        QVector<Protocol_Cell> cells;
+        bool moved;
+        carto.move(&cells, &moved);
+        carto.add_obstacle(START_X, 7);
+        carto.move(&cells, &moved);
+        QCOMPARE(carto.pose.coord_y, 8);
+        MISSION_interrupt();
+        carto.played = sent.size();
+        MISSION_resume(2);
+        // Les MOVE_DONE rejoués supposent le plan suivi : la position de fin de reprise le corrige et vide la fenêtre.
+        MISSION_move_done();
+        MISSION_move_done();
+        MISSION_set_robot_position(carto.pose.coord_x, carto.pose.coord_y);
+        int resent = sent.size();
+        for(int i = 0; i < 4; i++) {
+            QCOMPARE(sent.size(), resent);
+            carto.step();
+        }
+        QVERIFY(sent.size() > resent);
+        QVERIFY(MISSION_is_running());
+    }
+};
+
+QTEST_MAIN(TestMission)
+#include "tst_mission.moc"
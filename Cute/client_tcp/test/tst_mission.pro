@@ -0,0 +1,19 @@
+TEMPLATE = app
+TARGET = tst_mission
+
+# test de la mission contre une carte scriptee : "make check" le lance, sans affichage avec "-platform offscreen".
+QT = core gui widgets testlib
+CONFIG += testcase
+
+# protocole partage avec Carto (header only).
+INCLUDEPATH += ../../../Protocol
+
+# le proxy et le postman sont remplaces par les faux du test.
+SOURCES += \
+    tst_mission.cpp \
+    ../mission.cpp \
+    ../../map.cpp
+
+HEADERS += \
+    ../mission.h \
+    ../../map.h
@@ -12,6 +12,7 @@ class CustomGraphicsView : public QGraphicsView {
 public:
     using QGraphicsView::QGraphicsView;  // Utiliser le constructeur de QGraphicsView
     explicit CustomGraphicsView(int pixels_on_screen_per_matrix_cell, QGraphicsScene *scene, QWidget *parent = nullptr);
+    void set_pixels_on_screen_per_matrix_cell(int pixels) { pixels_on_screen_per_matrix_cell = pixels; }   // Quand les dimensions de la carte changent
 
 private:
     int pixels_on_screen_per_matrix_cell;
@@ -0,0 +1,344 @@
+/**
+ * \file  chunked_grid.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the chunked grid of Cute : a map without fixed size, growing as the robot explores.
+ *
+ * The cells are stored by square chunks of CHUNKED_GRID_SIDE x CHUNKED_GRID_SIDE, in a hash map keyed by the
+ * coordinates of the chunk. A chunk is allocated at the first write of one of its cells, every other cell reads as
+ * the background value : the memory follows the explored area, and coordinates may be negative (the robot starts
+ * wherever it is and the map grows on every side).
+ *
+ * The chunks are shared between copies of a grid, and copied only when one of the grids writes them (copy on write) :
+ * copying a grid copies pointers, not cells, and the copy keeps the cells of the moment it was made. A writer can thus
+ * hand out immutable versions of a grid (see Map::Snapshot) that other threads read while it keeps writing.
+ *
+ * \see grid.h
+ * \see map.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef GRID_CHUNKED_GRID_H_
+#define GRID_CHUNKED_GRID_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+
+/* ----------------------  PUBLIC CONFIGURATIONS  --------------------------- */
+/**
+ * \def CHUNKED_GRID_SHIFT
+ * log2 of the side of a chunk.
+ */
+#define CHUNKED_GRID_SHIFT 6
+/**
+ * \def CHUNKED_GRID_SIDE
+ * Rows and columns of a chunk (64 x 64 byte cells : 4 kB, one page).
+ */
+#define CHUNKED_GRID_SIDE (1 << CHUNKED_GRID_SHIFT)
+
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \struct GridBounds chunked_grid.h "grid/chunked_grid.h"
+ * \brief rows x cols box starting at (row, col). Empty when rows or cols is 0.
+ */
+struct GridBounds {
+    int row = 0;    // Première ligne de la boîte
+    int col = 0;    // Première colonne de la boîte
+    int rows = 0;   // Nombre de lignes
+    int cols = 0;   // Nombre de colonnes
+
+    bool is_empty() const { return rows == 0 || cols == 0; }
+    bool contains(int r, int c) const { return r >= row && r < row + rows && c >= col && c < col + cols; }
+    bool operator==(const GridBounds &other) const { return row == other.row && col == other.col && rows == other.rows && cols == other.cols; }
+    bool operator!=(const GridBounds &other) const { return !(*this == other); }
+    /**
+     * \fn GridBounds united(const GridBounds &other) const
+     * \brief Smallest box holding both boxes.
+     */
+    GridBounds united(const GridBounds &other) const {
+        if(is_empty()) {
+            return other;
+        }
+        if(other.is_empty()) {
+            return *this;
+        }
+        GridBounds box;
+        box.row = std::min(row, other.row);
+        box.col = std::min(col, other.col);
+        box.rows = std::max(row + rows, other.row + other.rows) - box.row;
+        box.cols = std::max(col + cols, other.col + other.cols) - box.col;
+        return box;
+    }
+};
+
+/**
+ * \class ChunkedGrid chunked_grid.h "grid/chunked_grid.h"
+ * \brief Unbounded grid, allocated by chunks on first write. Not thread-safe, even for reads (get() caches the last chunk).
+ *
+ * A copy shares the chunks of the original. A copy made in the writing thread can be read by another thread while the
+ * original is written : the original copies a shared chunk before writing it, and the copy is never touched.
+ */
+template<typename T>
+class ChunkedGrid {
+public:
+    /**
+     * \fn ChunkedGrid(const T &background)
+     * \brief Empty grid : every cell reads as background.
+     */
+    explicit ChunkedGrid(const T &background = T()) : background(background) {}
+    ChunkedGrid(const ChunkedGrid &other) : chunks(other.chunks), background(other.background), box(other.box) {}
+    ChunkedGrid &operator=(const ChunkedGrid &other) {
+        chunks = other.chunks;
+        background = other.background;
+        box = other.box;
+        cached_key = NO_CHUNK;
+        cached_chunk = nullptr;
+        return *this;
+    }
+
+    /**
+     * \fn GridBounds bounds() const
+     * \brief Smallest box holding every cell written since the last clear().
+     */
+    GridBounds bounds() const { return box; }
+    /**
+     * \fn size_t chunk_count() const
+     * \brief Amount of chunks allocated.
+     */
+    size_t chunk_count() const { return chunks.size(); }
+    const T &get_background() const { return background; }
+
+    /**
+     * \fn const T &get(int row, int col) const
+     * \brief Cell (row, col), background if its chunk was never written.
+     */
+    const T &get(int row, int col) const {
+        const Grid<T> *chunk = find_chunk(key_of(row, col));
+        return (chunk == nullptr) ? background : chunk->at(row & (CHUNKED_GRID_SIDE - 1), col & (CHUNKED_GRID_SIDE - 1));
+    }
+    /**
+     * \fn void set(int row, int col, const T &value)
+     * \brief Writes a cell, allocating its chunk if needed.
+     */
+    void set(int row, int col, const T &value) {
+        chunk_of(row, col).at(row & (CHUNKED_GRID_SIDE - 1), col & (CHUNKED_GRID_SIDE - 1)) = value;
+        box = box.united(GridBounds{row, col, 1, 1});
+    }
+    /**
+     * \fn void fill(const GridBounds &area, const T &value)
+     * \brief Writes every cell of area, chunk by chunk.
+     */
+    void fill(const GridBounds &area, const T &value) {
+        for_each_chunk_in(area, true, [&value](GridView<T> cells, int, int) {
+            cells.fill(value);
+        });
+        box = box.united(area);
+    }
+    /**
+     * \fn void update(const GridBounds &area, F visit)
+     * \brief Calls visit(cells, row, col) on the part of area in each chunk, allocating it, (row, col) being the first cell of the part.
+     * The rows of each part are contiguous : visit can run span kernels on them.
+     */
+    template<typename F>
+    void update(const GridBounds &area, F visit) {
+        for_each_chunk_in(area, true, visit);
+        box = box.united(area);
+    }
+    /**
+     * \fn void clear()
+     * \brief Frees every chunk : every cell reads as background again.
+     */
+    void clear() {
+        chunks.clear();
+        box = GridBounds();
+        cached_key = NO_CHUNK;
+        cached_chunk = nullptr;
+    }
+    /**
+     * \fn size_t count(const T &value) const
+     * \brief Counts the cells equal to value in the allocated chunks (8 at a time for byte cells).
+     */
+    size_t count(const T &value) const {
+        size_t found = 0;
+        for(const auto &chunk : chunks) {
+            found += chunk.second->count(value);
+        }
+        return found;
+    }
+    /**
+     * \fn size_t replace(const T &from, const T &to)
+     * \brief Sets to to the cells equal to from in the allocated chunks : from should not be the background.
+     * \return The amount of cells replaced.
+     */
+    size_t replace(const T &from, const T &to) {
+        size_t replaced = 0;
+        for(auto &chunk : chunks) {
+            // Un morceau partagé sans case à remplacer n'est pas copié
+            if(chunk.second->count(from) != 0) {
+                replaced += unshare(chunk.second).replace(from, to);
+            }
+        }
+        return replaced;
+    }
+    /**
+     * \fn void copy_to(const GridView<T> &destination, int row, int col) const
+     * \brief Copies the box of the size of destination starting at (row, col), background included.
+     */
+    void copy_to(const GridView<T> &destination, int row, int col) const {
+        destination.fill(background);
+        GridBounds area{row, col, destination.rows(), destination.cols()};
+        const_cast<ChunkedGrid *>(this)->for_each_chunk_in(area, false, [&destination, row, col](GridView<T> cells, int first_row, int first_col) {
+            destination.sub(first_row - row, first_col - col, cells.rows(), cells.cols()).copy_from(GridView<const T>(cells));
+        });
+    }
+    /**
+     * \fn void copy_from(const GridView<const T> &source, int row, int col)
+     * \brief Writes the cells of source at (row, col).
+     */
+    void copy_from(const GridView<const T> &source, int row, int col) {
+        GridBounds area{row, col, source.rows(), source.cols()};
+        for_each_chunk_in(area, true, [&source, row, col](GridView<T> cells, int first_row, int first_col) {
+            cells.copy_from(source.sub(first_row - row, first_col - col, cells.rows(), cells.cols()));
+        });
+        box = box.united(area);
+    }
+    /**
+     * \fn void for_each_chunk(F visit) const
+     * \brief Calls visit(cells, row, col) for every allocated chunk, (row, col) being its first cell.
+     */
+    template<typename F>
+    void for_each_chunk(F visit) const {
+        for(const auto &chunk : chunks) {
+            visit(static_cast<const Grid<T> &>(*chunk.second).view(), static_cast<int32_t>(static_cast<uint32_t>(chunk.first >> 32)) * CHUNKED_GRID_SIDE, static_cast<int32_t>(static_cast<uint32_t>(chunk.first)) * CHUNKED_GRID_SIDE);
+        }
+    }
+
+private:
+    /**
+     * \struct KeyHash
+     * \brief Mixes both halves of a chunk key (the std::hash of an integer is the identity with libstdc++).
+     */
+    struct KeyHash {
+        size_t operator()(uint64_t key) const {
+            key ^= key >> 33;
+            key *= UINT64_C(0xFF51AFD7ED558CCD);
+            key ^= key >> 33;
+            return static_cast<size_t>(key);
+        }
+    };
+
+    static constexpr uint64_t NO_CHUNK = UINT64_C(0x8000000000000000);    // Clé d'aucun morceau : un indice de morceau tient sur 26 bits (UINT64_MAX est le morceau (-1, -1))
+
+    /**
+     * \fn static int chunk_index(int coord)
+     * \brief Chunk of a row or column, rounded down for negative coordinates.
+     */
+    static int chunk_index(int coord) {
+        return (coord < 0) ? ~(~coord >> CHUNKED_GRID_SHIFT) : (coord >> CHUNKED_GRID_SHIFT);
+    }
+    static uint64_t key_of(int row, int col) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunk_index(row))) << 32) | static_cast<uint32_t>(chunk_index(col));
+    }
+    const Grid<T> *find_chunk(uint64_t key) const {
+        if(key != cached_key) {
+            // Cases voisines lues à la suite (affichage, parcours) : la plupart des accès restent dans le même morceau.
+            auto found = chunks.find(key);
+            cached_chunk = (found == chunks.end()) ? nullptr : const_cast<std::shared_ptr<Grid<T>> *>(&found->second);
+            cached_key = key;
+        }
+        return (cached_chunk == nullptr) ? nullptr : cached_chunk->get();
+    }
+    /**
+     * \fn Grid<T> &chunk_of(int row, int col)
+     * \brief Chunk of (row, col), to be written : allocated if needed, copied first if it is shared.
+     */
+    Grid<T> &chunk_of(int row, int col) {
+        uint64_t key = key_of(row, col);
+        const Grid<T> *chunk = find_chunk(key);
+        if(chunk == nullptr) {
+            // Les nœuds d'un unordered_map ne bougent pas au rehash : le pointeur en cache reste valide.
+            cached_chunk = &chunks.emplace(key, std::make_shared<Grid<T>>(CHUNKED_GRID_SIDE, CHUNKED_GRID_SIDE, background)).first->second;
+            cached_key = key;
+            return **cached_chunk;
+        }
+        return unshare(*cached_chunk);
+    }
+    /**
+     * \fn static Grid<T> &unshare(std::shared_ptr<Grid<T>> &chunk)
+     * \brief Makes chunk only owned by this grid, by copying it if a copy of the grid shares it.
+     */
+    static Grid<T> &unshare(std::shared_ptr<Grid<T>> &chunk) {
+        if(chunk.use_count() != 1) {
+            // Les copies gardent l'ancien morceau, la grille écrit dans le sien
+            chunk = std::make_shared<Grid<T>>(*chunk);
+        }
+        else {
+            // Seul propriétaire : les copies qui ont partagé le morceau, détruites dans d'autres threads, ont fini de le lire
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *chunk;
+    }
+    /**
+     * \fn void for_each_chunk_in(const GridBounds &area, bool allocate, F visit)
+     * \brief Calls visit(cells, row, col) for the part of area in each chunk, (row, col) being the first cell of the part.
+     * Chunks never written are skipped, or allocated when allocate is true.
+     */
+    template<typename F>
+    void for_each_chunk_in(const GridBounds &area, bool allocate, F visit) {
+        if(area.is_empty()) {
+            return;
+        }
+        for(int chunk_row = chunk_index(area.row); chunk_row <= chunk_index(area.row + area.rows - 1); chunk_row++) {
+            for(int chunk_col = chunk_index(area.col); chunk_col <= chunk_index(area.col + area.cols - 1); chunk_col++) {
+                int first_row = std::max(area.row, chunk_row * CHUNKED_GRID_SIDE);
+                int first_col = std::max(area.col, chunk_col * CHUNKED_GRID_SIDE);
+                Grid<T> *chunk = allocate ? &chunk_of(first_row, first_col) : const_cast<Grid<T> *>(find_chunk(key_of(first_row, first_col)));
+                if(chunk == nullptr) {
+                    continue;
+                }
+                int last_row = std::min(area.row + area.rows, (chunk_row + 1) * CHUNKED_GRID_SIDE);
+                int last_col = std::min(area.col + area.cols, (chunk_col + 1) * CHUNKED_GRID_SIDE);
+                visit(chunk->view().sub(first_row & (CHUNKED_GRID_SIDE - 1), first_col & (CHUNKED_GRID_SIDE - 1), last_row - first_row, last_col - first_col), first_row, first_col);
+            }
+        }
+    }
+
+    std::unordered_map<uint64_t, std::shared_ptr<Grid<T>>, KeyHash> chunks;  // Morceaux écrits, par coordonnées de morceau (ligne << 32 | colonne), partagés avec les copies
+    T background;                                           // Valeur des cases jamais écrites
+    GridBounds box;                                         // Boîte des cases écrites
+    mutable uint64_t cached_key = NO_CHUNK;                 // Dernier morceau cherché...
+    mutable std::shared_ptr<Grid<T>> *cached_chunk = nullptr;   // ...et son entrée dans chunks (nullptr s'il n'existe pas)
+};
+
+#endif /* GRID_CHUNKED_GRID_H_ */
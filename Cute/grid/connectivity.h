@@ -0,0 +1,329 @@
+/**
+ * \file  connectivity.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the connectivity index of Cute : connected components of the free cells, updated incrementally.
+ *
+ * Every free cell holds a label, and the labels are merged by a union-find : a new free cell takes the component of
+ * its neighbours and joins them, in almost constant time. Removing a cell may split its component, which a union-find
+ * cannot undo : update() gives fresh labels, by flood fill, to the components that lost a cell, and only to them.
+ * Two cells are then connected when their labels have the same root. Cells are 4-connected, like the moves of the robot.
+ *
+ * update() therefore costs the whole size of every component that lost a cell, even when the cell only trimmed its
+ * border : one flood of the explored area per Batch that removes a free cell from it. Every flood takes new labels,
+ * so once the labels outnumber twice the free cells (and CONNECTIVITY_MIN_LABELS), update() compacts them : every free
+ * cell is given the root of its label, renumbered from 1, in one pass over the allocated chunks. The labels then stay
+ * bounded by the free cells, and a pass only comes after the floods have made as many labels as there are free cells.
+ *
+ * \see chunked_grid.h
+ * \see map.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef GRID_CONNECTIVITY_H_
+#define GRID_CONNECTIVITY_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "chunked_grid.h"
+
+/* ----------------------  PUBLIC CONFIGURATIONS  --------------------------- */
+/**
+ * \def CONNECTIVITY_MIN_LABELS
+ * Labels kept without compaction, however few the free cells : a small map is never compacted.
+ */
+#define CONNECTIVITY_MIN_LABELS 4096
+
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \class Connectivity connectivity.h "grid/connectivity.h"
+ * \brief Connected components of the free cells. Not thread-safe, even for reads (find() compresses the paths).
+ *
+ * add_cell() is applied at once, remove_cell() only after update().
+ */
+class Connectivity {
+public:
+    /**
+     * \fn Connectivity()
+     * \brief No free cell.
+     */
+    Connectivity() : labels(0), parents(1, 0) {}
+
+    /**
+     * \fn bool is_free(int row, int col) const
+     * \brief Tells if (row, col) is a free cell.
+     */
+    bool is_free(int row, int col) const {
+        return labels.get(row, col) != 0;
+    }
+    /**
+     * \fn uint32_t component(int row, int col) const
+     * \brief Component of (row, col), 0 for a cell that is not free. Valid until the next change.
+     */
+    uint32_t component(int row, int col) const {
+        return find(labels.get(row, col));
+    }
+    /**
+     * \fn bool connected(int row, int col, int other_row, int other_col) const
+     * \brief Tells if both cells are free and a 4-connected path of free cells joins them.
+     */
+    bool connected(int row, int col, int other_row, int other_col) const {
+        uint32_t first = component(row, col);
+        return first != 0 && first == component(other_row, other_col);
+    }
+    /**
+     * \fn uint32_t get_version() const
+     * \brief Incremented every time components are created, merged or split.
+     */
+    uint32_t get_version() const { return version; }
+    /**
+     * \fn size_t label_count() const
+     * \brief Labels of the union-find, roots or not : at most about twice the free cells after update().
+     */
+    size_t label_count() const { return parents.size() - 1; }
+
+    /**
+     * \fn void add_cell(int row, int col)
+     * \brief Makes (row, col) free : it joins the components of its free neighbours.
+     */
+    void add_cell(int row, int col) {
+        if(is_free(row, col)) {
+            return;
+        }
+        uint32_t label = 0;
+        for(const auto &step : STEPS) {
+            uint32_t neighbour = component(row + step.first, col + step.second);
+            if(neighbour == 0 || neighbour == label) {
+                continue;
+            }
+            if(label != 0) {
+                parents[neighbour] = label;     // Deux composantes se rejoignent par la case
+                version++;
+            }
+            else {
+                label = neighbour;
+            }
+        }
+        if(label == 0) {
+            label = new_label();
+        }
+        labels.set(row, col, label);
+        free_cells++;
+    }
+    /**
+     * \fn void add_cells(const GridView<const uint8_t> &marks, int row, int col, uint8_t mark)
+     * \brief Makes free every cell of marks equal to mark, marks being placed at (row, col) : the cells are labelled run
+     * by run, with one chunk lookup per chunk instead of one per cell.
+     */
+    void add_cells(const GridView<const uint8_t> &marks, int row, int col, uint8_t mark) {
+        labels.update(GridBounds{row, col, marks.rows(), marks.cols()}, [this, &marks, row, col, mark](GridView<uint32_t> part, int first_row, int first_col) {
+            // Label d'une voisine : lu dans le morceau quand elle y est, sinon dans la grille
+            auto neighbour = [this, &part, first_row, first_col](int r, int c) -> uint32_t {
+                bool inside = r >= 0 && r < part.rows() && c >= 0 && c < part.cols();
+                return inside ? part.at(r, c) : labels.get(first_row + r, first_col + c);
+            };
+            for(int r = 0; r < part.rows(); r++) {
+                const uint8_t *line = marks.row(first_row - row + r) + (first_col - col);
+                int c = 0;
+                while(c < part.cols()) {
+                    if(line[c] != mark || part.at(r, c) != 0) {
+                        c++;
+                        continue;
+                    }
+                    // Suite de cases à libérer : une seule composante, jointe à celles des voisines de la suite
+                    int end = c;
+                    while(end < part.cols() && line[end] == mark && part.at(r, end) == 0) {
+                        end++;
+                    }
+                    uint32_t label = join(0, neighbour(r, c - 1));
+                    label = join(label, neighbour(r, end));
+                    for(int k = c; k < end; k++) {
+                        label = join(label, neighbour(r - 1, k));
+                        label = join(label, neighbour(r + 1, k));
+                    }
+                    if(label == 0) {
+                        label = new_label();
+                    }
+                    std::fill(part.row(r) + c, part.row(r) + end, label);
+                    free_cells += end - c;
+                    c = end;
+                }
+            }
+        });
+    }
+    /**
+     * \fn void remove_cell(int row, int col)
+     * \brief Makes (row, col) not free. Its component may be split : it is relabelled by update().
+     */
+    void remove_cell(int row, int col) {
+        if(!is_free(row, col)) {
+            return;
+        }
+        labels.set(row, col, 0);
+        removed.push_back(std::make_pair(row, col));
+        free_cells--;
+    }
+    /**
+     * \fn void update()
+     * \brief Relabels the components that lost cells since the last call, each in one flood fill, then compacts the
+     * labels if they outnumber twice the free cells.
+     */
+    void update() {
+        if(removed.empty()) {
+            return;
+        }
+        // Une composante déjà relabellisée pendant cet appel a un label d'au moins first_label : elle n'est pas reparcourue.
+        uint32_t first_label = static_cast<uint32_t>(parents.size());
+        for(const auto &cell : removed) {
+            for(const auto &step : STEPS) {
+                int row = cell.first + step.first;
+                int col = cell.second + step.second;
+                uint32_t label = labels.get(row, col);
+                if(label != 0 && label < first_label) {
+                    flood(row, col, new_label());
+                }
+            }
+        }
+        removed.clear();
+        version++;
+        if(parents.size() > 2 * free_cells + CONNECTIVITY_MIN_LABELS) {
+            compact();
+        }
+    }
+    /**
+     * \fn void clear()
+     * \brief Removes every free cell and frees every chunk.
+     */
+    void clear() {
+        labels.clear();
+        parents.assign(1, 0);
+        removed.clear();
+        free_cells = 0;
+        version++;
+    }
+
+private:
+    /**
+     * \fn uint32_t find(uint32_t label) const
+     * \brief Root of a label, halving the path on the way.
+     */
+    uint32_t find(uint32_t label) const {
+        while(parents[label] != label) {
+            parents[label] = parents[parents[label]];
+            label = parents[label];
+        }
+        return label;
+    }
+    /**
+     * \fn uint32_t join(uint32_t root, uint32_t label)
+     * \brief Joins the component of label to root (0 : none yet) and returns the root of both.
+     */
+    uint32_t join(uint32_t root, uint32_t label) {
+        label = find(label);
+        if(label == 0 || label == root) {
+            return root;
+        }
+        if(root == 0) {
+            return label;
+        }
+        parents[label] = root;      // Deux composantes se rejoignent par la suite
+        version++;
+        return root;
+    }
+    uint32_t new_label() {
+        uint32_t label = static_cast<uint32_t>(parents.size());
+        parents.push_back(label);
+        version++;
+        return label;
+    }
+    /**
+     * \fn void flood(int row, int col, uint32_t label)
+     * \brief Gives label to every free cell 4-connected to (row, col).
+     */
+    void flood(int row, int col, uint32_t label) {
+        std::vector<std::pair<int, int>> stack(1, std::make_pair(row, col));
+        labels.set(row, col, label);
+        while(!stack.empty()) {
+            std::pair<int, int> cell = stack.back();
+            stack.pop_back();
+            for(const auto &step : STEPS) {
+                int next_row = cell.first + step.first;
+                int next_col = cell.second + step.second;
+                uint32_t next = labels.get(next_row, next_col);
+                if(next != 0 && next != label) {
+                    labels.set(next_row, next_col, label);
+                    stack.push_back(std::make_pair(next_row, next_col));
+                }
+            }
+        }
+    }
+
+    /**
+     * \fn void compact()
+     * \brief Gives every free cell the root of its label, the roots renumbered from 1 : the other labels are dropped.
+     */
+    void compact() {
+        std::vector<uint32_t> renamed(parents.size(), 0);    // Nouveau label de chaque racine, 0 tant qu'aucune case ne l'a
+        std::vector<uint32_t> roots(1, 0);
+        std::vector<std::pair<int, int>> origins;
+        labels.for_each_chunk([&origins](GridView<const uint32_t>, int row, int col) {
+            origins.push_back(std::make_pair(row, col));
+        });
+        for(const auto &origin : origins) {
+            labels.update(GridBounds{origin.first, origin.second, CHUNKED_GRID_SIDE, CHUNKED_GRID_SIDE}, [this, &renamed, &roots](GridView<uint32_t> cells, int, int) {
+                for(int row = 0; row < cells.rows(); row++) {
+                    for(int col = 0; col < cells.cols(); col++) {
+                        uint32_t &label = cells.at(row, col);
+                        if(label == 0) {
+                            continue;
+                        }
+                        uint32_t root = find(label);
+                        if(renamed[root] == 0) {
+                            renamed[root] = static_cast<uint32_t>(roots.size());
+                            roots.push_back(renamed[root]);
+                        }
+                        label = renamed[root];
+                    }
+                }
+            });
+        }
+        parents.swap(roots);
+    }
+
+    static constexpr std::pair<int, int> STEPS[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    ChunkedGrid<uint32_t> labels;               // Label de chaque case libre, 0 pour les autres
+    mutable std::vector<uint32_t> parents;      // Union-find des labels : parents[label] == label pour une racine (0 : pas libre)
+    std::vector<std::pair<int, int>> removed;   // Cases enlevées depuis le dernier update()
+    size_t free_cells = 0;                      // Cases libres, sans les cases enlevées
+    uint32_t version = 0;                       // Changements des composantes
+};
+
+#endif /* GRID_CONNECTIVITY_H_ */
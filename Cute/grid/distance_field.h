@@ -0,0 +1,287 @@
+/**
+ * \file  distance_field.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the distance field of Cute : distance from every cell to its nearest obstacle, updated incrementally.
+ *
+ * Dynamic brushfire (Lau, Sprunk and Burgard, 2010) : every cell keeps its nearest obstacle, and the changes spread
+ * from the cells that changed in order of distance. A new obstacle lowers the distances around it ; a removed obstacle
+ * first raises (clears) the cells that pointed to it, then the obstacles around refill them. Only the cells whose
+ * nearest obstacle changes are visited, and nothing is computed farther than the range given to the constructor :
+ * the chunks allocated follow the obstacles, not the size of the map.
+ *
+ * \see chunked_grid.h
+ * \see map.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef GRID_DISTANCE_FIELD_H_
+#define GRID_DISTANCE_FIELD_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "chunked_grid.h"
+
+/* ----------------------  PUBLIC CONFIGURATIONS  --------------------------- */
+/**
+ * \def DISTANCE_FIELD_FAR
+ * Squared distance of a cell farther than the range from every obstacle.
+ */
+#define DISTANCE_FIELD_FAR UINT16_MAX
+/**
+ * \def DISTANCE_FIELD_MAX_RANGE
+ * Longest range : the nearest obstacle of a cell is kept as an int8 offset.
+ */
+#define DISTANCE_FIELD_MAX_RANGE 127
+
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \class DistanceField distance_field.h "grid/distance_field.h"
+ * \brief Squared euclidean distance (in cells) from every cell to its nearest obstacle, up to a range. Not thread-safe.
+ *
+ * set_obstacle() and remove_obstacle() only queue the change : update() spreads every queued change at once.
+ */
+class DistanceField {
+public:
+    /**
+     * \fn DistanceField(int range)
+     * \brief No obstacle. range (at most DISTANCE_FIELD_MAX_RANGE) is the longest distance computed.
+     */
+    explicit DistanceField(int range) : cells(Cell{DISTANCE_FIELD_FAR, 0, 0, 0}), range(range), range_squared(range * range) {}
+
+    /**
+     * \fn bool is_obstacle(int row, int col) const
+     * \brief Tells if (row, col) has been set as an obstacle.
+     */
+    bool is_obstacle(int row, int col) const {
+        return (cells.get(row, col).flags & OCCUPIED) != 0;
+    }
+    /**
+     * \fn int squared_distance(int row, int col) const
+     * \brief Squared distance from (row, col) to its nearest obstacle, DISTANCE_FIELD_FAR beyond the range. Up to date after update().
+     */
+    int squared_distance(int row, int col) const {
+        return cells.get(row, col).squared;
+    }
+    /**
+     * \fn void set_obstacle(int row, int col)
+     * \brief Adds an obstacle at (row, col).
+     */
+    void set_obstacle(int row, int col) {
+        Cell cell = cells.get(row, col);
+        if(cell.flags & OCCUPIED) {
+            return;
+        }
+        // Une levée encore en attente sur la case est gardée : les cases qui pointaient vers un autre obstacle par elle doivent être vidées.
+        cells.set(row, col, Cell{0, 0, 0, static_cast<uint8_t>(OCCUPIED | (cell.flags & RAISE))});
+        open.push(Entry{0, row, col});
+    }
+    /**
+     * \fn void build(const GridView<const uint8_t> &marks, const GridBounds &area, uint8_t mark)
+     * \brief Sets the obstacles of area and computes the distances of its cells at once, without spreading anything :
+     * marks holds the cells of area grown by the range on every side, mark for an obstacle. For cells that no obstacle
+     * has reached yet (after clear()), each area once : the field is up to date without update().
+     *
+     * Exact distance transform bounded by the range : the nearest obstacle of every column, then of every row.
+     */
+    void build(const GridView<const uint8_t> &marks, const GridBounds &area, uint8_t mark) {
+        // Écart (en lignes) de chaque case de area, colonne par colonne sur toute la largeur de marks, à l'obstacle le plus proche de sa colonne
+        std::vector<int8_t> vertical(static_cast<size_t>(area.rows) * marks.cols(), NO_OBSTACLE);
+        for(int c = 0; c < marks.cols(); c++) {
+            int last = -2 * DISTANCE_FIELD_MAX_RANGE;
+            for(int r = 0; r < range + area.rows; r++) {
+                last = (marks.at(r, c) == mark) ? r : last;
+                if(r >= range && r - last <= range) {
+                    vertical[static_cast<size_t>(r - range) * marks.cols() + c] = static_cast<int8_t>(last - r);
+                }
+            }
+            last = 2 * DISTANCE_FIELD_MAX_RANGE + marks.rows();
+            for(int r = marks.rows() - 1; r >= range; r--) {
+                last = (marks.at(r, c) == mark) ? r : last;
+                int8_t &offset = vertical[static_cast<size_t>(r - range) * marks.cols() + c];
+                if(r < range + area.rows && last - r <= range && (offset == NO_OBSTACLE || last - r < -offset)) {
+                    offset = static_cast<int8_t>(last - r);
+                }
+            }
+        }
+        std::vector<Cell> built(static_cast<size_t>(area.rows) * area.cols, Cell{DISTANCE_FIELD_FAR, 0, 0, 0});
+        bool reached = false;
+        for(int r = 0; r < area.rows; r++) {
+            const int8_t *offsets = &vertical[static_cast<size_t>(r) * marks.cols()];
+            for(int c = 0; c < area.cols; c++) {
+                // NO_OBSTACLE est au-delà de toute portée : la recherche du minimum se passe de test
+                int best = range_squared + 1;
+                int best_col = 0;
+                for(int dc = -range; dc <= range; dc++) {
+                    int dr = offsets[c + range + dc];
+                    int squared = dr * dr + dc * dc;
+                    best_col = (squared < best) ? dc : best_col;
+                    best = std::min(best, squared);
+                }
+                Cell &cell = built[static_cast<size_t>(r) * area.cols + c];
+                if(best <= range_squared) {
+                    cell = Cell{static_cast<uint16_t>(best), offsets[c + range + best_col], static_cast<int8_t>(best_col), 0};
+                }
+                cell.flags = (marks.at(r + range, c + range) == mark) ? OCCUPIED : 0;
+                reached |= cell.squared != DISTANCE_FIELD_FAR;
+            }
+        }
+        // Une zone hors de portée de tout obstacle n'alloue aucun morceau, comme avec update()
+        if(reached) {
+            cells.update(area, [&built, &area](GridView<Cell> part, int first_row, int first_col) {
+                part.copy_from(GridView<const Cell>(built.data(), area.rows, area.cols, area.cols).sub(first_row - area.row, first_col - area.col, part.rows(), part.cols()));
+            });
+        }
+    }
+    /**
+     * \fn void remove_obstacle(int row, int col)
+     * \brief Removes the obstacle at (row, col).
+     */
+    void remove_obstacle(int row, int col) {
+        if(!is_obstacle(row, col)) {
+            return;
+        }
+        cells.set(row, col, Cell{DISTANCE_FIELD_FAR, 0, 0, RAISE});
+        open.push(Entry{0, row, col});
+    }
+    /**
+     * \fn void update()
+     * \brief Spreads the queued changes : only the cells whose nearest obstacle changes are visited.
+     */
+    void update() {
+        while(!open.empty()) {
+            Entry entry = open.top();
+            open.pop();
+            Cell cell = cells.get(entry.row, entry.col);
+            if(cell.flags & RAISE) {
+                raise(entry.row, entry.col);
+                cell = cells.get(entry.row, entry.col);
+            }
+            if(holds_obstacle(entry.row, entry.col, cell)) {
+                lower(entry.row, entry.col, cell);
+            }
+        }
+    }
+    /**
+     * \fn void clear()
+     * \brief Removes every obstacle and frees every chunk.
+     */
+    void clear() {
+        cells.clear();
+        open = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>();
+    }
+
+private:
+    /**
+     * \struct Cell
+     * \brief Nearest obstacle of a cell.
+     */
+    struct Cell {
+        uint16_t squared;       // Carré de la distance à l'obstacle le plus proche, DISTANCE_FIELD_FAR au-delà de la portée
+        int8_t obstacle_row;    // Obstacle le plus proche, relatif à la case
+        int8_t obstacle_col;
+        uint8_t flags;          // OCCUPIED, RAISE
+    };
+    /**
+     * \struct Entry
+     * \brief Cell waiting in the open queue, by squared distance.
+     */
+    struct Entry {
+        int priority;
+        int row;
+        int col;
+        bool operator>(const Entry &other) const { return priority > other.priority; }
+    };
+
+    static constexpr uint8_t OCCUPIED = 1;   // La case est un obstacle
+    static constexpr uint8_t RAISE = 2;      // La case a été vidée, ses voisines qui pointent vers le même obstacle doivent l'être aussi
+    static constexpr int8_t NO_OBSTACLE = INT8_MIN;     // Pas d'obstacle à portée dans la colonne (build) : son carré dépasse DISTANCE_FIELD_MAX_RANGE²
+
+    /**
+     * \fn bool holds_obstacle(int row, int col, const Cell &cell) const
+     * \brief Tells if the nearest obstacle of cell is still an obstacle.
+     */
+    bool holds_obstacle(int row, int col, const Cell &cell) const {
+        return cell.squared != DISTANCE_FIELD_FAR && is_obstacle(row + cell.obstacle_row, col + cell.obstacle_col);
+    }
+    /**
+     * \fn void raise(int row, int col)
+     * \brief Clears the neighbours of a cleared cell that pointed to a removed obstacle, and queues the others to refill them.
+     */
+    void raise(int row, int col) {
+        for(int dr = -1; dr <= 1; dr++) {
+            for(int dc = -1; dc <= 1; dc++) {
+                Cell neighbour = cells.get(row + dr, col + dc);
+                if(neighbour.squared == DISTANCE_FIELD_FAR || (neighbour.flags & RAISE)) {
+                    continue;
+                }
+                open.push(Entry{neighbour.squared, row + dr, col + dc});
+                if(!holds_obstacle(row + dr, col + dc, neighbour)) {
+                    cells.set(row + dr, col + dc, Cell{DISTANCE_FIELD_FAR, 0, 0, static_cast<uint8_t>((neighbour.flags & OCCUPIED) | RAISE)});
+                }
+            }
+        }
+        Cell cell = cells.get(row, col);
+        cell.flags &= ~RAISE;
+        cells.set(row, col, cell);
+    }
+    /**
+     * \fn void lower(int row, int col, const Cell &cell)
+     * \brief Gives the nearest obstacle of cell to the neighbours for which it is nearer than theirs, within the range.
+     */
+    void lower(int row, int col, const Cell &cell) {
+        int obstacle_row = row + cell.obstacle_row;
+        int obstacle_col = col + cell.obstacle_col;
+        for(int dr = -1; dr <= 1; dr++) {
+            for(int dc = -1; dc <= 1; dc++) {
+                // get() n'alloue rien : seules les cases à portée d'un obstacle ont un morceau
+                Cell neighbour = cells.get(row + dr, col + dc);
+                if(neighbour.flags & RAISE) {
+                    continue;
+                }
+                int offset_row = obstacle_row - (row + dr);
+                int offset_col = obstacle_col - (col + dc);
+                int squared = offset_row * offset_row + offset_col * offset_col;
+                if(squared < neighbour.squared && squared <= range_squared) {
+                    cells.set(row + dr, col + dc, Cell{static_cast<uint16_t>(squared), static_cast<int8_t>(offset_row), static_cast<int8_t>(offset_col), neighbour.flags});
+                    open.push(Entry{squared, row + dr, col + dc});
+                }
+            }
+        }
+    }
+
+    ChunkedGrid<Cell> cells;    // Obstacle le plus proche de chaque case, alloué autour des obstacles seulement
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;     // Cases dont le changement doit encore se propager, la plus proche d'abord
+    int range;                  // Portée
+    int range_squared;          // Carré de la portée
+};
+
+#endif /* GRID_DISTANCE_FIELD_H_ */
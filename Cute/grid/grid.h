@@ -0,0 +1,342 @@
+/**
+ * \file  grid.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the grids of Cute : cells of a map in one runtime-sized, row-major buffer.
+ *
+ * A Grid owns its cells, a GridView only points at them : a view has its own stride, so that a sub-rectangle of a
+ * grid is read and written in place, without copy. Views are only valid until the grid is resized.
+ *
+ * Byte cells (uint8_t) are counted and replaced 8 at a time (see swar.h), the other types cell by cell.
+ *
+ * \see map.h
+ * \see swar.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef GRID_GRID_H_
+#define GRID_GRID_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+#include "swar.h"
+
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \class GridView grid.h "grid/grid.h"
+ * \brief rows x cols cells, row r starting stride cells after row r - 1. Does not own the cells.
+ */
+template<typename T>
+class GridView {
+public:
+    /**
+     * \class Iterator
+     * \brief Walks the cells of a view row by row, skipping the cells between the end of a row and the next row.
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename std::remove_const<T>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+        Iterator(const GridView &view, int row, int col) : first(view.data()), n_rows(view.rows()), n_cols(view.cols()), n_stride(view.stride()), r(row), c(col) {
+            cell = (r < n_rows && !view.is_empty()) ? first + static_cast<long>(r) * n_stride + c : nullptr;
+        }
+
+        T &operator*() const { return *cell; }
+        T *operator->() const { return cell; }
+        int row() const { return r; }
+        int col() const { return c; }
+        Iterator &operator++() {
+            if(++c < n_cols) {
+                cell++;
+            }
+            else {
+                // Saut du reste de la ligne (stride - cols cases) vers le début de la ligne suivante.
+                c = 0;
+                cell = (++r < n_rows) ? first + static_cast<long>(r) * n_stride : nullptr;
+            }
+            return *this;
+        }
+        Iterator operator++(int) { Iterator previous = *this; ++(*this); return previous; }
+        bool operator==(const Iterator &other) const { return cell == other.cell; }
+        bool operator!=(const Iterator &other) const { return cell != other.cell; }
+
+    private:
+        T *first;               // Première case de la vue parcourue (l'itérateur reste valide si la vue est détruite)
+        int n_rows;             // Dimensions de la vue parcourue
+        int n_cols;
+        int n_stride;
+        T *cell;                // Case courante, nullptr après la dernière
+        int r;                  // Ligne de la case courante
+        int c;                  // Colonne de la case courante
+    };
+
+    /**
+     * \fn GridView()
+     * \brief Empty view.
+     */
+    GridView() = default;
+    /**
+     * \fn GridView(T *cells, int rows, int cols, int stride)
+     * \brief View of rows x cols cells starting at cells, stride cells between two rows.
+     */
+    GridView(T *cells, int rows, int cols, int stride) : cells(cells), n_rows(rows), n_cols(cols), n_stride(stride) {}
+    /**
+     * \fn GridView(const GridView<U> &other)
+     * \brief Read-only view of a writable one.
+     */
+    template<typename U, typename = typename std::enable_if<std::is_same<const U, T>::value && !std::is_same<U, T>::value>::type>
+    GridView(const GridView<U> &other) : cells(other.data()), n_rows(other.rows()), n_cols(other.cols()), n_stride(other.stride()) {}
+
+    int rows() const { return n_rows; }
+    int cols() const { return n_cols; }
+    int stride() const { return n_stride; }
+    T *data() const { return cells; }
+    bool is_empty() const { return n_rows == 0 || n_cols == 0; }
+
+    /**
+     * \fn bool contains(int row, int col) const
+     * \brief Tells if (row, col) is in the view.
+     */
+    bool contains(int row, int col) const {
+        return row >= 0 && row < n_rows && col >= 0 && col < n_cols;
+    }
+    /**
+     * \fn T &at(int row, int col) const
+     * \brief Cell (row, col), which must be in the view.
+     */
+    T &at(int row, int col) const {
+        return cells[static_cast<long>(row) * n_stride + col];
+    }
+    /**
+     * \fn T *row(int row) const
+     * \brief First cell of a row : the cols cells of the row are contiguous.
+     */
+    T *row(int row) const {
+        return cells + static_cast<long>(row) * n_stride;
+    }
+    /**
+     * \fn T *operator[](int row) const
+     * \brief Same as row(), for view[row][col].
+     */
+    T *operator[](int r) const {
+        return row(r);
+    }
+    /**
+     * \fn GridView sub(int row, int col, int rows, int cols) const
+     * \brief View of the rows x cols cells starting at (row, col), clipped to this view.
+     */
+    GridView sub(int row, int col, int rows, int cols) const {
+        int first_row = std::max(row, 0);
+        int first_col = std::max(col, 0);
+        int last_row = std::min(row + rows, n_rows);
+        int last_col = std::min(col + cols, n_cols);
+        if(first_row >= last_row || first_col >= last_col) {
+            return GridView();
+        }
+        return GridView(&at(first_row, first_col), last_row - first_row, last_col - first_col, n_stride);
+    }
+    /**
+     * \fn void fill(const T &value) const
+     * \brief Sets every cell of the view.
+     */
+    void fill(const T &value) const {
+        for(int r = 0; r < n_rows; r++) {
+            std::fill(row(r), row(r) + n_cols, value);
+        }
+    }
+    /**
+     * \fn size_t count(const T &value) const
+     * \brief Counts the cells of the view equal to value.
+     */
+    size_t count(const typename std::remove_const<T>::type &value) const {
+        size_t found = 0;
+        for(int r = 0; r < n_rows; r++) {
+            found += count_span(row(r), n_cols, value);
+        }
+        return found;
+    }
+    /**
+     * \fn size_t replace(const T &from, const T &to) const
+     * \brief Sets to to the cells of the view equal to from.
+     * \return The amount of cells replaced.
+     */
+    size_t replace(const T &from, const T &to) const {
+        size_t replaced = 0;
+        for(int r = 0; r < n_rows; r++) {
+            replaced += replace_span(row(r), n_cols, from, to);
+        }
+        return replaced;
+    }
+    /**
+     * \fn void copy_from(const GridView<U> &source) const
+     * \brief Copies the cells shared by both views, from (0, 0).
+     */
+    template<typename U>
+    void copy_from(const GridView<U> &source) const {
+        int common_rows = std::min(n_rows, source.rows());
+        int common_cols = std::min(n_cols, source.cols());
+        for(int r = 0; r < common_rows; r++) {
+            std::copy(source.row(r), source.row(r) + common_cols, row(r));
+        }
+    }
+
+    Iterator begin() const { return Iterator(*this, 0, 0); }
+    Iterator end() const { return Iterator(*this, n_rows, 0); }
+
+    /**
+     * \fn static size_t count_span(const U *cells, size_t count, const U &value)
+     * \brief Counts the cells equal to value among count contiguous cells : 8 at a time for byte cells.
+     */
+    template<typename U>
+    static size_t count_span(const U *cells, size_t count, const U &value) {
+        if constexpr (std::is_same<U, uint8_t>::value) {
+            return SWAR_count(cells, count, value);
+        }
+        else {
+            return static_cast<size_t>(std::count(cells, cells + count, value));
+        }
+    }
+    /**
+     * \fn static size_t replace_span(U *cells, size_t count, const U &from, const U &to)
+     * \brief Replaces from by to among count contiguous cells : 8 at a time for byte cells.
+     */
+    template<typename U>
+    static size_t replace_span(U *cells, size_t count, const U &from, const U &to) {
+        if constexpr (std::is_same<U, uint8_t>::value) {
+            return SWAR_replace(cells, count, from, to);
+        }
+        else {
+            size_t replaced = 0;
+            for(size_t i = 0; i < count; i++) {
+                if(cells[i] == from) {
+                    cells[i] = to;
+                    replaced++;
+                }
+            }
+            return replaced;
+        }
+    }
+
+private:
+    T *cells = nullptr;     // Première case de la vue
+    int n_rows = 0;         // Nombre de lignes
+    int n_cols = 0;         // Nombre de colonnes
+    int n_stride = 0;       // Écart (en cases) entre le début de deux lignes
+};
+
+/**
+ * \class Grid grid.h "grid/grid.h"
+ * \brief rows x cols cells in one contiguous row-major buffer.
+ */
+template<typename T>
+class Grid {
+public:
+    /**
+     * \fn Grid(int rows, int cols, const T &value)
+     * \brief rows x cols cells set to value.
+     */
+    Grid(int rows = 0, int cols = 0, const T &value = T()) : cells(static_cast<size_t>(rows) * cols, value), n_rows(rows), n_cols(cols) {}
+
+    int rows() const { return n_rows; }
+    int cols() const { return n_cols; }
+    bool contains(int row, int col) const { return row >= 0 && row < n_rows && col >= 0 && col < n_cols; }
+    T &at(int row, int col) { return cells[static_cast<size_t>(row) * n_cols + col]; }
+    const T &at(int row, int col) const { return cells[static_cast<size_t>(row) * n_cols + col]; }
+    T *data() { return cells.data(); }
+    const T *data() const { return cells.data(); }
+
+    /**
+     * \fn GridView<T> view()
+     * \brief View of the whole grid, valid until the next resize().
+     */
+    GridView<T> view() { return GridView<T>(cells.data(), n_rows, n_cols, n_cols); }
+    GridView<const T> view() const { return GridView<const T>(cells.data(), n_rows, n_cols, n_cols); }
+
+    /**
+     * \fn void fill(const T &value)
+     * \brief Sets every cell.
+     */
+    void fill(const T &value) {
+        std::fill(cells.begin(), cells.end(), value);
+    }
+    /**
+     * \fn size_t count(const T &value) const
+     * \brief Counts the cells equal to value, in one pass over the whole buffer.
+     */
+    size_t count(const T &value) const {
+        return GridView<const T>::count_span(cells.data(), cells.size(), value);
+    }
+    /**
+     * \fn size_t replace(const T &from, const T &to)
+     * \brief Sets to to the cells equal to from, in one pass over the whole buffer.
+     * \return The amount of cells replaced.
+     */
+    size_t replace(const T &from, const T &to) {
+        return GridView<T>::replace_span(cells.data(), cells.size(), from, to);
+    }
+    /**
+     * \fn T *begin()
+     * \brief First cell : the cells of a grid are walked row by row with a plain pointer.
+     */
+    T *begin() { return cells.data(); }
+    T *end() { return cells.data() + cells.size(); }
+    const T *begin() const { return cells.data(); }
+    const T *end() const { return cells.data() + cells.size(); }
+    /**
+     * \fn void resize(int rows, int cols, const T &value)
+     * \brief Changes the size, keeping the cells shared by the old and the new size. The new cells are set to value.
+     */
+    void resize(int rows, int cols, const T &value = T()) {
+        if(rows == n_rows && cols == n_cols) {
+            return;
+        }
+        if(cols == n_cols) {
+            // Même largeur : les lignes gardées sont déjà à leur place.
+            cells.resize(static_cast<size_t>(rows) * cols, value);
+            n_rows = rows;
+            return;
+        }
+        Grid<T> resized(rows, cols, value);
+        resized.view().copy_from(view());
+        *this = std::move(resized);
+    }
+
+private:
+    std::vector<T> cells;   // Cases, ligne par ligne
+    int n_rows;             // Nombre de lignes
+    int n_cols;             // Nombre de colonnes
+};
+
+#endif /* GRID_GRID_H_ */
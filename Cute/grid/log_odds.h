@@ -0,0 +1,165 @@
+/**
+ * \file  log_odds.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the log-odds occupancy of Cute : sensor model, and word-wide kernels updating and thresholding int8 cells.
+ *
+ * A cell holds the log-odds log(p / (1 - p)) that it is an obstacle, in fixed point (LOG_ODDS_SCALE units per nat),
+ * 0 when nothing is known. Every cell reported by Carto is one observation : LOG_ODDS_HIT is added for an obstacle,
+ * LOG_ODDS_MISS for a free cell, saturated to the int8 range, so that a cell seen free many times is not turned into an
+ * obstacle by one bad ultrasound echo, and a certain cell can still change. With PROTOCOL_CAP_OBSERVATIONS, Carto reports
+ * a cell each time it sees it, not only when its value changes, so that conflicting reports end in the category seen
+ * most. The categories shown and planned on are a thresholded view : occupied above LOG_ODDS_OCCUPIED, free below
+ * LOG_ODDS_FREE, unknown in between.
+ *
+ * Both kernels work on spans of contiguous cells, 8 per 64-bit word like swar.h, the tail of a span cell by cell.
+ *
+ * \see swar.h
+ * \see map.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef GRID_LOG_ODDS_H_
+#define GRID_LOG_ODDS_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include "swar.h"
+
+/* ----------------------  PUBLIC CONFIGURATIONS  --------------------------- */
+/**
+ * \def LOG_ODDS_SCALE
+ * Units per nat : the int8 range is about +/- 3.5 nats (p = 0.03 to 0.97), the clamp of the occupancy.
+ */
+#define LOG_ODDS_SCALE 36
+/**
+ * \def LOG_ODDS_HIT
+ * Added for an obstacle echo : log(0.7 / 0.3) = 0.85 nat.
+ */
+#define LOG_ODDS_HIT 31
+/**
+ * \def LOG_ODDS_MISS
+ * Added for a free cell (reported free or crossed by the robot) : log(0.4 / 0.6) = -0.4 nat.
+ */
+#define LOG_ODDS_MISS (-15)
+/**
+ * \def LOG_ODDS_OCCUPIED
+ * Lowest log-odds of an obstacle (p = 0.66) : one echo on an unknown cell is enough, not on a cell seen free.
+ */
+#define LOG_ODDS_OCCUPIED 24
+/**
+ * \def LOG_ODDS_FREE
+ * Highest log-odds of a free cell (p = 0.44).
+ */
+#define LOG_ODDS_FREE (-8)
+/**
+ * \def LOG_ODDS_CERTAIN
+ * Log-odds of an obstacle set by hand, the opposite for a free cell.
+ */
+#define LOG_ODDS_CERTAIN 127
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+/**
+ * \fn static inline int8_t LOG_ODDS_add_cell(int8_t cell, int8_t delta)
+ * \brief Adds delta to one cell, saturated to the int8 range.
+ */
+static inline int8_t LOG_ODDS_add_cell(int8_t cell, int8_t delta) {
+    int sum = cell + delta;
+    return static_cast<int8_t>((sum > INT8_MAX) ? INT8_MAX : ((sum < INT8_MIN) ? INT8_MIN : sum));
+}
+
+/**
+ * \fn static inline uint8_t LOG_ODDS_classify_cell(int8_t cell, uint8_t occupied, uint8_t free, uint8_t unknown)
+ * \brief Gives the category of one cell.
+ */
+static inline uint8_t LOG_ODDS_classify_cell(int8_t cell, uint8_t occupied, uint8_t free, uint8_t unknown) {
+    return (cell >= LOG_ODDS_OCCUPIED) ? occupied : ((cell <= LOG_ODDS_FREE) ? free : unknown);
+}
+
+/**
+ * \fn static inline void LOG_ODDS_add(int8_t *cells, size_t count, int8_t delta)
+ * \brief Adds delta to count cells, saturated to the int8 range.
+ */
+static inline void LOG_ODDS_add(int8_t *cells, size_t count, int8_t delta) {
+    size_t i = 0;
+    uint64_t delta_word = SWAR_LOW_BITS * static_cast<uint8_t>(delta);
+    for(; count - i >= 8; i += 8) {
+        uint64_t word;
+        memcpy(&word, cells + i, 8);
+        // Somme octet par octet sans retenue entre octets : 7 bits bas additionnés, bit 7 par ou exclusif.
+        uint64_t sum = ((word & SWAR_SEVEN_BITS) + (delta_word & SWAR_SEVEN_BITS)) ^ ((word ^ delta_word) & SWAR_HIGH_BITS);
+        // Dépassement : deux termes de même signe, une somme de l'autre signe. La case sature à 0x7F (positive) ou 0x80 (négative).
+        uint64_t overflow = ~(word ^ delta_word) & (word ^ sum) & SWAR_HIGH_BITS;
+        uint64_t saturated = SWAR_SEVEN_BITS + ((word & SWAR_HIGH_BITS) >> 7);
+        sum ^= (sum ^ saturated) & ((overflow >> 7) * 0xFF);
+        memcpy(cells + i, &sum, 8);
+    }
+    for(; i < count; i++) {
+        cells[i] = LOG_ODDS_add_cell(cells[i], delta);
+    }
+}
+
+/**
+ * \fn static inline uint64_t LOG_ODDS_at_least(uint64_t word, int8_t threshold)
+ * \brief Gives 0x80 in every byte of word (int8 cells) greater than or equal to threshold, 0x00 in the other bytes.
+ */
+static inline uint64_t LOG_ODDS_at_least(uint64_t word, int8_t threshold) {
+    // Décalage de 0x80 : l'ordre des int8 devient celui des uint8.
+    uint64_t biased = word ^ SWAR_HIGH_BITS;
+    uint64_t limit = SWAR_LOW_BITS * static_cast<uint8_t>(static_cast<uint8_t>(threshold) ^ 0x80);
+    // Bit 7 de low : 7 bits bas de la case >= 7 bits bas de la limite (le bit 7 forcé à 1 absorbe l'emprunt).
+    uint64_t low = (biased | SWAR_HIGH_BITS) - (limit & SWAR_SEVEN_BITS);
+    return ((biased & ~limit) | (~(biased ^ limit) & low)) & SWAR_HIGH_BITS;
+}
+
+/**
+ * \fn static inline void LOG_ODDS_classify(const int8_t *cells, uint8_t *categories, size_t count, uint8_t occupied, uint8_t free, uint8_t unknown)
+ * \brief Writes the category of count cells : occupied, free or unknown (thresholded view).
+ */
+static inline void LOG_ODDS_classify(const int8_t *cells, uint8_t *categories, size_t count, uint8_t occupied, uint8_t free, uint8_t unknown) {
+    size_t i = 0;
+    uint64_t occupied_word = SWAR_LOW_BITS * occupied;
+    uint64_t free_word = SWAR_LOW_BITS * free;
+    uint64_t unknown_word = SWAR_LOW_BITS * unknown;
+    for(; count - i >= 8; i += 8) {
+        uint64_t word;
+        memcpy(&word, cells + i, 8);
+        uint64_t occupied_mask = (LOG_ODDS_at_least(word, LOG_ODDS_OCCUPIED) >> 7) * 0xFF;
+        uint64_t free_mask = ((LOG_ODDS_at_least(word, LOG_ODDS_FREE + 1) ^ SWAR_HIGH_BITS) >> 7) * 0xFF;
+        uint64_t result = unknown_word;
+        result ^= (result ^ occupied_word) & occupied_mask;
+        result ^= (result ^ free_word) & free_mask;
+        memcpy(categories + i, &result, 8);
+    }
+    for(; i < count; i++) {
+        categories[i] = LOG_ODDS_classify_cell(cells[i], occupied, free, unknown);
+    }
+}
+
+#endif /* GRID_LOG_ODDS_H_ */
@@ -0,0 +1,154 @@
+/**
+ * \file  swar.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the word-wide kernels on byte cells : fill, count and replace 8 cells per 64-bit word.
+ *
+ * SIMD within a register : the cells of a row are read 8 at a time in a uint64_t, compared to the value broadcast
+ * in every byte, and the bytes that matched are turned into a mask. Unaligned rows are read with memcpy, the tail
+ * of a row (less than 8 cells) cell by cell.
+ *
+ * \see grid.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef GRID_SWAR_H_
+#define GRID_SWAR_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def SWAR_LOW_BITS
+ * 0x01 in every byte of a word.
+ */
+#define SWAR_LOW_BITS UINT64_C(0x0101010101010101)
+/**
+ * \def SWAR_SEVEN_BITS
+ * 0x7F in every byte of a word.
+ */
+#define SWAR_SEVEN_BITS UINT64_C(0x7F7F7F7F7F7F7F7F)
+/**
+ * \def SWAR_HIGH_BITS
+ * 0x80 in every byte of a word.
+ */
+#define SWAR_HIGH_BITS UINT64_C(0x8080808080808080)
+/**
+ * \def SWAR_EVEN_BYTES
+ * 0x00FF in every 16-bit half-word of a word.
+ */
+#define SWAR_EVEN_BYTES UINT64_C(0x00FF00FF00FF00FF)
+/**
+ * \def SWAR_LOW_WORDS
+ * 0x0001 in every 16-bit half-word of a word.
+ */
+#define SWAR_LOW_WORDS UINT64_C(0x0001000100010001)
+/**
+ * \def SWAR_COUNT_WORDS
+ * Words counted before the per-byte counters (one match at most per word and byte) are summed : they must stay below 256.
+ */
+#define SWAR_COUNT_WORDS 255
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+/**
+ * \fn static inline uint64_t SWAR_match(uint64_t word, uint8_t value)
+ * \brief Gives 0x80 in every byte of word equal to value, 0x00 in the other bytes. Exact : no carry between bytes.
+ */
+static inline uint64_t SWAR_match(uint64_t word, uint8_t value) {
+    uint64_t diff = word ^ (SWAR_LOW_BITS * value);
+    // Le bit 7 d'un octet de diff ne reste à 0 que si l'octet est nul : ses 7 bits bas (retenue de + 0x7F) et son bit 7.
+    return ~(((diff & SWAR_SEVEN_BITS) + SWAR_SEVEN_BITS) | diff | SWAR_SEVEN_BITS);
+}
+
+/**
+ * \fn static inline void SWAR_fill(uint8_t *cells, size_t count, uint8_t value)
+ * \brief Sets count cells.
+ */
+static inline void SWAR_fill(uint8_t *cells, size_t count, uint8_t value) {
+    memset(cells, value, count);
+}
+
+/**
+ * \fn static inline size_t SWAR_count(const uint8_t *cells, size_t count, uint8_t value)
+ * \brief Counts the cells equal to value among count cells.
+ */
+static inline size_t SWAR_count(const uint8_t *cells, size_t count, uint8_t value) {
+    size_t found = 0;
+    size_t i = 0;
+    while(count - i >= 8) {
+        // Un compteur par octet : les correspondances de plusieurs mots sont additionnées avant une seule réduction.
+        uint64_t counters = 0;
+        for(int w = 0; w < SWAR_COUNT_WORDS && count - i >= 8; w++, i += 8) {
+            uint64_t word;
+            memcpy(&word, cells + i, 8);
+            counters += SWAR_match(word, value) >> 7;
+        }
+        // Octets regroupés deux à deux en compteurs de 16 bits (jusqu'à 2040) avant la somme horizontale.
+        uint64_t pairs = (counters & SWAR_EVEN_BYTES) + ((counters >> 8) & SWAR_EVEN_BYTES);
+        found += (pairs * SWAR_LOW_WORDS) >> 48;
+    }
+    for(; i < count; i++) {
+        found += (cells[i] == value);
+    }
+    return found;
+}
+
+/**
+ * \fn static inline size_t SWAR_replace(uint8_t *cells, size_t count, uint8_t from, uint8_t to)
+ * \brief Sets to to the cells equal to from among count cells.
+ * \return The amount of cells replaced.
+ */
+static inline size_t SWAR_replace(uint8_t *cells, size_t count, uint8_t from, uint8_t to) {
+    size_t replaced = 0;
+    size_t i = 0;
+    uint64_t to_word = SWAR_LOW_BITS * to;
+    for(; count - i >= 8; i += 8) {
+        uint64_t word;
+        memcpy(&word, cells + i, 8);
+        uint64_t match = SWAR_match(word, from);
+        if(match == 0) {
+            // Cas courant (une case à remplacer dans toute la carte) : aucune écriture.
+            continue;
+        }
+        uint64_t mask = (match >> 7) * 0xFF;
+        word ^= (word ^ to_word) & mask;
+        memcpy(cells + i, &word, 8);
+        replaced += ((match >> 7) * SWAR_LOW_BITS) >> 56;
+    }
+    for(; i < count; i++) {
+        if(cells[i] == from) {
+            cells[i] = to;
+            replaced++;
+        }
+    }
+    return replaced;
+}
+
+#endif /* GRID_SWAR_H_ */
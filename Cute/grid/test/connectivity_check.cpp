@@ -0,0 +1,239 @@
+/**
+ * \file  connectivity_check.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Checks of connectivity.h : the incremental components against a flood fill of every free cell.
+ *
+ * Free cells are added and removed at random, in bursts queued between two update(), like the Batch of the map. After
+ * each update(), two free cells must have the same component exactly when a flood fill from scratch joins them. A cell
+ * removed and added again at the border of a free area makes a new label at each update() : the labels must stay
+ * bounded by the free cells, and the components right, once compacted. Free cells added area by area with add_cells(),
+ * like a loaded map, must match the flood fill too. The seed is fixed : a failure is replayed as is. Runs with
+ * make -C Cute/grid/test check.
+ *
+ */
+
+/* ----------------------  INCLUDES  ---------------------------------------- */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../connectivity.h"
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def SIDE
+ * Side of the square where cells are drawn, centred on (0, 0) so that the chunks of negative coordinates are used too.
+ */
+#define SIDE 24
+/**
+ * \def CHANGES
+ * Cells added or removed in each run.
+ */
+#define CHANGES 6000
+/**
+ * \def BURST
+ * Changes queued between two update().
+ */
+#define BURST 7
+/**
+ * \def BLOCK
+ * Side of the free area whose border is worn out by check_compaction().
+ */
+#define BLOCK 30
+/**
+ * \def CYCLES
+ * Removals and additions of the border cell : more labels than CONNECTIVITY_MIN_LABELS and twice the free cells.
+ */
+#define CYCLES 12000
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static int failures
+ * \brief Amount of failed checks.
+ */
+static int failures = 0;
+
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+/**
+ * \fn static void check(bool condition, const char *what)
+ * \brief Counts and prints a failed check.
+ */
+static void check(bool condition, const char *what) {
+    if(!condition) {
+        failures++;
+        std::fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+
+/**
+ * \fn static bool matches(const Connectivity &connectivity, const std::vector<bool> &free, int first, int side)
+ * \brief Tells if the components of the side x side square starting at (first, first) are the ones found by a flood
+ * fill of free : one component of connectivity for each flooded area, and the other way round.
+ */
+static bool matches(const Connectivity &connectivity, const std::vector<bool> &free, int first, int side) {
+    std::vector<int> areas(free.size(), 0);
+    std::map<int, uint32_t> component_of;       // Composante de chaque zone remplie
+    std::map<uint32_t, int> area_of;            // Zone remplie de chaque composante
+    int area = 0;
+    for(int start = 0; start < side * side; start++) {
+        if(!free[start] || areas[start] != 0) {
+            continue;
+        }
+        std::vector<int> stack(1, start);
+        areas[start] = ++area;
+        while(!stack.empty()) {
+            int cell = stack.back();
+            stack.pop_back();
+            int row = cell / side;
+            int col = cell % side;
+            const int neighbours[4][2] = {{row - 1, col}, {row + 1, col}, {row, col - 1}, {row, col + 1}};
+            for(const auto &neighbour : neighbours) {
+                int next = neighbour[0] * side + neighbour[1];
+                if(neighbour[0] >= 0 && neighbour[0] < side && neighbour[1] >= 0 && neighbour[1] < side && free[next] && areas[next] == 0) {
+                    areas[next] = area;
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+    for(int cell = 0; cell < side * side; cell++) {
+        int row = first + cell / side;
+        int col = first + cell % side;
+        if(connectivity.is_free(row, col) != free[cell]) {
+            return false;
+        }
+        if(!free[cell]) {
+            continue;
+        }
+        uint32_t component = connectivity.component(row, col);
+        auto found = component_of.emplace(areas[cell], component);
+        auto back = area_of.emplace(component, areas[cell]);
+        if(found.first->second != component || back.first->second != areas[cell]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \fn static void check_random(unsigned seed)
+ * \brief Adds (three times out of five) and removes cells at random, and compares the components with a flood fill
+ * after each update().
+ */
+static void check_random(unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> coordinate(0, SIDE - 1);
+    std::uniform_int_distribution<int> choice(0, 4);
+    Connectivity connectivity;
+    std::vector<bool> free(SIDE * SIDE, false);
+    bool same = true;
+    for(int change = 1; change <= CHANGES && same; change++) {
+        int row = coordinate(random);
+        int col = coordinate(random);
+        bool add = choice(random) < 3;
+        if(add) {
+            connectivity.add_cell(row - SIDE / 2, col - SIDE / 2);
+        } else {
+            connectivity.remove_cell(row - SIDE / 2, col - SIDE / 2);
+        }
+        free[row * SIDE + col] = add;
+        if(change % BURST == 0) {
+            connectivity.update();
+            same = matches(connectivity, free, -SIDE / 2, SIDE);
+        }
+    }
+    check(same, "the components match a flood fill after each update");
+}
+
+/**
+ * \fn static void check_add_cells(unsigned seed)
+ * \brief Adds random free cells area by area with add_cells(), compares the components with a flood fill, then removes
+ * cells : update() must split the components made by add_cells() as the ones made by add_cell().
+ */
+static void check_add_cells(unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> choice(0, 4);
+    Connectivity connectivity;
+    std::vector<bool> free(SIDE * SIDE, false);
+    Grid<uint8_t> marks(SIDE, SIDE);
+    for(int cell = 0; cell < SIDE * SIDE; cell++) {
+        free[cell] = choice(random) < 3;
+        marks.at(cell / SIDE, cell % SIDE) = free[cell] ? 1 : 0;
+    }
+    // Zones à cheval sur les morceaux de coordonnées négatives et positives, données dans le désordre
+    const int block = SIDE / 3;
+    for(int row = 2 * block; row >= 0; row -= block) {
+        for(int col = 0; col < SIDE; col += block) {
+            GridView<const uint8_t> area = GridView<const uint8_t>(marks.view()).sub(row, col, block, block);
+            connectivity.add_cells(area, row - SIDE / 2, col - SIDE / 2, 1);
+        }
+    }
+    check(matches(connectivity, free, -SIDE / 2, SIDE), "the components added by area match a flood fill");
+
+    for(int cell = 0; cell < SIDE * SIDE; cell += 4) {
+        connectivity.remove_cell(cell / SIDE - SIDE / 2, cell % SIDE - SIDE / 2);
+        free[cell] = false;
+    }
+    connectivity.update();
+    check(matches(connectivity, free, -SIDE / 2, SIDE), "the components added by area are split by update");
+}
+
+/**
+ * \fn static void check_compaction(void)
+ * \brief Removes and adds again a cell at the border of a free area, then splits the area : the labels stay bounded
+ * and the components right.
+ */
+static void check_compaction(void) {
+    Connectivity connectivity;
+    std::vector<bool> free(BLOCK * BLOCK, true);
+    for(int row = 0; row < BLOCK; row++) {
+        for(int col = 0; col < BLOCK; col++) {
+            connectivity.add_cell(row, col);
+        }
+    }
+    size_t most = 0;
+    for(int cycle = 0; cycle < CYCLES; cycle++) {
+        // Chaque retrait relabellise toute la zone : un nouveau label par update()
+        connectivity.remove_cell(0, cycle % BLOCK);
+        connectivity.update();
+        connectivity.add_cell(0, cycle % BLOCK);
+        most = std::max(most, connectivity.label_count());
+    }
+    check(most <= 2 * BLOCK * BLOCK + CONNECTIVITY_MIN_LABELS, "the labels stay bounded by the free cells");
+    check(matches(connectivity, free, 0, BLOCK), "the components are kept by the compaction");
+
+    // Une colonne enlevée coupe la zone en deux, après compaction
+    for(int row = 0; row < BLOCK; row++) {
+        connectivity.remove_cell(row, BLOCK / 2);
+        free[row * BLOCK + BLOCK / 2] = false;
+    }
+    connectivity.update();
+    check(matches(connectivity, free, 0, BLOCK), "a compacted area is split");
+    check(!connectivity.connected(0, 0, 0, BLOCK - 1), "both halves are apart");
+}
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+/**
+ * \fn int main(void)
+ * \brief Runs every check.
+ *
+ * \return 0 when every check passed, 1 otherwise.
+ */
+int main(void) {
+    check_random(1);
+    check_random(2);
+    check_add_cells(3);
+    check_compaction();
+    std::printf("%s\n", failures ? "FAILED" : "OK");
+    if(failures) {
+        std::fprintf(stderr, "%d failed checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
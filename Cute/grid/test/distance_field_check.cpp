@@ -0,0 +1,194 @@
+/**
+ * \file  distance_field_check.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Checks of distance_field.h : the incremental field against the distances computed by brute force.
+ *
+ * Obstacles are added and removed at random, in bursts queued between two update(), like the Batch of the map. After
+ * each update(), the squared distance of every cell around the obstacles must be the one of the nearest obstacle found
+ * by brute force, DISTANCE_FIELD_FAR beyond the range. So must the field built at once by build(), like a loaded map.
+ * The seed is fixed : a failure is replayed as is. Runs with make -C Cute/grid/test check.
+ *
+ */
+
+/* ----------------------  INCLUDES  ---------------------------------------- */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../distance_field.h"
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def SIDE
+ * Side of the square where obstacles are drawn, centred on (0, 0) so that the chunks of negative coordinates are used too.
+ */
+#define SIDE 40
+/**
+ * \def MARGIN
+ * Cells checked around the square, beyond the longest range checked.
+ */
+#define MARGIN 10
+/**
+ * \def CHANGES
+ * Obstacles added or removed in each run.
+ */
+#define CHANGES 1500
+/**
+ * \def BURST
+ * Changes queued between two update().
+ */
+#define BURST 5
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static int failures
+ * \brief Amount of failed checks.
+ */
+static int failures = 0;
+
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+/**
+ * \fn static void check(bool condition, const char *what, int range)
+ * \brief Counts and prints a failed check, with the range of the field.
+ */
+static void check(bool condition, const char *what, int range) {
+    if(!condition) {
+        failures++;
+        std::fprintf(stderr, "FAIL %s (range %d)\n", what, range);
+    }
+}
+
+/**
+ * \fn static int brute_force(const std::vector<bool> &obstacles, int row, int col, int range)
+ * \brief Squared distance from (row, col) to its nearest obstacle, by a scan of every cell within the range.
+ */
+static int brute_force(const std::vector<bool> &obstacles, int row, int col, int range) {
+    int best = DISTANCE_FIELD_FAR;
+    for(int dr = -range; dr <= range; dr++) {
+        for(int dc = -range; dc <= range; dc++) {
+            int r = row + dr + SIDE / 2;
+            int c = col + dc + SIDE / 2;
+            int squared = dr * dr + dc * dc;
+            if(r >= 0 && r < SIDE && c >= 0 && c < SIDE && obstacles[r * SIDE + c] && squared <= range * range && squared < best) {
+                best = squared;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * \fn static bool matches(const DistanceField &field, const std::vector<bool> &obstacles, int range)
+ * \brief Tells if every cell of the square and its margin has the squared distance found by brute force.
+ */
+static bool matches(const DistanceField &field, const std::vector<bool> &obstacles, int range) {
+    for(int row = -SIDE / 2 - MARGIN; row < SIDE / 2 + MARGIN; row++) {
+        for(int col = -SIDE / 2 - MARGIN; col < SIDE / 2 + MARGIN; col++) {
+            if(field.squared_distance(row, col) != brute_force(obstacles, row, col, range)) {
+                std::fprintf(stderr, "(%d, %d) : %d instead of %d\n", row, col, field.squared_distance(row, col), brute_force(obstacles, row, col, range));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * \fn static void check_random(int range, unsigned seed)
+ * \brief Adds (two times out of three) and removes obstacles at random, and compares the field with brute force after
+ * each update(), then after clear().
+ */
+static void check_random(int range, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> coordinate(-SIDE / 2, SIDE / 2 - 1);
+    std::uniform_int_distribution<int> choice(0, 2);
+    DistanceField field(range);
+    std::vector<bool> obstacles(SIDE * SIDE, false);
+    bool same = true;
+    for(int change = 1; change <= CHANGES && same; change++) {
+        int row = coordinate(random);
+        int col = coordinate(random);
+        bool add = choice(random) != 0;
+        if(add) {
+            field.set_obstacle(row, col);
+        } else {
+            field.remove_obstacle(row, col);
+        }
+        obstacles[(row + SIDE / 2) * SIDE + col + SIDE / 2] = add;
+        check(field.is_obstacle(row, col) == add, "an obstacle is set and removed at once", range);
+        if(change % BURST == 0) {
+            field.update();
+            same = matches(field, obstacles, range);
+        }
+    }
+    check(same, "the field matches brute force after each update", range);
+
+    field.clear();
+    std::fill(obstacles.begin(), obstacles.end(), false);
+    check(matches(field, obstacles, range), "clear removes every obstacle", range);
+}
+
+/**
+ * \fn static void check_build(int range, unsigned seed)
+ * \brief Builds the field of random obstacles chunk by chunk, compares it with brute force, then removes obstacles :
+ * update() must start from the built field as from a spread one.
+ */
+static void check_build(int range, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> choice(0, 5);
+    DistanceField field(range);
+    std::vector<bool> obstacles(SIDE * SIDE, false);
+    // Marques de la carte entière et de sa marge : chaque zone lit les siennes autour d'elle
+    int side = SIDE + 2 * (MARGIN + range);
+    Grid<uint8_t> marks(side, side);
+    marks.view().fill(0);
+    for(int cell = 0; cell < SIDE * SIDE; cell++) {
+        obstacles[cell] = choice(random) == 0;
+        marks.at(cell / SIDE + MARGIN + range, cell % SIDE + MARGIN + range) = obstacles[cell] ? 1 : 0;
+    }
+    // Zones plus petites qu'un morceau et à cheval sur deux : les bords des zones et des morceaux ne coïncident pas
+    const int block = CHUNKED_GRID_SIDE / 3;
+    int first = -SIDE / 2 - MARGIN;
+    for(int row = first; row < SIDE / 2 + MARGIN; row += block) {
+        for(int col = first; col < SIDE / 2 + MARGIN; col += block) {
+            GridBounds area{row, col, std::min(block, SIDE / 2 + MARGIN - row), std::min(block, SIDE / 2 + MARGIN - col)};
+            field.build(GridView<const uint8_t>(marks.view()).sub(row - first, col - first, area.rows + 2 * range, area.cols + 2 * range), area, 1);
+        }
+    }
+    check(matches(field, obstacles, range), "the built field matches brute force", range);
+
+    for(int cell = 0; cell < SIDE * SIDE; cell += 3) {
+        if(obstacles[cell]) {
+            field.remove_obstacle(cell / SIDE - SIDE / 2, cell % SIDE - SIDE / 2);
+            obstacles[cell] = false;
+        }
+    }
+    field.update();
+    check(matches(field, obstacles, range), "the built field is updated like a spread one", range);
+}
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+/**
+ * \fn int main(void)
+ * \brief Runs every check.
+ *
+ * \return 0 when every check passed, 1 otherwise.
+ */
+int main(void) {
+    // Portée courte : les obstacles se touchent souvent. Portée de la carte (6 cases) et plus longue : les levées vont loin.
+    check_random(2, 1);
+    check_random(6, 2);
+    check_random(MARGIN, 3);
+    check_build(2, 4);
+    check_build(6, 5);
+    std::printf("%s\n", failures ? "FAILED" : "OK");
+    if(failures) {
+        std::fprintf(stderr, "%d failed checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * \file  log_odds_check.cpp
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Checks of log_odds.h : repeated observations of a cell converge to the category they agree on.
+ *
+ * Carto reports every observation (PROTOCOL_CAP_OBSERVATIONS) : a cell seen free once then occupied once sits between
+ * the thresholds, and must reach a category with the next observations instead of staying unknown. Each stream is fed
+ * from every int8 start value, to spans long enough for the word-wide kernels and their cell by cell tail. Runs with
+ * make -C Cute/grid/test check.
+ *
+ * \see log_odds.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+
+/* ----------------------  INCLUDES  ---------------------------------------- */
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "../log_odds.h"
+
+/* ----------------------  PRIVATE CONFIGURATIONS  -------------------------- */
+/**
+ * \def SPAN
+ * Cells updated together : two 64-bit words and a tail.
+ */
+#define SPAN 19
+/**
+ * \def ROUNDS
+ * Times each stream of observations is repeated.
+ */
+#define ROUNDS 100
+
+/* ----------------------  PRIVATE ENUMERATIONS  ---------------------------- */
+/**
+ * \enum Category
+ * \brief Categories of the thresholded view.
+ */
+enum Category : uint8_t {
+    OCCUPIED = 0,
+    FREE = 1,
+    UNKNOWN = 2
+};
+
+/* ----------------------  PRIVATE VARIABLES  ------------------------------- */
+/**
+ * \var static int failures
+ * \brief Amount of failed checks.
+ */
+static int failures = 0;
+
+/* ----------------------  PRIVATE FUNCTIONS  ------------------------------- */
+/**
+ * \fn static void check(bool condition, const char *what, int start)
+ * \brief Counts and prints a failed check, with the start value of the cells.
+ */
+static void check(bool condition, const char *what, int start) {
+    if(!condition) {
+        failures++;
+        std::fprintf(stderr, "FAIL %s (start %d)\n", what, start);
+    }
+}
+
+/**
+ * \fn static bool agree(const std::vector<int8_t> &cells, uint8_t category)
+ * \brief Tells if every cell of the span is in category.
+ */
+static bool agree(const std::vector<int8_t> &cells, uint8_t category) {
+    uint8_t categories[SPAN];
+    LOG_ODDS_classify(cells.data(), categories, cells.size(), OCCUPIED, FREE, UNKNOWN);
+    for(size_t i = 0; i < cells.size(); i++) {
+        if(categories[i] != category || LOG_ODDS_classify_cell(cells[i], OCCUPIED, FREE, UNKNOWN) != category) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \fn static void check_stream(const std::vector<int8_t> &stream, uint8_t category, int bound, const char *what)
+ * \brief Feeds the stream of observations ROUNDS times from every start value : the cells must be in category after
+ * at most bound observations, and stay in it until the end.
+ */
+static void check_stream(const std::vector<int8_t> &stream, uint8_t category, int bound, const char *what) {
+    for(int start = INT8_MIN; start <= INT8_MAX; start++) {
+        std::vector<int8_t> cells(SPAN, static_cast<int8_t>(start));
+        int observations = 0;
+        int settled = 0;    // Observations nécessaires : les cases ne quittent plus la catégorie ensuite
+        for(int round = 0; round < ROUNDS; round++) {
+            for(int8_t delta : stream) {
+                LOG_ODDS_add(cells.data(), cells.size(), delta);
+                observations++;
+                if(!agree(cells, category)) {
+                    settled = observations + 1;
+                }
+            }
+        }
+        check(settled <= bound, what, start);
+    }
+}
+
+/**
+ * \fn static void check_conflict(void)
+ * \brief A cell seen free once then occupied once is unknown, the next echo makes it occupied.
+ */
+static void check_conflict(void) {
+    std::vector<int8_t> cells(SPAN, 0);
+    LOG_ODDS_add(cells.data(), cells.size(), LOG_ODDS_MISS);
+    check(agree(cells, FREE), "one miss makes an unknown cell free", 0);
+    LOG_ODDS_add(cells.data(), cells.size(), LOG_ODDS_HIT);
+    check(agree(cells, UNKNOWN), "a hit on a cell seen free once leaves it unknown", 0);
+    LOG_ODDS_add(cells.data(), cells.size(), LOG_ODDS_HIT);
+    check(agree(cells, OCCUPIED), "the repeated hit makes it occupied", 0);
+}
+
+/* ----------------------  PUBLIC FUNCTIONS  -------------------------------- */
+/**
+ * \fn int main(void)
+ * \brief Runs every check.
+ *
+ * \return 0 when every check passed, 1 otherwise.
+ */
+int main(void) {
+    check_conflict();
+    // Des extrêmes de l'int8 : 5 échos suffisent à une case vue libre, 9 absences à une case vue occupée.
+    check_stream({LOG_ODDS_HIT}, OCCUPIED, 5, "repeated hits converge to occupied");
+    check_stream({LOG_ODDS_MISS}, FREE, 9, "repeated misses converge to free");
+    // Mesures bruitées : la catégorie vue le plus souvent l'emporte et n'est plus perdue.
+    check_stream({LOG_ODDS_HIT, LOG_ODDS_HIT, LOG_ODDS_MISS}, OCCUPIED, 10, "two hits for a miss converge to occupied");
+    check_stream({LOG_ODDS_MISS, LOG_ODDS_MISS, LOG_ODDS_MISS, LOG_ODDS_HIT}, FREE, 40, "three misses for a hit converge to free");
+    std::printf("%s\n", failures ? "FAILED" : "OK");
+    if(failures) {
+        std::fprintf(stderr, "%d failed checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
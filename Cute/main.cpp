@@ -3,6 +3,9 @@
 // Pour le projet ExploBot confié par Thales, dans le cadre du PFE 2023-2024 à l'ESEO.
 
 #include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
 #include "window.h"
 
 #include "client_tcp/dispatcher.h"
@@ -14,6 +17,13 @@ int main(int argc, char **argv)
 
     QApplication app (argc, argv);          // Création de l'application Qt
 
+    // La carte du bâtiment déjà exploré est reprise au démarrage et enregistrée en quittant
+    QString map_directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QString map_path = map_directory + "/carte.cutemap";
+    if (QFile::exists(map_path)) {
+        Map::getInstance().load_file(map_path);
+    }
+
     POSTMAN_create();           // Création du postman
     DISPATCHER_create();        // Création du dispatcher
     POSTMAN_start();            // Démarrage du postman
@@ -22,5 +32,10 @@ int main(int argc, char **argv)
     Window window;      // Création de la fenêtre de l'application
     window.show();      // Affichage de la fenêtre
 
-    return app.exec();  // Exécution de l'application Qt
+    int result = app.exec();    // Exécution de l'application Qt
+
+    QDir().mkpath(map_directory);
+    Map::getInstance().save_file(map_path);     // Remplace l'ancien fichier en une fois : une coupure pendant l'écriture le laisse intact
+
+    return result;
 }
@@ -15,31 +15,350 @@
 #include <QPixmap>
 #include <QString>
 #include <QStringList>
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <set>
+#include "map_file.h"
 
 // Constructeur de la classe Map
 Map::Map(QWidget *parent)
     : QWidget(parent),
-    point_de_destination_x(-1),
-    point_de_destination_y(-1),
-    robot_position_x(-1),
-    robot_position_y(-1)
+    occupancy(0),
+    clearance(clearance_range),
+    point_de_destination_x(no_position),
+    point_de_destination_y(no_position),
+    robot_position_x(no_position),
+    robot_position_y(no_position),
+    journal(journal_length)
 {
     init_map();     // Initialise la matrice en la remplissant de zones non cartographiées
+    publish();      // Première version pour les lecteurs, avant tout Batch
 }
 
 // Méthode initialisant la matrice en la remplissant de zones non cartographiées
 void Map::init_map() {
-    // Initialisation de la matrice à zéro
-    for (int i = 0; i < rows; ++i) {            // Pour chaque ligne de la matrice
-        for (int j = 0; j < cols; ++j) {            // Pour chaque colonne de la matrice
-            matrix[i][j] = non_cartographied;           // Met la case de la matrice en "non cartographiée"
+    GridBounds old_bounds = get_bounds();
+    occupancy.clear();     // Libère les morceaux de la carte : toutes les cases redeviennent "non cartographiée" (log-odds nul)
+    clearance.clear();
+    connectivity.clear();
+    occupancy.fill(GridBounds{0, 0, default_rows, default_cols}, 0);     // Zone affichée avant que le robot n'explore
+    waypoint_cells.clear();
+    dirty_layers |= occupancy_layer | planning_layer;
+    journal_floor = ++map_version;     // Toute la carte a changé : les lecteurs plus anciens relisent la carte entière
+    if (batch_depth > 0) {
+        // Les cases effacées ne sont pas listées : le lot donne seulement la boîte, avant et après
+        batch_dirty = batch_dirty.united(old_bounds).united(get_bounds());
+        batch_overflow = true;
+    }
+}
+
+// Clé d'une case dans l'index des waypoints (les coordonnées peuvent être négatives)
+static quint64 cell_key(int y, int x) {
+    return (static_cast<quint64>(static_cast<quint32>(y)) << 32) | static_cast<quint32>(x);
+}
+
+// Méthode écrivant une valeur de cell_value dans sa couche : les autres couches ne sont pas touchées
+void Map::write_cell(int y, int x, uint8_t value) {
+    switch (value) {
+        case waypoint: {
+            uint8_t old_value = get_cell(y, x);
+            waypoint_cells.insert(cell_key(y, x), QPoint(x, y));
+            dirty_layers |= planning_layer;
+            record_change(y, x, old_value);
+            break;
+        }
+        case destination:
+            move_marker(point_de_destination_y, point_de_destination_x, y, x);
+            dirty_layers |= planning_layer;
+            break;
+        case robot_position:
+            place_robot(y, x);
+            break;
+        default:
+            set_occupancy(y, x, value);
+            break;
+    }
+}
+
+// Méthode écrivant une case de la couche d'occupation : une case donnée par l'utilisateur ou le code Python est certaine
+void Map::set_occupancy(int y, int x, uint8_t value) {
+    int8_t log_odds = (value == obstacle) ? LOG_ODDS_CERTAIN : ((value == cartographied) ? -LOG_ODDS_CERTAIN : 0);
+    uint8_t old_value = get_cell(y, x);
+    occupancy.set(y, x, log_odds);    // La carte grandit si la case est hors de la zone connue
+    update_indexes(y, x, value);
+    dirty_layers |= occupancy_layer;
+    snapshot_stale = true;
+    record_change(y, x, old_value);
+}
+
+// Méthode journalisant une case dont la valeur affichée a changé
+void Map::record_change(int y, int x, uint8_t old_value) {
+    uint8_t new_value = get_cell(y, x);
+    if (new_value == old_value) {
+        return;     // Changement caché par une couche du dessus, ou log-odds changé sans changer de catégorie
+    }
+    map_version++;
+    journal[map_version % journal_length] = Change{map_version, y, x, old_value, new_value};
+    if (batch_depth > 0) {
+        batch_dirty = batch_dirty.united(GridBounds{y, x, 1, 1});
+        if (batch_cells.size() < batch_cells_limit) {
+            batch_cells.append(QPoint(x, y));
+        } else {
+            batch_overflow = true;
+        }
+    }
+}
+
+// Méthode suivant dans le champ de distances et les composantes connexes une case de l'occupation qui change de catégorie
+void Map::update_indexes(int y, int x, uint8_t category) {
+    if (category == obstacle) {
+        clearance.set_obstacle(y, x);
+    }
+    else {
+        clearance.remove_obstacle(y, x);
+    }
+    if (category == cartographied) {
+        connectivity.add_cell(y, x);
+    }
+    else {
+        connectivity.remove_cell(y, x);
+    }
+}
+
+Map::Batch::Batch(Map &map) : map(map) {
+    if (map.batch_depth++ == 0) {
+        // Premier Batch ouvert : un nouveau lot commence
+        map.batch_version = map.map_version;
+        map.batch_bounds = map.get_bounds();
+        map.batch_dirty = GridBounds();
+        map.batch_cells.clear();
+        map.batch_overflow = false;
+    }
+}
+
+Map::Batch::~Batch() {
+    if (map.batch_depth == 1) {
+        map.clearance.update();     // Les distances ne sont propagées qu'une fois par lot, autour des obstacles ajoutés ou enlevés
+        map.connectivity.update();  // Les composantes coupées par le lot sont relabellisées une seule fois
+    }
+    if (--map.batch_depth > 0) {
+        return;     // Batch imbriqué : le premier ouvert notifiera et rendra le lot visible aux lecteurs
+    }
+    bool changed = map.map_version != map.batch_version || map.get_bounds() != map.batch_bounds;
+    if (changed) {
+        map.snapshot_stale = true;      // Publiée au prochain snapshot() : les lecteurs voient tout le lot ou rien, jamais une partie
+    }
+    if (!changed) {
+        return;     // Lot qui ne change ni une case affichée ni la boîte de la carte
+    }
+    // Met à jour la carte sur l'IHM
+    emit map.map_updated();
+    emit map.map_changed(map.batch_dirty, map.batch_overflow ? QVector<QPoint>() : map.batch_cells);
+}
+
+// Méthode déplaçant un marqueur (robot ou destination) : son ancienne case et la nouvelle changent
+void Map::move_marker(int &marker_y, int &marker_x, int y, int x) {
+    int old_y = marker_y;
+    int old_x = marker_x;
+    bool had_position = old_y != no_position && old_x != no_position;
+    bool has_position = y != no_position && x != no_position;
+    uint8_t old_value_at_old_position = had_position ? get_cell(old_y, old_x) : 0;
+    uint8_t old_value_at_new_position = has_position ? get_cell(y, x) : 0;
+    marker_y = y;
+    marker_x = x;
+    if (had_position) {
+        record_change(old_y, old_x, old_value_at_old_position);
+    }
+    if (has_position) {
+        record_change(y, x, old_value_at_new_position);
+    }
+}
+
+// Méthode enlevant un waypoint, retourne l'itérateur suivant
+QHash<quint64, QPoint>::iterator Map::erase_waypoint(QHash<quint64, QPoint>::iterator it) {
+    QPoint cell = *it;
+    uint8_t old_value = get_cell(cell.y(), cell.x());
+    it = waypoint_cells.erase(it);
+    dirty_layers |= planning_layer;
+    record_change(cell.y(), cell.x(), old_value);
+    return it;
+}
+
+// Méthode donnant les changements postérieurs à version, tant que le journal les a tous
+bool Map::changes_since(quint32 version, QVector<Change> &changes) const {
+    if (version < journal_floor || version > map_version || map_version - version > static_cast<quint32>(journal_length)) {
+        return false;
+    }
+    for (quint32 v = version + 1; v <= map_version; ++v) {
+        changes.append(journal[v % journal_length]);
+    }
+    return true;
+}
+
+// Méthode ajoutant une observation de Carto aux cases : une case vue libre de nombreuses fois reste libre après un mauvais écho
+void Map::observe_cells(const QVector<QPoint> &cells, int8_t delta) {
+    int first = 0;
+    while (first < cells.size()) {
+        // Suite de cases voisines sur la même ligne (une ligne parcourue, un instantané) : mise à jour 8 cases à la fois
+        int last = first + 1;
+        while (last < cells.size() && cells[last].y() == cells[first].y() && cells[last].x() == cells[last - 1].x() + 1) {
+            last++;
         }
+        occupancy.update(GridBounds{cells[first].y(), cells[first].x(), 1, last - first}, [this, delta](GridView<int8_t> span, int first_row, int first_col) {
+            // Catégories avant et après (une suite ne dépasse pas un morceau) : seules les cases qui changent de catégorie sont journalisées
+            uint8_t old_values[CHUNKED_GRID_SIDE];
+            uint8_t new_values[CHUNKED_GRID_SIDE];
+            LOG_ODDS_classify(span.row(0), old_values, span.cols(), obstacle, cartographied, non_cartographied);
+            LOG_ODDS_add(span.row(0), span.cols(), delta);
+            LOG_ODDS_classify(span.row(0), new_values, span.cols(), obstacle, cartographied, non_cartographied);
+            for (int j = 0; j < span.cols(); ++j) {
+                if (new_values[j] != old_values[j]) {
+                    update_indexes(first_row, first_col + j, new_values[j]);
+                }
+                // Une case sous le robot, la destination ou un waypoint ne change pas à l'écran
+                if (new_values[j] != old_values[j] && get_cell(first_row, first_col + j) == new_values[j]) {
+                    record_change(first_row, first_col + j, old_values[j]);
+                }
+            }
+        });
+        first = last;
     }
+    dirty_layers |= occupancy_layer;
+    snapshot_stale = true;
 }
 
-// Méthode pour retourner la matrice
-int (*Map::get_map())[20] {
-    return matrix;
+// Méthode pour retourner la couche d'occupation
+const ChunkedGrid<int8_t> &Map::get_occupancy() const {
+    return occupancy;
+}
+
+// Fonction copiant la vue seuillée d'une couche d'occupation (de la carte ou d'un instantané), ligne par ligne
+static void classify_occupancy(const ChunkedGrid<int8_t> &occupancy, const GridView<uint8_t> &dest, int row, int col, uint8_t occupied, uint8_t free, uint8_t unknown) {
+    Grid<int8_t> log_odds(dest.rows(), dest.cols());
+    occupancy.copy_to(log_odds.view(), row, col);
+    for (int i = 0; i < dest.rows(); ++i) {
+        LOG_ODDS_classify(log_odds.view().row(i), dest.row(i), dest.cols(), occupied, free, unknown);
+    }
+}
+
+// Méthode copiant la vue seuillée de la couche d'occupation
+void Map::copy_occupancy(const GridView<uint8_t> &dest, int row, int col) const {
+    classify_occupancy(occupancy, dest, row, col, obstacle, cartographied, non_cartographied);
+}
+
+// Méthode retournant la valeur affichée d'une case, la couche du dessus l'emporte
+uint8_t Map::get_cell(int y, int x) const {
+    if (y == robot_position_y && x == robot_position_x) {
+        return robot_position;
+    }
+    if (y == point_de_destination_y && x == point_de_destination_x) {
+        return destination;
+    }
+    if (waypoint_cells.contains(cell_key(y, x))) {
+        return waypoint;
+    }
+    return LOG_ODDS_classify_cell(occupancy.get(y, x), obstacle, cartographied, non_cartographied);
+}
+
+// Méthode copiant l'occupation dans dest puis posant les couches du dessus
+void Map::compose(const GridView<uint8_t> &dest, int row, int col) const {
+    copy_occupancy(dest, row, col);
+    compose_overlays(dest, row, col);
+}
+
+// Méthode posant les couches du dessus dans dest : un passage sur la trajectoire, pas sur la carte
+void Map::compose_overlays(const GridView<uint8_t> &dest, int row, int col) const {
+    for (const QPoint &cell : std::as_const(waypoint_cells)) {
+        if (dest.contains(cell.y() - row, cell.x() - col)) {
+            dest.at(cell.y() - row, cell.x() - col) = waypoint;
+        }
+    }
+    if (point_de_destination_x != no_position && point_de_destination_y != no_position && dest.contains(point_de_destination_y - row, point_de_destination_x - col)) {
+        dest.at(point_de_destination_y - row, point_de_destination_x - col) = destination;
+    }
+    if (has_robot_position() && dest.contains(robot_position_y - row, robot_position_x - col)) {
+        dest.at(robot_position_y - row, robot_position_x - col) = robot_position;
+    }
+}
+
+// Méthode retournant puis oubliant les couches modifiées
+int Map::take_dirty_layers() {
+    int dirty = dirty_layers;
+    dirty_layers = 0;
+    return dirty;
+}
+
+// Méthode fixant le rayon d'inflation : les distances ne dépendent pas du rayon, rien n'est recalculé
+void Map::set_inflation_radius(int radius) {
+    Batch batch(*this);     // Publie le nouveau rayon pour les planificateurs, sans rafraîchir l'IHM
+    inflation_radius = qBound(0, radius, clearance_range - 1);
+    snapshot_stale = true;
+}
+
+// Fonction retournant la distance d'une case à l'obstacle le plus proche dans un champ de distances de portée range
+static float clearance_distance(const DistanceField &clearance, int range, int y, int x) {
+    int squared = clearance.squared_distance(y, x);
+    return (squared == DISTANCE_FIELD_FAR) ? static_cast<float>(range) : std::sqrt(static_cast<float>(squared));
+}
+
+// Méthode retournant la distance d'une case à l'obstacle le plus proche, à jour depuis la fin du dernier Batch
+float Map::get_clearance(int y, int x) const {
+    return clearance_distance(clearance, clearance_range, y, x);
+}
+
+// Méthode retournant le coût de passage d'une case pour un planificateur : interdite près des obstacles, de plus en plus chère en s'en approchant
+uint8_t Map::get_clearance_cost(int y, int x) const {
+    return clearance_cost(clearance, inflation_radius, y, x);
+}
+
+// Méthode calculant le coût de passage d'une case, pour la carte comme pour un instantané
+uint8_t Map::clearance_cost(const DistanceField &clearance, int inflation_radius, int y, int x) {
+    float distance = clearance_distance(clearance, clearance_range, y, x);
+    if (distance <= inflation_radius) {
+        return lethal_cost;
+    }
+    return static_cast<uint8_t>((lethal_cost - 1) * (clearance_range - distance) / (clearance_range - inflation_radius));
+}
+
+// Méthode vérifiant qu'un chemin de cases cartographiées relie deux cases, sans chercher le chemin
+bool Map::is_reachable(int from_y, int from_x, int to_y, int to_x) const {
+    return connectivity.connected(from_y, from_x, to_y, to_x);
+}
+
+// Méthode vérifiant que le robot peut atteindre une case
+bool Map::is_reachable_from_robot(int y, int x) const {
+    if (!has_robot_position()) {
+        return false;
+    }
+    if (is_reachable(robot_position_y, robot_position_x, y, x)) {
+        return true;
+    }
+    // Le robot peut être posé sur une case pas encore cartographiée : il part alors de ses voisines
+    static const int steps[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (const auto &step : steps) {
+        if (is_reachable(robot_position_y + step[0], robot_position_x + step[1], y, x)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Méthode indiquant que le prochain clic sur la carte choisira le point de destination
+bool Map::is_selecting_destination() const {
+    return is_map_clickable && has_robot_position() && point_de_destination_x == no_position && point_de_destination_y == no_position;
+}
+
+// Méthode retournant la boîte des cases connues, agrandie au robot s'il est hors de la couche d'occupation
+GridBounds Map::get_bounds() const {
+    GridBounds bounds = occupancy.bounds();
+    if (has_robot_position()) {
+        bounds = bounds.united(GridBounds{robot_position_y, robot_position_x, 1, 1});
+    }
+    return bounds;
 }
 
 // Pour obtenir la view dans le code window.cpp et l'ajouter sur l'IHM
@@ -49,47 +368,92 @@ CustomGraphicsView* Map::getCustomView() const {
 
 // Méthode pour modifier une case de la matrice en lui donnant une valeur spécifique. 0 : zone non cartographiée, 1 : zone cartographiée, 2 : zone avec un obstacle
 void Map::update_matrix_element(int y, int x, int new_value) {
-    if (x >= 0 && x < cols && y >= 0 && y < rows) {
-        this->matrix[y][x] = new_value;
-        // Met à jour la carte sur l'IHM
-        emit map_updated();
-    }
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    write_cell(y, x, static_cast<uint8_t>(new_value));    // La carte grandit si la case est hors de la zone connue
 }
 
 // Méthode pour ajouter un obstacle dans la matrice
 void Map::set_obstacle(int y, int x) {
-    if (x >= 0 && x < cols && y >= 0 && y < rows) {
-        this->matrix[y][x] = obstacle;
-        // Met à jour la carte sur l'IHM
-        emit map_updated();
-    }
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    set_occupancy(y, x, obstacle);    // La carte grandit si la case est hors de la zone connue
 }
 
 // Méthode pour ajouter une case cartographiée dans la matrice
 void Map::set_cartographied_area(int y, int x) {
-    if (x >= 0 && x < cols && y >= 0 && y < rows) {
-        this->matrix[y][x] = cartographied;
-        // Met à jour la carte sur l'IHM
-        emit map_updated();
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    set_occupancy(y, x, cartographied);    // La carte grandit si la case est hors de la zone connue
+}
+
+// Méthode pour appliquer un lot de cases reçu de Carto (QPoint : x = colonne, y = ligne)
+void Map::set_cells(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas) {
+    Batch batch(*this);     // Un seul rafraîchissement de l'IHM pour tout le lot
+    apply_cells(obstacles, cartographied_areas);
+}
+
+// Méthode pour remplacer toute la carte par celle du robot (MAP_SNAPSHOT, à la connexion)
+void Map::load_cells(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas) {
+    Batch batch(*this);     // Un seul rafraîchissement de l'IHM pour toute la carte
+    init_map();     // Les cases absentes de l'instantané redeviennent non cartographiées
+    apply_cells(obstacles, cartographied_areas);    // La position du robot et le point de destination, dans leurs couches, sont gardés
+}
+
+// Méthode pour appliquer la télémétrie reçue pendant une frame (QPoint : x = colonne, y = ligne)
+void Map::apply_telemetry(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas, const QPoint &robot) {
+    Batch batch(*this);     // Un seul rafraîchissement de l'IHM pour toute la frame
+    apply_cells(obstacles, cartographied_areas);
+
+    // Le robot est dans sa propre couche : une case libre du lot ne l'efface pas
+    if (robot.x() != no_position && robot.y() != no_position) {
+        place_robot(robot.y(), robot.x());
     }
 }
 
+// Méthode écrivant un lot de cases dans la matrice (qui grandit si besoin), retourne vrai si le lot n'est pas vide
+bool Map::apply_cells(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas) {
+    observe_cells(cartographied_areas, LOG_ODDS_MISS);
+    observe_cells(obstacles, LOG_ODDS_HIT);
+    return !obstacles.isEmpty() || !cartographied_areas.isEmpty();
+}
+
 // Méthode pour ajouter une case non cartographiée dans la matrice
 void Map::set_non_cartographied_area(int y, int x) {
-    if (x >= 0 && x < cols && y >= 0 && y < rows) {
-        this->matrix[y][x] = non_cartographied;
-        // Met à jour la carte sur l'IHM
-        emit map_updated();
-    }
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    set_occupancy(y, x, non_cartographied);    // La carte grandit si la case est hors de la zone connue
 }
 
-// Méthode pour modifier toute la matrice d'un coup en lui donnant une nouvelle matrice (à tester)
-void Map::update_entire_matrix(int new_matrix[20][20]) {
-    // Remplace la matrice par la nouvelle matrice
-    memcpy(matrix, new_matrix, sizeof(int) * rows * cols);
+// Méthode pour modifier la matrice d'un coup en lui donnant une nouvelle matrice, écrite à partir du coin de la boîte des cases connues
+// (la matrice donnée au code Python est cette boîte, voir Window::call_make_trajectory)
+void Map::update_entire_matrix(const GridView<const uint8_t> &new_matrix) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    // Remplace les cases de la matrice par celles de la nouvelle matrice
+    GridBounds bounds = get_bounds();
+    GridBounds copied{bounds.row, bounds.col, new_matrix.rows(), new_matrix.cols()};
+    dirty_layers |= planning_layer;
+
+    // La trajectoire de la zone copiée est remplacée par celle de la nouvelle matrice
+    for (auto it = waypoint_cells.begin(); it != waypoint_cells.end();) {
+        if (copied.contains(it->y(), it->x())) {
+            it = erase_waypoint(it);
+        }
+        else {
+            ++it;
+        }
+    }
 
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
+    // Les waypoints, la destination et le robot de la nouvelle matrice vont dans leurs couches, l'occupation en dessous est une zone cartographiée
+    // Seules les cases dont la catégorie change sont réécrites : les autres gardent leurs log-odds
+    for (int i = 0; i < new_matrix.rows(); ++i) {
+        for (int j = 0; j < new_matrix.cols(); ++j) {
+            uint8_t value = new_matrix.at(i, j);
+            uint8_t category = (value == obstacle || value == non_cartographied) ? value : static_cast<uint8_t>(cartographied);
+            if (LOG_ODDS_classify_cell(occupancy.get(copied.row + i, copied.col + j), obstacle, cartographied, non_cartographied) != category) {
+                set_occupancy(copied.row + i, copied.col + j, category);
+            }
+            if (value == waypoint || value == destination || value == robot_position) {
+                write_cell(copied.row + i, copied.col + j, value);
+            }
+        }
+    }
 }
 
 // Méthdoe permettant de modifier la matrice en la remplaçant par la matrice obtenue par le code Python trajectory.py
@@ -100,69 +464,65 @@ void Map::update_entire_matrix_from_trajectory_result(const QString &waypoints_s
     waypoints_string.replace("{{", "").replace("}}", "");       // Enlever les accolades extérieures
     QStringList waypoints_qstringlist = waypoints_string.split("},{", Qt::SkipEmptyParts);  // Diviser en lignes
 
-    int matrix_converted[20][20];   // Matrice temporaire pour convertir la matrice de QString en matrice d'entiers
+    // Matrice temporaire pour convertir la matrice de QString en matrice d'entiers, aux dimensions du résultat
+    int converted_cols = waypoints_qstringlist.isEmpty() ? 0 : waypoints_qstringlist[0].split(',', Qt::SkipEmptyParts).size();
+    Grid<uint8_t> matrix_converted(waypoints_qstringlist.size(), converted_cols, non_cartographied);
 
     for (int i = 0; i < waypoints_qstringlist.size(); ++i) {
         QStringList nums = waypoints_qstringlist[i].split(',', Qt::SkipEmptyParts); // Diviser en nombres
 
-        for (int j = 0; j < nums.size(); ++j) {
-            matrix_converted[i][j] = nums[j].trimmed().toInt();     // Convertir en entier
+        for (int j = 0; j < nums.size() && j < converted_cols; ++j) {
+            matrix_converted.at(i, j) = static_cast<uint8_t>(nums[j].trimmed().toInt());     // Convertir en entier (une case tient dans un octet)
         }
     }
 
     // Remplace la matrice par la nouvelle matrice récupérée ci-dessus
-    memcpy(matrix, matrix_converted, sizeof(int) * rows * cols);
-
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
+    update_entire_matrix(matrix_converted.view());
 }
 
 
 // Méthodes permettant d'ajouter des obstacles et zones non cartographiées
 void Map::ajout_zone_non_cartographiee_carre(int topLeftX, int topLeftY, int size) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
     for (int i = topLeftX; i < topLeftX + size; ++i) {
         for (int j = topLeftY; j < topLeftY + size; ++j) {
-            this->matrix[i][j] = non_cartographied;
+            set_occupancy(i, j, non_cartographied);
         }
     }
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
 }
 void Map::ajout_zone_non_cartographiee_rond(int centerX, int centerY, int radius) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
     for (int i = centerX - radius; i <= centerX + radius; ++i) {
         for (int j = centerY - radius; j <= centerY + radius; ++j) {
             if ((i - centerX) * (i - centerX) + (j - centerY) * (j - centerY) <= radius * radius) {
-                this->matrix[i][j] = non_cartographied;
+                set_occupancy(i, j, non_cartographied);
             }
         }
     }
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
 }
 void Map::ajout_obstacle_carre(int topLeftX, int topLeftY, int size) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
     for (int i = topLeftX; i < topLeftX + size; ++i) {
         for (int j = topLeftY; j < topLeftY + size; ++j) {
-            this->matrix[i][j] = obstacle;
+            set_occupancy(i, j, obstacle);
         }
     }
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
 }
 void Map::ajout_obstacle_rond(int centerX, int centerY, int radius) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
     for (int i = centerX - radius; i <= centerX + radius; ++i) {
         for (int j = centerY - radius; j <= centerY + radius; ++j) {
             if ((i - centerX) * (i - centerX) + (j - centerY) * (j - centerY) <= radius * radius) {
-                this->matrix[i][j] = obstacle;
+                set_occupancy(i, j, obstacle);
             }
         }
     }
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
 }
 void Map::ajout_obstacle_rectangulaire(int topLeftX, int topLeftY, int width, int height) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
     for (int i = topLeftX; i < topLeftX + height; ++i) {
         for (int j = topLeftY; j < topLeftY + width; ++j) {
-            this->matrix[i][j] = obstacle;
+            set_occupancy(i, j, obstacle);
         }
     }
 }
@@ -174,54 +534,32 @@ void Map::enable_map_click(bool clickable) {
 
 // Méthode permettant le set le point de position du robot
 void Map::set_robot_position(int y, int x) {
-    // Modifie la matrice pour ajouter le point de position
-    if (x >= 0 && x < cols && y >= 0 && y < rows) {
-
-        // Supprime l'ancienne position du robot
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (matrix[i][j] == robot_position) {           // Remplace toutes les cases position du robot par des cases position du robot
-                    matrix[i][j] = cartographied;
-                }
-            }
-        }
-
-        // Enregistre dans une variable les coordonnées de position du robot
-        robot_position_x = x;
-        robot_position_y = y;
-
-        // Set la position du robot dans la matrice
-        matrix[y][x] = robot_position;
-
-        // Met à jour la carte sur l'IHM
-        emit map_updated();
-    }
-    else
-    {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    if (!place_robot(y, x)) {
         // La position du robot dépasse les bordures de la matrice.
     }
 }
 
-// Méthode permettant le set du point de destination
-void Map::set_destination(int y, int x) {
-    // Supprime l'ancien point de destination
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            if (matrix[i][j] == destination) {           // Remplace toutes les cases vertes (destination) par des blanches (zones cartographiées)
-                matrix[i][j] = cartographied;
-            }
-        }
+// Méthode déplaçant le robot dans la matrice, retourne faux si la position dépasse les bordures de la matrice
+bool Map::place_robot(int y, int x) {
+    if (y == no_position || x == no_position) {
+        return false;
     }
 
-    // Enregistre dans une variable les coordonnées du point de destination
-    point_de_destination_x = x;
-    point_de_destination_y = y;
+    // Enregistre dans une variable les coordonnées de position du robot : l'ancienne position disparaît avec elles
+    move_marker(robot_position_y, robot_position_x, y, x);
+    dirty_layers |= entity_layer;
+    return true;
+}
 
-    // Set la position du robot dans la matrice
-    matrix[y][x] = destination;
+// Méthode permettant le set du point de destination
+void Map::set_destination(int y, int x) {
+    {
+        Batch batch(*this);     // Met à jour la carte sur l'IHM à la fin du bloc, avant le calcul de la trajectoire
 
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
+        // Enregistre dans une variable les coordonnées du point de destination : l'ancien point disparaît avec elles
+        write_cell(y, x, destination);
+    }
 
     // Met à jour la carte sur l'IHM
     emit map_updated_after_destination_selection();
@@ -232,12 +570,16 @@ void Map::set_destination(int y, int x) {
 // Cette méthode permet de set le point de destination et la position du robot
 void Map::set_destination_and_robot_position(int x, int y) {
     if (is_map_clickable) {         // Vérifie que l'utilisateur est bien autorisé à cliquer sur la carte (évite de changer le point de destination en cours de route si l'utilisateur n'a pas cliqué au préablable sur le bouton "Trajectoire"
-        if (matrix[x][y] == 1) {        // Vérification que le point sélectionné est bien accessible par le robot (que ce ne soit pas une zone non cartographiée ou un obstacle)
+        if (get_cell(x, y) == cartographied) {        // Vérification que le point sélectionné est bien accessible par le robot (que ce ne soit pas une zone non cartographiée ou un obstacle)
 
-            if (robot_position_x == -1 && robot_position_y == -1) {     // Au premier clic sur la carte c'est le point de position qui doit être défninit. Si la position du robot est n'a pas encore été définie, alors c'est elle qu'il faut définir en premier
+            if (!has_robot_position()) {     // Au premier clic sur la carte c'est le point de position qui doit être défninit. Si la position du robot est n'a pas encore été définie, alors c'est elle qu'il faut définir en premier
                 set_robot_position(x, y);
             }
-            else if (point_de_destination_x == -1 && point_de_destination_y == -1) {    // Sinon, si la position du robot est déjà définie, cela signifie que c'est le point de destination qu'il faut définir
+            else if (point_de_destination_x == no_position && point_de_destination_y == no_position) {    // Sinon, si la position du robot est déjà définie, cela signifie que c'est le point de destination qu'il faut définir
+                if (!is_reachable_from_robot(x, y)) {
+                    emit show_popup(4);     // Destination dans une zone fermée : refusée tout de suite, sans lancer le calcul de trajectoire
+                    return;
+                }
                 enable_map_click(false);        // Désactive la possibilité de cliquer sur la carte pour ne pas changer le point de destination en cours de route (sans avoir cliqué sur "Trajectoire" avant etc...)
                 set_destination(x, y);
             }
@@ -250,16 +592,18 @@ void Map::set_destination_and_robot_position(int x, int y) {
 }
 
 // Méthode permettant d'ajouter des waypoints à la matrice à partir d'une matrice constituée de 0 et de 1
-void Map::set_waypoints(int waypoints_matrix[20][20]) {
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
+void Map::set_waypoints(const GridView<const uint8_t> &waypoints_matrix) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    GridBounds bounds = get_bounds();    // La case (i, j) de la matrice passée en paramètre est la case (bounds.row + i, bounds.col + j) de la carte
+    for (int i = 0; i < waypoints_matrix.rows(); ++i) {
+        for (int j = 0; j < waypoints_matrix.cols(); ++j) {
             // Si la case est un waypoint dans la matrice passée en paramètre...
-            if (waypoints_matrix[i][j] == 1)
+            if (waypoints_matrix.at(i, j) == 1)
             {
                 // ...Et qu'elle n'est pas un obstacle, ni la position du robot ni sa destination dans la matrice de la carte
-                if (matrix[i][j] == cartographied && matrix[i][j] != obstacle && matrix[i][j] != robot_position && matrix[i][j] != destination) {
+                if (get_cell(bounds.row + i, bounds.col + j) == cartographied) {
                     // Alors ajoute le waypoint à la matrice
-                    matrix[i][j] = waypoint;
+                    write_cell(bounds.row + i, bounds.col + j, waypoint);
                 }
                 else {
                     // Le waypoint ne peut pas être ajouté car la zone est inaccessible
@@ -267,117 +611,306 @@ void Map::set_waypoints(int waypoints_matrix[20][20]) {
             }
         }
     }
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
 }
 
 // Méthode permettant d'ajouter un waypoint à la matrice
 void Map::set_waypoint(int y, int x)
 {
-    // Si les coordonnées ne sont pas un obstacle, ni la position du robot ni sa destination
-    if (matrix[x][y] == cartographied && matrix[x][y] != obstacle && matrix[x][y] != robot_position && matrix[x][y] != destination) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    // Si les coordonnées sont une zone cartographiée : ni un obstacle, ni la position du robot ni sa destination
+    if (get_cell(x, y) == cartographied) {
         // Alors ajoute le waypoint à la matrice
-        matrix[x][y] = waypoint;
+        write_cell(x, y, waypoint);
     }
     else {
         // Le waypoint ne peut pas être ajouté car la zone est inaccessible
     }
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
 }
 
 // Méthode permettant de supprimer les waypoints de la matrice en passant la matrice des waypoints à enlever en paramètre
-void Map::reset_trajectory_with_parameter(int waypoints_matrix[20][20]) {
-    // 1) Supprime les waypoints
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            // Si la case est un waypoint dans la matrice passée en paramètre...
-            if (waypoints_matrix[i][j] == 1)
-            {
-                // ...Et que c'est bien un waypoint, qu'elle n'est pas un obstacle, ni la position du robot ni sa destination dans la matrice de la carte
-                if (matrix[i][j] == waypoint && matrix[i][j] != obstacle && matrix[i][j] != robot_position && matrix[i][j] != destination) {
-                    // Alors ajoute le waypoint à la matrice
-                    matrix[i][j] = cartographied;
-                }
-                else {
-                    // Le waypoint ne peut pas être ajouté car la zone est inaccessible
-                }
-            }
+void Map::reset_trajectory_with_parameter(const GridView<const uint8_t> &waypoints_matrix) {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    // 1) Supprime les waypoints : seuls les waypoints de la trajectoire sont lus dans la matrice passée en paramètre
+    GridBounds bounds = get_bounds();    // La case (i, j) de la matrice passée en paramètre est la case (bounds.row + i, bounds.col + j) de la carte
+    for (auto it = waypoint_cells.begin(); it != waypoint_cells.end();) {
+        int i = it->y() - bounds.row;
+        int j = it->x() - bounds.col;
+        // Si la case est un waypoint dans la matrice passée en paramètre, alors l'enlève de la trajectoire (l'occupation en dessous n'a jamais été modifiée)
+        if (waypoints_matrix.contains(i, j) && waypoints_matrix.at(i, j) == 1) {
+            it = erase_waypoint(it);
+        }
+        else {
+            ++it;
         }
     }
 
-    // 2) Supprime le point de destination
-    for (int i = 0; i < rows; ++i) {                // Parcours la matrice à la recherche de la destination...
-        for (int j = 0; j < cols; ++j) {
-            if (matrix[i][j] == destination) {
-                matrix[i][j] = cartographied;   // Pour le supprimer et le rempplacer par des cases cartographiées
-            }
-        }
+    // 2) Supprime le point de destination en oubliant ses coordonnées
+    move_marker(point_de_destination_y, point_de_destination_x, no_position, no_position);
+    dirty_layers |= planning_layer;
+}
+
+// Méthode permettant de réinitialiser la trajectoire du robot
+void Map::reset_trajectory() {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+
+    // 1) Supprime les waypoints : la couche de planification est vidée, la couche d'occupation n'est pas touchée
+    for (auto it = waypoint_cells.begin(); it != waypoint_cells.end();) {
+        it = erase_waypoint(it);
     }
 
+    // 2) Reset les variables des coordonnées de position du robot
+    move_marker(robot_position_y, robot_position_x, no_position, no_position);
+
     // 3) Reset les variables des coordonnées du point de destination
-    point_de_destination_x = -1;
-    point_de_destination_y = -1;
+    move_marker(point_de_destination_y, point_de_destination_x, no_position, no_position);
+    dirty_layers |= planning_layer | entity_layer;
+}
 
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
+// Méthode permettant de réinitialiser la carte
+void Map::reset_map() {
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    // 1) Reset les variables des coordonnées du point de destination
+    point_de_destination_x = no_position;
+    point_de_destination_y = no_position;
+
+    // 2) Reset les variables des coordonnées de position du robot
+    robot_position_x = no_position;
+    robot_position_y = no_position;
+    dirty_layers |= entity_layer;
+
+    // 3) Met toutes les cases de la map à non_cartographied (les lecteurs du journal relisent toute la carte)
+    init_map();
 }
 
-// Méthode permettant de réinitialiser la trajectoire du robot
-void Map::reset_trajectory() {
+// Position de la section suivante d'un fichier de carte, alignée sur MAP_FILE_ALIGNMENT
+static quint64 map_file_align(quint64 offset) {
+    return (offset + MAP_FILE_ALIGNMENT - 1) / MAP_FILE_ALIGNMENT * MAP_FILE_ALIGNMENT;
+}
 
-    // 1) Supprime les waypoints
-    for (int i = 0; i < rows; ++i) {                // Parcours la matrice à la recherche de waypoints...
-        for (int j = 0; j < cols; ++j) {
-                if (matrix[i][j] == waypoint) {
-                    matrix[i][j] = cartographied;   // Pour les supprimer et les rempplacer par des cases cartographiées
-                }
-            }
-        }
+// Méthode enregistrant la carte dans un fichier, depuis sa dernière version publiée (à jour en dehors d'un Batch)
+bool Map::save_file(const QString &path) const {
+    return snapshot().save_file(path);
+}
 
-    // 2) Supprime la position du robot
-    for (int i = 0; i < rows; ++i) {                // Parcours la matrice à la recherche de la destination...
-        for (int j = 0; j < cols; ++j) {
-            if (matrix[i][j] == robot_position) {
-                    matrix[i][j] = cartographied;   // Pour le supprimer et le rempplacer par des cases cartographiées
+// Méthode enregistrant un instantané dans un fichier : QSaveFile écrit un fichier temporaire et le renomme à la fin, un fichier à moitié écrit ne remplace jamais le précédent
+// L'instantané ne change pas pendant l'écriture : elle peut se faire dans un autre thread pendant que la carte continue d'être modifiée
+bool Map::Snapshot::save_file(const QString &path) const {
+    GridBounds bounds = occupancy.bounds();
+
+    Map_File_Head head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, MAP_FILE_MAGIC, sizeof(MAP_FILE_MAGIC));
+    head.byte_order = MAP_FILE_BYTE_ORDER;
+    head.version = MAP_FILE_VERSION;
+    head.head_size = sizeof(head);
+    head.layers = MAP_FILE_PLANNING | MAP_FILE_ENTITY;
+    head.row = bounds.row;
+    head.col = bounds.col;
+    head.rows = bounds.rows;
+    head.cols = bounds.cols;
+    head.resolution_mm = MAP_FILE_RESOLUTION_MM;
+    head.waypoint_count = static_cast<uint32_t>(waypoint_cells.size());
+    head.robot_x = robot_position_x;
+    head.robot_y = robot_position_y;
+    head.destination_x = point_de_destination_x;
+    head.destination_y = point_de_destination_y;
+    head.cells_offset = map_file_align(sizeof(head));
+    head.waypoints_offset = map_file_align(head.cells_offset + static_cast<quint64>(bounds.rows) * bounds.cols);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Enregistrement de la carte impossible :" << file.errorString();
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&head), sizeof(head));
+    file.write(QByteArray(static_cast<int>(head.cells_offset - sizeof(head)), 0));
+
+    // Les cases sont copiées par bandes de la hauteur d'un morceau : la mémoire utilisée ne dépend pas de la taille de la carte
+    Grid<int8_t> band(CHUNKED_GRID_SIDE, bounds.cols);
+    for (int i = 0; i < bounds.rows; i += CHUNKED_GRID_SIDE) {
+        int band_rows = qMin(CHUNKED_GRID_SIDE, bounds.rows - i);
+        occupancy.copy_to(band.view().sub(0, 0, band_rows, bounds.cols), bounds.row + i, bounds.col);
+        file.write(reinterpret_cast<const char *>(band.data()), static_cast<qint64>(band_rows) * bounds.cols);
+    }
+    file.write(QByteArray(static_cast<int>(head.waypoints_offset - head.cells_offset - static_cast<quint64>(bounds.rows) * bounds.cols), 0));
+
+    QVector<Map_File_Cell> waypoints;
+    waypoints.reserve(waypoint_cells.size());
+    for (const QPoint &cell : std::as_const(waypoint_cells)) {
+        waypoints.append(Map_File_Cell{cell.x(), cell.y()});
+    }
+    file.write(reinterpret_cast<const char *>(waypoints.constData()), static_cast<qint64>(waypoints.size()) * sizeof(Map_File_Cell));
+
+    // Une écriture ratée fait échouer commit() : l'ancien fichier reste en place
+    if (!file.commit()) {
+        qDebug() << "Enregistrement de la carte impossible :" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Méthode reconstruisant les index d'une carte chargée, morceau par morceau : chaque case est seuillée 8 à la fois, puis
+// clearance est calculé en une passe (sans file de propagation) et connectivity reçoit les cases libres par suites
+void Map::rebuild_indexes() {
+    // Les morceaux voisins n'ont pas d'occupation mais peuvent être à portée d'un obstacle du bord
+    std::set<std::pair<int, int>> origins;
+    occupancy.for_each_chunk([&origins](GridView<const int8_t>, int row, int col) {
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                origins.insert(std::make_pair(row + i * CHUNKED_GRID_SIDE, col + j * CHUNKED_GRID_SIDE));
             }
         }
+    });
+    Grid<uint8_t> categories(CHUNKED_GRID_SIDE + 2 * clearance_range, CHUNKED_GRID_SIDE + 2 * clearance_range);
+    for (const auto &origin : origins) {
+        classify_occupancy(occupancy, categories.view(), origin.first - clearance_range, origin.second - clearance_range, obstacle, cartographied, non_cartographied);
+        GridBounds area{origin.first, origin.second, CHUNKED_GRID_SIDE, CHUNKED_GRID_SIDE};
+        if (categories.count(obstacle) != 0) {
+            clearance.build(categories.view(), area, obstacle);
+        }
+        // Un morceau sans case libre n'alloue rien dans connectivity
+        GridView<const uint8_t> chunk = GridView<const uint8_t>(categories.view()).sub(clearance_range, clearance_range, CHUNKED_GRID_SIDE, CHUNKED_GRID_SIDE);
+        if (chunk.count(cartographied) != 0) {
+            connectivity.add_cells(chunk, origin.first, origin.second, cartographied);
+        }
     }
+}
 
-    // 3) Supprime le point de destination
-    for (int i = 0; i < rows; ++i) {                // Parcours la matrice à la recherche de la destination...
-        for (int j = 0; j < cols; ++j) {
-            if (matrix[i][j] == destination) {
-                matrix[i][j] = cartographied;   // Pour le supprimer et le rempplacer par des cases cartographiées
-            }
+// Méthode rechargeant une carte enregistrée par save_file : le fichier est projeté en mémoire, les cases copiées telles
+// quelles dans les morceaux de la carte (une ligne de morceau à la fois), puis les index reconstruits une seule fois
+bool Map::load_file(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Chargement de la carte impossible :" << file.errorString();
+        return false;
+    }
+    quint64 size = static_cast<quint64>(file.size());
+    uchar *data = (size >= sizeof(Map_File_Head)) ? file.map(0, file.size()) : nullptr;
+    if (data == nullptr) {
+        qDebug() << "Chargement de la carte impossible : fichier trop court ou non projetable" << path;
+        return false;
+    }
+
+    // Vérifie l'en-tête avant de toucher à la carte : un fichier tronqué ou d'une autre version la laisse inchangée
+    Map_File_Head head;
+    memcpy(&head, data, sizeof(head));
+    quint64 cells_size = static_cast<quint64>(qMax(head.rows, 0)) * static_cast<quint64>(qMax(head.cols, 0));
+    bool valid = memcmp(head.magic, MAP_FILE_MAGIC, sizeof(MAP_FILE_MAGIC)) == 0
+              && head.byte_order == MAP_FILE_BYTE_ORDER
+              && head.version == MAP_FILE_VERSION
+              && head.head_size >= sizeof(Map_File_Head)
+              && head.rows >= 0 && head.cols >= 0
+              && static_cast<qint64>(head.row) + head.rows <= INT_MAX && static_cast<qint64>(head.col) + head.cols <= INT_MAX
+              && head.cells_offset >= head.head_size && head.cells_offset <= size && cells_size <= size - head.cells_offset
+              && head.waypoints_offset <= size && static_cast<quint64>(head.waypoint_count) * sizeof(Map_File_Cell) <= size - head.waypoints_offset;
+    if (!valid) {
+        qDebug() << "Chargement de la carte impossible : fichier invalide" << path;
+        file.unmap(data);
+        return false;
+    }
+
+    Batch batch(*this);     // Met à jour la carte sur l'IHM une seule fois, à la fin de la méthode
+    init_map();
+    occupancy.copy_from(GridView<const int8_t>(reinterpret_cast<const int8_t *>(data + head.cells_offset), head.rows, head.cols, head.cols), head.row, head.col);
+    rebuild_indexes();
+
+    // Couches facultatives : absentes du fichier, la destination et le robot actuels sont gardés
+    if (head.layers & MAP_FILE_PLANNING) {
+        for (uint32_t i = 0; i < head.waypoint_count; i++) {
+            Map_File_Cell cell;
+            memcpy(&cell, data + head.waypoints_offset + i * sizeof(Map_File_Cell), sizeof(cell));
+            waypoint_cells.insert(cell_key(cell.y, cell.x), QPoint(cell.x, cell.y));
         }
+        point_de_destination_x = head.destination_x;
+        point_de_destination_y = head.destination_y;
+    }
+    if (head.layers & MAP_FILE_ENTITY) {
+        robot_position_x = head.robot_x;
+        robot_position_y = head.robot_y;
+        dirty_layers |= entity_layer;
     }
+    file.unmap(data);
 
-    // 4) Reset les variables des coordonnées du point de destination
-    robot_position_x = -1;
-    robot_position_y = -1;
+    // Les couches ont été écrites sans journal : les lecteurs relisent toute la carte
+    journal_floor = ++map_version;
+    batch_dirty = batch_dirty.united(get_bounds());
+    return true;
+}
 
-    // 5) Reset les variables des coordonnées de position du robot
-    point_de_destination_x = -1;
-    point_de_destination_y = -1;
+// Constructeur d'un instantané : les morceaux des grilles et la trajectoire sont partagés avec la carte, pas copiés
+Map::Snapshot::Snapshot(const Map &map)
+    : version(map.map_version),
+    bounds(map.get_bounds()),
+    occupancy(map.occupancy),
+    clearance(map.clearance),
+    inflation_radius(map.inflation_radius),
+    waypoint_cells(map.waypoint_cells),
+    point_de_destination_x(map.point_de_destination_x),
+    point_de_destination_y(map.point_de_destination_y),
+    robot_position_x(map.robot_position_x),
+    robot_position_y(map.robot_position_y)
+{
+}
 
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
+// Méthode retournant la valeur affichée d'une case de l'instantané (voir Map::get_cell)
+uint8_t Map::Snapshot::get_cell(int y, int x) const {
+    if (y == robot_position_y && x == robot_position_x) {
+        return robot_position;
+    }
+    if (y == point_de_destination_y && x == point_de_destination_x) {
+        return destination;
+    }
+    if (waypoint_cells.contains(cell_key(y, x))) {
+        return waypoint;
+    }
+    return LOG_ODDS_classify_cell(occupancy.get(y, x), obstacle, cartographied, non_cartographied);
 }
 
-// Méthode permettant de réinitialiser la carte
-void Map::reset_map() {
-    // 1) Met toutes les cases de la map à non_cartographied
-    init_map();
+// Méthode composant les couches de l'instantané dans dest (voir Map::compose)
+void Map::Snapshot::compose(const GridView<uint8_t> &dest, int row, int col) const {
+    classify_occupancy(occupancy, dest, row, col, obstacle, cartographied, non_cartographied);
+    for (const QPoint &cell : std::as_const(waypoint_cells)) {
+        if (dest.contains(cell.y() - row, cell.x() - col)) {
+            dest.at(cell.y() - row, cell.x() - col) = waypoint;
+        }
+    }
+    if (point_de_destination_x != no_position && point_de_destination_y != no_position && dest.contains(point_de_destination_y - row, point_de_destination_x - col)) {
+        dest.at(point_de_destination_y - row, point_de_destination_x - col) = destination;
+    }
+    if (robot_position_x != no_position && robot_position_y != no_position && dest.contains(robot_position_y - row, robot_position_x - col)) {
+        dest.at(robot_position_y - row, robot_position_x - col) = robot_position;
+    }
+}
 
-    // 2) Reset les variables des coordonnées du point de destination
-    point_de_destination_x = -1;
-    point_de_destination_y = -1;
+// Méthode retournant le coût de passage d'une case de l'instantané (voir Map::get_clearance_cost)
+uint8_t Map::Snapshot::get_clearance_cost(int y, int x) const {
+    return clearance_cost(clearance, inflation_radius, y, x);
+}
 
-    // 3) Reset les variables des coordonnées de position du robot
-    robot_position_x = -1;
-    robot_position_y = -1;
+// Méthode publiant l'état de la carte : un lecteur charge l'ancienne version ou la nouvelle, jamais un mélange des deux
+void Map::publish() const {
+    std::atomic_store(&published, std::shared_ptr<const Snapshot>(std::make_shared<Snapshot>(*this)));
+    snapshot_stale = false;
+}
 
-    // Met à jour la carte sur l'IHM
-    emit map_updated();
+// Méthode copiant la dernière version publiée : seuls les pointeurs des morceaux sont copiés, la carte peut être modifiée pendant la copie
+// Une carte changée depuis est d'abord publiée par son thread : les morceaux ne sont partagés, et copiés à la prochaine écriture, que lorsqu'un lecteur en a besoin
+Map::Snapshot Map::snapshot() const {
+    if (snapshot_stale) {
+        if (QThread::currentThread() == thread()) {
+            if (batch_depth == 0) {
+                publish();      // Dans un Batch, le lecteur garde la version d'avant le lot
+            }
+        }
+        else {
+            // La carte n'est lue que dans son thread : il publie entre deux slots, hors de tout Batch, pendant que ce thread attend
+            QMetaObject::invokeMethod(const_cast<Map *>(this), [this]() {
+                if (snapshot_stale && batch_depth == 0) {
+                    publish();
+                }
+            }, Qt::BlockingQueuedConnection);
+        }
+    }
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&published);    // Gardée en vie pendant la copie, même si une nouvelle version est publiée
+    return *current;
 }
@@ -6,7 +6,17 @@
 #define MAP_H
 
 #include <QWidget>
+#include <QVector>
+#include <QPoint>
+#include <QHash>
 #include "customgraphicsview.h"
+#include <climits>
+#include <memory>
+#include <atomic>
+#include "grid/chunked_grid.h"
+#include "grid/log_odds.h"
+#include "grid/distance_field.h"
+#include "grid/connectivity.h"
 
 class CustomGraphicsView;
 class QGraphicsScene;
@@ -20,17 +30,28 @@ private:
     CustomGraphicsView *view;
     QGraphicsScene *scene;
 
-    static const int rows = 20; // Nombre de lignes de la matrice
-    static const int cols = 20; // Nombre de colonnes de la matrice
+    static const int default_rows = 20; // Nombre de lignes de la zone affichée au démarrage, avant toute exploration
+    static const int default_cols = 20; // Nombre de colonnes de la zone affichée au démarrage
     static const int number_of_possible_values_for_a_matrix_cell = 6;  // TODO : à modifier Nombre de valeurs différentes possible qu'une case de la matrice peut avoir
 
-    int matrix[rows][cols];
+    // La carte est faite de trois couches, composées seulement pour l'affichage (voir compose) :
+    // 1) Couche d'occupation : log-odds d'obstacle par case (voir grid/log_odds.h), 0 si rien n'est connu, par morceaux alloués à la première écriture (la carte grandit dans toutes les directions)
+    ChunkedGrid<int8_t> occupancy;
+    DistanceField clearance;    // Distance de chaque case à l'obstacle le plus proche, suivie avec la couche d'occupation et mise à jour à la fin de chaque Batch
+    int inflation_radius = 0;   // Distance (en cases) aux obstacles en deçà de laquelle une case est interdite au robot
+    Connectivity connectivity;  // Composantes connexes des cases cartographiées, mises à jour à la fin de chaque Batch
 
-    int point_de_destination_x;     // Si la valeur de ces variables est -1, alors cela signifie qu'elles ne sont pas encore affectées
+    // 2) Couche de planification : la trajectoire et sa destination, posées par-dessus l'occupation sans la modifier
+    QHash<quint64, QPoint> waypoint_cells;  // Waypoints de la trajectoire (QPoint : x = colonne, y = ligne)
+    int point_de_destination_x;     // Si la valeur de ces variables est no_position, alors cela signifie qu'elles ne sont pas encore affectées
     int point_de_destination_y;
+
+    // 3) Couche des entités : le robot
     int robot_position_x;
     int robot_position_y;
 
+    int dirty_layers = occupancy_layer | planning_layer | entity_layer;    // Couches modifiées depuis le dernier take_dirty_layers()
+
     bool is_map_clickable = false;
 
     enum cell_value {
@@ -47,6 +68,18 @@ private:
     void ajout_obstacle_rectangulaire(int topLeftX, int topLeftY, int width, int height);
     void ajout_zone_non_cartographiee_carre(int topLeftX, int topLeftY, int size);
     void ajout_zone_non_cartographiee_rond(int centerX, int centerY, int radius);
+    bool apply_cells(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas); // Écrit un lot de cases sans rafraîchir l'IHM
+    bool place_robot(int y, int x); // Déplace le robot dans la matrice sans rafraîchir l'IHM
+    void write_cell(int y, int x, uint8_t value); // Écrit une valeur de cell_value dans la couche à laquelle elle appartient
+    void set_occupancy(int y, int x, uint8_t value); // Écrit une case certaine (obstacle ou cartographied) ou inconnue (non_cartographied) dans la couche d'occupation
+    void observe_cells(const QVector<QPoint> &cells, int8_t delta); // Ajoute une observation (LOG_ODDS_HIT ou LOG_ODDS_MISS) aux cases, par suites de cases contiguës
+    void update_indexes(int y, int x, uint8_t category); // Suit la nouvelle catégorie (obstacle, cartographied ou non_cartographied) de la case (y, x) dans clearance et connectivity
+    void rebuild_indexes(); // Reconstruit clearance et connectivity (vides) depuis la couche d'occupation, morceau par morceau
+    void publish() const; // Publie l'état de la carte pour les lecteurs des autres threads (voir snapshot), dans le thread de la carte et hors d'un Batch
+    static uint8_t clearance_cost(const DistanceField &clearance, int inflation_radius, int y, int x); // Coût de passage de la case (y, x) selon le champ de distances
+    void record_change(int y, int x, uint8_t old_value); // Journalise la case (y, x) si sa valeur affichée n'est plus old_value
+    void move_marker(int &marker_y, int &marker_x, int y, int x); // Déplace le robot ou la destination (no_position pour l'enlever) en journalisant ses deux cases
+    QHash<quint64, QPoint>::iterator erase_waypoint(QHash<quint64, QPoint>::iterator it); // Enlève un waypoint de la trajectoire en journalisant sa case
 
 public:
     static Map& getInstance() {
@@ -59,18 +92,120 @@ public:
 
     CustomGraphicsView* getCustomView() const;
 
-    // Fonction pour retourner la matrice
-    int (*get_map())[20];
+    static const int no_position = INT_MIN;    // Coordonnée d'une position pas encore affectée (les coordonnées négatives sont des cases de la carte)
+
+    // Couches de la carte, pour take_dirty_layers()
+    enum layer {
+        occupancy_layer = 1,
+        planning_layer = 2,
+        entity_layer = 4
+    };
+
+    // Fonction pour retourner la couche d'occupation seule, en log-odds (à lire dans le thread de l'IHM)
+    const ChunkedGrid<int8_t> &get_occupancy() const;
+
+    // Fonction copiant la vue seuillée de la couche d'occupation (obstacle, cartographied ou non_cartographied) dans dest, dont la case (0, 0) est la case (row, col) de la carte
+    void copy_occupancy(const GridView<uint8_t> &dest, int row, int col) const;
+
+    // Fonction pour retourner la valeur affichée d'une case : le robot, puis la destination, puis un waypoint, puis l'occupation
+    uint8_t get_cell(int y, int x) const;
 
-    // Fonctions pour retourner les dimensions de la matrice
-    static int getRows() { return rows; }
-    static int getCols() { return cols; }
+    // Fonctions composant les couches dans dest, dont la case (0, 0) est la case (row, col) de la carte
+    void compose(const GridView<uint8_t> &dest, int row, int col) const;            // Occupation et couches du dessus
+    void compose_overlays(const GridView<uint8_t> &dest, int row, int col) const;   // Couches du dessus seulement, sur une occupation déjà copiée dans dest
+
+    // Fonction retournant les couches modifiées (masque de layer) depuis l'appel précédent
+    int take_dirty_layers();
+
+    // Changement d'une case affichée
+    struct Change {
+        quint32 version;    // Version de la carte après ce changement
+        int y;              // Ligne de la case
+        int x;              // Colonne de la case
+        uint8_t old_value;  // Valeur affichée (cell_value) avant...
+        uint8_t new_value;  // ...et après
+    };
+
+    // Fonction retournant la version de la carte
+    quint32 get_version() const { return map_version; }
+
+    // Fonction donnant les changements postérieurs à version, dans l'ordre. Retourne faux si le journal ne les a plus tous : il faut relire toute la carte (compose)
+    bool changes_since(quint32 version, QVector<Change> &changes) const;
+
+    // Transaction : les méthodes qui modifient la carte en ouvrent une, et le dernier Batch détruit émet map_updated puis map_changed, une seule fois pour tout le lot
+    class Batch {
+    public:
+        explicit Batch(Map &map);
+        ~Batch();
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+    private:
+        Map &map;
+    };
+
+    // Distance aux obstacles, pour les planificateurs : en O(1) par case
+    static const int clearance_range = 6;      // Portée (en cases) du champ de distances : au-delà, une case est loin de tout obstacle
+    static const uint8_t lethal_cost = 255;    // Coût d'un obstacle ou d'une case plus proche d'un obstacle que le rayon d'inflation
+    void set_inflation_radius(int radius);     // Rayon d'inflation (en cases, de 0 à clearance_range - 1)
+    int get_inflation_radius() const { return inflation_radius; }
+    float get_clearance(int y, int x) const;   // Distance (en cases) à l'obstacle le plus proche, clearance_range au-delà
+    uint8_t get_clearance_cost(int y, int x) const; // lethal_cost jusqu'au rayon d'inflation, puis décroissant jusqu'à 0 à clearance_range
+
+    // Accessibilité, en O(1) : deux cases cartographiées reliées par un chemin de cases cartographiées (voisines par un côté, comme les déplacements du robot)
+    bool is_reachable(int from_y, int from_x, int to_y, int to_x) const;
+    bool is_reachable_from_robot(int y, int x) const;  // Faux sans position du robot
+    bool is_selecting_destination() const;             // Vrai quand le prochain clic sur la carte choisit la destination : les cases inaccessibles sont grisées
+    quint32 get_connectivity_version() const { return connectivity.get_version(); }    // Change quand des composantes sont créées, réunies ou coupées
+
+    // Instantané de la carte : une version immuable, que l'affichage, la planification ou l'enregistrement lisent dans n'importe quel thread, sans verrou
+    // Les morceaux de la carte sont partagés avec l'instantané et copiés seulement quand la carte les écrit ensuite (voir chunked_grid.h) : publier ne copie pas les cases
+    // Elle n'est publiée qu'à la demande, au premier snapshot() après un Batch qui a changé la carte : la télémétrie sans lecteur ne copie aucun morceau
+    class Snapshot {
+    public:
+        explicit Snapshot(const Map &map);     // À construire dans le thread de la carte (voir Map::snapshot pour les autres threads)
+
+        quint32 get_version() const { return version; }     // Version de la carte publiée (voir Map::get_version)
+        GridBounds get_bounds() const { return bounds; }
+        const ChunkedGrid<int8_t> &get_occupancy() const { return occupancy; }
+        uint8_t get_cell(int y, int x) const;
+        void compose(const GridView<uint8_t> &dest, int row, int col) const;
+        uint8_t get_clearance_cost(int y, int x) const;
+        int get_robot_position_x() const { return robot_position_x; }
+        int get_robot_position_y() const { return robot_position_y; }
+        bool save_file(const QString &path) const;     // Voir Map::save_file
+
+    private:
+        // Mêmes couches que la carte, figées à la publication
+        quint32 version;
+        GridBounds bounds;
+        ChunkedGrid<int8_t> occupancy;
+        DistanceField clearance;
+        int inflation_radius;
+        QHash<quint64, QPoint> waypoint_cells;    // Partagé implicitement avec la carte jusqu'à sa prochaine modification
+        int point_de_destination_x;
+        int point_de_destination_y;
+        int robot_position_x;
+        int robot_position_y;
+    };
+
+    // Fonction retournant une copie de la carte telle qu'à la fin du dernier Batch. Peut être appelée de n'importe quel thread
+    // Si la carte a changé depuis la dernière publication, le thread de la carte la publie d'abord : un autre thread l'attend, il ne doit donc pas être attendu par le thread de la carte
+    // La copie est à l'appelant : ses lectures remplissent le cache de ses grilles, elle ne doit pas être lue par deux threads à la fois
+    Snapshot snapshot() const;
+
+    // Fonction pour retourner la boîte des cases connues de la carte (elle peut commencer à des coordonnées négatives)
+    GridBounds get_bounds() const;
     int get_robot_position_x() { return robot_position_x; }
     int get_robot_position_y() { return robot_position_y; }
+    bool has_robot_position() const { return robot_position_x != no_position && robot_position_y != no_position; }
     static int get_number_of_possible_values_for_a_matrix_cell() { return number_of_possible_values_for_a_matrix_cell; }
 
     void enable_map_click(bool clickable); // Méthode pour mettre à jour l'état
 
+    // Fonctions enregistrant la carte dans un fichier (voir map_file.h), remplacé en une fois, et la rechargeant. Retournent faux en cas d'erreur (la carte est alors inchangée)
+    bool save_file(const QString &path) const;
+    bool load_file(const QString &path);
+
 
 
 public slots:
@@ -79,14 +214,17 @@ public slots:
     void set_obstacle(int y, int x);
     void set_cartographied_area(int y, int x);
     void set_non_cartographied_area(int y, int x);
-    void update_entire_matrix(int new_matrix[rows][cols]); // si marche pas : tester en remplaçant rows et cols par 100
+    void set_cells(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas); // Applique un lot de cases (MAP_DELTA) avec un seul map_updated
+    void load_cells(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas); // Remplace toute la carte (MAP_SNAPSHOT) avec un seul map_updated
+    void apply_telemetry(const QVector<QPoint> &obstacles, const QVector<QPoint> &cartographied_areas, const QPoint &robot); // Applique un lot de télémétrie (cases et position du robot, (no_position, no_position) si inchangée) avec un seul map_updated
+    void update_entire_matrix(const GridView<const uint8_t> &new_matrix); // Écrit new_matrix sur la carte, à partir du coin de la boîte des cases connues
     void set_destination(int y, int x);
     void set_robot_position(int y, int x);
     void set_destination_and_robot_position(int y, int x);
-    void set_waypoints(int waypoints_matrix[rows][cols]);    // La matrice contient des 0 et des 1, 1 pour les waypoints
+    void set_waypoints(const GridView<const uint8_t> &waypoints_matrix);    // La matrice contient des 0 et des 1, 1 pour les waypoints, à partir du coin de la boîte des cases connues
     void set_waypoint(int y, int x);
     void reset_trajectory();
-    void reset_trajectory_with_parameter(int waypoints_matrix[rows][cols]);
+    void reset_trajectory_with_parameter(const GridView<const uint8_t> &waypoints_matrix);
     void reset_map();
 
     void update_entire_matrix_from_trajectory_result(const QString &str);  // Met à jour la matrice avvec la matrice que retourne l'algorithme "Trajectory"
@@ -96,6 +234,27 @@ signals:
     void map_updated(); // Signal à émettre après que la matrix ait été modifiée pour mettre à jour son affichage sur l'écran
     void map_updated_after_destination_selection(); // Signal à émettre après que l'utilisateur à sélectionner un point de destination sur la carte
     void show_popup(int id_popup); // Signal à émettre pour afficher la popup d'erreur de sélection de point de destination
+    void map_changed(const GridBounds &dirty, const QVector<QPoint> &cells); // Signal émis à la fin d'un Batch : boîte des cases affichées modifiées et leur liste (vide si elles dépassent batch_cells_limit : relire la boîte)
+
+private:
+    // Journal des changements des cases affichées, pour les lecteurs incrémentaux (voir changes_since)
+    static const int journal_length = 4096;    // Changements gardés : au-delà, un lecteur en retard relit toute la carte
+    QVector<Change> journal;                    // Anneau des derniers changements, indexé par version % journal_length
+    quint32 map_version = 0;                    // Version de la carte, incrémentée à chaque case affichée qui change
+    quint32 journal_floor = 0;                  // Plus petite version depuis laquelle le journal est complet (init_map efface tout sans journaliser)
+
+    // Transaction en cours (voir Batch)
+    static const int batch_cells_limit = journal_length;   // Cases listées par map_changed : au-delà, seule la boîte est donnée
+    int batch_depth = 0;                        // Batch imbriqués encore ouverts
+    quint32 batch_version = 0;                  // Version de la carte à l'ouverture du premier Batch
+    GridBounds batch_bounds;                    // Boîte de la carte à l'ouverture du premier Batch
+    GridBounds batch_dirty;                     // Boîte des cases modifiées par le lot
+    QVector<QPoint> batch_cells;                // Cases modifiées par le lot (x = colonne, y = ligne)
+    bool batch_overflow = false;                // Plus de batch_cells_limit cases modifiées
+
+    // Dernière version publiée (voir snapshot), remplacée d'un bloc par std::atomic_store : un lecteur garde la sienne tant qu'il la copie
+    mutable std::shared_ptr<const Snapshot> published;
+    mutable std::atomic<bool> snapshot_stale{false};   // Couches modifiées depuis la dernière publication : le prochain snapshot() publie
 };
 
 #endif // MAP_H
@@ -0,0 +1,123 @@
+/**
+ * \file  map_file.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Header file of the map file of Cute : versioned binary layout, loaded by mapping the file and saved atomically.
+ *
+ * A map file is a Map_File_Head, then the cells of the occupancy layer (int8 log-odds, see log_odds.h), row-major
+ * and packed, at cells_offset, then the waypoints of the planning layer (Map_File_Cell) at waypoints_offset.
+ * The destination and the robot are in the head. Every field is in the byte order of the host that saved the file,
+ * so that a map loads without any parsing : the cells are copied straight from the mapped file into the chunks of
+ * the map. A file saved by a host of the other byte order is refused (byte_order reads reversed).
+ *
+ * The journal of the map (Map::changes_since) is not saved : a loaded map starts a new journal.
+ *
+ * \see map.h
+ * \see log_odds.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef MAP_FILE_H_
+#define MAP_FILE_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <cstdint>
+
+/* ----------------------  PUBLIC CONFIGURATIONS  --------------------------- */
+/**
+ * \def MAP_FILE_MAGIC
+ * First 8 bytes of a map file.
+ */
+#define MAP_FILE_MAGIC "CUTEMAP"
+/**
+ * \def MAP_FILE_VERSION
+ * Version of the layout, to be increased at every change of Map_File_Head or of the sections.
+ */
+#define MAP_FILE_VERSION 1
+/**
+ * \def MAP_FILE_BYTE_ORDER
+ * Written as is by the saving host : read reversed, the file comes from a host of the other byte order.
+ */
+#define MAP_FILE_BYTE_ORDER 0x01020304u
+/**
+ * \def MAP_FILE_ALIGNMENT
+ * Alignment of the sections in the file.
+ */
+#define MAP_FILE_ALIGNMENT 64
+/**
+ * \def MAP_FILE_RESOLUTION_MM
+ * Side of a cell : one move of the robot (see motor_sim.c).
+ */
+#define MAP_FILE_RESOLUTION_MM 120
+
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \enum Map_File_Layer
+ * \brief Optional layers saved in a map file (bits of Map_File_Head::layers). The occupancy layer is always saved.
+ */
+typedef enum {
+    MAP_FILE_PLANNING = 1,      /**< Waypoints and destination. */
+    MAP_FILE_ENTITY = 2         /**< Position of the robot. */
+} Map_File_Layer;
+
+/**
+ * \struct Map_File_Head map_file.h "map_file.h"
+ * \brief Head of a map file. The cells of the map are (row .. row + rows - 1, col .. col + cols - 1).
+ */
+typedef struct {
+    char magic[8];              /**< MAP_FILE_MAGIC, 0 terminated. */
+    uint32_t byte_order;        /**< MAP_FILE_BYTE_ORDER. */
+    uint32_t version;           /**< MAP_FILE_VERSION. */
+    uint32_t head_size;         /**< sizeof(Map_File_Head) of the saving version. */
+    uint32_t layers;            /**< Map_File_Layer bits. */
+    int32_t row;                /**< First row of the map (negative when explored upwards). */
+    int32_t col;                /**< First column of the map. */
+    int32_t rows;               /**< Rows of the map. */
+    int32_t cols;               /**< Columns of the map. */
+    uint32_t resolution_mm;     /**< Side of a cell. */
+    uint32_t waypoint_count;    /**< Map_File_Cell at waypoints_offset. */
+    int32_t robot_x;            /**< Column of the robot, INT_MIN when unknown or without MAP_FILE_ENTITY. */
+    int32_t robot_y;            /**< Row of the robot. */
+    int32_t destination_x;      /**< Column of the destination, INT_MIN when unknown or without MAP_FILE_PLANNING. */
+    int32_t destination_y;      /**< Row of the destination. */
+    uint64_t cells_offset;      /**< rows x cols int8 log-odds, row-major. */
+    uint64_t waypoints_offset;  /**< waypoint_count Map_File_Cell. */
+} Map_File_Head;
+
+/**
+ * \struct Map_File_Cell map_file.h "map_file.h"
+ * \brief Coordinates of a cell in a section of a map file.
+ */
+typedef struct {
+    int32_t x;                  /**< Column. */
+    int32_t y;                  /**< Row. */
+} Map_File_Cell;
+
+static_assert(sizeof(Map_File_Head) == 80, "Map_File_Head is written as is");
+static_assert(sizeof(Map_File_Cell) == 8, "Map_File_Cell is written as is");
+
+#endif /* MAP_FILE_H_ */
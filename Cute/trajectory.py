@@ -8,6 +8,7 @@ en une série de commandes pour le robot.
 
 import numpy as np
 import heapq
+import json
 import sys
 from generate_commands import generate_commands
 
@@ -27,16 +28,21 @@ ROBOT_ORIENTATION_OUEST = 8
 # Orientation initiale du robot.
 ROBOT = ROBOT_ORIENTATION_EST
 
+# Coûts de passage des cases selon leur distance aux obstacles (Map::get_clearance_cost).
+LETHAL_COST = 255           # Case trop proche d'un obstacle : interdite.
+CLEARANCE_COST_SCALE = 64   # Un coût de 64 vaut un pas de plus : le robot s'écarte des murs quand le détour est court.
+
 # Commandes possibles à envoyer au robot.
 FRONT = 0 
 RIGHT = 1 
 LEFT = 2 
 
-def make_trajectory(matrix):
+def make_trajectory(matrix, costs=None):
     """
     @brief Transforme une matrice de l'environnement en une trajectoire pour le robot.
     La matrice est mise à jour avec les waypoints et la trajectoire est retournée sous forme de commandes.
     @param matrix: np.array - La matrice représentant l'environnement du robot.
+    @param costs: np.array - Le coût de passage de chaque case (0 à LETHAL_COST), ou None pour un coût nul partout.
     @return: tuple - La matrice mise à jour, les commandes générées, et le nombre de commandes.
     """
     matrix[matrix == UNKNOWN] = OBSTACLE
@@ -44,7 +50,10 @@ def make_trajectory(matrix):
     if robot_pos is None or destination_pos is None:
         return matrix, []
 
-    path = a_star_search(robot_pos, destination_pos, matrix)
+    if costs is None:
+        costs = np.zeros(matrix.shape, dtype=int)
+
+    path = a_star_search(robot_pos, destination_pos, matrix, costs)
     
     if not path:
         print("No path found")
@@ -73,12 +82,14 @@ def find_robot_and_destination(matrix):
 
     return robot_pos, destination_pos
 
-def a_star_search(start, goal, grid):
+def a_star_search(start, goal, grid, costs):
     """
-    @brief Implémente l'algorithme A* pour trouver le chemin le plus court entre deux points.
+    @brief Implémente l'algorithme A* pour trouver le chemin le moins coûteux entre deux points.
+    Un pas coûte 1, plus le coût de passage de la case atteinte : la distance de Manhattan reste une heuristique admissible.
     @param start: tuple - Position de départ.
     @param goal: tuple - Position de la destination.
     @param grid: np.array - La grille représentant l'environnement.
+    @param costs: np.array - Le coût de passage de chaque case.
     @return: list - Le chemin trouvé, si disponible.
     """
     open_set = []  # Initialise l'ensemble ouvert pour stocker les noeuds à explorer
@@ -89,14 +100,18 @@ def a_star_search(start, goal, grid):
     f_score = {start: manhattan_distance(start, goal)}  # Estimation du coût total de start à goal passant par n
 
     while open_set:
-        _, current = heapq.heappop(open_set)  # Récupère le noeud avec le plus petit score f
+        f, current = heapq.heappop(open_set)  # Récupère le noeud avec le plus petit score f
+
+        # Entrée périmée : le noeud a été remis dans l'ensemble ouvert avec un meilleur score, et déjà exploré avec lui
+        if f > f_score[current]:
+            continue
 
         if current == goal:
             return reconstruct_path(came_from, current)  # Reconstruit le chemin complet si le but est atteint
 
         # Explore les voisins du noeud courant
-        for neighbor in get_neighbors(current, grid):
-            tentative_g_score = g_score[current] + 1  # Coût du chemin de start à neighbor par current
+        for neighbor in get_neighbors(current, grid, costs):
+            tentative_g_score = g_score[current] + 1 + costs[neighbor[0]][neighbor[1]] / CLEARANCE_COST_SCALE  # Coût du chemin de start à neighbor par current
 
             # Si le chemin vers neighbor est meilleur que tout chemin précédent, enregistre ce nouveau chemin
             if tentative_g_score < g_score.get(neighbor, float('inf')):
@@ -104,9 +119,8 @@ def a_star_search(start, goal, grid):
                 g_score[neighbor] = tentative_g_score  # Met à jour le coût du chemin de start à neighbor
                 f_score[neighbor] = tentative_g_score + manhattan_distance(neighbor, goal)  # Estime le coût total de start à goal
                 
-                # Ajoute le voisin à l'ensemble ouvert s'il n'est pas déjà dedans
-                if neighbor not in [i[1] for i in open_set]:
-                    heapq.heappush(open_set, (f_score[neighbor], neighbor))
+                # Ajoute le voisin à l'ensemble ouvert, même s'il y est déjà : avec des coûts inégaux son score a pu baisser (l'ancienne entrée sera ignorée)
+                heapq.heappush(open_set, (f_score[neighbor], neighbor))
 
     return []  # Retourne une liste vide si aucun chemin n'est trouvé
 
@@ -120,18 +134,19 @@ def manhattan_distance(a, b):
     """
     return abs(a[0] - b[0]) + abs(a[1] - b[1])
 
-def get_neighbors(node, grid):
+def get_neighbors(node, grid, costs):
     """
     @brief Retourne les voisins d'un noeud dans la grille.
     @param node: tuple - Le noeud dont les voisins sont recherchés.
     @param grid: np.array - La grille.
+    @param costs: np.array - Le coût de passage de chaque case : LETHAL_COST interdit la case, sauf la destination.
     @return: list - Liste des voisins.
     """
     directions = [(0, 1), (1, 0), (-1, 0), (0, -1)] 
     neighbors = []
     for dx, dy in directions:
         x, y = node[0] + dx, node[1] + dy
-        if 0 <= x < len(grid) and 0 <= y < len(grid[0]) and grid[x][y] in [PASSAGE, DESTINATION]:
+        if 0 <= x < len(grid) and 0 <= y < len(grid[0]) and (grid[x][y] == DESTINATION or (grid[x][y] == PASSAGE and costs[x][y] < LETHAL_COST)):
             neighbors.append((x, y))
     return neighbors
 
@@ -170,20 +185,36 @@ if __name__ == "__main__":
     Traite l'entrée de la matrice et produit une trajectoire.
     """
     if len(sys.argv) >= 2:
-        matrix_str = sys.argv[1]
-        
+        # "-" : la matrice puis les coûts, une ligne chacun, sont lus sur l'entrée standard (un argument est limité à 128 Kio)
+        if sys.argv[1] == "-":
+            lines = sys.stdin.read().splitlines()
+            matrix_str = lines[0] if lines else ""
+            costs_str = lines[1] if len(lines) >= 2 and lines[1] else None
+        else:
+            matrix_str = sys.argv[1]
+            costs_str = sys.argv[3] if len(sys.argv) >= 4 else None
+
         if matrix_str.startswith('"') and matrix_str.endswith('"'):
             matrix_str = matrix_str[1:-1]
 
         try:
-            matrix_list = eval(matrix_str)
-        except:
+            matrix = np.array(json.loads(matrix_str), dtype=int)
+        except ValueError:
             print("Invalid matrix format. Please provide a valid matrix as an argument.")
             sys.exit(1)
 
-        matrix = np.array(matrix_list)
+        # Coûts de passage facultatifs, dans le même format que la matrice
+        costs = None
+        if costs_str is not None:
+            try:
+                costs = np.array(json.loads(costs_str), dtype=int)
+            except ValueError:
+                costs = None
+            if costs is None or costs.shape != matrix.shape:
+                print("Invalid costs format. Please provide a cost matrix of the size of the matrix.")
+                sys.exit(1)
 
-        resulting_matrix, commands, size = make_trajectory(matrix)
+        resulting_matrix, commands, size = make_trajectory(matrix, costs)
 
         matrix_str = formated_matrice(resulting_matrix)
         commands_str = format_commands(commands)
@@ -192,4 +223,4 @@ if __name__ == "__main__":
 
         print(result_str)
     else:
-        print("Usage: python3 trajectory.py <matrix>")
+        print("Usage: python3 trajectory.py <matrix> [orientation] [costs], or python3 trajectory.py - < matrix and costs lines")
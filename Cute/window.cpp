@@ -7,6 +7,8 @@
 
 #include "client_tcp/dispatcher.h"
 #include "client_tcp/postman.h"
+#include "client_tcp/ingestion.h"
+#include "client_tcp/mission.h"
 
 #include <unistd.h>
 
@@ -87,8 +89,6 @@ protected:
 // Constructeur de la classe Window
 Window::Window(QWidget *parent)
     : QWidget(parent), myMap(Map::getInstance()) {
-    matrix = myMap.get_map();                           // Récupère la matrice du singleton Map
-
     connect(&myMap, &Map::map_updated, this, &Window::display_map);     // A chaque fois que la méthode map_updated sera appelée dans la classe map : la méthode display_map sera appelée
     connect(&myMap, &Map::show_popup, this, &Window::display_popup);    // " "
     connect(&myMap, &Map::map_updated_after_destination_selection, this, &Window::call_make_trajectory);   // " "
@@ -171,7 +171,7 @@ void Window::init_map()
     connect(view, &CustomGraphicsView::canvasClicked, &myMap, &Map::set_destination_and_robot_position);    // A chaque fois que l'utilisateur clique sur la carte, appelle la méthode set_destination_and_robot_position de la classe Map
 
 
-    view->setFixedSize(myMap.getCols() * pixels_on_screen_per_matrix_cell, myMap.getRows() * pixels_on_screen_per_matrix_cell); // Définit la taille du cadre de la carte en fonction du nombre de lignes et de colonnes de la matrice, afin que celle-ci ne soit pas disprorpotionnée par rapport au reste de l'écran
+    fit_map_frame(myMap.get_bounds()); // Définit la taille du cadre de la carte en fonction du nombre de lignes et de colonnes de la matrice, afin que celle-ci ne soit pas disprorpotionnée par rapport au reste de l'écran
     view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);     // Supprime la barre de défilement horizontale du cadre de la carte
     view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);       // Supprime la barre de défilement verticale du cadre de la carte
 
@@ -181,24 +181,78 @@ void Window::init_map()
 // Méthode permettant d'initialiser la map
 void Window::display_map()
 {
-    // Définition des couleurs pour chaque valeur de la matrice (0 : noir, 1 : gris, ...)
-    static const QColor colors[6] = {Qt::black, Qt::gray, Qt::white, Qt::red, QColorConstants::Svg::orange, Qt::blue};
+    // Récupère la boîte des cases connues du singleton Map (elle grandit pendant l'exploration, y compris vers les coordonnées négatives)
+    GridBounds bounds = myMap.get_bounds();
+
+    // Pendant le choix de la destination, les cases que le robot ne peut pas atteindre sont grisées : tout est repeint quand le grisage, les composantes ou le robot changent
+    bool greying = myMap.is_selecting_destination();
+    quint32 connectivity = myMap.get_connectivity_version();
+    QPoint robot(myMap.get_robot_position_x(), myMap.get_robot_position_y());
+    bool same_greying = (greying == displayed_greying) && (!greying || (connectivity == displayed_connectivity && robot == displayed_robot));
+    displayed_greying = greying;
+    displayed_connectivity = connectivity;
+    displayed_robot = robot;
+
+    // Même boîte et changements encore dans le journal : seules les cases qui ont changé sont repeintes
+    QVector<Map::Change> changes;
+    if (bounds == displayed_bounds && same_greying && myMap.changes_since(displayed_version, changes)) {
+        for (const Map::Change &change : changes) {
+            if (bounds.contains(change.y, change.x)) {
+                paint_cell(displayed_cells.at(change.y - bounds.row, change.x - bounds.col), change.new_value, !greying || myMap.is_reachable_from_robot(change.y, change.x));
+            }
+        }
+        displayed_version = myMap.get_version();
+        return;
+    }
+
+    // Sinon la carte est redessinée entièrement
+    fit_map_frame(bounds);
+    Grid<uint8_t> matrix(bounds.rows, bounds.cols);
+    myMap.compose(matrix.view(), bounds.row, bounds.col);
+    displayed_version = myMap.get_version();
 
     // Efface les éléments précédents de la scène si nécessaire
     scene->clear();
-
-    // Redessine la carte
-    for (int i = 0; i < myMap.getRows(); ++i) {
-        for (int j = 0; j < myMap.getCols(); ++j) {
-            if (matrix[i][j] >= 0 && matrix[i][j] < myMap.get_number_of_possible_values_for_a_matrix_cell()) {
-                scene->addRect(j * pixels_on_screen_per_matrix_cell, i * pixels_on_screen_per_matrix_cell, pixels_on_screen_per_matrix_cell, pixels_on_screen_per_matrix_cell, QPen(Qt::NoPen), colors[this->matrix[i][j]]);    // Ajoute un rectangle sur la carte pour chaque cas de la matrice
-            } else {
-                // Gestion de l'erreur pour les valeurs de this->map incorrectes
-            }
+    displayed_cells = Grid<QGraphicsRectItem *>(bounds.rows, bounds.cols, nullptr);
+
+    // Redessine la carte : un rectangle par case, gardé pour être repeint quand la case change
+    for (int i = 0; i < matrix.rows(); ++i) {
+        const uint8_t *row = matrix.view().row(i);
+        for (int j = 0; j < matrix.cols(); ++j) {
+            // La scène est en coordonnées de la carte (x pixels par case) : un clic donne directement la case
+            displayed_cells.at(i, j) = scene->addRect((bounds.col + j) * pixels_on_screen_per_matrix_cell, (bounds.row + i) * pixels_on_screen_per_matrix_cell, pixels_on_screen_per_matrix_cell, pixels_on_screen_per_matrix_cell, QPen(Qt::NoPen));
+            paint_cell(displayed_cells.at(i, j), row[j], !greying || myMap.is_reachable_from_robot(bounds.row + i, bounds.col + j));
         }
     }
 }
 
+// Méthode donnant au rectangle d'une case la couleur de sa valeur, plus sombre pour une zone cartographiée que le robot ne peut pas atteindre
+void Window::paint_cell(QGraphicsRectItem *cell, uint8_t value, bool reachable)
+{
+    // Définition des couleurs pour chaque valeur de la matrice (0 : noir, 1 : gris, ...)
+    static const QColor colors[6] = {Qt::black, Qt::gray, Qt::white, Qt::red, QColorConstants::Svg::orange, Qt::blue};
+
+    if (value == 1 && !reachable) {      // Zone cartographiée hors d'atteinte du robot
+        cell->setBrush(Qt::darkGray);
+    } else if (value < myMap.get_number_of_possible_values_for_a_matrix_cell()) {
+        cell->setBrush(colors[value]);
+    } else {
+        // Gestion de l'erreur pour les valeurs de this->map incorrectes
+        cell->setBrush(Qt::NoBrush);
+    }
+}
+
+// Méthode calculant la taille d'une case pour que la boîte de la carte tienne dans le cadre, puis retaillant le cadre et la scène
+void Window::fit_map_frame(const GridBounds &bounds)
+{
+    int longest_side = qMax(1, qMax(bounds.rows, bounds.cols));
+    pixels_on_screen_per_matrix_cell = qBound(1, map_frame_size / longest_side, max_pixels_on_screen_per_matrix_cell);
+    view->set_pixels_on_screen_per_matrix_cell(pixels_on_screen_per_matrix_cell);     // Pour que les clics sur la carte tombent sur la bonne case
+    view->setFixedSize(bounds.cols * pixels_on_screen_per_matrix_cell, bounds.rows * pixels_on_screen_per_matrix_cell);
+    scene->setSceneRect(bounds.col * pixels_on_screen_per_matrix_cell, bounds.row * pixels_on_screen_per_matrix_cell, bounds.cols * pixels_on_screen_per_matrix_cell, bounds.rows * pixels_on_screen_per_matrix_cell);
+    displayed_bounds = bounds;
+}
+
 // Créer une fonction affichant une popup dont le texte dépend de l'ID passer en paramètre de la fonction
 void Window::display_popup(int id_popup)
 {
@@ -487,23 +541,23 @@ void Window::add_components_to_screen()
 
 // Méthode permettant de convertir une matrice en QString
 // Cette méthode permet de passer la matrice au code Python
-// Paramètres : matrice d'entiers, nombre de lignes de la matrice
-QString Window::convertMatrixToString(int (*matrix)[20], int rows) {
+// Paramètre : matrice d'entiers (ses dimensions sont prises dans la vue)
+QString Window::convertMatrixToString(const GridView<const uint8_t> &matrix) {
     QString string;
     QTextStream stream(&string);
 
     stream << "["; // Début de la matrice
 
-    for (int i = 0; i < rows; ++i) {
+    for (int i = 0; i < matrix.rows(); ++i) {
         stream << "["; // Début d'une ligne
 
-        for (int j = 0; j < 20; ++j) {
-            stream << matrix[i][j];
-            if (j < 19) stream << ","; // Séparateur pour les éléments
+        for (int j = 0; j < matrix.cols(); ++j) {
+            stream << static_cast<int>(matrix.at(i, j));    // Une case est un octet : écrite comme un nombre, pas comme un caractère
+            if (j < matrix.cols() - 1) stream << ","; // Séparateur pour les éléments
         }
 
         stream << "]"; // Fin d'une ligne
-        if (i < rows - 1) stream << ","; // Séparateur pour les lignes
+        if (i < matrix.rows() - 1) stream << ","; // Séparateur pour les lignes
     }
 
     stream << "]"; // Fin de la matrice
@@ -538,22 +592,27 @@ QVector<Command> Window::convertStringToCommands(const QString &str) {
 
 
 // Fonction permettant d'éxécuter un code Python et de récupérer son résultat (dans le premier "connect")
-// Tous les paramètres sont à mettre entre "quillemets". python_file_name : nom du fichier python à éxécuter (ajouter .py à la fin), argument 1 et 2 : les arguments à passer au code python
-void Window::run_python_code(QString python_file_name, QString argument_1, QString argument_2){
+// Tous les paramètres sont à mettre entre "quillemets". python_file_name : nom du fichier python à éxécuter (ajouter .py à la fin), argument : l'argument à passer au code python
+// input : les données écrites sur l'entrée standard du code python (une matrice en argument dépasserait vite les 128 Kio qu'accepte Linux pour un argument)
+void Window::run_python_code(QString python_file_name, QString argument, const QByteArray &input){
     // Python
     process = new QProcess(this);       // Crée un nouveau processus qui exécutera le code Python
 
     if (python_file_name == "trajectory.py") {      // Si le code python à éxécuter est le code de la trajectoire optimisée
 
         // Gestion du résultat du code Python
-        connect(process, &QProcess::readyReadStandardOutput, this, [this]() {       // Quand le code Python a fini de s'éxécuter, exécute le code suivant :
-            QString output = process->readAllStandardOutput();                      // Récupère le résultat du code Python dans la variable "output"
+        connect(process, &QProcess::finished, this, [this](int exit_code, QProcess::ExitStatus) {      // Quand le code Python a fini de s'éxécuter, exécute le code suivant :
+            QString output = process->readAllStandardOutput();                      // Récupère tout le résultat du code Python dans la variable "output" : une grande matrice arrive en plusieurs morceaux
 
             // La variable "trajectory_result_python_string" est de la forme : "matrice|moves_list_commands|moves_size_of_list_commands"
             // Il faut donc récupérer chacun de ces 3 éléments dans une variable :
             QString trajectory_result_cpp_string = output.trimmed();                // Supprime les espaces avant et après la string
 
             QStringList trajectory_result_cpp_qstringlist = trajectory_result_cpp_string.split("|", Qt::SkipEmptyParts);    // Divise le résultat du code Python (trajectory_result_python_string) en 3 parties
+            if (exit_code != 0 || trajectory_result_cpp_qstringlist.size() < 3) {      // Erreur du code Python (entrée invalide) : aucune trajectoire
+                qDebug() << "Trajectoire impossible :" << trajectory_result_cpp_string;
+                return;
+            }
 
             // Stocke chacun des 3 éléments dans une variable
             QString waypoints_string = trajectory_result_cpp_qstringlist[0];            // Les waypoints que doit emprunter le robot pour aller au point de destiantion
@@ -575,7 +634,9 @@ void Window::run_python_code(QString python_file_name, QString argument_1, QStri
     });
 
     // Lance le processus qui exécute le code Python
-    process->start("python", QStringList() << python_file_name << argument_1 << argument_2);
+    process->start("python", QStringList() << python_file_name << "-" << argument);
+    process->write(input);
+    process->closeWriteChannel();       // Fin de l'entrée : le code Python a tout lu
 }
 
 // Méthode permettant de lancer le processus de trajectoire optimisée
@@ -583,6 +644,7 @@ void Window::start_trajectory()
 {
     // Rend la carte cliquable pour pouvoir sélectionner le point de départ et de destination du robot en cliquant sur la carte
     myMap.enable_map_click(true);
+    display_map();      // Grise les zones que le robot ne peut pas atteindre
 
     // Affiche la pop-up invitant à sélectionner le point de destination du robot sur la carte
     display_popup(1);
@@ -591,44 +653,30 @@ void Window::start_trajectory()
 //  Méthode appelée une fois que l'utilisateur à sélectionner un point de destination sur la carte
 // Cette méthode est appelée grâce à la connection avec le signal "map_updated_after_destination_selection" de la classe Map
 void Window::call_make_trajectory() {
-    int (*matrix)[20] = myMap.get_map();                                    // Obtention de la matrice de la carte
-    QString matrixString = convertMatrixToString(matrix, myMap.getRows());  // Conversion de la matrice en QString pour pouvoir la passer au code Python
-    run_python_code("trajectory.py", matrixString, "5");                    // Exécution du code Python de trajectoire optimisée
+    Map::Snapshot snapshot = myMap.snapshot();                              // Une seule version de la carte pour la matrice et les coûts, même si la télémétrie arrive entre les deux
+    GridBounds bounds = snapshot.get_bounds();                              // Obtention de la matrice de la carte : la boîte des cases connues
+    Grid<uint8_t> matrix(bounds.rows, bounds.cols);
+    snapshot.compose(matrix.view(), bounds.row, bounds.col);                // Toutes les couches : le code Python lit le robot et sa destination dans la matrice
+    QString matrixString = convertMatrixToString(matrix.view());            // Conversion de la matrice en QString pour pouvoir la passer au code Python
+
+    // Coût de passage de chaque case selon sa distance aux obstacles : le robot ne longe plus les murs
+    Grid<uint8_t> costs(bounds.rows, bounds.cols);
+    for (int i = 0; i < bounds.rows; ++i) {
+        for (int j = 0; j < bounds.cols; ++j) {
+            costs.at(i, j) = snapshot.get_clearance_cost(bounds.row + i, bounds.col + j);
+        }
+    }
+    QByteArray input = (matrixString + "\n" + convertMatrixToString(costs.view()) + "\n").toUtf8();    // La matrice puis les coûts, une ligne chacun, sur l'entrée standard du code Python
+    run_python_code("trajectory.py", "5", input);     // Exécution du code Python de trajectoire optimisée
 }
 
 // Méthode exécutée lorsque le bouton "Cartographie" est cliqué
-// Comme la Cartographie n'a pas été implémentée, cette méthode génère une carte contenant des obstacles pour simuler une carte cartographiée
+// Lance la cartographie de Carto : la mission envoie les déplacements et la carte se remplit avec la télémétrie reçue
 void Window::click_on_cartography_button()
 {
-    // Obtention de l'instance singleton de Map
-    Map& myMap = Map::getInstance();
-
-    // La carte générée contenant des obstacles pour simuler une carte cartographiée
-    // Les 1 représentent les zones accessibles par le robot
-    // Les 0 représentent les zones obstacles
-    int matrix2[20][20] = {
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 1, 0, 0, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 1, 0, 1, 0, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-    };
-    myMap.update_entire_matrix(matrix2);    // Met à jour la matrice de la carte avec la carte générée ci-dessus
+    if (MISSION_start() == -1) {
+        qDebug() << "Cartographie impossible : Carto non connecté ou cartographie déjà en cours.";
+    }
 }
 
 // Méthode exécutée lorsque le bouton "Trajectoire" est cliqué
@@ -647,15 +695,17 @@ void Window::click_on_reset_button()
 // Méthode exécutée lorsque le bouton "STOP" est cliqué
 void Window::click_on_stop_button()
 {
+    MISSION_stop();             // Plus aucun déplacement de cartographie n'est envoyé
     PROXYPILOT_stop_robot();    // Stop le robot
 
     //QApplication::quit();       // Quitte complètement l'application, ou utiliser this->close(); pour fermer la fenêtre = même effet ici
 
-    DISPATCHER_disconnect();    // Déconnecte le dispatcher
-    POSTMAN_disconnect();       // Déconnecte le postman
     DISPATCHER_stop();          // Stop le dispatcher
+    POSTMAN_disconnect();       // Déconnecte le postman (le STOP part avant)
     POSTMAN_stop();             // Stop le postman
+    DISPATCHER_disconnect();    // Déconnecte le dispatcher, le thread réseau est arrêté
     DISPATCHER_destroy();       // Détruit le dispatcher
+    INGESTION_destroy();        // Détruit l'ingestion de la télémétrie
     POSTMAN_destroy();          // Détruit le postman
 }
 
@@ -13,6 +13,7 @@ class QPushButton;
 class QHBoxLayout;
 class QLabel;
 class QGraphicsScene;
+class QGraphicsRectItem;
 class QProcess;
 
 class Map;
@@ -41,11 +42,11 @@ private slots:  // Ajoutez cette section pour déclarer des slots
     void init_image();
     void init_buttons();
     void add_components_to_screen();
-    void run_python_code(QString python_file_name, QString argument_1, QString argument_2);
+    void run_python_code(QString python_file_name, QString argument, const QByteArray &input);
 
     void showSplashScreen();
 
-    QString convertMatrixToString(int matrix[20][20], int rows);
+    QString convertMatrixToString(const GridView<const uint8_t> &matrix);
 
     void call_make_trajectory();
 
@@ -65,12 +66,20 @@ private:
     QProcess *process;
 
     CustomGraphicsView *view;
-    const int pixels_on_screen_per_matrix_cell = 30; // ou 6 pour une matrice 100x100. Nombre de pixels de l'écran pour afficher une case de la matrice
+    const int max_pixels_on_screen_per_matrix_cell = 30; // Taille d'une case pour les petites cartes (20x20)
+    const int map_frame_size = 600; // Nombre de pixels de l'écran pour le plus grand côté de la carte
+    int pixels_on_screen_per_matrix_cell = 30; // Nombre de pixels de l'écran pour afficher une case de la matrice, recalculé quand les dimensions de la carte changent
+    GridBounds displayed_bounds; // Boîte de la carte affichée, pour retailler le cadre quand elle change
+    Grid<QGraphicsRectItem *> displayed_cells; // Rectangle de chaque case de la boîte affichée (appartient à la scène)
+    quint32 displayed_version = 0; // Version de la carte affichée : les changements suivants sont lus dans le journal de Map
+    bool displayed_greying = false; // Cases inaccessibles grisées à l'écran...
+    quint32 displayed_connectivity = 0; // ...pour ces composantes connexes...
+    QPoint displayed_robot;         // ...et cette position du robot
 
     int m_counter;          // Compteur permettant de fermer la fenêtre au bout de 3 fois
 
-    // Map map;
-    int (*matrix)[20]; // Pointeur vers la matrice de Map
+    void fit_map_frame(const GridBounds &bounds);
+    void paint_cell(QGraphicsRectItem *cell, uint8_t value, bool reachable);
 
     Map& myMap; // Référence vers l'instance de Map
 };
@@ -0,0 +1,452 @@
+/**
+ * \file  protocol_bench.c
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Round trips, fuzzing and microbenchmark of the codecs of protocol.h.
+ *
+ * Builds as C99 (the Carto side) and as C++ (the Cute side) : make -C Protocol check runs both
+ * and compares their digests, so an endpoint encoding a frame differently shows up at once.
+ *
+ * Usage : protocol_bench [-s seed] [-r rounds] [-b iterations]
+ *  - seed : seed of the generator (deterministic : same seed, same frames, same digest).
+ *  - rounds : round trips and fuzzed frames per message type.
+ *  - iterations : encodes and decodes per message type timed by the benchmark, 0 to skip it.
+ *
+ * \see protocol.h
+ * \see protocol.schema
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#define _POSIX_C_SOURCE 199309L
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../protocol.h"
+/* ----------------------  PRIVATE CONFIGURATIONS ----------------------------*/
+/**
+ * \def DEFAULT_SEED
+ * Seed used without -s.
+ */
+#define DEFAULT_SEED 2024u
+/**
+ * \def DEFAULT_ROUNDS
+ * Round trips and fuzzed frames per message type used without -r.
+ */
+#define DEFAULT_ROUNDS 10000
+/**
+ * \def DEFAULT_ITERATIONS
+ * Benchmark iterations per message type used without -b.
+ */
+#define DEFAULT_ITERATIONS 2000000
+/**
+ * \def SNAPSHOT_MAX_CELLS
+ * Biggest map of the snapshot round trips and of the fuzzed snapshots.
+ */
+#define SNAPSHOT_MAX_CELLS 65536
+/**
+ * \def FNV_OFFSET
+ * Offset basis of the FNV-1a digest.
+ */
+#define FNV_OFFSET 2166136261u
+/**
+ * \def FNV_PRIME
+ * Prime of the FNV-1a digest.
+ */
+#define FNV_PRIME 16777619u
+/* ----------------------  PRIVATE VARIABLES ---------------------------------*/
+/**
+ * \var static uint32_t random_state
+ * \brief State of the xorshift generator.
+ */
+static uint32_t random_state = DEFAULT_SEED;
+/**
+ * \var static uint32_t digest
+ * \brief FNV-1a of every frame encoded by the round trips.
+ */
+static uint32_t digest = FNV_OFFSET;
+/**
+ * \var static int failures
+ * \brief Amount of failed checks.
+ */
+static int failures = 0;
+/**
+ * \var static volatile uint32_t sink
+ * \brief Keeps the benchmarked results alive.
+ */
+static volatile uint32_t sink = 0;
+/* ----------------------  PRIVATE FUNCTIONS  --------------------------------*/
+/**
+ * \fn static uint32_t next_random(void)
+ * \brief xorshift32 : same sequence in C and in C++, whatever the libc.
+ * \author Thomas ROCHER
+ */
+static uint32_t next_random(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+/**
+ * \fn static void hash_bytes(const uint8_t * bytes, int size)
+ * \brief Adds bytes to the digest.
+ * \author Thomas ROCHER
+ */
+static void hash_bytes(const uint8_t * bytes, int size) {
+    for(int i = 0; i < size; i++) {
+        digest = (digest ^ bytes[i]) * FNV_PRIME;
+    }
+}
+/**
+ * \fn static void check(int condition, const char * what, const char * name)
+ * \brief Counts and prints a failed check.
+ * \author Thomas ROCHER
+ */
+static void check(int condition, const char * what, const char * name) {
+    if(!condition) {
+        failures++;
+        if(failures <= 10) {
+            fprintf(stderr, "FAIL %s : %s\n", name, what);
+        }
+    }
+}
+/**
+ * \fn static int64_t random_field(uint8_t kind)
+ * \brief Random value covering the whole range of a field.
+ * \author Thomas ROCHER
+ */
+static int64_t random_field(uint8_t kind) {
+    uint32_t value = next_random();
+    switch(kind) {
+        case PROTOCOL_FIELD_U8 : return value & 0xFF;
+        case PROTOCOL_FIELD_U16 : return value & 0xFFFF;
+        case PROTOCOL_FIELD_U32 : return value;
+        case PROTOCOL_FIELD_I32 : return (int32_t)value;
+        case PROTOCOL_FIELD_COMMAND : return value % (STOP + 1);
+        default : return value % (EAST + 1);
+    }
+}
+/**
+ * \fn static double elapsed_ns(struct timespec start)
+ * \brief Nanoseconds since start.
+ * \author Thomas ROCHER
+ */
+static double elapsed_ns(struct timespec start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start.tv_sec) * 1e9 + (now.tv_nsec - start.tv_nsec);
+}
+/**
+ * \fn static void round_trip_fixed(const Protocol_Message_Info * info, int rounds)
+ * \brief Encodes random messages, checks the head, decodes them, and re-encodes them byte for byte.
+ * Every other frame is sequenced, as with PROTOCOL_CAP_SEQUENCE.
+ * \author Thomas ROCHER
+ */
+static void round_trip_fixed(const Protocol_Message_Info * info, int rounds) {
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    uint8_t again[PROTOCOL_MAX_FRAME_SIZE];
+    int64_t values[PROTOCOL_MAX_FIELDS];
+    int64_t decoded[PROTOCOL_MAX_FIELDS];
+    for(int round = 0; round < rounds; round++) {
+        for(int i = 0; i < info->field_count; i++) {
+            values[i] = random_field(info->fields[i]);
+        }
+        int size = PROTOCOL_write_message(frame, info->type, values);
+        check(size == PROTOCOL_FRAME_SIZE(info->payload_size), "frame size", info->name);
+        uint16_t seq = (uint16_t)next_random();
+        uint16_t ack = (uint16_t)next_random();
+        if(round & 1) {
+            size = PROTOCOL_add_sequence(frame, seq, ack);
+        }
+        hash_bytes(frame, size);
+        Communication_Protocol_Head head = PROTOCOL_decode_head(frame);
+        check(head.msg_type == info->type, "type", info->name);
+        check(head.msg_size + PROTOCOL_SIZE_FIELD == size, "msg_size", info->name);
+        check(PROTOCOL_payload_size(head) == info->payload_size, "payload size", info->name);
+        check(head.sequenced == (round & 1) && (!head.sequenced || (head.seq == seq && head.ack == ack)), "sequence", info->name);
+        const uint8_t * payload = frame + PROTOCOL_payload_offset(head);
+        check(PROTOCOL_read_message(payload, PROTOCOL_payload_size(head), info->type, decoded) == info->field_count, "read", info->name);
+        check(memcmp(values, decoded, sizeof(int64_t) * info->field_count) == 0, "values", info->name);
+        int again_size = PROTOCOL_write_message(again, info->type, decoded);
+        check(again_size == PROTOCOL_FRAME_SIZE(info->payload_size)
+              && memcmp(again + PROTOCOL_HEAD_SIZE, payload, info->payload_size) == 0, "re-encode", info->name);
+        check(PROTOCOL_read_message(payload, info->payload_size - 1, info->type, decoded) == -1, "short payload", info->name);
+    }
+}
+/**
+ * \fn static void round_trip_hand_api(int rounds)
+ * \brief Checks the encode and decode functions used by Carto and Cute against the generated codecs.
+ * \author Thomas ROCHER
+ */
+static void round_trip_hand_api(int rounds) {
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    for(int round = 0; round < rounds; round++) {
+        int32_t coord_x = (int32_t)next_random();
+        int32_t coord_y = (int32_t)next_random();
+        Direction dir = (Direction)(next_random() % (EAST + 1));
+        for(int version = PROTOCOL_VERSION_1; version <= PROTOCOL_VERSION_2; version++) {
+            int wide = (version >= PROTOCOL_VERSION_2);
+            int32_t expected_x = wide ? coord_x : (uint8_t)coord_x;
+            int32_t expected_y = wide ? coord_y : (uint8_t)coord_y;
+            PROTOCOL_encode_robot_position(frame, version, coord_x, coord_y, dir);
+            Communication_Protocol_Head head = PROTOCOL_decode_head(frame);
+            Protocol_Pose pose = PROTOCOL_decode_pose(head.msg_type, frame + PROTOCOL_HEAD_SIZE);
+            check(pose.coord_x == expected_x && pose.coord_y == expected_y && pose.dir == dir, "pose", "SEND_ROBOT_POSITION");
+            PROTOCOL_encode_set_robot_position(frame, version, coord_x, coord_y, dir);
+            head = PROTOCOL_decode_head(frame);
+            pose = PROTOCOL_decode_pose(head.msg_type, frame + PROTOCOL_HEAD_SIZE);
+            check(pose.coord_x == expected_x && pose.coord_y == expected_y && pose.dir == (wide ? dir : SOUTH), "pose", "SET_ROBOT_POSITION");
+            PROTOCOL_encode_obstacle_position(frame, version, coord_x, coord_y);
+            head = PROTOCOL_decode_head(frame);
+            pose = PROTOCOL_decode_pose(head.msg_type, frame + PROTOCOL_HEAD_SIZE);
+            check(pose.coord_x == expected_x && pose.coord_y == expected_y && pose.dir == SOUTH, "cell", "SET_OBSTACLE_POSITION");
+        }
+        uint32_t capabilities = next_random();
+        PROTOCOL_encode_hello(frame, HELLO_ACK, (uint8_t)round, capabilities);
+        Protocol_Hello hello = PROTOCOL_decode_hello(frame + PROTOCOL_HEAD_SIZE);
+        check(PROTOCOL_decode_head(frame).msg_type == HELLO_ACK && hello.version == (uint8_t)round && hello.capabilities == capabilities, "hello", "HELLO_ACK");
+    }
+}
+/**
+ * \fn static void round_trip_map_delta(int rounds)
+ * \brief Encodes and decodes random MAP_DELTA batches, from rays (small steps) to far away cells.
+ * \author Thomas ROCHER
+ */
+static void round_trip_map_delta(int rounds) {
+    uint8_t frame[PROTOCOL_MAX_DELTA_FRAME_SIZE];
+    Protocol_Cell cells[PROTOCOL_MAX_DELTA_CELLS];
+    Protocol_Cell decoded[PROTOCOL_MAX_DELTA_CELLS];
+    for(int round = 0; round < rounds; round++) {
+        int count = (int)(next_random() % (PROTOCOL_MAX_DELTA_CELLS + 1));
+        int32_t coord_x = (int32_t)next_random();
+        int32_t coord_y = (int32_t)next_random();
+        for(int i = 0; i < count; i++) {
+            uint32_t step = next_random();
+            coord_x = (step & 1) ? (int32_t)next_random() : coord_x + (int32_t)(step >> 28) - 8;
+            coord_y = (step & 2) ? (int32_t)next_random() : coord_y + (int32_t)((step >> 24) & 0xF) - 8;
+            cells[i].coord_x = coord_x;
+            cells[i].coord_y = coord_y;
+            cells[i].value = (uint8_t)(step % (PROTOCOL_CELL_OBSTACLE + 1));
+        }
+        uint32_t map_version = next_random();
+        int size = PROTOCOL_encode_map_delta(frame, map_version, cells, count);
+        check(size <= PROTOCOL_FRAME_SIZE(PROTOCOL_MAX_DELTA_PAYLOAD), "frame size", "MAP_DELTA");
+        hash_bytes(frame, size);
+        Communication_Protocol_Head head = PROTOCOL_decode_head(frame);
+        uint32_t decoded_version = 0;
+        int decoded_count = PROTOCOL_decode_map_delta(frame + PROTOCOL_HEAD_SIZE, PROTOCOL_payload_size(head), &decoded_version, decoded, PROTOCOL_MAX_DELTA_CELLS);
+        check(head.msg_type == MAP_DELTA && decoded_count == count && decoded_version == map_version, "head", "MAP_DELTA");
+        for(int i = 0; i < count && i < decoded_count; i++) {
+            check(decoded[i].coord_x == cells[i].coord_x && decoded[i].coord_y == cells[i].coord_y && decoded[i].value == cells[i].value, "cell", "MAP_DELTA");
+        }
+    }
+}
+/**
+ * \fn static void round_trip_snapshot(int rounds)
+ * \brief Sends random maps (runs of random lengths) in MAP_SNAPSHOT chunks and rebuilds them.
+ * \author Thomas ROCHER
+ */
+static void round_trip_snapshot(int rounds) {
+    uint8_t * frame = (uint8_t *)malloc(PROTOCOL_MAX_SNAPSHOT_FRAME_SIZE);
+    uint8_t * cells = (uint8_t *)malloc(SNAPSHOT_MAX_CELLS);
+    uint8_t * rebuilt = (uint8_t *)malloc(SNAPSHOT_MAX_CELLS);
+    for(int round = 0; round < rounds; round++) {
+        Protocol_Snapshot_Head head = {next_random(), (int32_t)next_random(), (int32_t)next_random(),
+                                       (uint16_t)(1 + next_random() % 256), (uint16_t)(1 + next_random() % 256), 0, 0};
+        uint32_t total = (uint32_t)head.rows * head.cols;
+        uint32_t run_limit = 1 + next_random() % 64;
+        for(uint32_t cell = 0; cell < total;) {
+            uint32_t run = 1 + next_random() % run_limit;
+            uint8_t value = (uint8_t)(next_random() % (PROTOCOL_CELL_OBSTACLE + 1));
+            for(; run > 0 && cell < total; run--) {
+                cells[cell++] = value;
+            }
+        }
+        memset(rebuilt, 0xFF, total);
+        do {
+            int size = PROTOCOL_encode_snapshot_chunk(frame, &head, cells);
+            hash_bytes(frame, size);
+            Communication_Protocol_Head frame_head = PROTOCOL_decode_head(frame);
+            Protocol_Snapshot_Head decoded = PROTOCOL_decode_snapshot_head(frame + PROTOCOL_HEAD_SIZE);
+            check(frame_head.msg_type == MAP_SNAPSHOT && decoded.first_cell == head.first_cell && decoded.cell_count == head.cell_count
+                  && decoded.origin_x == head.origin_x && decoded.origin_y == head.origin_y, "head", "MAP_SNAPSHOT");
+            check(PROTOCOL_decode_snapshot_cells(frame + PROTOCOL_HEAD_SIZE, PROTOCOL_payload_size(frame_head), decoded, rebuilt) == 0, "cells", "MAP_SNAPSHOT");
+            head.first_cell += head.cell_count;
+        } while(head.first_cell < total && head.cell_count > 0);
+        check(memcmp(cells, rebuilt, total) == 0, "map", "MAP_SNAPSHOT");
+    }
+    free(rebuilt);
+    free(cells);
+    free(frame);
+}
+/**
+ * \fn static void fuzz(int rounds)
+ * \brief Gives random and truncated frames to every decoder : they must fail cleanly, never read out of the frame.
+ * Run under -fsanitize=address,undefined to catch the reads (make -C Protocol check).
+ * \author Thomas ROCHER
+ */
+static void fuzz(int rounds) {
+    uint8_t * cells = (uint8_t *)malloc(SNAPSHOT_MAX_CELLS);
+    Protocol_Cell decoded[PROTOCOL_MAX_DELTA_CELLS];
+    int64_t values[PROTOCOL_MAX_FIELDS];
+    for(int round = 0; round < rounds * PROTOCOL_MESSAGE_COUNT; round++) {
+        const Protocol_Message_Info * info = &PROTOCOL_MESSAGES[round % PROTOCOL_MESSAGE_COUNT];
+        int size = (int)(next_random() % 64);
+        uint8_t * payload = (uint8_t *)malloc(size ? size : 1);
+        for(int i = 0; i < size; i++) {
+            /* Small bytes make valid varints and short runs likely, so the decoders go deeper. */
+            payload[i] = (uint8_t)((next_random() & 3) ? next_random() % 4 : next_random());
+        }
+        if(info->payload_size >= 0) {
+            int read = PROTOCOL_read_message(payload, size, info->type, values);
+            check(read == (size >= info->payload_size ? info->field_count : -1), "fuzzed read", info->name);
+        }
+        else if(info->type == MAP_DELTA) {
+            uint32_t map_version = 0;
+            int count = PROTOCOL_decode_map_delta(payload, size, &map_version, decoded, PROTOCOL_MAX_DELTA_CELLS);
+            check(count >= -1 && count <= PROTOCOL_MAX_DELTA_CELLS, "fuzzed delta", info->name);
+        }
+        else if(info->type == MAP_SNAPSHOT && size >= PROTOCOL_SNAPSHOT_HEAD_SIZE) {
+            Protocol_Snapshot_Head head = PROTOCOL_decode_snapshot_head(payload);
+            if((uint32_t)head.rows * head.cols <= SNAPSHOT_MAX_CELLS) {
+                PROTOCOL_decode_snapshot_cells(payload, size, head, cells);
+            }
+        }
+        if(size >= PROTOCOL_HEAD_SIZE + PROTOCOL_SEQUENCE_SIZE) {
+            Communication_Protocol_Head head = PROTOCOL_decode_head(payload);
+            check((head.msg_type & PROTOCOL_SEQUENCE_FLAG) == 0 && PROTOCOL_payload_offset(head) <= PROTOCOL_HEAD_SIZE + PROTOCOL_SEQUENCE_SIZE, "fuzzed head", info->name);
+        }
+        free(payload);
+    }
+    free(cells);
+}
+/**
+ * \fn static void bench(int iterations)
+ * \brief Prints the ns per encode and per decode of every fixed size message type.
+ * \author Thomas ROCHER
+ */
+static void bench(int iterations) {
+    uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+    int64_t values[PROTOCOL_MAX_FIELDS];
+    printf("%-26s %12s %12s\n", "message", "encode ns", "decode ns");
+    for(int m = 0; m < PROTOCOL_MESSAGE_COUNT; m++) {
+        const Protocol_Message_Info * info = &PROTOCOL_MESSAGES[m];
+        if(info->payload_size < 0) {
+            continue;
+        }
+        for(int i = 0; i < info->field_count; i++) {
+            values[i] = random_field(info->fields[i]);
+        }
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for(int i = 0; i < iterations; i++) {
+            values[0] ^= i & 1;
+            sink += (uint32_t)PROTOCOL_write_message(frame, info->type, values) + frame[PROTOCOL_HEAD_SIZE];
+        }
+        double encode = elapsed_ns(start) / iterations;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for(int i = 0; i < iterations; i++) {
+            frame[PROTOCOL_HEAD_SIZE] ^= (uint8_t)(i & 1);
+            Communication_Protocol_Head head = PROTOCOL_decode_head(frame);
+            sink += (uint32_t)PROTOCOL_read_message(frame + PROTOCOL_payload_offset(head), PROTOCOL_payload_size(head), head.msg_type, values) + (uint32_t)values[0];
+        }
+        double decode = elapsed_ns(start) / iterations;
+        printf("%-26s %12.2f %12.2f\n", info->name, encode, decode);
+    }
+    Protocol_Cell cells[PROTOCOL_MAX_DELTA_CELLS];
+    Protocol_Cell decoded[PROTOCOL_MAX_DELTA_CELLS];
+    uint8_t delta[PROTOCOL_MAX_DELTA_FRAME_SIZE];
+    for(int i = 0; i < PROTOCOL_MAX_DELTA_CELLS; i++) {
+        cells[i].coord_x = 100 + i / 16;
+        cells[i].coord_y = -50 + i % 16;
+        cells[i].value = PROTOCOL_CELL_FREE;
+    }
+    int delta_iterations = iterations / PROTOCOL_MAX_DELTA_CELLS + 1;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i = 0; i < delta_iterations; i++) {
+        sink += (uint32_t)PROTOCOL_encode_map_delta(delta, (uint32_t)i, cells, PROTOCOL_MAX_DELTA_CELLS);
+    }
+    double encode = elapsed_ns(start) / ((double)delta_iterations * PROTOCOL_MAX_DELTA_CELLS);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i = 0; i < delta_iterations; i++) {
+        uint32_t map_version = 0;
+        Communication_Protocol_Head head = PROTOCOL_decode_head(delta);
+        sink += (uint32_t)PROTOCOL_decode_map_delta(delta + PROTOCOL_HEAD_SIZE, PROTOCOL_payload_size(head), &map_version, decoded, PROTOCOL_MAX_DELTA_CELLS);
+    }
+    double decode = elapsed_ns(start) / ((double)delta_iterations * PROTOCOL_MAX_DELTA_CELLS);
+    printf("%-26s %12.2f %12.2f\n", "MAP_DELTA (per cell)", encode, decode);
+}
+/* ----------------------  PUBLIC FUNCTIONS  ---------------------------------*/
+/**
+ * \fn int main(int argc, char * argv[])
+ * \brief Runs the round trips and the fuzzing, prints the digest, then the benchmark.
+ * \author Thomas ROCHER
+ *
+ * \return 0 when every check passed, 1 otherwise.
+ */
+int main(int argc, char * argv[]) {
+    uint32_t seed = DEFAULT_SEED;
+    int rounds = DEFAULT_ROUNDS;
+    int iterations = DEFAULT_ITERATIONS;
+    int option;
+    while((option = getopt(argc, argv, "s:r:b:")) != -1) {
+        switch(option) {
+            case 's' : seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'r' : rounds = atoi(optarg); break;
+            case 'b' : iterations = atoi(optarg); break;
+            default :
+                fprintf(stderr, "Usage : %s [-s seed] [-r rounds] [-b iterations]\n", argv[0]);
+                return 1;
+        }
+    }
+    random_state = seed ? seed : DEFAULT_SEED;
+    for(int m = 0; m < PROTOCOL_MESSAGE_COUNT; m++) {
+        check(PROTOCOL_message_info(PROTOCOL_MESSAGES[m].type) == &PROTOCOL_MESSAGES[m], "info", PROTOCOL_MESSAGES[m].name);
+        check((PROTOCOL_MESSAGES[m].type & PROTOCOL_SEQUENCE_FLAG) == 0, "sequence flag", PROTOCOL_MESSAGES[m].name);
+        if(PROTOCOL_MESSAGES[m].payload_size >= 0) {
+            round_trip_fixed(&PROTOCOL_MESSAGES[m], rounds);
+        }
+    }
+    round_trip_hand_api(rounds);
+    round_trip_map_delta(rounds / 10 + 1);
+    round_trip_snapshot(rounds / 100 + 1);
+    fuzz(rounds);
+    printf("digest %08x seed %u rounds %d\n", (unsigned int)digest, (unsigned int)seed, rounds);
+    printf("%s\n", failures ? "FAILED" : "OK");
+    if(failures) {
+        fprintf(stderr, "%d failed checks\n", failures);
+        return 1;
+    }
+    if(iterations > 0) {
+        bench(iterations);
+    }
+    return 0;
+}
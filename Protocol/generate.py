@@ -0,0 +1,335 @@
+#!/usr/bin/env python3
+#
+# Generates protocol_messages.h (types) and protocol_codecs.h (codecs) from protocol.schema.
+# Both are included by protocol.h, itself included by Carto (C99) and Cute (C++).
+#
+# Usage : generate.py [-o output_directory]
+#
+# @author Thomas ROCHER
+
+import argparse
+import os
+import shlex
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# kind : (C type, size on the wire, writer, reader)
+KINDS = {
+    'u8': ('uint8_t', 1, 'payload[{o}] = msg->{f};', 'payload[{o}]'),
+    'u16': ('uint16_t', 2, 'PROTOCOL_put_u16(payload + {o}, msg->{f});', 'PROTOCOL_get_u16(payload + {o})'),
+    'u32': ('uint32_t', 4, 'PROTOCOL_put_u32(payload + {o}, msg->{f});', 'PROTOCOL_get_u32(payload + {o})'),
+    'i32': ('int32_t', 4, 'PROTOCOL_put_i32(payload + {o}, msg->{f});', 'PROTOCOL_get_i32(payload + {o})'),
+    'Command': ('Command', 1, 'payload[{o}] = (uint8_t)msg->{f};', '(Command)(payload[{o}] & PROTOCOL_ENUM_MASK)'),
+    'Direction': ('Direction', 1, 'payload[{o}] = (uint8_t)msg->{f};', '(Direction)(payload[{o}] & PROTOCOL_ENUM_MASK)'),
+}
+FIELD_KINDS = {
+    'u8': 'PROTOCOL_FIELD_U8',
+    'u16': 'PROTOCOL_FIELD_U16',
+    'u32': 'PROTOCOL_FIELD_U32',
+    'i32': 'PROTOCOL_FIELD_I32',
+    'Command': 'PROTOCOL_FIELD_COMMAND',
+    'Direction': 'PROTOCOL_FIELD_DIRECTION',
+}
+
+LICENSE = """ * \\section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \\copyright PFE 2024
+ */"""
+
+
+class Message:
+    def __init__(self, name, type_value, fields, custom, description):
+        self.name = name
+        self.type_value = type_value
+        self.fields = fields            # [(field, kind)]
+        self.custom = custom
+        self.description = description
+
+    @property
+    def lower(self):
+        return self.name.lower()
+
+    @property
+    def struct(self):
+        return 'Protocol_Msg_' + '_'.join(part.capitalize() if not part.startswith('V') or not part[1:].isdigit() else part
+                                          for part in self.name.split('_'))
+
+    @property
+    def payload_size(self):
+        return sum(KINDS[kind][1] for _, kind in self.fields)
+
+
+def parse(path):
+    messages = []
+    with open(path) as schema:
+        for number, line in enumerate(schema, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            words = shlex.split(line)
+            if len(words) < 3:
+                sys.exit('%s:%d: NAME TYPE [FIELDS] "DESCRIPTION" expected' % (path, number))
+            name, type_value, description = words[0], int(words[1], 16), words[-1]
+            if type_value & 0xFF or type_value > 0xFFFF:
+                sys.exit('%s:%d: %s : the low byte of the type must be 0' % (path, number, name))
+            custom = words[2:-1] == ['custom']
+            fields = []
+            if not custom:
+                for word in words[2:-1]:
+                    field, _, kind = word.partition(':')
+                    if kind not in KINDS:
+                        sys.exit('%s:%d: %s : unknown kind "%s"' % (path, number, name, kind))
+                    fields.append((field, kind))
+            messages.append(Message(name, type_value, fields, custom, description))
+    names = [message.name for message in messages]
+    types = [message.type_value for message in messages]
+    if len(set(names)) != len(names) or len(set(types)) != len(types):
+        sys.exit('%s: duplicated message name or type' % path)
+    return messages
+
+
+def head(file_name, brief):
+    return """/**
+ * \\file  %s
+ * \\version  0.1
+ * \\author Thomas ROCHER
+ * \\date Oct 18, 2026
+ * \\brief %s
+ *
+ * Generated by generate.py from protocol.schema : do not edit, run make -C Protocol generate.
+ *
+ * \\see protocol.h
+ *
+%s
+""" % (file_name, brief, LICENSE)
+
+
+def plural(size):
+    return '%d byte%s' % (size, '' if size == 1 else 's')
+
+
+def enum_comment(message):
+    text = message.description
+    if message.fields:
+        text += ' Payload : ' + ', '.join('%s (%s)' % field for field in message.fields) + '.'
+    return '%s : %s' % (message.name, text)
+
+
+def messages_header(messages):
+    fixed = [message for message in messages if not message.custom]
+    max_fields = max(len(message.fields) for message in messages)
+    out = [head('protocol_messages.h', 'Message types of the protocol and their fields. Included by protocol.h.')]
+    out.append('#ifndef PROTOCOL_PROTOCOL_MESSAGES_H_')
+    out.append('#define PROTOCOL_PROTOCOL_MESSAGES_H_')
+    out.append('/* ----------------------  PUBLIC CONFIGURATIONS -----------------------------*/')
+    out.append('/**\n * \\def PROTOCOL_MESSAGE_COUNT\n * Amount of message types.\n */')
+    out.append('#define PROTOCOL_MESSAGE_COUNT %d' % len(messages))
+    out.append('/**\n * \\def PROTOCOL_MAX_FIELDS\n * Max amount of fields of a fixed size message.\n */')
+    out.append('#define PROTOCOL_MAX_FIELDS %d' % max_fields)
+    out.append('/**\n * \\def PROTOCOL_MAX_FIXED_PAYLOAD\n * Biggest payload of a fixed size message.\n */')
+    out.append('#define PROTOCOL_MAX_FIXED_PAYLOAD %d' % max(message.payload_size for message in fixed))
+    out.append('/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/')
+    out.append('''/**
+ * \\enum Message_Type
+ * \\brief Defines message types.
+ *
+ * Unscoped so that C uses SEND_MOVES_TRAJECTORY and C++ can keep writing Message_Type::SEND_MOVES_TRAJECTORY.
+ */
+typedef enum {''')
+    width = max(len(message.name) for message in messages) + len(' = 0x0000,')
+    for message in messages:
+        entry = '%s = 0x%04X,' % (message.name, message.type_value)
+        out.append('    %s/**< %s */' % (entry.ljust(width + 1), enum_comment(message)))
+    out.append('    %s/**< PROTOCOL_TYPE_LIMIT : not a message, gives the enum every 16-bit value so that an unknown type read from the wire stays defined in C++. */'
+               % 'PROTOCOL_TYPE_LIMIT = 0xFFFF'.ljust(width + 1))
+    out.append('} Message_Type;')
+    out.append('''/**
+ * \\enum Protocol_Field_Kind
+ * \\brief Encoding of a field on the wire.
+ */
+typedef enum {
+    PROTOCOL_FIELD_U8 = 0,      /**< PROTOCOL_FIELD_U8 : unsigned, 1 byte. */
+    PROTOCOL_FIELD_U16,         /**< PROTOCOL_FIELD_U16 : unsigned, 2 bytes. */
+    PROTOCOL_FIELD_U32,         /**< PROTOCOL_FIELD_U32 : unsigned, 4 bytes. */
+    PROTOCOL_FIELD_I32,         /**< PROTOCOL_FIELD_I32 : signed, 4 bytes. */
+    PROTOCOL_FIELD_COMMAND,     /**< PROTOCOL_FIELD_COMMAND : Command, 1 byte. */
+    PROTOCOL_FIELD_DIRECTION    /**< PROTOCOL_FIELD_DIRECTION : Direction, 1 byte. */
+} Protocol_Field_Kind;''')
+    out.append('/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/')
+    out.append('''/**
+ * \\struct Protocol_Message_Info protocol_messages.h "protocol_messages.h"
+ * \\brief Description of a message type, see PROTOCOL_MESSAGES.
+ */
+typedef struct {
+    Message_Type type;                          /**< Type of the message. */
+    const char * name;                          /**< Name of the type. */
+    int payload_size;                           /**< Size of the payload, -1 for a variable payload. */
+    int field_count;                            /**< Amount of fields (0 for a variable payload). */
+    uint8_t fields[PROTOCOL_MAX_FIELDS];        /**< Protocol_Field_Kind of each field. */
+} Protocol_Message_Info;''')
+    for message in fixed:
+        if not message.fields:
+            continue
+        out.append('/**\n * \\struct %s protocol_messages.h "protocol_messages.h"\n * \\brief Payload of %s.\n */'
+                   % (message.struct, message.name))
+        out.append('typedef struct {')
+        for field, kind in message.fields:
+            out.append('    %s %s;' % (KINDS[kind][0], field))
+        out.append('} %s;' % message.struct)
+    out.append('/* ----------------------  PUBLIC VARIABLES ----------------------------------*/')
+    out.append('''/**
+ * \\var PROTOCOL_MESSAGES
+ * \\brief Every message type, in the order of the schema.
+ */
+PROTOCOL_TABLE Protocol_Message_Info PROTOCOL_MESSAGES[PROTOCOL_MESSAGE_COUNT] = {''')
+    for message in messages:
+        kinds = [FIELD_KINDS[kind] for _, kind in message.fields] or ['0']
+        out.append('    {%s, "%s", %d, %d, {%s}},' % (message.name, message.name,
+                                                   -1 if message.custom else message.payload_size,
+                                                   len(message.fields), ', '.join(kinds)))
+    out.append('};')
+    out.append('')
+    out.append('#endif /* PROTOCOL_PROTOCOL_MESSAGES_H_ */')
+    return '\n'.join(out) + '\n'
+
+
+def codecs_header(messages):
+    out = [head('protocol_codecs.h', 'Encoders and decoders of the fixed size messages. Included by protocol.h.')]
+    out.append('#ifndef PROTOCOL_PROTOCOL_CODECS_H_')
+    out.append('#define PROTOCOL_PROTOCOL_CODECS_H_')
+    out.append('/* ----------------------  PUBLIC FUNCTIONS  ---------------------------------*/')
+    for message in messages:
+        if message.custom:
+            continue
+        size = message.payload_size
+        if not message.fields:
+            out.append('''/**
+ * \\fn PROTOCOL_API int PROTOCOL_write_%s(uint8_t * frame)
+ * \\brief %s frame.
+ *
+ * \\return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_%s(uint8_t * frame) {
+    return PROTOCOL_encode_head(frame, %s, 0);
+}''' % (message.lower, message.name, message.lower, message.name))
+            continue
+        out.append('''/**
+ * \\fn PROTOCOL_API int PROTOCOL_write_%s(uint8_t * frame, const %s * msg)
+ * \\brief %s frame (%s of payload).
+ *
+ * \\return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_%s(uint8_t * frame, const %s * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;''' % (message.lower, message.struct, message.name, plural(size),
+                                                          message.lower, message.struct))
+        offset = 0
+        for field, kind in message.fields:
+            out.append('    ' + KINDS[kind][2].format(o=offset, f=field))
+            offset += KINDS[kind][1]
+        out.append('    return PROTOCOL_encode_head(frame, %s, %d);\n}' % (message.name, size))
+        readers = []
+        offset = 0
+        for field, kind in message.fields:
+            readers.append(KINDS[kind][3].format(o=offset))
+            offset += KINDS[kind][1]
+        out.append('''/**
+ * \\fn PROTOCOL_API %s PROTOCOL_read_%s(const uint8_t * payload)
+ * \\brief Reads the payload of %s (%s).
+ */
+PROTOCOL_API %s PROTOCOL_read_%s(const uint8_t * payload) {
+    %s msg = {%s};
+    return msg;
+}''' % (message.struct, message.lower, message.name, plural(size), message.struct, message.lower, message.struct,
+        ', '.join(readers)))
+    out.append('''/**
+ * \\fn PROTOCOL_API const Protocol_Message_Info * PROTOCOL_message_info(Message_Type type)
+ * \\brief Gives the description of a message type, NULL for an unknown type.
+ */
+PROTOCOL_API const Protocol_Message_Info * PROTOCOL_message_info(Message_Type type) {
+    for(int i = 0; i < PROTOCOL_MESSAGE_COUNT; i++) {
+        if(PROTOCOL_MESSAGES[i].type == type) {
+            return &PROTOCOL_MESSAGES[i];
+        }
+    }
+    return 0;
+}''')
+    out.append('''/**
+ * \\fn PROTOCOL_API int PROTOCOL_write_message(uint8_t * frame, Message_Type type, const int64_t * values)
+ * \\brief Frame of any fixed size message, the fields given in the order of the schema.
+ *
+ * \\return Size of the frame, -1 for a variable or unknown type.
+ */
+PROTOCOL_API int PROTOCOL_write_message(uint8_t * frame, Message_Type type, const int64_t * values) {
+    switch(type) {''')
+    for message in messages:
+        if message.custom:
+            continue
+        if not message.fields:
+            out.append('        case %s : return PROTOCOL_write_%s(frame);' % (message.name, message.lower))
+            continue
+        values = ', '.join('(%s)values[%d]' % (KINDS[kind][0], i) for i, (_, kind) in enumerate(message.fields))
+        out.append('        case %s :\n        {\n            %s msg = {%s};\n            return PROTOCOL_write_%s(frame, &msg);\n        }'
+                   % (message.name, message.struct, values, message.lower))
+    out.append('        default : return -1;\n    }\n}')
+    out.append('''/**
+ * \\fn PROTOCOL_API int PROTOCOL_read_message(const uint8_t * payload, int payload_size, Message_Type type, int64_t * values)
+ * \\brief Reads the fields of any fixed size message, in the order of the schema.
+ *
+ * \\return On success, returns the amount of fields. On error (short payload, variable or unknown type), returns -1.
+ */
+PROTOCOL_API int PROTOCOL_read_message(const uint8_t * payload, int payload_size, Message_Type type, int64_t * values) {
+    const Protocol_Message_Info * info = PROTOCOL_message_info(type);
+    if(info == 0 || info->payload_size < 0 || payload_size < info->payload_size) {
+        return -1;
+    }
+    switch(type) {''')
+    for message in messages:
+        if message.custom or not message.fields:
+            continue
+        out.append('        case %s :\n        {\n            %s msg = PROTOCOL_read_%s(payload);'
+                   % (message.name, message.struct, message.lower))
+        for i, (field, _) in enumerate(message.fields):
+            out.append('            values[%d] = msg.%s;' % (i, field))
+        out.append('            break;\n        }')
+    out.append('        default : break;\n    }\n    return info->field_count;\n}')
+    out.append('')
+    out.append('#endif /* PROTOCOL_PROTOCOL_CODECS_H_ */')
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('-o', '--output', default=HERE, help='directory of the generated headers')
+    arguments = parser.parse_args()
+    messages = parse(os.path.join(HERE, 'protocol.schema'))
+    for file_name, text in (('protocol_messages.h', messages_header(messages)),
+                            ('protocol_codecs.h', codecs_header(messages))):
+        with open(os.path.join(arguments.output, file_name), 'w') as output:
+            output.write(text)
+
+
+if __name__ == '__main__':
+    main()
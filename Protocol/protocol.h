@@ -0,0 +1,742 @@
+/**
+ * \file  protocol.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Wire protocol shared by Carto (C99) and Cute (C++). Header only.
+ *
+ * A frame is a 4 bytes head followed by the payload :
+ *
+ *     | msg_size (2) | msg_type (2) | payload (msg_size - 2) |
+ *
+ * Every multi-byte field is big-endian, whatever the host. Frames must only be built and read with the
+ * PROTOCOL_* functions below : no struct is ever copied on the wire.
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+#ifndef PROTOCOL_PROTOCOL_H_
+#define PROTOCOL_PROTOCOL_H_
+/* ----------------------  INCLUDES ------------------------------------------*/
+#include <stdint.h>
+/* ----------------------  PUBLIC CONFIGURATIONS -----------------------------*/
+/**
+ * \def PROTOCOL_API
+ * Codecs are constexpr in C++ and static inline in C.
+ */
+#ifdef __cplusplus
+#define PROTOCOL_API constexpr inline
+#else
+#define PROTOCOL_API static inline
+#endif
+/**
+ * \def PROTOCOL_STATIC_ASSERT
+ * Compile time check, usable in C99 (negative array size) and in C++.
+ */
+#ifdef __cplusplus
+#define PROTOCOL_STATIC_ASSERT(condition, name) static_assert(condition, #name)
+#else
+#define PROTOCOL_STATIC_ASSERT(condition, name) typedef char protocol_assert_##name[(condition) ? 1 : -1]
+#endif
+/**
+ * \def PROTOCOL_TABLE
+ * Constant tables of the generated headers.
+ */
+#ifdef __cplusplus
+#define PROTOCOL_TABLE static constexpr
+#else
+#define PROTOCOL_TABLE static const
+#endif
+/**
+ * \def PROTOCOL_SIZE_FIELD
+ * Size of the msg_size field.
+ */
+#define PROTOCOL_SIZE_FIELD 2
+/**
+ * \def PROTOCOL_TYPE_FIELD
+ * Size of the msg_type field.
+ */
+#define PROTOCOL_TYPE_FIELD 2
+/**
+ * \def PROTOCOL_HEAD_SIZE
+ * Size of the head of a frame.
+ */
+#define PROTOCOL_HEAD_SIZE (PROTOCOL_SIZE_FIELD + PROTOCOL_TYPE_FIELD)
+/**
+ * \def PROTOCOL_SEQUENCE_FLAG
+ * Bit of the msg_type field telling that seq (u16) and ack (u16) follow the type. Message types keep their low byte at 0.
+ */
+#define PROTOCOL_SEQUENCE_FLAG 0x0001
+/**
+ * \def PROTOCOL_SEQUENCE_SIZE
+ * Size of the seq and ack fields of a sequenced head.
+ */
+#define PROTOCOL_SEQUENCE_SIZE 4
+/**
+ * \def PROTOCOL_FRAME_SIZE
+ * Size of a whole frame carrying payload_size bytes.
+ */
+#define PROTOCOL_FRAME_SIZE(payload_size) (PROTOCOL_HEAD_SIZE + (payload_size))
+/**
+ * \def PROTOCOL_ENUM_MASK
+ * Bits of a Command or Direction byte. Decoders mask the byte so that C++ never holds a value out of the enum.
+ */
+#define PROTOCOL_ENUM_MASK 0x03
+/**
+ * \def PROTOCOL_MAX_PAYLOAD
+ * Biggest fixed payload of the protocol (RESUME : token, map version, count of MOVE_DONE).
+ */
+#define PROTOCOL_MAX_PAYLOAD 12
+/**
+ * \def PROTOCOL_MAX_FRAME_SIZE
+ * Buffer size able to hold any frame, sequenced or not.
+ */
+#define PROTOCOL_MAX_FRAME_SIZE (PROTOCOL_FRAME_SIZE(PROTOCOL_MAX_PAYLOAD) + PROTOCOL_SEQUENCE_SIZE)
+/**
+ * \def PROTOCOL_VERSION_1
+ * First protocol : one byte coordinates, no handshake. Used until a HELLO is exchanged.
+ */
+#define PROTOCOL_VERSION_1 1
+/**
+ * \def PROTOCOL_VERSION_2
+ * Signed 32 bits coordinates and explicit heading, negotiated by HELLO / HELLO_ACK.
+ */
+#define PROTOCOL_VERSION_2 2
+/**
+ * \def PROTOCOL_VERSION
+ * Highest version spoken by this build.
+ */
+#define PROTOCOL_VERSION PROTOCOL_VERSION_2
+/**
+ * \def PROTOCOL_CAP_WIDE_COORDS
+ * Capability : coordinates are signed 32 bits (maps wider than 256 cells, negative cells).
+ */
+#define PROTOCOL_CAP_WIDE_COORDS (1u << 0)
+/**
+ * \def PROTOCOL_CAP_HEADING
+ * Capability : SET_ROBOT_POSITION_V2 carries the heading of the robot.
+ */
+#define PROTOCOL_CAP_HEADING (1u << 1)
+/**
+ * \def PROTOCOL_CAP_MAP_DELTA
+ * Capability : map changes are batched in MAP_DELTA instead of one SET_OBSTACLE_POSITION per cell.
+ */
+#define PROTOCOL_CAP_MAP_DELTA (1u << 2)
+/**
+ * \def PROTOCOL_CAP_MAP_SNAPSHOT
+ * Capability : Carto answers MAP_SNAPSHOT_REQUEST with its whole map.
+ */
+#define PROTOCOL_CAP_MAP_SNAPSHOT (1u << 3)
+/**
+ * \def PROTOCOL_CAP_SEQUENCE
+ * Capability : frames carry a sequence number and a cumulative ack (sequenced head), so requests can be pipelined.
+ */
+#define PROTOCOL_CAP_SEQUENCE (1u << 4)
+/**
+ * \def PROTOCOL_CAP_RESUME
+ * Capability : after a reconnection, RESUME / SESSION keep the session and Carto replays only the missed telemetry.
+ */
+#define PROTOCOL_CAP_RESUME (1u << 5)
+/**
+ * \def PROTOCOL_CAP_OBSERVATIONS
+ * Capability : MAP_DELTA carries every observation of a cell, repeated ones included, not only its changes.
+ */
+#define PROTOCOL_CAP_OBSERVATIONS (1u << 6)
+/**
+ * \def PROTOCOL_CAPABILITIES
+ * Capabilities of this build, announced in HELLO and HELLO_ACK.
+ */
+#define PROTOCOL_CAPABILITIES (PROTOCOL_CAP_WIDE_COORDS | PROTOCOL_CAP_HEADING | PROTOCOL_CAP_MAP_DELTA | PROTOCOL_CAP_MAP_SNAPSHOT \
+                               | PROTOCOL_CAP_SEQUENCE | PROTOCOL_CAP_RESUME | PROTOCOL_CAP_OBSERVATIONS)
+/**
+ * \def PROTOCOL_MAX_DELTA_CELLS
+ * Max amount of cells in one MAP_DELTA.
+ */
+#define PROTOCOL_MAX_DELTA_CELLS 128
+/**
+ * \def PROTOCOL_MAX_VARINT_SIZE
+ * Max size of a varint (32 bits value, 7 bits per byte).
+ */
+#define PROTOCOL_MAX_VARINT_SIZE 5
+/**
+ * \def PROTOCOL_MAX_DELTA_PAYLOAD
+ * Biggest MAP_DELTA payload : version, count, then per cell two varints and the value.
+ */
+#define PROTOCOL_MAX_DELTA_PAYLOAD (4 + 2 + PROTOCOL_MAX_DELTA_CELLS * (2 * PROTOCOL_MAX_VARINT_SIZE + 1))
+/**
+ * \def PROTOCOL_MAX_DELTA_FRAME_SIZE
+ * Buffer size able to hold any MAP_DELTA frame, sequenced or not.
+ */
+#define PROTOCOL_MAX_DELTA_FRAME_SIZE (PROTOCOL_FRAME_SIZE(PROTOCOL_MAX_DELTA_PAYLOAD) + PROTOCOL_SEQUENCE_SIZE)
+/**
+ * \def PROTOCOL_SNAPSHOT_HEAD_SIZE
+ * Size of the head of a MAP_SNAPSHOT payload.
+ */
+#define PROTOCOL_SNAPSHOT_HEAD_SIZE 24
+/**
+ * \def PROTOCOL_MAX_SNAPSHOT_PAYLOAD
+ * Biggest MAP_SNAPSHOT payload : a chunk fits in one TCP segment, and in the receive buffers sized for a full MAP_DELTA.
+ */
+#define PROTOCOL_MAX_SNAPSHOT_PAYLOAD 1400
+/**
+ * \def PROTOCOL_MAX_SNAPSHOT_FRAME_SIZE
+ * Buffer size able to hold any MAP_SNAPSHOT frame, sequenced or not.
+ */
+#define PROTOCOL_MAX_SNAPSHOT_FRAME_SIZE (PROTOCOL_FRAME_SIZE(PROTOCOL_MAX_SNAPSHOT_PAYLOAD) + PROTOCOL_SEQUENCE_SIZE)
+/* ----------------------  PUBLIC TYPE DEFINITIONS ---------------------------*/
+/**
+ * \enum Command
+ * \brief Move commands.
+ */
+typedef enum {
+    FORWARD = 0, /**< FORWARD : one cell ahead. */
+    RIGHT,       /**< RIGHT : left motor clockwise, right  motor anti-clockwise. */
+    LEFT,        /**< LEFT : left  motor anti-clockwise, right  motor clockwise. */
+    STOP         /**< STOP :  motors stop. */
+} Command;
+/**
+ * \enum Direction
+ * \brief Heading of the robot in the map.
+ */
+typedef enum {
+    SOUTH = 0,  /**< SOUTH : Direction SOUTH according to the matrix(+x) */
+    NORTH,      /**< NORTH : Direction NORTH according to the matrix(-x) */
+    WEST,       /**< WEST : Direction WEST according to the matrix(-y) */
+    EAST        /**< EAST : Direction EAST according to the matrix(+y) */
+} Direction;
+#include "protocol_messages.h"
+/**
+ * \struct Communication_Protocol_Head protocol.h "protocol.h"
+ * \brief Decoded head of a frame. Host representation only, see PROTOCOL_decode_head().
+ *
+ * With PROTOCOL_CAP_SEQUENCE, each side numbers its frames (seq, +1 per frame, wrapping) and puts in ack the seq of the
+ * last request of the peer it has started to answer. Requests are handled in order : a frame acking n tells that every
+ * request before n is done, and the final answer of a request tells that n is done : MOVE_DONE for SEND_MOVE_CARTOGRAPHY
+ * (which first sends ROBOT_POSITION_RECEIVED), ROBOT_POSITION_RECEIVED for SEND_ROBOT_POSITION.
+ */
+typedef struct {
+    uint16_t msg_size;      /**< Gives the Message size (type + data) in bytes. Minimum = 2 bytes Maximum = 0xFFFF. */
+    Message_Type msg_type;  /**< Gives the Message type. */
+    uint8_t sequenced;      /**< 1 when the head carries seq and ack (PROTOCOL_SEQUENCE_FLAG). */
+    uint16_t seq;           /**< Sequence number of the frame. */
+    uint16_t ack;           /**< Sequence number of the last request of the peer being answered. */
+} Communication_Protocol_Head;
+/**
+ * \enum Protocol_Cell_Value
+ * \brief Value of a cell in MAP_DELTA.
+ */
+typedef enum {
+    PROTOCOL_CELL_UNKNOWN = 0,  /**< PROTOCOL_CELL_UNKNOWN : not explored yet. */
+    PROTOCOL_CELL_FREE,         /**< PROTOCOL_CELL_FREE : explored, nothing there. */
+    PROTOCOL_CELL_OBSTACLE      /**< PROTOCOL_CELL_OBSTACLE : obstacle seen by the robot. */
+} Protocol_Cell_Value;
+/**
+ * \struct Protocol_Cell protocol.h "protocol.h"
+ * \brief One cell change of a MAP_DELTA.
+ */
+typedef struct {
+    int32_t coord_x;    /**< Row of the cell. */
+    int32_t coord_y;    /**< Column of the cell. */
+    uint8_t value;      /**< Protocol_Cell_Value. */
+} Protocol_Cell;
+/**
+ * \struct Protocol_Snapshot_Head protocol.h "protocol.h"
+ * \brief Head of a MAP_SNAPSHOT chunk. The map is the rows x cols box starting at (origin_x, origin_y),
+ * the chunk holds the cells [first_cell, first_cell + cell_count[ in row-major order.
+ */
+typedef struct {
+    uint32_t map_version;   /**< Version of the map : the next MAP_DELTA has map_version + 1. */
+    int32_t origin_x;       /**< Row of the first cell of the box. */
+    int32_t origin_y;       /**< Column of the first cell of the box. */
+    uint16_t rows;          /**< Amount of rows of the box. */
+    uint16_t cols;          /**< Amount of columns of the box. */
+    uint32_t first_cell;    /**< Row-major index of the first cell of the chunk. */
+    uint32_t cell_count;    /**< Amount of cells of the chunk. The last chunk ends at rows x cols. */
+} Protocol_Snapshot_Head;
+/**
+ * \struct Protocol_Hello protocol.h "protocol.h"
+ * \brief Payload of HELLO and HELLO_ACK.
+ */
+typedef struct {
+    uint8_t version;        /**< Protocol version (PROTOCOL_VERSION_1, PROTOCOL_VERSION_2). */
+    uint32_t capabilities;  /**< PROTOCOL_CAP_* bitmask. */
+} Protocol_Hello;
+/**
+ * \struct Protocol_Pose protocol.h "protocol.h"
+ * \brief Decoded cell or pose, whatever the version of the message.
+ */
+typedef struct {
+    int32_t coord_x;    /**< Row of the cell. */
+    int32_t coord_y;    /**< Column of the cell. */
+    Direction dir;      /**< Heading, SOUTH when the message has none. */
+} Protocol_Pose;
+/* ----------------------  LAYOUT CHECKS -------------------------------------*/
+PROTOCOL_STATIC_ASSERT(PROTOCOL_HEAD_SIZE == 4, head_is_4_bytes);
+PROTOCOL_STATIC_ASSERT(SEND_ROBOT_POSITION_V2 <= 0xFFFF, types_fit_16_bits);
+PROTOCOL_STATIC_ASSERT(STOP <= 0xFF && EAST <= 0xFF, payload_enums_fit_8_bits);
+PROTOCOL_STATIC_ASSERT(STOP == PROTOCOL_ENUM_MASK && EAST == PROTOCOL_ENUM_MASK, payload_enums_fill_the_mask);
+PROTOCOL_STATIC_ASSERT(PROTOCOL_VERSION <= 0xFF, version_fits_8_bits);
+PROTOCOL_STATIC_ASSERT(PROTOCOL_MAX_FRAME_SIZE == 20, max_frame_is_20_bytes);
+PROTOCOL_STATIC_ASSERT(PROTOCOL_MAX_PAYLOAD == PROTOCOL_MAX_FIXED_PAYLOAD, max_payload_matches_the_schema);
+PROTOCOL_STATIC_ASSERT((HELLO & 0xFF) == 0 && (MAP_SNAPSHOT & 0xFF) == 0, types_leave_the_sequence_flag_free);
+PROTOCOL_STATIC_ASSERT(PROTOCOL_MAX_DELTA_FRAME_SIZE <= 0xFFFF, delta_fits_size_field);
+PROTOCOL_STATIC_ASSERT(PROTOCOL_MAX_SNAPSHOT_PAYLOAD <= PROTOCOL_MAX_DELTA_PAYLOAD, snapshot_fits_delta_buffers);
+PROTOCOL_STATIC_ASSERT(PROTOCOL_MAX_SNAPSHOT_PAYLOAD > PROTOCOL_SNAPSHOT_HEAD_SIZE + PROTOCOL_MAX_VARINT_SIZE + 1, snapshot_holds_a_run);
+/* ----------------------  PUBLIC FUNCTIONS  ---------------------------------*/
+/**
+ * \fn PROTOCOL_API void PROTOCOL_put_u16(uint8_t * buffer, uint16_t value)
+ * \brief Writes value big-endian.
+ */
+PROTOCOL_API void PROTOCOL_put_u16(uint8_t * buffer, uint16_t value) {
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)(value & 0xFF);
+}
+/**
+ * \fn PROTOCOL_API uint16_t PROTOCOL_get_u16(const uint8_t * buffer)
+ * \brief Reads a big-endian value.
+ */
+PROTOCOL_API uint16_t PROTOCOL_get_u16(const uint8_t * buffer) {
+    return (uint16_t)((buffer[0] << 8) | buffer[1]);
+}
+/**
+ * \fn PROTOCOL_API void PROTOCOL_put_u32(uint8_t * buffer, uint32_t value)
+ * \brief Writes value big-endian.
+ */
+PROTOCOL_API void PROTOCOL_put_u32(uint8_t * buffer, uint32_t value) {
+    PROTOCOL_put_u16(buffer, (uint16_t)(value >> 16));
+    PROTOCOL_put_u16(buffer + 2, (uint16_t)(value & 0xFFFF));
+}
+/**
+ * \fn PROTOCOL_API uint32_t PROTOCOL_get_u32(const uint8_t * buffer)
+ * \brief Reads a big-endian value.
+ */
+PROTOCOL_API uint32_t PROTOCOL_get_u32(const uint8_t * buffer) {
+    return ((uint32_t)PROTOCOL_get_u16(buffer) << 16) | PROTOCOL_get_u16(buffer + 2);
+}
+/**
+ * \fn PROTOCOL_API void PROTOCOL_put_i32(uint8_t * buffer, int32_t value)
+ * \brief Writes value big-endian, two's complement.
+ */
+PROTOCOL_API void PROTOCOL_put_i32(uint8_t * buffer, int32_t value) {
+    PROTOCOL_put_u32(buffer, (uint32_t)value);
+}
+/**
+ * \fn PROTOCOL_API int32_t PROTOCOL_get_i32(const uint8_t * buffer)
+ * \brief Reads a big-endian two's complement value (no implementation defined conversion).
+ */
+PROTOCOL_API int32_t PROTOCOL_get_i32(const uint8_t * buffer) {
+    uint32_t value = PROTOCOL_get_u32(buffer);
+    return (value & 0x80000000u) ? -(int32_t)(~value) - 1 : (int32_t)value;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_put_varint(uint8_t * buffer, int32_t value)
+ * \brief Writes value zigzag encoded (small magnitudes, positive or negative, use few bytes), 7 bits per byte.
+ *
+ * \return Amount of bytes written (1 to PROTOCOL_MAX_VARINT_SIZE).
+ */
+PROTOCOL_API int PROTOCOL_put_varint(uint8_t * buffer, int32_t value) {
+    uint32_t zigzag = (value < 0) ? ((~(uint32_t)value) << 1) | 1u : ((uint32_t)value << 1);
+    int size = 0;
+    while(zigzag >= 0x80) {
+        buffer[size++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    buffer[size++] = (uint8_t)zigzag;
+    return size;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_get_varint(const uint8_t * buffer, int available, int32_t * value)
+ * \brief Reads a value written by PROTOCOL_put_varint().
+ *
+ * \return Amount of bytes read, -1 when the varint is truncated or too long.
+ */
+PROTOCOL_API int PROTOCOL_get_varint(const uint8_t * buffer, int available, int32_t * value) {
+    uint32_t zigzag = 0;
+    int size = 0;
+    while(size < available && size < PROTOCOL_MAX_VARINT_SIZE) {
+        uint8_t byte = buffer[size];
+        zigzag |= (uint32_t)(byte & 0x7F) << (7 * size);
+        size++;
+        if((byte & 0x80) == 0) {
+            *value = (zigzag & 1u) ? -(int32_t)(zigzag >> 1) - 1 : (int32_t)(zigzag >> 1);
+            return size;
+        }
+    }
+    return -1;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_head(uint8_t * frame, Message_Type type, int payload_size)
+ * \brief Writes the head of a frame.
+ *
+ * \return Size of the whole frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_head(uint8_t * frame, Message_Type type, int payload_size) {
+    PROTOCOL_put_u16(frame, (uint16_t)(PROTOCOL_TYPE_FIELD + payload_size));
+    PROTOCOL_put_u16(frame + PROTOCOL_SIZE_FIELD, (uint16_t)type);
+    return PROTOCOL_FRAME_SIZE(payload_size);
+}
+/**
+ * \fn PROTOCOL_API Communication_Protocol_Head PROTOCOL_decode_head(const uint8_t * frame)
+ * \brief Reads the head of a frame.
+ */
+PROTOCOL_API Communication_Protocol_Head PROTOCOL_decode_head(const uint8_t * frame) {
+    uint16_t size = PROTOCOL_get_u16(frame);
+    uint16_t type = PROTOCOL_get_u16(frame + PROTOCOL_SIZE_FIELD);
+    uint8_t sequenced = (type & PROTOCOL_SEQUENCE_FLAG) && size >= PROTOCOL_TYPE_FIELD + PROTOCOL_SEQUENCE_SIZE;
+    Communication_Protocol_Head head = {size, (Message_Type)(type & ~PROTOCOL_SEQUENCE_FLAG), sequenced,
+                                        (uint16_t)(sequenced ? PROTOCOL_get_u16(frame + PROTOCOL_HEAD_SIZE) : 0),
+                                        (uint16_t)(sequenced ? PROTOCOL_get_u16(frame + PROTOCOL_HEAD_SIZE + 2) : 0)};
+    return head;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_payload_offset(Communication_Protocol_Head head)
+ * \brief Gives the position of the payload in the frame.
+ */
+PROTOCOL_API int PROTOCOL_payload_offset(Communication_Protocol_Head head) {
+    return PROTOCOL_HEAD_SIZE + (head.sequenced ? PROTOCOL_SEQUENCE_SIZE : 0);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_payload_size(Communication_Protocol_Head head)
+ * \brief Gives the size of the payload announced by a head (0 for a malformed size).
+ */
+PROTOCOL_API int PROTOCOL_payload_size(Communication_Protocol_Head head) {
+    int size = head.msg_size - PROTOCOL_TYPE_FIELD - (head.sequenced ? PROTOCOL_SEQUENCE_SIZE : 0);
+    return (size > 0) ? size : 0;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_add_sequence(uint8_t * frame, uint16_t seq, uint16_t ack)
+ * \brief Turns an encoded frame into a sequenced one : inserts seq and ack after the type.
+ * The buffer must have PROTOCOL_SEQUENCE_SIZE bytes free after the frame (the PROTOCOL_MAX_*_FRAME_SIZE buffers have).
+ *
+ * \return Size of the whole frame.
+ */
+PROTOCOL_API int PROTOCOL_add_sequence(uint8_t * frame, uint16_t seq, uint16_t ack) {
+    int payload_size = PROTOCOL_get_u16(frame) - PROTOCOL_TYPE_FIELD;
+    for(int i = payload_size - 1; i >= 0; i--) {
+        frame[PROTOCOL_HEAD_SIZE + PROTOCOL_SEQUENCE_SIZE + i] = frame[PROTOCOL_HEAD_SIZE + i];
+    }
+    PROTOCOL_put_u16(frame, (uint16_t)(PROTOCOL_TYPE_FIELD + PROTOCOL_SEQUENCE_SIZE + payload_size));
+    PROTOCOL_put_u16(frame + PROTOCOL_SIZE_FIELD, (uint16_t)(PROTOCOL_get_u16(frame + PROTOCOL_SIZE_FIELD) | PROTOCOL_SEQUENCE_FLAG));
+    PROTOCOL_put_u16(frame + PROTOCOL_HEAD_SIZE, seq);
+    PROTOCOL_put_u16(frame + PROTOCOL_HEAD_SIZE + 2, ack);
+    return PROTOCOL_FRAME_SIZE(PROTOCOL_SEQUENCE_SIZE + payload_size);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_sequence_distance(uint16_t from, uint16_t to)
+ * \brief Amount of sequence numbers from from to to, wrapping included (negative when to is before from).
+ */
+PROTOCOL_API int PROTOCOL_sequence_distance(uint16_t from, uint16_t to) {
+    return (int16_t)(uint16_t)(to - from);
+}
+#include "protocol_codecs.h"
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_signal(uint8_t * frame, Message_Type type)
+ * \brief Frame without payload : MOVE_DONE, ROBOT_POSITION_RECEIVED, STOP_ROBOT.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_signal(uint8_t * frame, Message_Type type) {
+    return PROTOCOL_encode_head(frame, type, 0);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_cell(uint8_t * frame, Message_Type type, int coord_x, int coord_y)
+ * \brief Frame carrying a cell : SET_OBSTACLE_POSITION, SET_ROBOT_POSITION.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_cell(uint8_t * frame, Message_Type type, int coord_x, int coord_y) {
+    Protocol_Msg_Set_Obstacle_Position cell = {(uint8_t)coord_x, (uint8_t)coord_y};
+    PROTOCOL_write_set_obstacle_position(frame, &cell);
+    return PROTOCOL_encode_head(frame, type, 2);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_pose_v2(uint8_t * frame, Message_Type type, int32_t coord_x, int32_t coord_y, Direction dir)
+ * \brief v2 frame carrying a pose : SET_ROBOT_POSITION_V2, SEND_ROBOT_POSITION_V2.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_pose_v2(uint8_t * frame, Message_Type type, int32_t coord_x, int32_t coord_y, Direction dir) {
+    Protocol_Msg_Set_Robot_Position_V2 pose = {coord_x, coord_y, dir};
+    PROTOCOL_write_set_robot_position_v2(frame, &pose);
+    return PROTOCOL_encode_head(frame, type, 9);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_robot_position(uint8_t * frame, int version, int32_t coord_x, int32_t coord_y, Direction dir)
+ * \brief SEND_ROBOT_POSITION frame of the given version (v1 truncates the coordinates to one byte).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_robot_position(uint8_t * frame, int version, int32_t coord_x, int32_t coord_y, Direction dir) {
+    if(version >= PROTOCOL_VERSION_2) {
+        return PROTOCOL_encode_pose_v2(frame, SEND_ROBOT_POSITION_V2, coord_x, coord_y, dir);
+    }
+    Protocol_Msg_Send_Robot_Position pose = {(uint8_t)coord_x, (uint8_t)coord_y, dir};
+    return PROTOCOL_write_send_robot_position(frame, &pose);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_obstacle_position(uint8_t * frame, int version, int32_t coord_x, int32_t coord_y)
+ * \brief SET_OBSTACLE_POSITION frame of the given version.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_obstacle_position(uint8_t * frame, int version, int32_t coord_x, int32_t coord_y) {
+    if(version >= PROTOCOL_VERSION_2) {
+        Protocol_Msg_Set_Obstacle_Position_V2 cell = {coord_x, coord_y};
+        return PROTOCOL_write_set_obstacle_position_v2(frame, &cell);
+    }
+    return PROTOCOL_encode_cell(frame, SET_OBSTACLE_POSITION, coord_x, coord_y);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_set_robot_position(uint8_t * frame, int version, int32_t coord_x, int32_t coord_y, Direction dir)
+ * \brief SET_ROBOT_POSITION frame of the given version (the heading is only sent in v2).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_set_robot_position(uint8_t * frame, int version, int32_t coord_x, int32_t coord_y, Direction dir) {
+    if(version >= PROTOCOL_VERSION_2) {
+        return PROTOCOL_encode_pose_v2(frame, SET_ROBOT_POSITION_V2, coord_x, coord_y, dir);
+    }
+    return PROTOCOL_encode_cell(frame, SET_ROBOT_POSITION, coord_x, coord_y);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Pose PROTOCOL_decode_pose(Message_Type type, const uint8_t * payload)
+ * \brief Reads the cell or pose of SET_OBSTACLE_POSITION, SET_ROBOT_POSITION, SEND_ROBOT_POSITION and of their v2.
+ */
+PROTOCOL_API Protocol_Pose PROTOCOL_decode_pose(Message_Type type, const uint8_t * payload) {
+    Protocol_Pose pose = {0, 0, SOUTH};
+    if(type == SET_ROBOT_POSITION_V2 || type == SEND_ROBOT_POSITION_V2) {
+        Protocol_Msg_Set_Robot_Position_V2 msg = PROTOCOL_read_set_robot_position_v2(payload);
+        pose.coord_x = msg.coord_x;
+        pose.coord_y = msg.coord_y;
+        pose.dir = msg.dir;
+    }
+    else if(type == SET_OBSTACLE_POSITION_V2) {
+        Protocol_Msg_Set_Obstacle_Position_V2 msg = PROTOCOL_read_set_obstacle_position_v2(payload);
+        pose.coord_x = msg.coord_x;
+        pose.coord_y = msg.coord_y;
+    }
+    else if(type == SEND_ROBOT_POSITION) {
+        Protocol_Msg_Send_Robot_Position msg = PROTOCOL_read_send_robot_position(payload);
+        pose.coord_x = msg.coord_x;
+        pose.coord_y = msg.coord_y;
+        pose.dir = msg.dir;
+    }
+    else {
+        Protocol_Msg_Set_Robot_Position msg = PROTOCOL_read_set_robot_position(payload);
+        pose.coord_x = msg.coord_x;
+        pose.coord_y = msg.coord_y;
+    }
+    return pose;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_map_delta(uint8_t * frame, uint32_t map_version, const Protocol_Cell * cells, int count)
+ * \brief MAP_DELTA frame. frame must hold PROTOCOL_MAX_DELTA_FRAME_SIZE bytes, count is at most PROTOCOL_MAX_DELTA_CELLS.
+ *
+ * Each cell is stored relative to the previous one : a ray or a wall costs about 3 bytes per cell.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_map_delta(uint8_t * frame, uint32_t map_version, const Protocol_Cell * cells, int count) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    PROTOCOL_put_u32(payload, map_version);
+    PROTOCOL_put_u16(payload + 4, (uint16_t)count);
+    int size = 6;
+    int32_t previous_x = 0;
+    int32_t previous_y = 0;
+    for(int i = 0; i < count; i++) {
+        size += PROTOCOL_put_varint(payload + size, (int32_t)((uint32_t)cells[i].coord_x - (uint32_t)previous_x));
+        size += PROTOCOL_put_varint(payload + size, (int32_t)((uint32_t)cells[i].coord_y - (uint32_t)previous_y));
+        payload[size++] = cells[i].value;
+        previous_x = cells[i].coord_x;
+        previous_y = cells[i].coord_y;
+    }
+    return PROTOCOL_encode_head(frame, MAP_DELTA, size);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_decode_map_delta(const uint8_t * payload, int payload_size, uint32_t * map_version, Protocol_Cell * cells, int max_cells)
+ * \brief Reads a MAP_DELTA payload.
+ *
+ * \return Amount of cells read, -1 when the payload is malformed or holds more than max_cells.
+ */
+PROTOCOL_API int PROTOCOL_decode_map_delta(const uint8_t * payload, int payload_size, uint32_t * map_version, Protocol_Cell * cells, int max_cells) {
+    if(payload_size < 6) {
+        return -1;
+    }
+    *map_version = PROTOCOL_get_u32(payload);
+    int count = PROTOCOL_get_u16(payload + 4);
+    if(count > max_cells) {
+        return -1;
+    }
+    int offset = 6;
+    int32_t coord_x = 0;
+    int32_t coord_y = 0;
+    for(int i = 0; i < count; i++) {
+        int32_t delta_x = 0;
+        int32_t delta_y = 0;
+        int size = PROTOCOL_get_varint(payload + offset, payload_size - offset, &delta_x);
+        if(size == -1) {
+            return -1;
+        }
+        offset += size;
+        size = PROTOCOL_get_varint(payload + offset, payload_size - offset, &delta_y);
+        if(size == -1 || offset + size >= payload_size) {
+            return -1;
+        }
+        offset += size;
+        coord_x = (int32_t)((uint32_t)coord_x + (uint32_t)delta_x);
+        coord_y = (int32_t)((uint32_t)coord_y + (uint32_t)delta_y);
+        cells[i].coord_x = coord_x;
+        cells[i].coord_y = coord_y;
+        cells[i].value = payload[offset++];
+    }
+    return count;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_snapshot_chunk(uint8_t * frame, Protocol_Snapshot_Head * head, const uint8_t * cells)
+ * \brief MAP_SNAPSHOT frame holding as many cells from head->first_cell as fit in PROTOCOL_MAX_SNAPSHOT_PAYLOAD.
+ * Cells are run-length encoded in row-major order, runs may span several rows.
+ *
+ * \param frame : buffer of PROTOCOL_MAX_SNAPSHOT_FRAME_SIZE bytes.
+ * \param head : head of the chunk, cell_count is set to the amount of cells encoded.
+ * \param cells : the rows x cols cells of the map, row-major.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_snapshot_chunk(uint8_t * frame, Protocol_Snapshot_Head * head, const uint8_t * cells) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    uint32_t total = (uint32_t)head->rows * head->cols;
+    uint32_t cell = head->first_cell;
+    int size = PROTOCOL_SNAPSHOT_HEAD_SIZE;
+    while(cell < total && size + PROTOCOL_MAX_VARINT_SIZE + 1 <= PROTOCOL_MAX_SNAPSHOT_PAYLOAD) {
+        uint32_t run = 1;
+        while(cell + run < total && cells[cell + run] == cells[cell] && run < 0x7FFFFFFF) {
+            run++;
+        }
+        size += PROTOCOL_put_varint(payload + size, (int32_t)run);
+        payload[size++] = cells[cell];
+        cell += run;
+    }
+    head->cell_count = cell - head->first_cell;
+    PROTOCOL_put_u32(payload, head->map_version);
+    PROTOCOL_put_i32(payload + 4, head->origin_x);
+    PROTOCOL_put_i32(payload + 8, head->origin_y);
+    PROTOCOL_put_u16(payload + 12, head->rows);
+    PROTOCOL_put_u16(payload + 14, head->cols);
+    PROTOCOL_put_u32(payload + 16, head->first_cell);
+    PROTOCOL_put_u32(payload + 20, head->cell_count);
+    return PROTOCOL_encode_head(frame, MAP_SNAPSHOT, size);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Snapshot_Head PROTOCOL_decode_snapshot_head(const uint8_t * payload)
+ * \brief Reads the head of a MAP_SNAPSHOT payload (at least PROTOCOL_SNAPSHOT_HEAD_SIZE bytes).
+ */
+PROTOCOL_API Protocol_Snapshot_Head PROTOCOL_decode_snapshot_head(const uint8_t * payload) {
+    Protocol_Snapshot_Head head = {PROTOCOL_get_u32(payload), PROTOCOL_get_i32(payload + 4), PROTOCOL_get_i32(payload + 8),
+                                   PROTOCOL_get_u16(payload + 12), PROTOCOL_get_u16(payload + 14),
+                                   PROTOCOL_get_u32(payload + 16), PROTOCOL_get_u32(payload + 20)};
+    return head;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_decode_snapshot_cells(const uint8_t * payload, int payload_size, Protocol_Snapshot_Head head, uint8_t * cells)
+ * \brief Writes the cells of a MAP_SNAPSHOT chunk in the rows x cols row-major buffer cells.
+ *
+ * \return On success, returns 0. On error (malformed or out of the box), returns -1.
+ */
+PROTOCOL_API int PROTOCOL_decode_snapshot_cells(const uint8_t * payload, int payload_size, Protocol_Snapshot_Head head, uint8_t * cells) {
+    uint32_t total = (uint32_t)head.rows * head.cols;
+    if(payload_size < PROTOCOL_SNAPSHOT_HEAD_SIZE || head.first_cell > total || head.cell_count > total - head.first_cell) {
+        return -1;
+    }
+    uint32_t cell = head.first_cell;
+    uint32_t end = head.first_cell + head.cell_count;
+    int offset = PROTOCOL_SNAPSHOT_HEAD_SIZE;
+    while(cell < end) {
+        int32_t run = 0;
+        int size = PROTOCOL_get_varint(payload + offset, payload_size - offset, &run);
+        if(size == -1 || offset + size >= payload_size || run <= 0 || (uint32_t)run > end - cell) {
+            return -1;
+        }
+        offset += size;
+        uint8_t value = payload[offset++];
+        for(int32_t i = 0; i < run; i++) {
+            cells[cell++] = value;
+        }
+    }
+    return 0;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_hello(uint8_t * frame, Message_Type type, uint8_t version, uint32_t capabilities)
+ * \brief HELLO or HELLO_ACK frame.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_hello(uint8_t * frame, Message_Type type, uint8_t version, uint32_t capabilities) {
+    Protocol_Msg_Hello hello = {version, capabilities};
+    PROTOCOL_write_hello(frame, &hello);
+    return PROTOCOL_encode_head(frame, type, 5);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Hello PROTOCOL_decode_hello(const uint8_t * payload)
+ * \brief Reads the payload of HELLO or HELLO_ACK.
+ */
+PROTOCOL_API Protocol_Hello PROTOCOL_decode_hello(const uint8_t * payload) {
+    Protocol_Msg_Hello msg = PROTOCOL_read_hello(payload);
+    Protocol_Hello hello = {msg.version, msg.capabilities};
+    return hello;
+}
+/**
+ * \fn PROTOCOL_API Protocol_Hello PROTOCOL_negotiate(Protocol_Hello offer)
+ * \brief Version and capabilities kept for a session : the lowest version and the common capabilities.
+ */
+PROTOCOL_API Protocol_Hello PROTOCOL_negotiate(Protocol_Hello offer) {
+    Protocol_Hello kept = {(uint8_t)((offer.version < PROTOCOL_VERSION) ? offer.version : PROTOCOL_VERSION), offer.capabilities & PROTOCOL_CAPABILITIES};
+    if(kept.version < PROTOCOL_VERSION_1) {
+        kept.version = PROTOCOL_VERSION_1;
+    }
+    return kept;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_move_cartography(uint8_t * frame, Command cmd)
+ * \brief SEND_MOVE_CARTOGRAPHY frame.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_move_cartography(uint8_t * frame, Command cmd) {
+    Protocol_Msg_Send_Move_Cartography move = {cmd};
+    return PROTOCOL_write_send_move_cartography(frame, &move);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_encode_move_trajectory(uint8_t * frame, int size, Command cmd)
+ * \brief SEND_MOVES_TRAJECTORY frame : one command of a trajectory of size commands.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_encode_move_trajectory(uint8_t * frame, int size, Command cmd) {
+    Protocol_Msg_Send_Moves_Trajectory move = {(uint8_t)size, cmd};
+    return PROTOCOL_write_send_moves_trajectory(frame, &move);
+}
+
+#endif /* PROTOCOL_PROTOCOL_H_ */
@@ -0,0 +1,514 @@
+/**
+ * \file  protocol_codecs.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Encoders and decoders of the fixed size messages. Included by protocol.h.
+ *
+ * Generated by generate.py from protocol.schema : do not edit, run make -C Protocol generate.
+ *
+ * \see protocol.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+
+#ifndef PROTOCOL_PROTOCOL_CODECS_H_
+#define PROTOCOL_PROTOCOL_CODECS_H_
+/* ----------------------  PUBLIC FUNCTIONS  ---------------------------------*/
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_send_moves_trajectory(uint8_t * frame, const Protocol_Msg_Send_Moves_Trajectory * msg)
+ * \brief SEND_MOVES_TRAJECTORY frame (2 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_send_moves_trajectory(uint8_t * frame, const Protocol_Msg_Send_Moves_Trajectory * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = msg->size;
+    payload[1] = (uint8_t)msg->command;
+    return PROTOCOL_encode_head(frame, SEND_MOVES_TRAJECTORY, 2);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Send_Moves_Trajectory PROTOCOL_read_send_moves_trajectory(const uint8_t * payload)
+ * \brief Reads the payload of SEND_MOVES_TRAJECTORY (2 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Send_Moves_Trajectory PROTOCOL_read_send_moves_trajectory(const uint8_t * payload) {
+    Protocol_Msg_Send_Moves_Trajectory msg = {payload[0], (Command)(payload[1] & PROTOCOL_ENUM_MASK)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_send_move_cartography(uint8_t * frame, const Protocol_Msg_Send_Move_Cartography * msg)
+ * \brief SEND_MOVE_CARTOGRAPHY frame (1 byte of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_send_move_cartography(uint8_t * frame, const Protocol_Msg_Send_Move_Cartography * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = (uint8_t)msg->command;
+    return PROTOCOL_encode_head(frame, SEND_MOVE_CARTOGRAPHY, 1);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Send_Move_Cartography PROTOCOL_read_send_move_cartography(const uint8_t * payload)
+ * \brief Reads the payload of SEND_MOVE_CARTOGRAPHY (1 byte).
+ */
+PROTOCOL_API Protocol_Msg_Send_Move_Cartography PROTOCOL_read_send_move_cartography(const uint8_t * payload) {
+    Protocol_Msg_Send_Move_Cartography msg = {(Command)(payload[0] & PROTOCOL_ENUM_MASK)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_move_done(uint8_t * frame)
+ * \brief MOVE_DONE frame.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_move_done(uint8_t * frame) {
+    return PROTOCOL_encode_head(frame, MOVE_DONE, 0);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_set_obstacle_position(uint8_t * frame, const Protocol_Msg_Set_Obstacle_Position * msg)
+ * \brief SET_OBSTACLE_POSITION frame (2 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_set_obstacle_position(uint8_t * frame, const Protocol_Msg_Set_Obstacle_Position * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = msg->coord_x;
+    payload[1] = msg->coord_y;
+    return PROTOCOL_encode_head(frame, SET_OBSTACLE_POSITION, 2);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Set_Obstacle_Position PROTOCOL_read_set_obstacle_position(const uint8_t * payload)
+ * \brief Reads the payload of SET_OBSTACLE_POSITION (2 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Set_Obstacle_Position PROTOCOL_read_set_obstacle_position(const uint8_t * payload) {
+    Protocol_Msg_Set_Obstacle_Position msg = {payload[0], payload[1]};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_set_robot_position(uint8_t * frame, const Protocol_Msg_Set_Robot_Position * msg)
+ * \brief SET_ROBOT_POSITION frame (2 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_set_robot_position(uint8_t * frame, const Protocol_Msg_Set_Robot_Position * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = msg->coord_x;
+    payload[1] = msg->coord_y;
+    return PROTOCOL_encode_head(frame, SET_ROBOT_POSITION, 2);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Set_Robot_Position PROTOCOL_read_set_robot_position(const uint8_t * payload)
+ * \brief Reads the payload of SET_ROBOT_POSITION (2 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Set_Robot_Position PROTOCOL_read_set_robot_position(const uint8_t * payload) {
+    Protocol_Msg_Set_Robot_Position msg = {payload[0], payload[1]};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_stop_robot(uint8_t * frame)
+ * \brief STOP_ROBOT frame.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_stop_robot(uint8_t * frame) {
+    return PROTOCOL_encode_head(frame, STOP_ROBOT, 0);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_send_robot_position(uint8_t * frame, const Protocol_Msg_Send_Robot_Position * msg)
+ * \brief SEND_ROBOT_POSITION frame (3 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_send_robot_position(uint8_t * frame, const Protocol_Msg_Send_Robot_Position * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = msg->coord_x;
+    payload[1] = msg->coord_y;
+    payload[2] = (uint8_t)msg->dir;
+    return PROTOCOL_encode_head(frame, SEND_ROBOT_POSITION, 3);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Send_Robot_Position PROTOCOL_read_send_robot_position(const uint8_t * payload)
+ * \brief Reads the payload of SEND_ROBOT_POSITION (3 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Send_Robot_Position PROTOCOL_read_send_robot_position(const uint8_t * payload) {
+    Protocol_Msg_Send_Robot_Position msg = {payload[0], payload[1], (Direction)(payload[2] & PROTOCOL_ENUM_MASK)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_robot_position_received(uint8_t * frame)
+ * \brief ROBOT_POSITION_RECEIVED frame.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_robot_position_received(uint8_t * frame) {
+    return PROTOCOL_encode_head(frame, ROBOT_POSITION_RECEIVED, 0);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_hello(uint8_t * frame, const Protocol_Msg_Hello * msg)
+ * \brief HELLO frame (5 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_hello(uint8_t * frame, const Protocol_Msg_Hello * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = msg->version;
+    PROTOCOL_put_u32(payload + 1, msg->capabilities);
+    return PROTOCOL_encode_head(frame, HELLO, 5);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Hello PROTOCOL_read_hello(const uint8_t * payload)
+ * \brief Reads the payload of HELLO (5 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Hello PROTOCOL_read_hello(const uint8_t * payload) {
+    Protocol_Msg_Hello msg = {payload[0], PROTOCOL_get_u32(payload + 1)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_hello_ack(uint8_t * frame, const Protocol_Msg_Hello_Ack * msg)
+ * \brief HELLO_ACK frame (5 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_hello_ack(uint8_t * frame, const Protocol_Msg_Hello_Ack * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    payload[0] = msg->version;
+    PROTOCOL_put_u32(payload + 1, msg->capabilities);
+    return PROTOCOL_encode_head(frame, HELLO_ACK, 5);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Hello_Ack PROTOCOL_read_hello_ack(const uint8_t * payload)
+ * \brief Reads the payload of HELLO_ACK (5 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Hello_Ack PROTOCOL_read_hello_ack(const uint8_t * payload) {
+    Protocol_Msg_Hello_Ack msg = {payload[0], PROTOCOL_get_u32(payload + 1)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_map_snapshot_request(uint8_t * frame)
+ * \brief MAP_SNAPSHOT_REQUEST frame.
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_map_snapshot_request(uint8_t * frame) {
+    return PROTOCOL_encode_head(frame, MAP_SNAPSHOT_REQUEST, 0);
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_resume(uint8_t * frame, const Protocol_Msg_Resume * msg)
+ * \brief RESUME frame (12 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_resume(uint8_t * frame, const Protocol_Msg_Resume * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    PROTOCOL_put_u32(payload + 0, msg->token);
+    PROTOCOL_put_u32(payload + 4, msg->map_version);
+    PROTOCOL_put_u32(payload + 8, msg->moves_done);
+    return PROTOCOL_encode_head(frame, RESUME, 12);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Resume PROTOCOL_read_resume(const uint8_t * payload)
+ * \brief Reads the payload of RESUME (12 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Resume PROTOCOL_read_resume(const uint8_t * payload) {
+    Protocol_Msg_Resume msg = {PROTOCOL_get_u32(payload + 0), PROTOCOL_get_u32(payload + 4), PROTOCOL_get_u32(payload + 8)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_session(uint8_t * frame, const Protocol_Msg_Session * msg)
+ * \brief SESSION frame (9 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_session(uint8_t * frame, const Protocol_Msg_Session * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    PROTOCOL_put_u32(payload + 0, msg->token);
+    payload[4] = msg->resumed;
+    PROTOCOL_put_u32(payload + 5, msg->moves_done);
+    return PROTOCOL_encode_head(frame, SESSION, 9);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Session PROTOCOL_read_session(const uint8_t * payload)
+ * \brief Reads the payload of SESSION (9 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Session PROTOCOL_read_session(const uint8_t * payload) {
+    Protocol_Msg_Session msg = {PROTOCOL_get_u32(payload + 0), payload[4], PROTOCOL_get_u32(payload + 5)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_set_obstacle_position_v2(uint8_t * frame, const Protocol_Msg_Set_Obstacle_Position_V2 * msg)
+ * \brief SET_OBSTACLE_POSITION_V2 frame (8 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_set_obstacle_position_v2(uint8_t * frame, const Protocol_Msg_Set_Obstacle_Position_V2 * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    PROTOCOL_put_i32(payload + 0, msg->coord_x);
+    PROTOCOL_put_i32(payload + 4, msg->coord_y);
+    return PROTOCOL_encode_head(frame, SET_OBSTACLE_POSITION_V2, 8);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Set_Obstacle_Position_V2 PROTOCOL_read_set_obstacle_position_v2(const uint8_t * payload)
+ * \brief Reads the payload of SET_OBSTACLE_POSITION_V2 (8 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Set_Obstacle_Position_V2 PROTOCOL_read_set_obstacle_position_v2(const uint8_t * payload) {
+    Protocol_Msg_Set_Obstacle_Position_V2 msg = {PROTOCOL_get_i32(payload + 0), PROTOCOL_get_i32(payload + 4)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_set_robot_position_v2(uint8_t * frame, const Protocol_Msg_Set_Robot_Position_V2 * msg)
+ * \brief SET_ROBOT_POSITION_V2 frame (9 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_set_robot_position_v2(uint8_t * frame, const Protocol_Msg_Set_Robot_Position_V2 * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    PROTOCOL_put_i32(payload + 0, msg->coord_x);
+    PROTOCOL_put_i32(payload + 4, msg->coord_y);
+    payload[8] = (uint8_t)msg->dir;
+    return PROTOCOL_encode_head(frame, SET_ROBOT_POSITION_V2, 9);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Set_Robot_Position_V2 PROTOCOL_read_set_robot_position_v2(const uint8_t * payload)
+ * \brief Reads the payload of SET_ROBOT_POSITION_V2 (9 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Set_Robot_Position_V2 PROTOCOL_read_set_robot_position_v2(const uint8_t * payload) {
+    Protocol_Msg_Set_Robot_Position_V2 msg = {PROTOCOL_get_i32(payload + 0), PROTOCOL_get_i32(payload + 4), (Direction)(payload[8] & PROTOCOL_ENUM_MASK)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_send_robot_position_v2(uint8_t * frame, const Protocol_Msg_Send_Robot_Position_V2 * msg)
+ * \brief SEND_ROBOT_POSITION_V2 frame (9 bytes of payload).
+ *
+ * \return Size of the frame.
+ */
+PROTOCOL_API int PROTOCOL_write_send_robot_position_v2(uint8_t * frame, const Protocol_Msg_Send_Robot_Position_V2 * msg) {
+    uint8_t * payload = frame + PROTOCOL_HEAD_SIZE;
+    PROTOCOL_put_i32(payload + 0, msg->coord_x);
+    PROTOCOL_put_i32(payload + 4, msg->coord_y);
+    payload[8] = (uint8_t)msg->dir;
+    return PROTOCOL_encode_head(frame, SEND_ROBOT_POSITION_V2, 9);
+}
+/**
+ * \fn PROTOCOL_API Protocol_Msg_Send_Robot_Position_V2 PROTOCOL_read_send_robot_position_v2(const uint8_t * payload)
+ * \brief Reads the payload of SEND_ROBOT_POSITION_V2 (9 bytes).
+ */
+PROTOCOL_API Protocol_Msg_Send_Robot_Position_V2 PROTOCOL_read_send_robot_position_v2(const uint8_t * payload) {
+    Protocol_Msg_Send_Robot_Position_V2 msg = {PROTOCOL_get_i32(payload + 0), PROTOCOL_get_i32(payload + 4), (Direction)(payload[8] & PROTOCOL_ENUM_MASK)};
+    return msg;
+}
+/**
+ * \fn PROTOCOL_API const Protocol_Message_Info * PROTOCOL_message_info(Message_Type type)
+ * \brief Gives the description of a message type, NULL for an unknown type.
+ */
+PROTOCOL_API const Protocol_Message_Info * PROTOCOL_message_info(Message_Type type) {
+    for(int i = 0; i < PROTOCOL_MESSAGE_COUNT; i++) {
+        if(PROTOCOL_MESSAGES[i].type == type) {
+            return &PROTOCOL_MESSAGES[i];
+        }
+    }
+    return 0;
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_write_message(uint8_t * frame, Message_Type type, const int64_t * values)
+ * \brief Frame of any fixed size message, the fields given in the order of the schema.
+ *
+ * \return Size of the frame, -1 for a variable or unknown type.
+ */
+PROTOCOL_API int PROTOCOL_write_message(uint8_t * frame, Message_Type type, const int64_t * values) {
+    switch(type) {
+        case SEND_MOVES_TRAJECTORY :
+        {
+            Protocol_Msg_Send_Moves_Trajectory msg = {(uint8_t)values[0], (Command)values[1]};
+            return PROTOCOL_write_send_moves_trajectory(frame, &msg);
+        }
+        case SEND_MOVE_CARTOGRAPHY :
+        {
+            Protocol_Msg_Send_Move_Cartography msg = {(Command)values[0]};
+            return PROTOCOL_write_send_move_cartography(frame, &msg);
+        }
+        case MOVE_DONE : return PROTOCOL_write_move_done(frame);
+        case SET_OBSTACLE_POSITION :
+        {
+            Protocol_Msg_Set_Obstacle_Position msg = {(uint8_t)values[0], (uint8_t)values[1]};
+            return PROTOCOL_write_set_obstacle_position(frame, &msg);
+        }
+        case SET_ROBOT_POSITION :
+        {
+            Protocol_Msg_Set_Robot_Position msg = {(uint8_t)values[0], (uint8_t)values[1]};
+            return PROTOCOL_write_set_robot_position(frame, &msg);
+        }
+        case STOP_ROBOT : return PROTOCOL_write_stop_robot(frame);
+        case SEND_ROBOT_POSITION :
+        {
+            Protocol_Msg_Send_Robot_Position msg = {(uint8_t)values[0], (uint8_t)values[1], (Direction)values[2]};
+            return PROTOCOL_write_send_robot_position(frame, &msg);
+        }
+        case ROBOT_POSITION_RECEIVED : return PROTOCOL_write_robot_position_received(frame);
+        case HELLO :
+        {
+            Protocol_Msg_Hello msg = {(uint8_t)values[0], (uint32_t)values[1]};
+            return PROTOCOL_write_hello(frame, &msg);
+        }
+        case HELLO_ACK :
+        {
+            Protocol_Msg_Hello_Ack msg = {(uint8_t)values[0], (uint32_t)values[1]};
+            return PROTOCOL_write_hello_ack(frame, &msg);
+        }
+        case MAP_SNAPSHOT_REQUEST : return PROTOCOL_write_map_snapshot_request(frame);
+        case RESUME :
+        {
+            Protocol_Msg_Resume msg = {(uint32_t)values[0], (uint32_t)values[1], (uint32_t)values[2]};
+            return PROTOCOL_write_resume(frame, &msg);
+        }
+        case SESSION :
+        {
+            Protocol_Msg_Session msg = {(uint32_t)values[0], (uint8_t)values[1], (uint32_t)values[2]};
+            return PROTOCOL_write_session(frame, &msg);
+        }
+        case SET_OBSTACLE_POSITION_V2 :
+        {
+            Protocol_Msg_Set_Obstacle_Position_V2 msg = {(int32_t)values[0], (int32_t)values[1]};
+            return PROTOCOL_write_set_obstacle_position_v2(frame, &msg);
+        }
+        case SET_ROBOT_POSITION_V2 :
+        {
+            Protocol_Msg_Set_Robot_Position_V2 msg = {(int32_t)values[0], (int32_t)values[1], (Direction)values[2]};
+            return PROTOCOL_write_set_robot_position_v2(frame, &msg);
+        }
+        case SEND_ROBOT_POSITION_V2 :
+        {
+            Protocol_Msg_Send_Robot_Position_V2 msg = {(int32_t)values[0], (int32_t)values[1], (Direction)values[2]};
+            return PROTOCOL_write_send_robot_position_v2(frame, &msg);
+        }
+        default : return -1;
+    }
+}
+/**
+ * \fn PROTOCOL_API int PROTOCOL_read_message(const uint8_t * payload, int payload_size, Message_Type type, int64_t * values)
+ * \brief Reads the fields of any fixed size message, in the order of the schema.
+ *
+ * \return On success, returns the amount of fields. On error (short payload, variable or unknown type), returns -1.
+ */
+PROTOCOL_API int PROTOCOL_read_message(const uint8_t * payload, int payload_size, Message_Type type, int64_t * values) {
+    const Protocol_Message_Info * info = PROTOCOL_message_info(type);
+    if(info == 0 || info->payload_size < 0 || payload_size < info->payload_size) {
+        return -1;
+    }
+    switch(type) {
+        case SEND_MOVES_TRAJECTORY :
+        {
+            Protocol_Msg_Send_Moves_Trajectory msg = PROTOCOL_read_send_moves_trajectory(payload);
+            values[0] = msg.size;
+            values[1] = msg.command;
+            break;
+        }
+        case SEND_MOVE_CARTOGRAPHY :
+        {
+            Protocol_Msg_Send_Move_Cartography msg = PROTOCOL_read_send_move_cartography(payload);
+            values[0] = msg.command;
+            break;
+        }
+        case SET_OBSTACLE_POSITION :
+        {
+            Protocol_Msg_Set_Obstacle_Position msg = PROTOCOL_read_set_obstacle_position(payload);
+            values[0] = msg.coord_x;
+            values[1] = msg.coord_y;
+            break;
+        }
+        case SET_ROBOT_POSITION :
+        {
+            Protocol_Msg_Set_Robot_Position msg = PROTOCOL_read_set_robot_position(payload);
+            values[0] = msg.coord_x;
+            values[1] = msg.coord_y;
+            break;
+        }
+        case SEND_ROBOT_POSITION :
+        {
+            Protocol_Msg_Send_Robot_Position msg = PROTOCOL_read_send_robot_position(payload);
+            values[0] = msg.coord_x;
+            values[1] = msg.coord_y;
+            values[2] = msg.dir;
+            break;
+        }
+        case HELLO :
+        {
+            Protocol_Msg_Hello msg = PROTOCOL_read_hello(payload);
+            values[0] = msg.version;
+            values[1] = msg.capabilities;
+            break;
+        }
+        case HELLO_ACK :
+        {
+            Protocol_Msg_Hello_Ack msg = PROTOCOL_read_hello_ack(payload);
+            values[0] = msg.version;
+            values[1] = msg.capabilities;
+            break;
+        }
+        case RESUME :
+        {
+            Protocol_Msg_Resume msg = PROTOCOL_read_resume(payload);
+            values[0] = msg.token;
+            values[1] = msg.map_version;
+            values[2] = msg.moves_done;
+            break;
+        }
+        case SESSION :
+        {
+            Protocol_Msg_Session msg = PROTOCOL_read_session(payload);
+            values[0] = msg.token;
+            values[1] = msg.resumed;
+            values[2] = msg.moves_done;
+            break;
+        }
+        case SET_OBSTACLE_POSITION_V2 :
+        {
+            Protocol_Msg_Set_Obstacle_Position_V2 msg = PROTOCOL_read_set_obstacle_position_v2(payload);
+            values[0] = msg.coord_x;
+            values[1] = msg.coord_y;
+            break;
+        }
+        case SET_ROBOT_POSITION_V2 :
+        {
+            Protocol_Msg_Set_Robot_Position_V2 msg = PROTOCOL_read_set_robot_position_v2(payload);
+            values[0] = msg.coord_x;
+            values[1] = msg.coord_y;
+            values[2] = msg.dir;
+            break;
+        }
+        case SEND_ROBOT_POSITION_V2 :
+        {
+            Protocol_Msg_Send_Robot_Position_V2 msg = PROTOCOL_read_send_robot_position_v2(payload);
+            values[0] = msg.coord_x;
+            values[1] = msg.coord_y;
+            values[2] = msg.dir;
+            break;
+        }
+        default : break;
+    }
+    return info->field_count;
+}
+
+#endif /* PROTOCOL_PROTOCOL_CODECS_H_ */
@@ -0,0 +1,235 @@
+/**
+ * \file  protocol_messages.h
+ * \version  0.1
+ * \author Thomas ROCHER
+ * \date Oct 18, 2026
+ * \brief Message types of the protocol and their fields. Included by protocol.h.
+ *
+ * Generated by generate.py from protocol.schema : do not edit, run make -C Protocol generate.
+ *
+ * \see protocol.h
+ *
+ * \section License
+ *
+ * The MIT License
+ *
+ * Copyright (c) 2023, PFE 2024
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * \copyright PFE 2024
+ */
+
+#ifndef PROTOCOL_PROTOCOL_MESSAGES_H_
+#define PROTOCOL_PROTOCOL_MESSAGES_H_
+/* ----------------------  PUBLIC CONFIGURATIONS -----------------------------*/
+/**
+ * \def PROTOCOL_MESSAGE_COUNT
+ * Amount of message types.
+ */
+#define PROTOCOL_MESSAGE_COUNT 18
+/**
+ * \def PROTOCOL_MAX_FIELDS
+ * Max amount of fields of a fixed size message.
+ */
+#define PROTOCOL_MAX_FIELDS 3
+/**
+ * \def PROTOCOL_MAX_FIXED_PAYLOAD
+ * Biggest payload of a fixed size message.
+ */
+#define PROTOCOL_MAX_FIXED_PAYLOAD 12
+/* ----------------------  PUBLIC ENUMERATIONS -------------------------------*/
+/**
+ * \enum Message_Type
+ * \brief Defines message types.
+ *
+ * Unscoped so that C uses SEND_MOVES_TRAJECTORY and C++ can keep writing Message_Type::SEND_MOVES_TRAJECTORY.
+ */
+typedef enum {
+    SEND_MOVES_TRAJECTORY = 0x0100,    /**< SEND_MOVES_TRAJECTORY : Cute sends the move commands for the trajectory to Carto. Payload : size (u8), command (Command). */
+    SEND_MOVE_CARTOGRAPHY = 0x0200,    /**< SEND_MOVE_CARTOGRAPHY : Cute sends a move command for the cartography to Carto. Payload : command (Command). */
+    MOVE_DONE = 0x0300,                /**< MOVE_DONE : Carto confirms to Cute that move command has been performed. */
+    SET_OBSTACLE_POSITION = 0x0400,    /**< SET_OBSTACLE_POSITION : Carto sends an obstacle position to Cute. Payload : coord_x (u8), coord_y (u8). */
+    SET_ROBOT_POSITION = 0x0500,       /**< SET_ROBOT_POSITION : Carto sends the new robot position to Cute. Payload : coord_x (u8), coord_y (u8). */
+    STOP_ROBOT = 0x0600,               /**< STOP_ROBOT : Cute sends a stop command to the robot. */
+    SEND_ROBOT_POSITION = 0x0700,      /**< SEND_ROBOT_POSITION : Cute sends the robot position to Carto. Payload : coord_x (u8), coord_y (u8), dir (Direction). */
+    ROBOT_POSITION_RECEIVED = 0x0800,  /**< ROBOT_POSITION_RECEIVED : Carto confirms to Cute that the robot position has been received. */
+    HELLO = 0x0900,                    /**< HELLO : Cute opens the session. Payload : version (u8), capabilities (u32). */
+    HELLO_ACK = 0x0A00,                /**< HELLO_ACK : Carto answers the version and capabilities kept for the session. Payload : version (u8), capabilities (u32). */
+    MAP_DELTA = 0x0B00,                /**< MAP_DELTA : Carto sends a batch of cell changes. Payload : map version (u32), count (u16), count x [dx, dy (zigzag varints from the previous cell), value (u8)]. */
+    MAP_SNAPSHOT_REQUEST = 0x0C00,     /**< MAP_SNAPSHOT_REQUEST : Cute asks for the whole map (on connection). */
+    MAP_SNAPSHOT = 0x0D00,             /**< MAP_SNAPSHOT : One chunk of the map. Payload : Protocol_Snapshot_Head, then runs [length (varint), value (u8)] of the row-major cells. */
+    RESUME = 0x0E00,                   /**< RESUME : Cute resumes its session after a reconnection (token 0 : new session), with the map version and the count of MOVE_DONE it holds. Payload : token (u32), map_version (u32), moves_done (u32). */
+    SESSION = 0x0F00,                  /**< SESSION : Carto answers RESUME : token of the session, resumed = 1 when the token matched, count of MOVE_DONE sent in the session. Payload : token (u32), resumed (u8), moves_done (u32). */
+    SET_OBSTACLE_POSITION_V2 = 0x1400, /**< SET_OBSTACLE_POSITION_V2 : v2 SET_OBSTACLE_POSITION. Payload : coord_x (i32), coord_y (i32). */
+    SET_ROBOT_POSITION_V2 = 0x1500,    /**< SET_ROBOT_POSITION_V2 : v2 SET_ROBOT_POSITION. Payload : coord_x (i32), coord_y (i32), dir (Direction). */
+    SEND_ROBOT_POSITION_V2 = 0x1700,   /**< SEND_ROBOT_POSITION_V2 : v2 SEND_ROBOT_POSITION. Payload : coord_x (i32), coord_y (i32), dir (Direction). */
+    PROTOCOL_TYPE_LIMIT = 0xFFFF       /**< PROTOCOL_TYPE_LIMIT : not a message, gives the enum every 16-bit value so that an unknown type read from the wire stays defined in C++. */
+} Message_Type;
+/**
+ * \enum Protocol_Field_Kind
+ * \brief Encoding of a field on the wire.
+ */
+typedef enum {
+    PROTOCOL_FIELD_U8 = 0,      /**< PROTOCOL_FIELD_U8 : unsigned, 1 byte. */
+    PROTOCOL_FIELD_U16,         /**< PROTOCOL_FIELD_U16 : unsigned, 2 bytes. */
+    PROTOCOL_FIELD_U32,         /**< PROTOCOL_FIELD_U32 : unsigned, 4 bytes. */
+    PROTOCOL_FIELD_I32,         /**< PROTOCOL_FIELD_I32 : signed, 4 bytes. */
+    PROTOCOL_FIELD_COMMAND,     /**< PROTOCOL_FIELD_COMMAND : Command, 1 byte. */
+    PROTOCOL_FIELD_DIRECTION    /**< PROTOCOL_FIELD_DIRECTION : Direction, 1 byte. */
+} Protocol_Field_Kind;
+/* ----------------------  PUBLIC STRUCTURES ---------------------------------*/
+/**
+ * \struct Protocol_Message_Info protocol_messages.h "protocol_messages.h"
+ * \brief Description of a message type, see PROTOCOL_MESSAGES.
+ */
+typedef struct {
+    Message_Type type;                          /**< Type of the message. */
+    const char * name;                          /**< Name of the type. */
+    int payload_size;                           /**< Size of the payload, -1 for a variable payload. */
+    int field_count;                            /**< Amount of fields (0 for a variable payload). */
+    uint8_t fields[PROTOCOL_MAX_FIELDS];        /**< Protocol_Field_Kind of each field. */
+} Protocol_Message_Info;
+/**
+ * \struct Protocol_Msg_Send_Moves_Trajectory protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SEND_MOVES_TRAJECTORY.
+ */
+typedef struct {
+    uint8_t size;
+    Command command;
+} Protocol_Msg_Send_Moves_Trajectory;
+/**
+ * \struct Protocol_Msg_Send_Move_Cartography protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SEND_MOVE_CARTOGRAPHY.
+ */
+typedef struct {
+    Command command;
+} Protocol_Msg_Send_Move_Cartography;
+/**
+ * \struct Protocol_Msg_Set_Obstacle_Position protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SET_OBSTACLE_POSITION.
+ */
+typedef struct {
+    uint8_t coord_x;
+    uint8_t coord_y;
+} Protocol_Msg_Set_Obstacle_Position;
+/**
+ * \struct Protocol_Msg_Set_Robot_Position protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SET_ROBOT_POSITION.
+ */
+typedef struct {
+    uint8_t coord_x;
+    uint8_t coord_y;
+} Protocol_Msg_Set_Robot_Position;
+/**
+ * \struct Protocol_Msg_Send_Robot_Position protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SEND_ROBOT_POSITION.
+ */
+typedef struct {
+    uint8_t coord_x;
+    uint8_t coord_y;
+    Direction dir;
+} Protocol_Msg_Send_Robot_Position;
+/**
+ * \struct Protocol_Msg_Hello protocol_messages.h "protocol_messages.h"
+ * \brief Payload of HELLO.
+ */
+typedef struct {
+    uint8_t version;
+    uint32_t capabilities;
+} Protocol_Msg_Hello;
+/**
+ * \struct Protocol_Msg_Hello_Ack protocol_messages.h "protocol_messages.h"
+ * \brief Payload of HELLO_ACK.
+ */
+typedef struct {
+    uint8_t version;
+    uint32_t capabilities;
+} Protocol_Msg_Hello_Ack;
+/**
+ * \struct Protocol_Msg_Resume protocol_messages.h "protocol_messages.h"
+ * \brief Payload of RESUME.
+ */
+typedef struct {
+    uint32_t token;
+    uint32_t map_version;
+    uint32_t moves_done;
+} Protocol_Msg_Resume;
+/**
+ * \struct Protocol_Msg_Session protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SESSION.
+ */
+typedef struct {
+    uint32_t token;
+    uint8_t resumed;
+    uint32_t moves_done;
+} Protocol_Msg_Session;
+/**
+ * \struct Protocol_Msg_Set_Obstacle_Position_V2 protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SET_OBSTACLE_POSITION_V2.
+ */
+typedef struct {
+    int32_t coord_x;
+    int32_t coord_y;
+} Protocol_Msg_Set_Obstacle_Position_V2;
+/**
+ * \struct Protocol_Msg_Set_Robot_Position_V2 protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SET_ROBOT_POSITION_V2.
+ */
+typedef struct {
+    int32_t coord_x;
+    int32_t coord_y;
+    Direction dir;
+} Protocol_Msg_Set_Robot_Position_V2;
+/**
+ * \struct Protocol_Msg_Send_Robot_Position_V2 protocol_messages.h "protocol_messages.h"
+ * \brief Payload of SEND_ROBOT_POSITION_V2.
+ */
+typedef struct {
+    int32_t coord_x;
+    int32_t coord_y;
+    Direction dir;
+} Protocol_Msg_Send_Robot_Position_V2;
+/* ----------------------  PUBLIC VARIABLES ----------------------------------*/
+/**
+ * \var PROTOCOL_MESSAGES
+ * \brief Every message type, in the order of the schema.
+ */
+PROTOCOL_TABLE Protocol_Message_Info PROTOCOL_MESSAGES[PROTOCOL_MESSAGE_COUNT] = {
+    {SEND_MOVES_TRAJECTORY, "SEND_MOVES_TRAJECTORY", 2, 2, {PROTOCOL_FIELD_U8, PROTOCOL_FIELD_COMMAND}},
+    {SEND_MOVE_CARTOGRAPHY, "SEND_MOVE_CARTOGRAPHY", 1, 1, {PROTOCOL_FIELD_COMMAND}},
+    {MOVE_DONE, "MOVE_DONE", 0, 0, {0}},
+    {SET_OBSTACLE_POSITION, "SET_OBSTACLE_POSITION", 2, 2, {PROTOCOL_FIELD_U8, PROTOCOL_FIELD_U8}},
+    {SET_ROBOT_POSITION, "SET_ROBOT_POSITION", 2, 2, {PROTOCOL_FIELD_U8, PROTOCOL_FIELD_U8}},
+    {STOP_ROBOT, "STOP_ROBOT", 0, 0, {0}},
+    {SEND_ROBOT_POSITION, "SEND_ROBOT_POSITION", 3, 3, {PROTOCOL_FIELD_U8, PROTOCOL_FIELD_U8, PROTOCOL_FIELD_DIRECTION}},
+    {ROBOT_POSITION_RECEIVED, "ROBOT_POSITION_RECEIVED", 0, 0, {0}},
+    {HELLO, "HELLO", 5, 2, {PROTOCOL_FIELD_U8, PROTOCOL_FIELD_U32}},
+    {HELLO_ACK, "HELLO_ACK", 5, 2, {PROTOCOL_FIELD_U8, PROTOCOL_FIELD_U32}},
+    {MAP_DELTA, "MAP_DELTA", -1, 0, {0}},
+    {MAP_SNAPSHOT_REQUEST, "MAP_SNAPSHOT_REQUEST", 0, 0, {0}},
+    {MAP_SNAPSHOT, "MAP_SNAPSHOT", -1, 0, {0}},
+    {RESUME, "RESUME", 12, 3, {PROTOCOL_FIELD_U32, PROTOCOL_FIELD_U32, PROTOCOL_FIELD_U32}},
+    {SESSION, "SESSION", 9, 3, {PROTOCOL_FIELD_U32, PROTOCOL_FIELD_U8, PROTOCOL_FIELD_U32}},
+    {SET_OBSTACLE_POSITION_V2, "SET_OBSTACLE_POSITION_V2", 8, 2, {PROTOCOL_FIELD_I32, PROTOCOL_FIELD_I32}},
+    {SET_ROBOT_POSITION_V2, "SET_ROBOT_POSITION_V2", 9, 3, {PROTOCOL_FIELD_I32, PROTOCOL_FIELD_I32, PROTOCOL_FIELD_DIRECTION}},
+    {SEND_ROBOT_POSITION_V2, "SEND_ROBOT_POSITION_V2", 9, 3, {PROTOCOL_FIELD_I32, PROTOCOL_FIELD_I32, PROTOCOL_FIELD_DIRECTION}},
+};
+
+#endif /* PROTOCOL_PROTOCOL_MESSAGES_H_ */